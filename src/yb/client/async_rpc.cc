@@ -22,6 +22,8 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/common/transaction.h"
 
+#include "yb/rpc/slow_query_log.h"
+
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
@@ -131,6 +133,13 @@ const YBTable* AsyncRpc::table() const {
 void AsyncRpc::Finished(const Status& status) {
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
+    if (ErrorCode(response_error()) == tserver::TabletServerErrorPB::TABLET_SPLIT) {
+      if (batcher_->RetryOpsAfterTabletSplit(ops_)) {
+        retained_self_.reset();
+        return;
+      }
+      Failed(new_status);
+    }
     ProcessResponseFromTserver(new_status);
     batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, PropagatedHybridTime());
     batcher_->CheckForFinishedFlush();
@@ -204,7 +213,15 @@ AsyncRpcBase<Req, Resp>::AsyncRpcBase(
     bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel consistency_level)
     : AsyncRpc(batcher, tablet, allow_local_calls_in_curr_thread, ops, consistency_level) {
   req_.set_tablet_id(tablet_invoker_.tablet()->tablet_id());
-  req_.set_include_trace(IsTracingEnabled());
+  if (IsTracingEnabled()) {
+    req_.set_include_trace(true);
+  } else if (Trace::CurrentTrace() && rpc::IsSlowQueryLogEnabled()) {
+    // The call could end up in the slow query log, ask the tablet server for its trace when
+    // handling of the request takes a noticeable part of the slow query threshold. The call could
+    // be slow because of several requests, none of which takes the whole threshold.
+    req_.set_include_trace(true);
+    req_.set_trace_threshold_us(rpc::SlowQueryLogRequestTraceThreshold().ToMicroseconds());
+  }
   auto& transaction_data = batcher_->transaction_prepare_data();
   if (transaction_data.propagated_ht.is_valid()) {
     req_.set_propagated_hybrid_time(transaction_data.propagated_ht.ToUint64());
@@ -386,11 +403,10 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
         ql_op->mutable_response()->Swap(resp_.mutable_ql_response_batch(ql_idx));
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
-          Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          RefCntSlice rows_data;
+          CHECK_OK(retrier().controller().GetSidecarHolder(
               ql_response.rows_data_sidecar(), &rows_data));
-          down_cast<YBqlWriteOp*>(yb_op)->mutable_rows_data()->assign(
-              util::to_char_ptr(rows_data.data()), rows_data.size());
+          ql_op->set_rows_data(std::move(rows_data));
         }
         ql_idx++;
         break;
@@ -421,6 +437,7 @@ ReadRpc::ReadRpc(
     : AsyncRpcBase(batcher, tablet, allow_local_calls_in_curr_thread, ops, yb_consistency_level) {
   TRACE_TO(trace_, "ReadRpc initiated to $0", tablet->tablet_id());
   req_.set_consistency_level(yb_consistency_level);
+  MonoDelta max_staleness;
 
   int ctr = 0;
   for (auto& op : ops_) {
@@ -442,6 +459,11 @@ ReadRpc::ReadRpc(
         if (ql_op->read_time()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        // The ops are sent in a single request, so the tightest bound applies to all of them.
+        if (ql_op->max_staleness() &&
+            (!max_staleness || ql_op->max_staleness() < max_staleness)) {
+          max_staleness = ql_op->max_staleness();
+        }
         break;
       }
       case YBOperation::Type::REDIS_WRITE: FALLTHROUGH_INTENDED;
@@ -455,6 +477,15 @@ ReadRpc::ReadRpc(
     op->state = InFlightOpState::kRequestSent;
     VLOG(4) << ++ctr << ". Encoded row " << op->yb_op->ToString();
   }
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    if (max_staleness) {
+      req_.set_max_staleness_ms(max_staleness.ToMilliseconds());
+    }
+    auto session_write_hybrid_time = batcher->session_write_hybrid_time();
+    if (session_write_hybrid_time.is_valid()) {
+      req_.set_session_write_hybrid_time(session_write_hybrid_time.ToUint64());
+    }
+  }
 
   if (VLOG_IS_ON(3)) {
     VLOG(3) << "Created batch for " << tablet->tablet_id() << ":\n" << req_.ShortDebugString();
@@ -479,6 +510,13 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
+  if (req_.consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+      !tablet_invoker_.consistent_prefix()) {
+    // The replica was too stale, so the read falls back to the leader.
+    req_.set_consistency_level(YBConsistencyLevel::STRONG);
+    req_.clear_max_staleness_ms();
+    req_.clear_session_write_hybrid_time();
+  }
   tablet_invoker_.proxy()->ReadAsync(
       req_, &resp_, PrepareController(),
       std::bind(&ReadRpc::Finished, this, Status::OK()));
@@ -524,11 +562,10 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
         ql_op->mutable_response()->Swap(resp_.mutable_ql_batch(ql_idx));
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
-          Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          RefCntSlice rows_data;
+          CHECK_OK(retrier().controller().GetSidecarHolder(
               ql_response.rows_data_sidecar(), &rows_data));
-          down_cast<YBqlReadOp*>(yb_op)->mutable_rows_data()->assign(
-              util::to_char_ptr(rows_data.data()), rows_data.size());
+          ql_op->set_rows_data(std::move(rows_data));
         }
         ql_idx++;
         break;
@@ -58,6 +58,8 @@
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
 
@@ -79,6 +81,14 @@ namespace client {
 
 namespace internal {
 
+namespace {
+
+// The split tablet is returned by the master until the new tablets are running, so the ops are
+// looked up again after a delay.
+constexpr auto kLookupAfterTabletSplitDelay = std::chrono::milliseconds(100);
+
+} // namespace
+
 // About lock ordering in this file:
 // ------------------------------
 // The locks must be acquired in the following order:
@@ -105,7 +115,8 @@ Batcher::Batcher(YBClient* client,
     max_buffer_size_(7 * 1024 * 1024),
     buffer_bytes_used_(0),
     async_rpc_metrics_(session_data->async_rpc_metrics()),
-    transaction_(std::move(transaction)) {
+    transaction_(std::move(transaction)),
+    trace_(Trace::CurrentTrace()) {
 }
 
 void Batcher::Abort(const Status& status) {
@@ -205,13 +216,18 @@ MonoTime Batcher::ComputeDeadlineUnlocked() const {
 }
 
 void Batcher::FlushAsync(boost::function<void(const Status&)> callback) {
+  size_t num_ops;
+  int outstanding_lookups;
   {
     std::lock_guard<simple_spinlock> l(lock_);
     CHECK_EQ(state_, kGatheringOps);
     state_ = kFlushing;
     flush_callback_ = std::move(callback);
     deadline_ = ComputeDeadlineUnlocked();
+    num_ops = ops_.size();
+    outstanding_lookups = outstanding_lookups_;
   }
+  TRACE("Flushing $0 ops, $1 tablet lookups outstanding", num_ops, outstanding_lookups);
 
   // In the case that we have nothing buffered, just call the callback
   // immediately. Otherwise, the callback will be called by the last callback
@@ -372,6 +388,9 @@ OpGroup GetOpGroup(const InFlightOpPtr& op) {
 }
 
 void Batcher::FlushBuffersIfReady() {
+  // Could be called from the tablet lookup or transaction callbacks, so adopt the trace of the
+  // batcher for the RPCs to be traced as its children.
+  ADOPT_TRACE(trace_.get());
   InFlightOps ops;
 
   // We're only ready to flush if:
@@ -413,6 +432,7 @@ void Batcher::FlushBuffersIfReady() {
   if (ops.empty()) {
     return;
   }
+  TRACE("Tablet lookups done, sending $0 ops", ops.size());
 
   std::sort(ops.begin(),
             ops.end(),
@@ -516,6 +536,53 @@ void Batcher::RemoveInFlightOpsAfterFlushing(
   }
 }
 
+bool Batcher::RetryOpsAfterTabletSplit(const InFlightOps& ops) {
+  // Ops of a transaction are already registered with the tablets they were sent to, and ops with
+  // an explicitly specified tablet could not be moved to another one.
+  if (transaction()) {
+    return false;
+  }
+  for (const auto& op : ops) {
+    if (op->yb_op->tablet()) {
+      return false;
+    }
+  }
+
+  MonoTime deadline;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    if (IsAbortedUnlocked()) {
+      return false;
+    }
+    outstanding_lookups_ += ops.size();
+    deadline = deadline_;
+  }
+
+  for (const auto& op : ops) {
+    std::lock_guard<simple_spinlock> l(op->lock_);
+    op->state = InFlightOpState::kLookingUpTablet;
+    op->tablet = nullptr;
+  }
+  BatcherPtr self(this);
+  client_->messenger()->scheduler().Schedule(
+      [self, ops, deadline](const Status& status) {
+        self->LookupTabletsAfterSplit(ops, deadline);
+      },
+      kLookupAfterTabletSplitDelay);
+  return true;
+}
+
+void Batcher::LookupTabletsAfterSplit(const InFlightOps& ops, MonoTime deadline) {
+  // The lookups are done even if the scheduler was shut down, so that they fail and the ops are
+  // accounted for.
+  for (const auto& op : ops) {
+    VLOG(2) << "Looking up tablet again after split for " << op->yb_op->ToString();
+    client_->data_->meta_cache_->LookupTabletByKey(
+        op->yb_op->table(), op->partition_key, deadline, &op->tablet,
+        Bind(&Batcher::TabletLookupFinished, this, op));
+  }
+}
+
 void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
   // TODO: there is a potential race here -- if the Batcher gets destructed while
   // RPCs are in-flight, then accessing state_ will crash. We probably need to keep
@@ -532,6 +599,11 @@ void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
   }
 }
 
+HybridTime Batcher::session_write_hybrid_time() const {
+  auto session_data = weak_session_data_.lock();
+  return session_data ? session_data->write_hybrid_time() : HybridTime::kInvalid;
+}
+
 void Batcher::ProcessReadResponse(const ReadRpc &rpc, const Status &s) {
   ProcessRpcStatus(rpc, s);
 }
@@ -543,6 +615,13 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
     client_->data_->UpdateLatestObservedHybridTime(rpc.resp().propagated_hybrid_time());
   }
 
+  if (s.ok() && rpc.resp().has_write_hybrid_time()) {
+    auto session_data = weak_session_data_.lock();
+    if (session_data) {
+      session_data->UpdateWriteHybridTime(HybridTime(rpc.resp().write_hybrid_time()));
+    }
+  }
+
   // Check individual row errors.
   for (const WriteResponsePB_PerRowErrorPB& err_pb : rpc.resp().per_row_errors()) {
     // TODO: handle case where we get one of the more specific TS errors
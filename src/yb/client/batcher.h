@@ -51,6 +51,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/locks.h"
 #include "yb/util/status.h"
+#include "yb/util/trace.h"
 
 namespace yb {
 
@@ -159,6 +160,17 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void RemoveInFlightOpsAfterFlushing(
       const InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
+  // Looks up the tablets of ops, that were sent to a tablet that was split, again and resends
+  // them. Returns false if the ops could not be resent, so they should fail.
+  bool RetryOpsAfterTabletSplit(const InFlightOps& ops);
+
+  // Looks up the tablets of ops after a split, once the delay of RetryOpsAfterTabletSplit passed.
+  void LookupTabletsAfterSplit(const InFlightOps& ops, MonoTime deadline);
+
+  // Returns the hybrid time of the latest write done by the session of this batcher, or invalid
+  // hybrid time if it is unknown.
+  HybridTime session_write_hybrid_time() const;
+
     // Return true if the batch has been aborted, and any in-flight ops should stop
   // processing wherever they are.
   bool IsAbortedUnlocked() const;
@@ -264,6 +276,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   TransactionPrepareData transaction_prepare_data_;
 
+  // Trace of the call that created this batcher, the RPCs sent by the batcher are traced as its
+  // children.
+  scoped_refptr<Trace> trace_;
+
   DISALLOW_COPY_AND_ASSIGN(Batcher);
 };
 
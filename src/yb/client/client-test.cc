@@ -309,7 +309,7 @@ class ClientTest: public YBMiniClusterTestBase<MiniCluster> {
     ASSERT_OK(session->Apply(op));
     ASSERT_OK(session->Flush());
     ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
-    auto rowblock = ql::RowsResult(op.get()).GetRowBlock();
+    auto rowblock = ASSERT_RESULT(ql::RowsResult(op.get()).GetRowBlock());
     for (const auto& row : rowblock->rows()) {
       int32_t key = row.column(0).int32_value();
       ASSERT_GE(key, 5);
@@ -1515,6 +1515,57 @@ TEST_F(ClientTest, TestReplicatedTabletWritesWithLeaderElection) {
                                                      kNoBound, kNoBound));
 }
 
+// Checks that the meta cache follows a leader change pushed by the master, without any RPC to the
+// tablet failing first.
+TEST_F(ClientTest, TestWatchedTabletLocationsFollowLeaderChange) {
+  const YBTableName kReplicatedTable("replicated_watched_locations");
+  const int kNumReplicas = 3;
+
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kReplicatedTable, kNumReplicas, 1, &table));
+  ASSERT_NO_FATALS(InsertTestRows(table, 10));
+
+  Synchronizer sync;
+  scoped_refptr<internal::RemoteTablet> rt;
+  client_->data_->meta_cache_->LookupTabletByKey(table.get(), "",
+                                                 MonoTime::Max(),
+                                                 &rt, sync.AsStatusCallback());
+  ASSERT_OK(sync.Wait());
+  internal::RemoteTabletServer* old_leader = rt->LeaderTServer();
+  ASSERT_NE(old_leader, nullptr);
+  const string old_leader_uuid = old_leader->permanent_uuid();
+
+  MiniTabletServer* new_leader = nullptr;
+  for (int i = 0; i < cluster_->num_tablet_servers(); i++) {
+    MiniTabletServer* ts = cluster_->mini_tablet_server(i);
+    if (ts->server()->fs_manager()->uuid() != old_leader_uuid) {
+      new_leader = ts;
+      break;
+    }
+  }
+  ASSERT_NE(new_leader, nullptr);
+  const string new_leader_uuid = new_leader->server()->fs_manager()->uuid();
+
+  rpc::MessengerBuilder bld("client");
+  auto client_messenger = bld.Build();
+  ASSERT_OK(client_messenger);
+  consensus::ConsensusServiceProxy new_leader_proxy(
+      *client_messenger, new_leader->bound_rpc_addr());
+  consensus::RunLeaderElectionRequestPB req;
+  consensus::RunLeaderElectionResponsePB resp;
+  rpc::RpcController controller;
+  req.set_dest_uuid(new_leader_uuid);
+  req.set_tablet_id(rt->tablet_id());
+  ASSERT_OK(new_leader_proxy.RunLeaderElection(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << "Got error. Response: " << resp.ShortDebugString();
+
+  // Nothing is sent to the tablet, so only the watch can update the cached leader.
+  ASSERT_OK(WaitFor([rt, &new_leader_uuid]() -> Result<bool> {
+    auto* leader = rt->LeaderTServer();
+    return !rt->stale() && leader != nullptr && leader->permanent_uuid() == new_leader_uuid;
+  }, MonoDelta::FromSeconds(30), "Cached leader follows the leader change"));
+}
+
 namespace {
 
 void CheckCorrectness(const TableHandle& table, int expected[], int nrows) {
@@ -1913,7 +1964,7 @@ TEST_F(ClientTest, TestReadFromFollower) {
         *client_messenger, *endpoint);
 
     std::unique_ptr<QLRowBlock> rowBlock;
-    ASSERT_OK(WaitFor([&]() -> bool {
+    ASSERT_OK(WaitFor([&]() -> Result<bool> {
       // Setup read request.
       tserver::ReadRequestPB req;
       tserver::ReadResponsePB resp;
@@ -1946,7 +1997,7 @@ TEST_F(ClientTest, TestReadFromFollower) {
       EXPECT_TRUE(controller.finished());
       EXPECT_OK(controller.GetSidecar(ql_resp.rows_data_sidecar(), &rows_data));
       yb::ql::RowsResult rowsResult(kReadFromFollowerTable, selected_cols, rows_data.ToBuffer());
-      rowBlock = rowsResult.GetRowBlock();
+      rowBlock = VERIFY_RESULT(rowsResult.GetRowBlock());
       return FLAGS_test_scan_num_rows == rowBlock->row_count();
     }, MonoDelta::FromSeconds(30), "Waiting for replication to followers"));
 
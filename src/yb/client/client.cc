@@ -310,6 +310,8 @@ Status YBClientBuilder::Build(shared_ptr<YBClient>* client) {
   c->data_->cloud_info_pb_ = data_->cloud_info_pb_;
   c->data_->uuid_ = data_->uuid_;
 
+  c->data_->meta_cache_->StartWatchingTabletLocations();
+
   client->swap(c);
   return Status::OK();
 }
@@ -1443,6 +1445,14 @@ void YBSession::SetTimeout(MonoDelta timeout) {
   data_->SetTimeout(timeout);
 }
 
+HybridTime YBSession::write_hybrid_time() const {
+  return data_->write_hybrid_time();
+}
+
+void YBSession::UpdateWriteHybridTime(HybridTime hybrid_time) {
+  data_->UpdateWriteHybridTime(hybrid_time);
+}
+
 Status YBSession::Flush() {
   return data_->Flush();
 }
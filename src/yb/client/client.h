@@ -50,6 +50,7 @@
 #ifdef YB_HEADERS_NO_STUBS
 #include <gtest/gtest_prod.h>
 #include "yb/common/entity_ids.h"
+#include "yb/common/hybrid_time.h"
 #include "yb/common/index.h"
 #include "yb/gutil/macros.h"
 #include "yb/gutil/port.h"
@@ -101,6 +102,7 @@ namespace internal {
 class Batcher;
 class GetTableSchemaRpc;
 class LookupRpc;
+class TabletLocationsWatchRpc;
 class MetaCache;
 class RemoteTablet;
 class RemoteTabletServer;
@@ -471,6 +473,7 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   friend class internal::Batcher;
   friend class internal::GetTableSchemaRpc;
   friend class internal::LookupRpc;
+  friend class internal::TabletLocationsWatchRpc;
   friend class internal::MetaCache;
   friend class internal::RemoteTablet;
   friend class internal::RemoteTabletServer;
@@ -485,6 +488,7 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   FRIEND_TEST(ClientTest, TestReplicatedTabletWritesWithLeaderElection);
   FRIEND_TEST(ClientTest, TestScanFaultTolerance);
   FRIEND_TEST(ClientTest, TestScanTimeout);
+  FRIEND_TEST(ClientTest, TestWatchedTabletLocationsFollowLeaderChange);
   FRIEND_TEST(ClientTest, TestWriteWithDeadMaster);
   FRIEND_TEST(MasterFailoverTest, DISABLED_TestPauseAfterCreateTableIssued);
 
@@ -929,6 +933,15 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // Set the timeout for writes made in this session.
   void SetTimeout(MonoDelta timeout);
 
+  // Returns the hybrid time of the latest write done by this session, or invalid hybrid time if
+  // there were no writes. Consistent prefix reads of the session are served only by the replicas
+  // that have applied the writes up to this time, so the session reads its own writes.
+  HybridTime write_hybrid_time() const;
+
+  // Makes consistent prefix reads of this session observe the writes up to the given hybrid time,
+  // e.g. the write_hybrid_time() of another session.
+  void UpdateWriteHybridTime(HybridTime hybrid_time);
+
   CHECKED_STATUS ReadSync(std::shared_ptr<YBOperation> yb_op) WARN_UNUSED_RESULT;
 
   void ReadAsync(std::shared_ptr<YBOperation> yb_op, boost::function<void(const Status&)> callback);
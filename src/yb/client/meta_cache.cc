@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <condition_variable>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -49,8 +50,10 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/random_util.h"
 
 using std::string;
 using std::map;
@@ -60,6 +63,22 @@ using strings::Substitute;
 DEFINE_int32(max_concurrent_master_lookups, 50,
              "Maximum number of concurrent tablet location lookups from YB client to master");
 
+DEFINE_bool(client_watch_tablet_locations, true,
+            "Whether YB client should follow tablet location changes pushed by the master "
+            "instead of only finding them out after RPCs to moved tablets fail.");
+TAG_FLAG(client_watch_tablet_locations, advanced);
+
+DEFINE_int32(client_tablet_locations_watch_wait_ms, 1000,
+             "How long the master may hold a tablet locations watch from YB client when there "
+             "are no changes.");
+TAG_FLAG(client_tablet_locations_watch_wait_ms, advanced);
+
+DEFINE_int32(client_tablet_locations_full_refresh_spread_ms, 10000,
+             "When the master asks YB client to refresh all tablet locations, e.g. after a master "
+             "leader change, each cached tablet becomes stale at a random time within this "
+             "interval, so that clients do not look up all their tablets at once.");
+TAG_FLAG(client_tablet_locations_full_refresh_spread_ms, advanced);
+
 namespace yb {
 
 using consensus::RaftPeerPB;
@@ -69,6 +88,8 @@ using master::MasterServiceProxy;
 using master::TabletLocationsPB;
 using master::TabletLocationsPB_ReplicaPB;
 using master::TSInfoPB;
+using master::WatchTabletLocationsRequestPB;
+using master::WatchTabletLocationsResponsePB;
 using rpc::Messenger;
 using rpc::Rpc;
 using tablet::TabletStatePB;
@@ -211,6 +232,7 @@ void RemoteTablet::Refresh(const TabletServerMap& tservers,
     replicas_.push_back(rep);
   }
   stale_ = false;
+  stale_at_ = MonoTime();
 }
 
 void RemoteTablet::MarkStale() {
@@ -218,9 +240,16 @@ void RemoteTablet::MarkStale() {
   stale_ = true;
 }
 
+void RemoteTablet::MarkStaleAt(MonoTime stale_at) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (!stale_at_.Initialized() || stale_at.ComesBefore(stale_at_)) {
+    stale_at_ = stale_at;
+  }
+}
+
 bool RemoteTablet::stale() const {
   std::lock_guard<simple_spinlock> l(lock_);
-  return stale_;
+  return stale_ || (stale_at_.Initialized() && !MonoTime::Now().ComesBefore(stale_at_));
 }
 
 bool RemoteTablet::MarkReplicaFailed(RemoteTabletServer *ts,
@@ -597,6 +626,14 @@ void LookupRpc::DoFinished(const Status& status,
       }
     }
     new_status = StatusFromPB(resp.error().status());
+    // The tablet is being split, its locations are returned once the new tablets are running.
+    if (resp.error().code() == master::MasterErrorPB::IN_TRANSITION_CAN_RETRY) {
+      auto retry_status = mutable_retrier()->DelayedRetry(this, new_status);
+      if (retry_status.ok()) {
+        return;
+      }
+      new_status = retry_status;
+    }
   }
 
   if (new_status.IsTimedOut()) {
@@ -669,7 +706,15 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
       remote = new RemoteTablet(tablet_id, partition);
 
       CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
-      CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+      auto emplace_result = tablets_by_key.emplace(partition.partition_key_start(), remote);
+      if (!emplace_result.second) {
+        // The cached tablet was split, and this is the first of the new tablets, that starts at
+        // the same partition key. The split tablet stays cached by id, but is marked stale.
+        VLOG(1) << "Replacing split tablet " << emplace_result.first->second->tablet_id()
+                << " with " << tablet_id;
+        emplace_result.first->second->MarkStale();
+        emplace_result.first->second = remote;
+      }
     }
     remote->Refresh(ts_cache_, loc.replicas());
 
@@ -788,6 +833,246 @@ class LookupByKeyRpc : public LookupRpc {
   GetTableLocationsResponsePB resp_;
 };
 
+// Long-polls the master for tablet location changes. Each response starts the next watch, so
+// there is at most one watch in flight per meta cache.
+class TabletLocationsWatchRpc : public Rpc {
+ public:
+  TabletLocationsWatchRpc(const scoped_refptr<MetaCache>& meta_cache,
+                          rpc::Rpcs::Handle handle,
+                          std::string history_id,
+                          int64_t since_version,
+                          const MonoTime& deadline,
+                          const shared_ptr<Messenger>& messenger)
+      : Rpc(deadline, messenger),
+        meta_cache_(meta_cache),
+        handle_(handle) {
+    req_.set_history_id(std::move(history_id));
+    req_.set_since_version(since_version);
+    req_.set_wait_timeout_ms(FLAGS_client_tablet_locations_watch_wait_ms);
+  }
+
+  void SendRpc() override {
+    mutable_retrier()->mutable_controller()->set_deadline(retrier().deadline());
+    auto self = shared_from_this();
+    master_proxy()->WatchTabletLocationsAsync(
+        req_, &resp_, mutable_retrier()->mutable_controller(),
+        [this, self] { Finished(Status::OK()); });
+  }
+
+  // The master could hold the watch for a while, so shutdown does not wait for the response.
+  // The RPC leaves the meta cache right away, the call in flight keeps it alive until the
+  // response arrives, which is then ignored.
+  void Abort() override;
+
+  std::string ToString() const override {
+    return Format("TabletLocationsWatchRpc($0, $1, $2)",
+                  req_.history_id(), req_.since_version(), num_attempts());
+  }
+
+ private:
+  YBClient* client() const { return meta_cache_->client_; }
+
+  std::shared_ptr<MasterServiceProxy> master_proxy() const {
+    return client()->data_->master_proxy();
+  }
+
+  void Finished(const Status& status) override;
+
+  void DoFinished(const Status& status);
+
+  void ResetMasterLeaderAndRetry();
+
+  static void NewLeaderMasterDetermined(
+      const std::shared_ptr<TabletLocationsWatchRpc>& rpc, const Status& status);
+
+  // Callbacks use the client, so Abort() waits for the running ones, and they do nothing once
+  // the RPC is aborted. Returns false if the RPC is aborted.
+  bool Enter();
+  void Leave();
+
+  scoped_refptr<MetaCache> meta_cache_;
+  rpc::Rpcs::Handle handle_;
+  WatchTabletLocationsRequestPB req_;
+  WatchTabletLocationsResponsePB resp_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool aborted_ = false;
+  int running_callbacks_ = 0;
+};
+
+void TabletLocationsWatchRpc::Abort() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    aborted_ = true;
+    cond_.wait(lock, [this] { return running_callbacks_ == 0; });
+  }
+  // Cancels the retry the last callback could have scheduled.
+  Rpc::Abort();
+  auto retained_self = meta_cache_->rpcs_.Unregister(&handle_);
+}
+
+bool TabletLocationsWatchRpc::Enter() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (aborted_) {
+    return false;
+  }
+  ++running_callbacks_;
+  return true;
+}
+
+void TabletLocationsWatchRpc::Leave() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (--running_callbacks_ == 0) {
+    cond_.notify_all();
+  }
+}
+
+void TabletLocationsWatchRpc::Finished(const Status& status) {
+  // The completion could drop the last reference to the RPC.
+  auto retained_self = shared_from_this();
+  if (!Enter()) {
+    return;
+  }
+  DoFinished(status);
+  Leave();
+}
+
+void TabletLocationsWatchRpc::DoFinished(const Status& status) {
+  Status new_status = status;
+  if (new_status.ok() && mutable_retrier()->HandleResponse(this, &new_status)) {
+    return;
+  }
+
+  if (new_status.ok() && resp_.has_error()) {
+    if (resp_.error().code() == master::MasterErrorPB::NOT_THE_LEADER ||
+        resp_.error().code() == master::MasterErrorPB::CATALOG_MANAGER_NOT_INITIALIZED) {
+      if (client()->IsMultiMaster()) {
+        VLOG(1) << "Leader Master has changed, re-trying " << ToString();
+        ResetMasterLeaderAndRetry();
+        return;
+      }
+    }
+    new_status = StatusFromPB(resp_.error().status());
+  }
+
+  if (new_status.IsNetworkError() && client()->IsMultiMaster() &&
+      MonoTime::Now().ComesBefore(retrier().deadline())) {
+    ResetMasterLeaderAndRetry();
+    return;
+  }
+
+  std::string history_id = req_.history_id();
+  int64_t since_version = req_.since_version();
+  if (new_status.ok()) {
+    meta_cache_->ProcessWatchedTabletLocations(resp_);
+    history_id = resp_.history_id();
+    since_version = resp_.version();
+  } else if (new_status.IsAborted() || new_status.IsRemoteError()) {
+    // Either the client is shutting down or the master does not support watching.
+    LOG(INFO) << "Stopped watching tablet locations: " << new_status;
+    auto retained_self = meta_cache_->rpcs_.Unregister(&handle_);
+    return;
+  } else if (!new_status.IsTimedOut()) {
+    YB_LOG_EVERY_N(WARNING, 10) << ToString() << " failed: " << new_status;
+    // Retry with backoff until the deadline, then start over with a new watch.
+    if (mutable_retrier()->DelayedRetry(this, new_status).ok()) {
+      return;
+    }
+    auto retained_self = meta_cache_->rpcs_.Unregister(&handle_);
+    return;
+  }
+
+  // Keep ourselves alive until we return, the next watch replaces us in the meta cache.
+  auto meta_cache = meta_cache_;
+  auto retained_self = meta_cache->rpcs_.Unregister(&handle_);
+  meta_cache->WatchTabletLocations(std::move(history_id), since_version);
+}
+
+void TabletLocationsWatchRpc::ResetMasterLeaderAndRetry() {
+  client()->data_->SetMasterServerProxyAsync(
+      client(),
+      retrier().deadline(),
+      false /* skip_resolution */,
+      Bind(&TabletLocationsWatchRpc::NewLeaderMasterDetermined,
+           std::static_pointer_cast<TabletLocationsWatchRpc>(shared_from_this())));
+}
+
+void TabletLocationsWatchRpc::NewLeaderMasterDetermined(
+    const std::shared_ptr<TabletLocationsWatchRpc>& rpc, const Status& status) {
+  if (!rpc->Enter()) {
+    return;
+  }
+  if (status.ok()) {
+    rpc->mutable_retrier()->mutable_controller()->Reset();
+    rpc->SendRpc();
+  } else {
+    auto retry_status = rpc->mutable_retrier()->DelayedRetry(rpc.get(), status);
+    LOG_IF(DFATAL, !retry_status.ok()) << "Retry failed: " << retry_status;
+  }
+  rpc->Leave();
+}
+
+void MetaCache::StartWatchingTabletLocations() {
+  if (FLAGS_client_watch_tablet_locations) {
+    WatchTabletLocations(std::string(), 0);
+  }
+}
+
+void MetaCache::WatchTabletLocations(std::string history_id, int64_t since_version) {
+  auto handle = rpcs_.Prepare();
+  if (handle == rpcs_.InvalidHandle()) {
+    return;
+  }
+  auto deadline = MonoTime::Now() +
+                  MonoDelta::FromMilliseconds(FLAGS_client_tablet_locations_watch_wait_ms) +
+                  client_->default_rpc_timeout();
+  *handle = std::make_shared<TabletLocationsWatchRpc>(
+      this, handle, std::move(history_id), since_version, deadline, client_->data_->messenger_);
+  (**handle).SendRpc();
+}
+
+void MetaCache::ProcessWatchedTabletLocations(const WatchTabletLocationsResponsePB& resp) {
+  VLOG(2) << "Processing tablet locations watch response " << resp.ShortDebugString();
+
+  std::lock_guard<rw_spinlock> l(lock_);
+  if (resp.needs_full_refresh()) {
+    // Some changes were missed, so nothing cached can be trusted. Tablets that moved are still
+    // refreshed right away when RPCs to them fail.
+    const auto spread_ms = FLAGS_client_tablet_locations_full_refresh_spread_ms;
+    const auto now = MonoTime::Now();
+    for (const auto& entry : tablets_by_id_) {
+      if (spread_ms > 0) {
+        entry.second->MarkStaleAt(
+            now + MonoDelta::FromMilliseconds(RandomUniformInt(0, spread_ms - 1)));
+      } else {
+        entry.second->MarkStale();
+      }
+    }
+    return;
+  }
+
+  for (const auto& tablet_id : resp.invalidated_tablet_ids()) {
+    RemoteTabletPtr remote = FindPtrOrNull(tablets_by_id_, tablet_id);
+    if (remote) {
+      remote->MarkStale();
+    }
+  }
+
+  for (const TabletLocationsPB& loc : resp.tablet_locations()) {
+    // Tablets that were never looked up are not cached, they will be fetched on the first use.
+    RemoteTabletPtr remote = FindPtrOrNull(tablets_by_id_, loc.tablet_id());
+    if (!remote) {
+      continue;
+    }
+    for (const TabletLocationsPB_ReplicaPB& r : loc.replicas()) {
+      UpdateTabletServer(r.ts_info());
+    }
+    VLOG(3) << "Refreshing watched tablet " << loc.tablet_id() << ": " << loc.ShortDebugString();
+    remote->Refresh(ts_cache_, loc.replicas());
+  }
+}
+
 RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
                                                      const string& partition_key) {
   shared_lock<rw_spinlock> l(lock_);
@@ -74,6 +74,7 @@ class MasterServiceProxy;
 class TabletLocationsPB_ReplicaPB;
 class TabletLocationsPB;
 class TSInfoPB;
+class WatchTabletLocationsResponsePB;
 } // namespace master
 
 namespace client {
@@ -87,6 +88,7 @@ namespace internal {
 class LookupRpc;
 class LookupByKeyRpc;
 class LookupByIdRpc;
+class TabletLocationsWatchRpc;
 
 // The information cached about a given tablet server in the cluster.
 //
@@ -176,6 +178,10 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // path can be used or whether the metadata must be refreshed from the Master.
   void MarkStale();
 
+  // Same as MarkStale(), but the tablet becomes stale only at 'stale_at'. Used to spread the
+  // lookups that follow a refresh of all cached tablets.
+  void MarkStaleAt(MonoTime stale_at);
+
   // Whether the tablet has been marked as stale.
   bool stale() const;
 
@@ -235,6 +241,8 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // All non-const members are protected by 'lock_'.
   mutable simple_spinlock lock_;
   bool stale_;
+  // When the tablet becomes stale, uninitialized unless MarkStaleAt() was called.
+  MonoTime stale_at_;
   std::vector<RemoteReplica> replicas_;
 
   // The state of this tablet at each specific replica. Only updated after calling GetTabletStatus.
@@ -284,6 +292,10 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // not be returned in future cache lookups.
   void MarkTSFailed(RemoteTabletServer* ts, const Status& status);
 
+  // Starts following tablet location changes pushed by the master, so that cached tablets are
+  // refreshed before RPCs to them fail. Does nothing if disabled by flag.
+  void StartWatchingTabletLocations();
+
   // Acquire or release a permit to perform a (slow) master lookup.
   //
   // If acquisition fails, caller may still do the lookup, but is first
@@ -295,6 +307,7 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   friend class LookupRpc;
   friend class LookupByKeyRpc;
   friend class LookupByIdRpc;
+  friend class TabletLocationsWatchRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
 
@@ -310,6 +323,13 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   RemoteTabletPtr LookupTabletByIdFastPath(const std::string& tablet_id);
 
+  // Applies tablet location changes received from the master. Only tablets that are already
+  // cached are updated.
+  void ProcessWatchedTabletLocations(const master::WatchTabletLocationsResponsePB& resp);
+
+  // Starts the next watch RPC, continuing from the given history and version.
+  void WatchTabletLocations(std::string history_id, int64_t since_version);
+
   // Update our information about the given tablet server.
   //
   // This is called when we get some response from the master which contains
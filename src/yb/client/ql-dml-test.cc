@@ -137,7 +137,11 @@ class QLDmlTest : public QLDmlTestBase {
     auto op = SelectRow(session, {"c1", "c2"}, h1, h2, r1, r2);
 
     VERIFY_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
-    auto rowblock = RowsResult(op.get()).GetRowBlock();
+    auto rowblock_result = RowsResult(op.get()).GetRowBlock();
+    if (!rowblock_result.ok()) {
+      return testing::AssertionFailure() << rowblock_result.status().ToString();
+    }
+    const auto& rowblock = *rowblock_result;
     VERIFY_EQ(1, rowblock->row_count());
     const auto& row = rowblock->row(0);
     VERIFY_EQ(c1, row.column(0).int32_value());
@@ -169,7 +173,7 @@ TEST_F(QLDmlTest, TestInsertUpdateAndSelect) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -201,7 +205,7 @@ TEST_F(QLDmlTest, TestInsertUpdateAndSelect) {
 
     // Expect 4, 'd' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(row.column(0).int32_value(), 4);
@@ -367,7 +371,7 @@ TEST_F(QLDmlTest, TestInsertMultipleRows) {
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
     {
-      unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+      auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
       EXPECT_EQ(rowblock->row_count(), 1);
       EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
     }
@@ -382,7 +386,7 @@ TEST_F(QLDmlTest, TestInsertMultipleRows) {
     // Expect 1, 'a', 2, 'd', 4, 'e' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
     {
-      unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+      auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
       EXPECT_EQ(rowblock->row_count(), 1);
       EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "d", 4, "e");
     }
@@ -422,7 +426,7 @@ TEST_F(QLDmlTest, TestSelectMultipleRows) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' and 1, 'a', 2, 'd', 4, 'e' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 2);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
     EXPECT_ROW_VALUES(rowblock->row(1), 1, "a", 2, "d", 4, "e");
@@ -448,7 +452,7 @@ TEST_F(QLDmlTest, TestSelectMultipleRows) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' and 1, 'a', 2, 'd', 4, 'e' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 2);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
     EXPECT_ROW_VALUES(rowblock->row(1), 1, "a", 2, "d", 4, "e");
@@ -495,7 +499,7 @@ TEST_F(QLDmlTest, TestSelectWithoutConditionWithLimit) {
     //   1, 'a', 5, 'b', 6, 'c'
     //   1, 'a', 6, 'b', 7, 'c'
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 5);
     for (int32_t i = 0; i < 5; i++) {
       EXPECT_ROW_VALUES(rowblock->row(i), 1, "a", 2 + i, "b", 3 + i, "c");
@@ -527,7 +531,7 @@ TEST_F(QLDmlTest, TestUpsert) {
 
     // Expect 1, 'a', 2, 'b', 3, null returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(row.column(0).int32_value(), 1);
@@ -559,7 +563,7 @@ TEST_F(QLDmlTest, TestUpsert) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -594,7 +598,7 @@ TEST_F(QLDmlTest, TestDelete) {
 
     // Expect null, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_TRUE(row.column(0).IsNull());
@@ -621,7 +625,7 @@ TEST_F(QLDmlTest, TestDelete) {
 
     // Expect no row returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 0);
   }
 }
@@ -640,7 +644,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -662,7 +666,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect not applied
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -676,7 +680,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -701,7 +705,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect not applied, return c2 = 'd'. Verify column names ("[applied]" and "c2") also.
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -718,7 +722,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -743,7 +747,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect applied
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -757,7 +761,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 4, "d");
   }
@@ -775,7 +779,7 @@ TEST_F(QLDmlTest, TestConditionalInsert) {
 
     // Expect 1, 'a', 2, 'b', 5, 'e' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 5, "e");
   }
@@ -795,7 +799,7 @@ TEST_F(QLDmlTest, TestConditionalUpdate) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -816,7 +820,7 @@ TEST_F(QLDmlTest, TestConditionalUpdate) {
 
     // Expect not applied
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -830,7 +834,7 @@ TEST_F(QLDmlTest, TestConditionalUpdate) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -851,7 +855,7 @@ TEST_F(QLDmlTest, TestConditionalUpdate) {
 
     // Expect applied
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -865,7 +869,7 @@ TEST_F(QLDmlTest, TestConditionalUpdate) {
 
     // Expect 1, 'a', 2, 'b', 6, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 6, "c");
   }
@@ -885,7 +889,7 @@ TEST_F(QLDmlTest, TestConditionalDelete) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -906,7 +910,7 @@ TEST_F(QLDmlTest, TestConditionalDelete) {
 
     // Expect not applied, return c1 = 3. Verify column names also.
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().num_columns(), 2);
@@ -924,7 +928,7 @@ TEST_F(QLDmlTest, TestConditionalDelete) {
 
     // Expect 1, 'a', 2, 'b', 3, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     EXPECT_ROW_VALUES(rowblock->row(0), 1, "a", 2, "b", 3, "c");
   }
@@ -948,7 +952,7 @@ TEST_F(QLDmlTest, TestConditionalDelete) {
 
     // Expect applied
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -962,7 +966,7 @@ TEST_F(QLDmlTest, TestConditionalDelete) {
 
     // Expect 1, 'a', 2, 'b', null, 'c' returned
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(row.column(0).int32_value(), 1);
@@ -988,7 +992,7 @@ TEST_F(QLDmlTest, TestConditionalDelete) {
 
     // Expect not applied
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(rowblock->schema().column(0).name(), "[applied]");
@@ -1050,7 +1054,7 @@ TEST_F(QLDmlTest, TestSimultaneousReadAndWrite) {
     if (read_op) {
       ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, read_op->response().status());
 
-      auto rowblock = RowsResult(read_op.get()).GetRowBlock();
+      auto rowblock = ASSERT_RESULT(RowsResult(read_op.get()).GetRowBlock());
       ASSERT_EQ(1, rowblock->row_count());
       const auto& row = rowblock->row(0);
       ASSERT_EQ((i - 1) * 2, row.column(0).int32_value());
@@ -87,7 +87,7 @@ TEST_F(QLDmlTTLTest, TestInsertWithTTL) {
 
     // Expect all 4 columns (c1, c2, c3, c4) to be valid right now.
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(row.column(0).int32_value(), 1);
@@ -111,7 +111,7 @@ TEST_F(QLDmlTTLTest, TestInsertWithTTL) {
 
     // Expect columns (c1, c2) to be null and (c3, c4) to be valid right now.
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 1);
     const auto& row = rowblock->row(0);
     EXPECT_EQ(row.column(0).int32_value(), 1);
@@ -135,7 +135,7 @@ TEST_F(QLDmlTTLTest, TestInsertWithTTL) {
 
     // Expect all 4 columns (c1, c2, c3, c4) to be null.
     EXPECT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-    unique_ptr<QLRowBlock> rowblock(RowsResult(op.get()).GetRowBlock());
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
     EXPECT_EQ(rowblock->row_count(), 0);
   }
 
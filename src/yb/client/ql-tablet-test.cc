@@ -21,6 +21,8 @@
 #include "yb/client/ql-dml-test-base.h"
 #include "yb/client/table_handle.h"
 
+#include "yb/common/partition.h"
+
 #include "yb/consensus/consensus.pb.h"
 
 #include "yb/docdb/consensus_frontier.h"
@@ -31,13 +33,16 @@
 #include "yb/master/master.h"
 
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
 
 #include "yb/server/test_clock.h"
 
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
+#include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver_service.proxy.h"
 
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -48,6 +53,12 @@ DECLARE_uint64(initial_seqno);
 DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int64(db_write_buffer_size);
 DECLARE_bool(use_test_clock);
+DECLARE_bool(propagate_safe_time);
+DECLARE_int32(max_wait_for_session_writes_on_follower_ms);
+DECLARE_bool(enable_automatic_tablet_splitting);
+DECLARE_int64(tablet_split_size_threshold_bytes);
+
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
 
 namespace yb {
 namespace client {
@@ -97,7 +108,7 @@ class QLTabletTest : public QLDmlTestBase {
   boost::optional<int32_t> GetValue(const YBSessionPtr& session, int32_t key, TableHandle* table) {
     const auto op = CreateReadOp(key, table);
     EXPECT_OK(session->Apply(op));
-    auto rowblock = RowsResult(op.get()).GetRowBlock();
+    auto rowblock = CHECK_RESULT(RowsResult(op.get()).GetRowBlock());
     if (rowblock->row_count() == 0) {
       return boost::none;
     }
@@ -227,8 +238,8 @@ class QLTabletTest : public QLDmlTestBase {
             columns = std::make_shared<std::vector<ColumnSchema>>(table->schema().columns());
           Slice data;
           RETURN_NOT_OK(controller.GetSidecar(ql_batch.rows_data_sidecar(), &data));
-          yb::ql::RowsResult result(table->name(), columns, data.ToBuffer());
-          auto row_block = result.GetRowBlock();
+          yb::ql::RowsResult rows_result(table->name(), columns, data.ToBuffer());
+          auto row_block = VERIFY_RESULT(rows_result.GetRowBlock());
           if (row_block->row_count() == 1) {
             if (found) {
               return STATUS_FORMAT(Corruption, "Key found twice: $0", i);
@@ -606,6 +617,207 @@ TEST_F(QLTabletTest, BoundaryValues) {
   }
 }
 
+// Consistent prefix reads of the session should observe the writes of the same session, even when
+// they are served by a follower that lags behind the leader.
+TEST_F(QLTabletTest, ReadYourWrites) {
+  google::FlagSaver saver;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+
+  int leader_index = -1;
+  int follower_index = -1;
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      if (peer->tablet_metadata()->table_id() != table->id()) {
+        continue;
+      }
+      if (peer->LeaderStatus() == consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+        leader_index = i;
+      } else {
+        follower_index = i;
+      }
+    }
+  }
+  ASSERT_NE(-1, leader_index);
+  ASSERT_NE(-1, follower_index);
+
+  // Without the propagated safe time, the safe time of the follower only advances when it learns
+  // from the next leader request that the operations were committed. That request is sent along
+  // with the response to the write, so the follower usually has to wait for the write of the
+  // session to serve the read that follows it.
+  FLAGS_propagate_safe_time = false;
+  // The follower should serve all the reads, even when the test machine is slow, so it is allowed
+  // to wait longer than by default before falling back to the leader.
+  FLAGS_max_wait_for_session_writes_on_follower_ms = 5000;
+
+  // The client considers the follower local, so it sends the consistent prefix reads there.
+  YBClientBuilder builder;
+  auto* follower = cluster_->mini_tablet_server(follower_index)->server();
+  builder.set_tserver_uuid(follower->permanent_uuid());
+  std::shared_ptr<YBClient> follower_client;
+  ASSERT_OK(cluster_->CreateClient(&builder, &follower_client));
+  auto session = follower_client->NewSession();
+  session->SetTimeout(15s);
+
+  auto num_reads_received = [this](int index) {
+    return METRIC_handler_latency_yb_tserver_TabletServerService_Read.Instantiate(
+        cluster_->mini_tablet_server(index)->server()->metric_entity())->TotalCount();
+  };
+  const auto leader_reads = num_reads_received(leader_index);
+  const auto follower_reads = num_reads_received(follower_index);
+
+  constexpr int kNumWrites = 200;
+  HybridTime last_write_hybrid_time = HybridTime::kMin;
+  for (int i = 0; i != kNumWrites; ++i) {
+    SetValue(session, 0, i, &table);
+    auto write_hybrid_time = session->write_hybrid_time();
+    ASSERT_TRUE(write_hybrid_time.is_valid());
+    ASSERT_GT(write_hybrid_time, last_write_hybrid_time);
+    last_write_hybrid_time = write_hybrid_time;
+
+    auto op = CreateReadOp(0, &table);
+    op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    ASSERT_OK(session->Apply(op));
+    auto rowblock = ASSERT_RESULT(RowsResult(op.get()).GetRowBlock());
+    ASSERT_EQ(1, rowblock->row_count());
+    ASSERT_EQ(i, rowblock->row(0).column(0).int32_value());
+  }
+
+  // All the reads were served by the follower, none of them fell back to the leader.
+  ASSERT_EQ(leader_reads, num_reads_received(leader_index));
+  ASSERT_EQ(follower_reads + kNumWrites, num_reads_received(follower_index));
+}
+
+void StepDownTabletLeader(MiniCluster* cluster, const TabletId& tablet_id) {
+  for (int i = 0; i != cluster->num_tablet_servers(); ++i) {
+    tablet::TabletPeerPtr peer;
+    auto* tablet_manager = cluster->mini_tablet_server(i)->server()->tablet_manager();
+    if (!tablet_manager->LookupTablet(tablet_id, &peer) ||
+        peer->LeaderStatus() != consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+      continue;
+    }
+    consensus::LeaderStepDownRequestPB req;
+    req.set_tablet_id(tablet_id);
+    consensus::LeaderStepDownResponsePB resp;
+    ASSERT_OK(peer->consensus()->StepDown(&req, &resp));
+  }
+}
+
+// Splits a tablet under concurrent reads and writes, while its leader changes and a tablet server
+// is restarted, and checks that all rows are readable from the new tablets.
+TEST_F(QLTabletTest, SplitUnderLoad) {
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  FillTable(0, kTotalKeys, &table);
+
+  auto* catalog_manager = cluster_->leader_mini_master()->master()->catalog_manager();
+  auto table_info = catalog_manager->GetTableInfo(table->id());
+  ASSERT_TRUE(table_info);
+  master::TabletInfos tablets;
+  table_info->GetAllTablets(&tablets);
+  ASSERT_EQ(1, tablets.size());
+  const auto parent = tablets[0];
+
+  std::atomic<bool> stop(false);
+  std::atomic<int> rows_written(kTotalKeys);
+  std::thread writer([this, &table, &stop, &rows_written] {
+    auto session = CreateSession();
+    while (!stop.load(std::memory_order_acquire)) {
+      const int key = rows_written.load(std::memory_order_acquire);
+      SetValue(session, key, ValueForKey(key), &table);
+      rows_written.store(key + 1, std::memory_order_release);
+    }
+  });
+  std::thread reader([this, &table, &stop, &rows_written] {
+    auto session = CreateSession();
+    while (!stop.load(std::memory_order_acquire)) {
+      const int key = RandomUniformInt(0, rows_written.load(std::memory_order_acquire) - 1);
+      auto value = GetValue(session, key, &table);
+      ASSERT_TRUE(value.is_initialized()) << "key: " << key;
+      ASSERT_EQ(ValueForKey(key), *value) << "key: " << key;
+    }
+  });
+
+  ASSERT_OK(catalog_manager->SplitTablet(
+      parent, PartitionSchema::EncodeMultiColumnHashValue(0x8000)));
+  StepDownTabletLeader(cluster_.get(), parent->tablet_id());
+  ASSERT_OK(cluster_->mini_tablet_server(0)->Restart());
+  ASSERT_OK(cluster_->mini_tablet_server(0)->WaitStarted());
+
+  ASSERT_OK(WaitFor([&] {
+    table_info->GetAllTablets(&tablets);
+    return tablets.size() == 2 && parent->LockForRead()->data().is_deleted();
+  }, 60s, "Tablet split"));
+  std::this_thread::sleep_for(2s);
+
+  stop.store(true, std::memory_order_release);
+  writer.join();
+  reader.join();
+
+  LOG(INFO) << "Rows written: " << rows_written.load();
+  ASSERT_GT(rows_written.load(), kTotalKeys);
+  VerifyTable(0, rows_written.load(), &table);
+  FillTable(rows_written.load(), rows_written.load() + kTotalKeys, &table);
+}
+
+// Tablets created by a split share the SST files of their parent until those are compacted, so a
+// tablet split because of its size should not make its children look large enough to be split.
+TEST_F(QLTabletTest, SplitDoesNotCascade) {
+  google::FlagSaver saver;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  FillTable(0, kTotalKeys, &table);
+  ASSERT_OK(cluster_->FlushTablets());
+
+  auto* catalog_manager = cluster_->leader_mini_master()->master()->catalog_manager();
+  auto table_info = catalog_manager->GetTableInfo(table->id());
+  ASSERT_TRUE(table_info);
+  master::TabletInfos tablets;
+  table_info->GetAllTablets(&tablets);
+  ASSERT_EQ(1, tablets.size());
+  const auto parent = tablets[0];
+
+  auto max_replica_size = [this](const TabletId& tablet_id, bool own) {
+    uint64_t result = 0;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      tablet::TabletPeerPtr peer;
+      auto* tablet_manager = cluster_->mini_tablet_server(i)->server()->tablet_manager();
+      if (tablet_manager->LookupTablet(tablet_id, &peer) && peer->tablet()) {
+        result = std::max(result, own ? peer->tablet()->GetOwnSSTFileSizes()
+                                      : peer->tablet()->GetTotalSSTFileSizes());
+      }
+    }
+    return result;
+  };
+  const uint64_t parent_size = max_replica_size(parent->tablet_id(), /* own = */ false);
+  ASSERT_GT(parent_size, 0);
+
+  FLAGS_tablet_split_size_threshold_bytes = parent_size * 3 / 4;
+  FLAGS_enable_automatic_tablet_splitting = true;
+
+  ASSERT_OK(WaitFor([&] {
+    table_info->GetAllTablets(&tablets);
+    return tablets.size() == 2 && parent->LockForRead()->data().is_deleted();
+  }, 60s, "Tablet split"));
+
+  // Let the tablet servers report the load of the new tablets a few times.
+  std::this_thread::sleep_for(15s);
+
+  table_info->GetAllTablets(&tablets);
+  ASSERT_EQ(2, tablets.size());
+  for (const auto& tablet : tablets) {
+    const auto own_size = max_replica_size(tablet->tablet_id(), /* own = */ true);
+    LOG(INFO) << "Tablet " << tablet->tablet_id() << " size: " << own_size << ", total: "
+              << max_replica_size(tablet->tablet_id(), /* own = */ false);
+    ASSERT_LT(own_size, static_cast<uint64_t>(FLAGS_tablet_split_size_threshold_bytes));
+  }
+  VerifyTable(0, kTotalKeys, &table);
+}
+
 // There was bug with MvccManager when clocks were skewed.
 // Client tries to read from follower and max safe time is requested w/o any limits,
 // so new operations could be added with HT lower than returned.
@@ -24,6 +24,12 @@
 #include "yb/client/transaction_rpc.h"
 #include "yb/client/transaction_manager.h"
 
+#include "yb/consensus/log.h"
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/value_type.h"
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/write_batch.h"
+#include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/yql/cql/ql/util/errcodes.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
 
@@ -211,7 +217,7 @@ class QLTransactionTest : public QLDmlTestBase {
                     Slice(),
                     static_cast<int64_t>(ql::QLStatusToErrorCode(op->response().status())));
     }
-    auto rowblock = yb::ql::RowsResult(op.get()).GetRowBlock();
+    auto rowblock = VERIFY_RESULT(yb::ql::RowsResult(op.get()).GetRowBlock());
     if (rowblock->row_count() == 0) {
       return STATUS_FORMAT(NotFound, "Row not found for key $0", key);
     }
@@ -254,7 +260,7 @@ class QLTransactionTest : public QLDmlTestBase {
       SCOPED_TRACE(Format("Row: $0, key: $1", r, KeyForTransactionAndIndex(transaction, r)));
       auto& op = ops[r];
       ASSERT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
-      auto rowblock = yb::ql::RowsResult(op.get()).GetRowBlock();
+      auto rowblock = ASSERT_RESULT(yb::ql::RowsResult(op.get()).GetRowBlock());
       ASSERT_EQ(rowblock->row_count(), 1);
       ASSERT_EQ(rowblock->row(0).column(0).int32_value(),
                 ValueForTransactionAndIndex(transaction, r, op_type));
@@ -551,6 +557,165 @@ TEST_F(QLTransactionTest, Cleanup) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+// Intents are written to the intents DB, so the regular DB contains only applied values.
+TEST_F(QLTransactionTest, IntentsDB) {
+  WriteData();
+  VerifyData();
+
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  ASSERT_OK(cluster_->FlushTablets());
+
+  size_t tablets_with_intents_db = 0;
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      if (!peer->tablet()->TEST_intents_db()) {
+        continue;
+      }
+      ++tablets_with_intents_db;
+      std::unique_ptr<rocksdb::Iterator> iter(
+          peer->tablet()->TEST_db()->NewIterator(rocksdb::ReadOptions()));
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ASSERT_NE(static_cast<char>(docdb::ValueType::kIntentPrefix), iter->key()[0])
+            << "Intent in regular DB: " << iter->key().ToDebugHexString();
+      }
+    }
+  }
+  ASSERT_GT(tablets_with_intents_db, 0);
+
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyData();
+}
+
+// Flushes only the intents DB after transactions were applied. Deletions of applied intents can be
+// flushed only after the regular DB flushes the applied values, so the intents flush makes the
+// regular DB flush, and is completed after it. Bootstrap then replays the log from the op id
+// flushed to both DBs and does not lose the applied values.
+TEST_F(QLTransactionTest, IntentsDbFlushAndRestart) {
+  WriteData();
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+
+  std::vector<tablet::TabletPeerPtr> peers;
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> ts_peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&ts_peers);
+    for (const auto& peer : ts_peers) {
+      if (peer->tablet()->TEST_intents_db()) {
+        peers.push_back(peer);
+      }
+    }
+  }
+  ASSERT_FALSE(peers.empty());
+
+  rocksdb::FlushOptions flush_options;
+  flush_options.wait = false;
+  for (const auto& peer : peers) {
+    ASSERT_OK(peer->tablet()->TEST_intents_db()->Flush(flush_options));
+  }
+
+  auto has_unflushed_data = [](rocksdb::DB* db) {
+    uint64_t active_entries = 0;
+    uint64_t immutable_entries = 0;
+    db->GetIntProperty(rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries);
+    db->GetIntProperty(rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries);
+    return active_entries != 0 || immutable_entries != 0;
+  };
+  ASSERT_OK(WaitFor([&peers, &has_unflushed_data] {
+    for (const auto& peer : peers) {
+      if (has_unflushed_data(peer->tablet()->TEST_intents_db()) ||
+          has_unflushed_data(peer->tablet()->TEST_db())) {
+        return false;
+      }
+    }
+    return true;
+  }, MonoDelta::FromSeconds(30), "Intents flushed after regular records"));
+  peers.clear();
+
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyData();
+}
+
+// Tablets used to keep intents in the regular DB. They are moved to the intents DB when such a
+// tablet is opened.
+TEST_F(QLTransactionTest, IntentsMovedFromRegularDb) {
+  auto txn = CreateTransaction();
+  WriteRows(CreateSession(txn));
+
+  const char intent_prefix = static_cast<char>(docdb::ValueType::kIntentPrefix);
+  auto for_each_intent = [intent_prefix](
+      rocksdb::DB* db, const std::function<void(rocksdb::Iterator*)>& callback) {
+    std::unique_ptr<rocksdb::Iterator> iter(db->NewIterator(rocksdb::ReadOptions()));
+    for (iter->Seek(rocksdb::Slice(&intent_prefix, 1));
+         iter->Valid() && iter->key()[0] == intent_prefix; iter->Next()) {
+      callback(iter.get());
+    }
+  };
+  auto count_intents = [&for_each_intent](rocksdb::DB* db) {
+    size_t num_intents = 0;
+    for_each_intent(db, [&num_intents](rocksdb::Iterator*) { ++num_intents; });
+    return num_intents;
+  };
+
+  // Put the intents of the pending transaction into the regular DBs, where old tablets kept them.
+  std::unordered_map<std::string, size_t> num_intents;
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      auto* regular_db = peer->tablet()->TEST_db();
+      auto* intents_db = peer->tablet()->TEST_intents_db();
+      if (!intents_db) {
+        continue;
+      }
+      docdb::ConsensusFrontiers frontiers;
+      set_op_id(peer->log()->GetLatestEntryOpId(), &frontiers);
+      set_hybrid_time(HybridTime::kMin, &frontiers);
+      rocksdb::WriteBatch regular_batch;
+      rocksdb::WriteBatch intents_batch;
+      for_each_intent(intents_db, [&regular_batch, &intents_batch](rocksdb::Iterator* iter) {
+        regular_batch.Put(iter->key(), iter->value());
+        intents_batch.Delete(iter->key());
+      });
+      if (regular_batch.Count() == 0) {
+        continue;
+      }
+      num_intents[peer->tablet_id() + peer->permanent_uuid()] = regular_batch.Count();
+      rocksdb::WriteOptions write_options;
+      InitRocksDBWriteOptions(&write_options);
+      regular_batch.SetFrontiers(&frontiers);
+      intents_batch.SetFrontiers(&frontiers);
+      ASSERT_OK(regular_db->Write(write_options, &regular_batch));
+      ASSERT_OK(intents_db->Write(write_options, &intents_batch));
+      rocksdb::FlushOptions flush_options;
+      flush_options.wait = true;
+      ASSERT_OK(regular_db->Flush(flush_options));
+      ASSERT_OK(intents_db->Flush(flush_options));
+      ASSERT_EQ(0, count_intents(intents_db));
+    }
+  }
+  ASSERT_FALSE(num_intents.empty());
+
+  ASSERT_OK(cluster_->RestartSync());
+
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      auto it = num_intents.find(peer->tablet_id() + peer->permanent_uuid());
+      if (it == num_intents.end()) {
+        continue;
+      }
+      ASSERT_EQ(0, count_intents(peer->tablet()->TEST_db()));
+      ASSERT_EQ(it->second, count_intents(peer->tablet()->TEST_intents_db()));
+      num_intents.erase(it);
+    }
+  }
+  ASSERT_TRUE(num_intents.empty());
+}
+
 TEST_F(QLTransactionTest, Heartbeat) {
   auto txn = CreateTransaction();
   auto session = CreateSession(txn);
@@ -899,7 +1064,7 @@ TEST_F(QLTransactionTest, CorrectStatusRequestBatching) {
           YBqlReadOpPtr op = ReadRow(session, key);
           ASSERT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK)
                         << op->response().ShortDebugString();
-          auto rowblock = yb::ql::RowsResult(op.get()).GetRowBlock();
+          auto rowblock = ASSERT_RESULT(yb::ql::RowsResult(op.get()).GetRowBlock());
           int32_t current_value;
           if (rowblock->row_count() == 0) {
             current_value = 0;
@@ -1136,7 +1301,7 @@ TEST_F(QLTransactionTest, WaitRead) {
       for (auto& op : reads[j]) {
         ASSERT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK)
             << op->response().ShortDebugString();
-        auto rowblock = yb::ql::RowsResult(op.get()).GetRowBlock();
+        auto rowblock = ASSERT_RESULT(yb::ql::RowsResult(op.get()).GetRowBlock());
         if (rowblock->row_count() == 1) {
           values[j].push_back(rowblock->row(0).column(0).int32_value());
         } else {
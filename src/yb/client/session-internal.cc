@@ -40,6 +40,8 @@
 #include "yb/client/error_collector.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/util/atomic.h"
+
 MAKE_ENUM_LIMITS(yb::client::YBSession::FlushMode,
                  yb::client::YBSession::AUTO_FLUSH_SYNC,
                  yb::client::YBSession::MANUAL_FLUSH);
@@ -131,6 +133,17 @@ void YBSessionData::set_allow_local_calls_in_curr_thread(bool flag) {
   allow_local_calls_in_curr_thread_ = flag;
 }
 
+HybridTime YBSessionData::write_hybrid_time() const {
+  auto value = write_hybrid_time_.load(std::memory_order_acquire);
+  return value ? HybridTime(value) : HybridTime::kInvalid;
+}
+
+void YBSessionData::UpdateWriteHybridTime(HybridTime hybrid_time) {
+  if (hybrid_time.is_valid()) {
+    UpdateAtomicMax(&write_hybrid_time_, hybrid_time.ToUint64());
+  }
+}
+
 Status YBSessionData::Apply(std::shared_ptr<YBOperation> yb_op) {
   if (!batcher_) {
     batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
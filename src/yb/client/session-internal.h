@@ -32,6 +32,7 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <atomic>
 #include <unordered_set>
 
 #include "yb/client/async_rpc.h"
@@ -98,6 +99,10 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   void set_allow_local_calls_in_curr_thread(bool flag);
   bool allow_local_calls_in_curr_thread() const;
 
+  // See YBSession::write_hybrid_time.
+  HybridTime write_hybrid_time() const;
+  void UpdateWriteHybridTime(HybridTime hybrid_time);
+
  private:
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
@@ -130,6 +135,9 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   MonoDelta timeout_;
 
   internal::AsyncRpcMetricsPtr async_rpc_metrics_;
+
+  // Hybrid time of the latest write done by this session, 0 if there were no writes.
+  std::atomic<uint64_t> write_hybrid_time_{0};
 };
 
 }  // namespace client
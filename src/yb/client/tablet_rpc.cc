@@ -208,6 +208,26 @@ bool TabletInvoker::Done(Status* status) {
     *status = resp_error_status;
   }
 
+  // The tablet was split, so the command should be sent to one of the new tablets. It is up to the
+  // caller, since only it knows how to find the new tablet.
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::TABLET_SPLIT) {
+    if (tablet_ != nullptr) {
+      tablet_->MarkStale();
+    }
+    return true;
+  }
+
+  // The replica lags behind the leader more than the read allows, so read from the leader. The
+  // leader can serve the read, so there is no reason to back off.
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::STALE_FOLLOWER) {
+    VLOG(1) << "Tablet " << tablet_id_ << ": replica " << yb::ToString(current_ts_)
+            << " is too stale, retrying on the leader: " << *status;
+    consistent_prefix_ = false;
+    auto retry_status = retrier_->RetryWithoutDelay(command_, *status);
+    LOG_IF(DFATAL, !retry_status.ok()) << "Retry failed: " << retry_status;
+    return false;
+  }
+
   // Oops, we failed over to a replica that wasn't a LEADER. Unlikely as
   // we're using consensus configuration information from the master, but still possible
   // (e.g. leader restarted and became a FOLLOWER). Try again.
@@ -71,6 +71,10 @@ class TabletInvoker {
   YBClient& client() const { return *client_; }
   const RemoteTabletServer& current_ts() { return *current_ts_; }
 
+  // Whether the command could be sent to any replica. Reset when the replica refused to serve it
+  // because of its staleness, so that it is retried on the leader.
+  bool consistent_prefix() const { return consistent_prefix_; }
+
  private:
   void SelectTabletServer();
 
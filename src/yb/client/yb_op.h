@@ -41,6 +41,9 @@
 
 #include "yb/client/meta_cache.h"
 
+#include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
+
 namespace yb {
 
 class RedisWriteRequestPB;
@@ -208,9 +211,11 @@ class YBqlOp : public YBOperation {
 
   QLResponsePB* mutable_response() { return ql_response_.get(); }
 
-  std::string&& rows_data() { return std::move(rows_data_); }
+  // Rows returned by the tablet server, serialized as a QLRowBlock. Refers to the RPC response
+  // data, so that it could be passed further without copying.
+  const RefCntSlice& rows_data() const { return rows_data_; }
 
-  std::string* mutable_rows_data() { return &rows_data_; }
+  void set_rows_data(RefCntSlice rows_data) { rows_data_ = std::move(rows_data); }
 
   // Set the hash key in the partial row of this QL operation.
   virtual void SetHashCode(uint16_t hash_code) override = 0;
@@ -220,7 +225,7 @@ class YBqlOp : public YBOperation {
  protected:
   explicit YBqlOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLResponsePB> ql_response_;
-  std::string rows_data_;
+  RefCntSlice rows_data_;
 };
 
 class YBqlWriteOp : public YBqlOp {
@@ -298,6 +303,13 @@ class YBqlReadOp : public YBqlOp {
     yb_consistency_level_ = yb_consistency_level;
   }
 
+  // Maximum staleness of the data returned by a CONSISTENT_PREFIX read. If the closest replica
+  // lags behind the leader by more than that, the read is served by the leader. Uninitialized
+  // value means that staleness is not bounded.
+  const MonoDelta& max_staleness() const { return max_staleness_; }
+
+  void set_max_staleness(const MonoDelta& max_staleness) { max_staleness_ = max_staleness; }
+
   std::vector<ColumnSchema> MakeColumnSchemasFromRequest() const;
   Result<QLRowBlock> MakeRowBlock() const;
 
@@ -312,6 +324,7 @@ class YBqlReadOp : public YBqlOp {
   explicit YBqlReadOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
+  MonoDelta max_staleness_;
   ReadHybridTime read_time_;
 };
 
@@ -131,32 +131,26 @@ Status QLRowBlock::Deserialize(const QLClient client, Slice* data) {
   return Status::OK();
 }
 
-Status QLRowBlock::GetRowCount(const QLClient client, const std::string& data, size_t* count) {
+Status QLRowBlock::DeserializeRows(const QLClient client, Slice data) {
   CHECK_EQ(client, YQL_CLIENT_CQL);
-  int32_t cnt = 0;
-  Slice slice(data);
-  RETURN_NOT_OK(CQLDecodeNum(sizeof(cnt), NetworkByteOrder::Load32, &slice, &cnt));
-  *count = cnt;
+  while (!data.empty()) {
+    RETURN_NOT_OK(Extend().Deserialize(client, &data));
+  }
   return Status::OK();
 }
 
-Status QLRowBlock::AppendRowsData(
-    const QLClient client, const std::string& src, std::string* dst) {
+Status QLRowBlock::GetRowCount(
+    const QLClient client, const Slice& data, size_t* count, Slice* rows) {
   CHECK_EQ(client, YQL_CLIENT_CQL);
-  int32_t src_cnt = 0;
-  Slice src_slice(src);
-  RETURN_NOT_OK(CQLDecodeNum(sizeof(src_cnt), NetworkByteOrder::Load32, &src_slice, &src_cnt));
-  if (src_cnt > 0) {
-    int32_t dst_cnt = 0;
-    Slice dst_slice(*dst);
-    RETURN_NOT_OK(CQLDecodeNum(sizeof(dst_cnt), NetworkByteOrder::Load32, &dst_slice, &dst_cnt));
-    if (dst_cnt == 0) {
-      *dst = src;
-    } else {
-      dst->append(util::to_char_ptr(src_slice.data()), src_slice.size());
-      dst_cnt += src_cnt;
-      CQLEncodeLength(dst_cnt, &(*dst)[0]);
-    }
+  int32_t cnt = 0;
+  Slice slice(data);
+  RETURN_NOT_OK(CQLDecodeNum(sizeof(cnt), NetworkByteOrder::Load32, &slice, &cnt));
+  if (cnt < 0) {
+    return STATUS_FORMAT(Corruption, "Negative row count: $0", cnt);
+  }
+  *count = cnt;
+  if (rows != nullptr) {
+    *rows = slice;
   }
   return Status::OK();
 }
@@ -112,12 +112,14 @@ class QLRowBlock {
   void Serialize(QLClient client, faststring* buffer) const;
   CHECKED_STATUS Deserialize(QLClient client, Slice* data);
 
+  // Deserialize rows that are not preceded by the row count and append them to the row block.
+  CHECKED_STATUS DeserializeRows(QLClient client, Slice data);
+
   //-------------------------- utility functions for rows data ------------------------------
   // Return row count.
-  static CHECKED_STATUS GetRowCount(QLClient client, const std::string& data, size_t* count);
-
-  // Append rows data. Caller should ensure the column schemas are the same.
-  static CHECKED_STATUS AppendRowsData(QLClient client, const std::string& src, std::string* dst);
+  // If rows is not null, it is set to the serialized rows that follow the row count.
+  static CHECKED_STATUS GetRowCount(QLClient client, const Slice& data, size_t* count,
+                                    Slice* rows = nullptr);
 
  private:
   // Schema of the selected columns. (Note: this schema has no key column definitions)
@@ -111,14 +111,20 @@ class TransactionStatusManager {
 
 struct TransactionOperationContext {
   TransactionOperationContext(
-      const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_)
+      const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_,
+      rocksdb::DB* intents_db_ = nullptr)
       : transaction_id(transaction_id_),
-        txn_status_manager(*(DCHECK_NOTNULL(txn_status_manager_))) {}
+        txn_status_manager(*(DCHECK_NOTNULL(txn_status_manager_))),
+        intents_db(intents_db_) {}
 
   bool transactional() const;
 
   TransactionId transaction_id;
   TransactionStatusManager& txn_status_manager;
+
+  // DB that stores intents, when they are kept apart from regular records. Null means that intents
+  // are stored in the same DB as regular records.
+  rocksdb::DB* intents_db;
 };
 
 typedef boost::optional<TransactionOperationContext> TransactionOperationContextOpt;
@@ -420,7 +420,8 @@ YB_DEFINE_ENUM(StateChangeReason,
     (NEW_LEADER_ELECTED)
     (FOLLOWER_NO_OP_COMPLETE)
     (LEADER_CONFIG_CHANGE_COMPLETE)
-    (FOLLOWER_CONFIG_CHANGE_COMPLETE));
+    (FOLLOWER_CONFIG_CHANGE_COMPLETE)
+    (TABLET_SPLIT));
 
 // Context provided for callback on master/tablet-server peer state change for post processing
 // e.g., update in-memory contents.
@@ -472,6 +473,8 @@ struct StateChangeContext {
       case StateChangeReason::FOLLOWER_CONFIG_CHANGE_COMPLETE:
         return strings::Substitute("Config change $0 complete on follower",
           change_record.ShortDebugString());
+      case StateChangeReason::TABLET_SPLIT:
+        return "Tablet split";
       case StateChangeReason::INVALID_REASON: FALLTHROUGH_INTENDED;
       default:
         return "INVALID REASON";
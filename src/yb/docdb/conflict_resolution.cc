@@ -13,7 +13,7 @@
 
 #include "yb/docdb/conflict_resolution.h"
 
-#include <boost/scope_exit.hpp>
+#include <map>
 
 #include "yb/common/hybrid_time.h"
 #include "yb/common/transaction.h"
@@ -25,6 +25,7 @@
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/trace.h"
 
 using namespace std::placeholders;
 
@@ -82,9 +83,11 @@ class ConflictResolverContext {
 class ConflictResolver {
  public:
   ConflictResolver(rocksdb::DB* db,
+                   rocksdb::DB* intents_db,
                    TransactionStatusManager* status_manager,
                    ConflictResolverContext* context)
-    : db_(db), status_manager_(*status_manager), context_(*context) {}
+    : db_(db), intents_db_(intents_db ? intents_db : db), status_manager_(*status_manager),
+      context_(*context) {}
 
   TransactionStatusManager& status_manager() {
     return status_manager_;
@@ -100,24 +103,60 @@ class ConflictResolver {
 
   CHECKED_STATUS Resolve() {
     RETURN_NOT_OK(context_.ReadConflicts(this));
+    RETURN_NOT_OK(ReadIntentConflicts());
     return ResolveConflicts();
   }
 
-  // Reads conflicts for specified intent from DB.
-  CHECKED_STATUS ReadIntentConflicts(IntentType type, KeyBytes* intent_key_prefix) {
+  // Requests check of intents stored for specified intent key prefix against intent of specified
+  // type. Conflicts are read later by a single pass over all requested prefixes.
+  void RequestIntentConflicts(IntentType type, const Slice& intent_key_prefix) {
+    std::string key;
+    key.reserve(intent_key_prefix.size() + 1);
+    key.append(intent_key_prefix.cdata(), intent_key_prefix.size());
+    key.push_back(static_cast<char>(ValueType::kIntentType));
+    intent_requests_[key] |= kIntentConflicts[static_cast<size_t>(type)];
+  }
+
+ private:
+  // Reads conflicts for all requested intent key prefixes from DB.
+  // Prefixes are visited in sorted order, so the intent iterator only moves forward and does not
+  // seek when it is already positioned close enough to the next prefix.
+  CHECKED_STATUS ReadIntentConflicts() {
+    if (intent_requests_.empty()) {
+      return Status::OK();
+    }
+
     EnsureIntentIteratorCreated();
 
-    const auto& conflicting_intent_types = kIntentConflicts[static_cast<size_t>(type)];
+    bool positioned = false;
+    for (const auto& request : intent_requests_) {
+      Slice intent_key_prefix(request.first);
+      if (!positioned) {
+        ROCKSDB_SEEK(intent_iter_.get(), intent_key_prefix);
+        positioned = true;
+      } else if (!intent_iter_->Valid()) {
+        // All remaining prefixes are after the last intent.
+        break;
+      } else if (intent_iter_->key().compare(intent_key_prefix) < 0) {
+        ROCKSDB_SEEK(intent_iter_.get(), intent_key_prefix);
+      }
+      RETURN_NOT_OK(ReadConflictsWithPrefix(intent_key_prefix, request.second));
+    }
+    RETURN_NOT_OK(intent_iter_->status());
 
-    intent_key_prefix->AppendValueType(ValueType::kIntentType);
-    BOOST_SCOPE_EXIT(intent_key_prefix) {
-      intent_key_prefix->RemoveValueTypeSuffix(ValueType::kIntentType);
-    } BOOST_SCOPE_EXIT_END;
-    intent_iter_->Seek(intent_key_prefix->data());
+    TRACE("Read conflicts for $0 intent prefixes: $1 conflicting transactions",
+          intent_requests_.size(), conflicts_.size());
+    return Status::OK();
+  }
+
+  // Reads intents starting from the current position of the intent iterator while they start with
+  // the specified prefix.
+  CHECKED_STATUS ReadConflictsWithPrefix(const Slice& intent_key_prefix,
+                                         const LockState& conflicting_intent_types) {
     while (intent_iter_->Valid()) {
       auto existing_key = intent_iter_->key();
       auto existing_value = intent_iter_->value();
-      if (!existing_key.starts_with(intent_key_prefix->data())) {
+      if (!existing_key.starts_with(intent_key_prefix)) {
         break;
       }
       if (existing_value.empty() ||
@@ -145,7 +184,6 @@ class ConflictResolver {
     return Status::OK();
   }
 
- private:
   CHECKED_STATUS ResolveConflicts() {
     if (!conflicts_.empty()) {
       transactions_.reserve(conflicts_.size());
@@ -162,7 +200,7 @@ class ConflictResolver {
   void EnsureIntentIteratorCreated() {
     if (!intent_iter_) {
       intent_iter_ = CreateRocksDBIterator(
-          db_,
+          intents_db_,
           BloomFilterMode::DONT_USE_BLOOM_FILTER,
           boost::none /* user_key_for_filter */,
           rocksdb::kDefaultQueryId);
@@ -279,9 +317,12 @@ class ConflictResolver {
   }
 
   rocksdb::DB* db_;
+  rocksdb::DB* intents_db_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   TransactionStatusManager& status_manager_;
   ConflictResolverContext& context_;
+  // Intent key prefixes to check, mapped to the intent types they conflict with.
+  std::map<std::string, LockState> intent_requests_;
   TransactionIdSet conflicts_;
   std::vector<TransactionData> transactions_;
 };
@@ -354,7 +395,8 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
       }
     }
 
-    return resolver->ReadIntentConflicts(intent_type, intent_key_prefix);
+    resolver->RequestIntentConflicts(intent_type, intent_key_prefix->AsSlice());
+    return Status::OK();
   }
 
   CHECKED_STATUS CheckPriority(ConflictResolver* resolver,
@@ -406,35 +448,24 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
 
 class OperationConflictResolverContext : public ConflictResolverContext {
  public:
-  OperationConflictResolverContext(const DocOperations* doc_ops,
+  OperationConflictResolverContext(const KeyToIntentTypeMap* keys_locked,
                                    HybridTime hybrid_time)
-      : doc_ops_(*doc_ops), hybrid_time_(hybrid_time) {
+      : keys_locked_(*keys_locked), hybrid_time_(hybrid_time) {
   }
 
   virtual ~OperationConflictResolverContext() {}
 
   // Reads stored intents, that could conflict with our operations.
+  // Lock keys are already encoded doc paths, so intent key prefixes are built from them directly.
   CHECKED_STATUS ReadConflicts(ConflictResolver* resolver) override {
-    std::list<DocPath> doc_paths;
     KeyBytes current_intent_prefix;
 
-    for (const auto& doc_op : doc_ops_) {
-      doc_paths.clear();
-      IsolationLevel isolation;
-      doc_op->GetDocPathsToLock(&doc_paths, &isolation);
-
-      const IntentTypePair intent_types = GetWriteIntentsForIsolationLevel(isolation);
-
-      for (const auto& doc_path : doc_paths) {
-        current_intent_prefix.Clear();
-        current_intent_prefix.AppendValueType(ValueType::kIntentPrefix);
-        current_intent_prefix.AppendRawBytes(doc_path.encoded_doc_key().data());
-        for (int i = 0; i < doc_path.num_subkeys(); i++) {
-          RETURN_NOT_OK(resolver->ReadIntentConflicts(intent_types.weak, &current_intent_prefix));
-          doc_path.subkey(i).AppendToKey(&current_intent_prefix);
-        }
-        RETURN_NOT_OK(resolver->ReadIntentConflicts(intent_types.strong, &current_intent_prefix));
-      }
+    for (const auto& key_and_intent_type : keys_locked_) {
+      current_intent_prefix.Clear();
+      current_intent_prefix.AppendValueType(ValueType::kIntentPrefix);
+      current_intent_prefix.AppendRawBytes(key_and_intent_type.first);
+      resolver->RequestIntentConflicts(key_and_intent_type.second,
+                                       current_intent_prefix.AsSlice());
     }
 
     return Status::OK();
@@ -455,7 +486,7 @@ class OperationConflictResolverContext : public ConflictResolverContext {
   }
 
  private:
-  const DocOperations& doc_ops_;
+  const KeyToIntentTypeMap& keys_locked_;
   HybridTime hybrid_time_;
 };
 
@@ -464,19 +495,21 @@ class OperationConflictResolverContext : public ConflictResolverContext {
 Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                    HybridTime hybrid_time,
                                    rocksdb::DB* db,
+                                   rocksdb::DB* intents_db,
                                    TransactionStatusManager* status_manager) {
   DCHECK(hybrid_time.is_valid());
   TransactionConflictResolverContext context(write_batch, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
+  ConflictResolver resolver(db, intents_db, status_manager, &context);
   return resolver.Resolve();
 }
 
-Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
+Result<HybridTime> ResolveOperationConflicts(const LockBatch& keys_locked,
                                              HybridTime hybrid_time,
                                              rocksdb::DB* db,
+                                             rocksdb::DB* intents_db,
                                              TransactionStatusManager* status_manager) {
-  OperationConflictResolverContext context(&doc_ops, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
+  OperationConflictResolverContext context(&keys_locked.key_to_intent_type(), hybrid_time);
+  ConflictResolver resolver(db, intents_db, status_manager, &context);
   RETURN_NOT_OK(resolver.Resolve());
   return context.GetHybridTime();
 }
@@ -15,6 +15,7 @@
 #define YB_DOCDB_CONFLICT_RESOLUTION_H
 
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/lock_batch.h"
 #include "yb/docdb/value_type.h"
 
 #include "yb/util/result.h"
@@ -44,27 +45,32 @@ class KeyValueWriteBatchPB;
 // write_batch - values that would be written as part of transaction.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
+// intents_db - db that contains intents, null if they are stored in db.
 // status_manager - status manager that should be used during this conflict resolution.
 CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                            HybridTime hybrid_time,
                                            rocksdb::DB* db,
+                                           rocksdb::DB* intents_db,
                                            TransactionStatusManager* status_manager);
 
 // Resolves conflicts for doc operations.
-// Read all intents that could conflict with provided doc_ops.
+// Read all intents that could conflict with locks taken for doc operations.
 // Forms set of conflicting transactions.
 // Tries to abort conflicting transactions.
 // If it conflicts with already committed transaction, then returns maximal commit time of such
 // transaction. So we could update local clock and apply those operations later than conflicting
 // transaction.
 //
-// doc_ops - doc operations that would be applied as part of operation.
+// keys_locked - locks acquired by PrepareDocWriteOperation for doc operations, i.e. encoded doc
+//               paths with intent types that would be applied as part of operation.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
+// intents_db - db that contains intents, null if they are stored in db.
 // status_manager - status manager that should be used during this conflict resolution.
-Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
+Result<HybridTime> ResolveOperationConflicts(const LockBatch& keys_locked,
                                              HybridTime hybrid_time,
                                              rocksdb::DB* db,
+                                             rocksdb::DB* intents_db,
                                              TransactionStatusManager* status_manager);
 
 struct ParsedIntent {
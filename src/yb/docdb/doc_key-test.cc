@@ -18,6 +18,7 @@
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/full_filter_block.h"
 
+#include "yb/common/partition.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -379,5 +380,45 @@ TEST(DocKeyTest, TestWriteId) {
   TestRoundTripDocOrSubDocKeyEncodingDecoding(subdoc_key);
 }
 
+TEST(DocKeyTest, TestHashBounds) {
+  PartitionPB partition_pb;
+  partition_pb.set_partition_key_start(PartitionSchema::EncodeMultiColumnHashValue(0x1000));
+  partition_pb.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(0x2000));
+  Partition partition;
+  Partition::FromPB(partition_pb, &partition);
+  auto bounds = DocKeyHashBounds::FromPartition(partition);
+  ASSERT_EQ("[4096, 8192)", bounds.ToString());
+  ASSERT_FALSE(bounds.IsFull());
+
+  auto encoded_key = [](DocKeyHash hash) {
+    return SubDocKey(DocKey(hash, PrimitiveValues("h"), PrimitiveValues(10)),
+                     HybridTime::FromMicros(1000)).Encode();
+  };
+  ASSERT_FALSE(bounds.ContainsEncodedKey(encoded_key(0x0fff).AsSlice()));
+  ASSERT_TRUE(bounds.ContainsEncodedKey(encoded_key(0x1000).AsSlice()));
+  ASSERT_TRUE(bounds.ContainsEncodedKey(encoded_key(0x1fff).AsSlice()));
+  ASSERT_FALSE(bounds.ContainsEncodedKey(encoded_key(0x2000).AsSlice()));
+  // Keys of range partitioned tables do not have a hash.
+  ASSERT_TRUE(bounds.ContainsEncodedKey(DocKey(PrimitiveValues(10)).Encode().AsSlice()));
+
+  // Share of the keys of an SST file that belongs to the tablet.
+  auto share = [&bounds, &encoded_key](DocKeyHash smallest, DocKeyHash largest) {
+    return bounds.ShareOfRange(encoded_key(smallest).AsSlice(), encoded_key(largest).AsSlice());
+  };
+  ASSERT_DOUBLE_EQ(1.0, share(0x1000, 0x1fff));
+  ASSERT_DOUBLE_EQ(0.5, share(0x0000, 0x1fff));
+  ASSERT_DOUBLE_EQ(0.25, share(0x0000, 0x3fff));
+  ASSERT_DOUBLE_EQ(0.0, share(0x2000, 0x3fff));
+  ASSERT_DOUBLE_EQ(1.0, bounds.ShareOfRange(
+      DocKey(PrimitiveValues(10)).Encode().AsSlice(), encoded_key(0x3fff).AsSlice()));
+
+  // The last tablet of a table covers the whole rest of the hash range.
+  partition_pb.clear_partition_key_end();
+  Partition::FromPB(partition_pb, &partition);
+  bounds = DocKeyHashBounds::FromPartition(partition);
+  ASSERT_TRUE(bounds.ContainsEncodedKey(encoded_key(0xffff).AsSlice()));
+  ASSERT_TRUE(DocKeyHashBounds().IsFull());
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -13,6 +13,7 @@
 
 #include "yb/docdb/doc_key.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -191,6 +192,16 @@ Result<size_t> DocKey::EncodedSize(Slice slice, DocKeyPart part) {
   return slice.cdata() - initial_begin;
 }
 
+Result<size_t> DocKey::EncodedSizeWithFirstRangeComponent(Slice slice) {
+  auto initial_begin = slice.cdata();
+  RETURN_NOT_OK(DoDecode(&slice, DocKeyPart::HASHED_PART_ONLY, DummyCallback()));
+  if (slice.empty() || slice[0] == static_cast<uint8_t>(ValueType::kGroupEnd)) {
+    return 0;
+  }
+  RETURN_NOT_OK(PrimitiveValue::DecodeKey(&slice, nullptr /* out */));
+  return slice.cdata() - initial_begin;
+}
+
 class DocKey::DecodeFromCallback {
  public:
   explicit DecodeFromCallback(DocKey* key) : key_(key) {
@@ -340,6 +351,47 @@ DocKey DocKey::FromRedisKey(uint16_t hash, const string &key) {
   return new_doc_key;
 }
 
+DocKeyHashBounds DocKeyHashBounds::FromPartition(const Partition& partition) {
+  DocKeyHashBounds result;
+  if (!partition.partition_key_start().empty()) {
+    result.lower = PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+  }
+  if (!partition.partition_key_end().empty()) {
+    result.upper = PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end());
+  }
+  return result;
+}
+
+bool DocKeyHashBounds::ContainsEncodedKey(const Slice& key) const {
+  if (key.size() < sizeof(DocKeyHash) + 1 ||
+      key[0] != static_cast<uint8_t>(ValueType::kUInt16Hash)) {
+    return true;
+  }
+  return Contains(BigEndian::Load16(key.data() + 1));
+}
+
+double DocKeyHashBounds::ShareOfRange(const Slice& smallest_key, const Slice& largest_key) const {
+  auto has_hash = [](const Slice& key) {
+    return key.size() >= sizeof(DocKeyHash) + 1 &&
+           key[0] == static_cast<uint8_t>(ValueType::kUInt16Hash);
+  };
+  if (!has_hash(smallest_key) || !has_hash(largest_key)) {
+    return 1.0;
+  }
+  const uint32_t range_lower = BigEndian::Load16(smallest_key.data() + 1);
+  const uint32_t range_upper = BigEndian::Load16(largest_key.data() + 1) + 1;
+  const uint32_t overlap_lower = std::max(lower, range_lower);
+  const uint32_t overlap_upper = std::min(upper, range_upper);
+  if (overlap_lower >= overlap_upper) {
+    return 0.0;
+  }
+  return static_cast<double>(overlap_upper - overlap_lower) / (range_upper - range_lower);
+}
+
+std::string DocKeyHashBounds::ToString() const {
+  return Format("[$0, $1)", lower, upper);
+}
+
 // ------------------------------------------------------------------------------------------------
 // SubDocKey
 // ------------------------------------------------------------------------------------------------
@@ -663,6 +715,14 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
     CHECK_OK(size);
     return Slice(key.data(), *size);
   }
+
+  // Hashed components and the first range component, so that scans limited to a single value of
+  // the first range component (e.g. a time bucket) could skip files without it.
+  Slice ExtendedTransform(Slice key) const override {
+    auto size = DocKey::EncodedSizeWithFirstRangeComponent(key);
+    CHECK_OK(size);
+    return Slice(key.data(), *size);
+  }
 };
 
 } // namespace
@@ -28,6 +28,9 @@
 #include "yb/docdb/primitive_value.h"
 
 namespace yb {
+
+class Partition;
+
 namespace docdb {
 
 using DocKeyHash = uint16_t;
@@ -117,6 +120,10 @@ class DocKey {
 
   static Result<size_t> EncodedSize(Slice slice, DocKeyPart part);
 
+  // Returns the size of the prefix of the encoded document key that ends with its first range
+  // component, or 0 if the key has no range components.
+  static Result<size_t> EncodedSizeWithFirstRangeComponent(Slice slice);
+
   // Decode the current document key from the given slice, but expect all bytes to be consumed, and
   // return an error status if that is not the case.
   CHECKED_STATUS FullyDecodeFrom(const rocksdb::Slice& slice);
@@ -186,6 +193,35 @@ inline std::ostream& operator <<(std::ostream& out, const DocKey& doc_key) {
   return out;
 }
 
+// Half-open range [lower, upper) of the hash codes of the documents that belong to a tablet.
+// The RocksDB of a tablet created by a split is a checkpoint of the whole split tablet, so it also
+// contains the documents of its sibling, until they are removed by a compaction.
+struct DocKeyHashBounds {
+  static constexpr uint32_t kMaxUpper = 0x10000;
+
+  uint32_t lower = 0;
+  uint32_t upper = kMaxUpper;
+
+  // Returns the bounds of a tablet of a hash partitioned table with the given partition.
+  static DocKeyHashBounds FromPartition(const Partition& partition);
+
+  bool IsFull() const { return lower == 0 && upper == kMaxUpper; }
+
+  bool Contains(DocKeyHash hash) const { return lower <= hash && hash < upper; }
+
+  // Returns true if the document of the given encoded key is within the bounds. Keys without a
+  // hash component are considered to be within the bounds.
+  bool ContainsEncodedKey(const Slice& key) const;
+
+  // Returns the share of the documents between the given encoded keys that is within the bounds,
+  // assuming that the documents are spread evenly over their hashes. Used to estimate how much of
+  // an SST file inherited from the split parent belongs to this tablet. Keys without a hash are
+  // considered to be within the bounds.
+  double ShareOfRange(const Slice& smallest_key, const Slice& largest_key) const;
+
+  std::string ToString() const;
+};
+
 // ------------------------------------------------------------------------------------------------
 // SubDocKey
 // ------------------------------------------------------------------------------------------------
@@ -496,7 +532,9 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account hashed components of keys for filtering. The
+// hashed components together with the first range component are added to the filter as extended
+// keys (see rocksdb::FilterPolicy::KeyTransformer::ExtendedTransform).
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
   explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
@@ -1867,9 +1867,8 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
           RETURN_NOT_OK(maybe_column);
           const ColumnSchema& column = *maybe_column;
 
-          DocPath sub_path(column.is_static() ? hashed_doc_path_->encoded_doc_key()
-                                              : pk_doc_path_->encoded_doc_key(),
-                           PrimitiveValue(column_id));
+          const KeyBytes& encoded_doc_key = column.is_static()
+              ? hashed_doc_path_->encoded_doc_key() : pk_doc_path_->encoded_doc_key();
 
           QLValue expr_result;
           RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
@@ -1877,6 +1876,18 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
           const SubDocument& sub_doc =
               SubDocument::FromQLValuePB(expr_result.value(), column.sorting_type(), write_instr);
 
+          // Most common case, setting a column to a primitive value. The column id is appended to
+          // the encoded row key without building a DocPath for the column.
+          if (column_value.subscript_args().empty() && write_instr == TSOpcode::kScalarInsert &&
+              sub_doc.IsTombstoneOrPrimitive()) {
+            RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+                encoded_doc_key, PrimitiveValue(column_id), Value(sub_doc, ttl, user_timestamp),
+                request_.query_id()));
+            continue;
+          }
+
+          DocPath sub_path(encoded_doc_key, PrimitiveValue(column_id));
+
           // Typical case, setting a columns value
           if (column_value.subscript_args().empty()) {
             switch (write_instr) {
@@ -1980,12 +1991,12 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
             const ColumnId column_id(column_value.column_id());
             const auto column = schema_.column_by_id(column_id);
             RETURN_NOT_OK(column);
-            const DocPath sub_path(
+            RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
                 column->is_static() ? hashed_doc_path_->encoded_doc_key()
                                     : pk_doc_path_->encoded_doc_key(),
-                PrimitiveValue(column_id));
-            RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(sub_path,
-                                                             request_.query_id(), user_timestamp));
+                PrimitiveValue(column_id),
+                Value(PrimitiveValue::kTombstone, Value::kMaxTtl, user_timestamp),
+                request_.query_id()));
           }
         } else if (IsRangeOperation(request_, schema_)) {
           // If the range columns are not specified, we read everything and delete all rows for
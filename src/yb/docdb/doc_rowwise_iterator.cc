@@ -75,6 +75,19 @@ Status DocRowwiseIterator::Init() {
   return Status::OK();
 }
 
+namespace {
+
+bool FirstRangeComponentFixed(const DocKey& lower_doc_key, const DocKey& upper_doc_key) {
+  if (lower_doc_key.range_group().empty() || upper_doc_key.range_group().empty()) {
+    return false;
+  }
+  const PrimitiveValue& value = lower_doc_key.range_group()[0];
+  return value.value_type() != ValueType::kLowest && value.value_type() != ValueType::kHighest &&
+         value == upper_doc_key.range_group()[0];
+}
+
+} // namespace
+
 Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const DocQLScanSpec& doc_spec = dynamic_cast<const DocQLScanSpec&>(spec);
   is_forward_scan_ = doc_spec.is_forward_scan();
@@ -94,10 +107,23 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
-  const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+
+  // The bloom filter also checks the first range component of the key for filtering, which is
+  // only correct when the scan is limited to a single value of it. Otherwise only the hashed
+  // components are passed.
+  KeyBytes filter_key_encoded;
+  if (is_fixed_point_get) {
+    if (FirstRangeComponentFixed(lower_doc_key, upper_doc_key)) {
+      filter_key_encoded = row_key_encoded;
+    } else {
+      DocKey filter_doc_key = lower_doc_key;
+      filter_doc_key.ClearRangeComponents();
+      filter_key_encoded = filter_doc_key.Encode();
+    }
+  }
 
   db_iter_ = CreateIntentAwareIterator(
-      db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
+      db_, mode, filter_key_encoded.AsSlice(), doc_spec.QueryId(), txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
 
   db_iter_->SeekWithoutHt(row_key_encoded);
@@ -62,13 +62,7 @@ Result<bool> DocWriteBatch::SetPrimitiveInternalHandleUserTimestamp(
   return should_apply;
 }
 
-CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
-    const DocPath& doc_path,
-    const Value& value,
-    InternalDocIterator *doc_iter,
-    const bool is_deletion,
-    const int num_subkeys) {
-
+Result<DocHybridTime> DocWriteBatch::NextWriteHybridTime() const {
   // The write_id is always incremented by one for each new element of the write batch.
   if (put_batch_.size() > numeric_limits<IntraTxnWriteId>::max()) {
     return STATUS_SUBSTITUTE(
@@ -77,16 +71,27 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
         numeric_limits<IntraTxnWriteId>::max());
   }
 
-  if (value.has_user_timestamp() && !optional_init_markers()) {
-    return STATUS(IllegalState,
-                  "User Timestamp is only supported for Optional Init Markers");
-  }
-
   // We need the write_id component of DocHybridTime to disambiguate between writes in the same
   // WriteBatch, as they will have the same HybridTime when committed. E.g. if we insert, delete,
   // and re-insert the same column in one WriteBatch, we need to know the order of these operations.
   const auto write_id = static_cast<IntraTxnWriteId>(put_batch_.size());
-  const DocHybridTime hybrid_time = DocHybridTime(HybridTime::kMax, write_id);
+  return DocHybridTime(HybridTime::kMax, write_id);
+}
+
+CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
+    const DocPath& doc_path,
+    const Value& value,
+    InternalDocIterator *doc_iter,
+    const bool is_deletion,
+    const int num_subkeys) {
+  auto next_hybrid_time = NextWriteHybridTime();
+  RETURN_NOT_OK(next_hybrid_time);
+  const DocHybridTime hybrid_time = *next_hybrid_time;
+
+  if (value.has_user_timestamp() && !optional_init_markers()) {
+    return STATUS(IllegalState,
+                  "User Timestamp is only supported for Optional Init Markers");
+  }
 
   for (int subkey_index = 0; subkey_index < num_subkeys; ++subkey_index) {
     const PrimitiveValue& subkey = doc_path.subkey(subkey_index);
@@ -188,6 +193,37 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
   return Status::OK();
 }
 
+Status DocWriteBatch::SetPrimitiveWithoutReads(const KeyBytes& encoded_doc_key,
+                                               const PrimitiveValue* subkeys,
+                                               size_t num_subkeys,
+                                               const Value& value) {
+  DCHECK(optional_init_markers());
+  DCHECK(!value.has_user_timestamp());
+  auto hybrid_time = NextWriteHybridTime();
+  RETURN_NOT_OK(hybrid_time);
+
+  // Assigning to the buffer does not reallocate it once it is large enough for the keys of the
+  // row, so the only allocation per key/value pair is for the key stored in the batch.
+  key_buffer_.mutable_data()->assign(encoded_doc_key.data());
+  for (size_t i = 0; i != num_subkeys; ++i) {
+    subkeys[i].AppendToKey(&key_buffer_);
+  }
+
+  put_batch_.emplace_back(key_buffer_.data(), value.Encode());
+  cache_.Put(key_buffer_, *hybrid_time, value.primitive_value().value_type());
+  return Status::OK();
+}
+
+Status DocWriteBatch::SetPrimitive(const KeyBytes& encoded_doc_key,
+                                   const PrimitiveValue& subkey,
+                                   const Value& value,
+                                   rocksdb::QueryId query_id) {
+  if (!optional_init_markers() || value.has_user_timestamp()) {
+    return SetPrimitive(DocPath(encoded_doc_key, subkey), value, query_id);
+  }
+  return SetPrimitiveWithoutReads(encoded_doc_key, &subkey, 1, value);
+}
+
 Status DocWriteBatch::SetPrimitive(const DocPath& doc_path,
                                    const Value& value,
                                    rocksdb::QueryId query_id) {
@@ -195,6 +231,11 @@ Status DocWriteBatch::SetPrimitive(const DocPath& doc_path,
                   doc_path.ToString(), value.ToString());
   const KeyBytes& encoded_doc_key = doc_path.encoded_doc_key();
   const int num_subkeys = doc_path.num_subkeys();
+  if (optional_init_markers() && !value.has_user_timestamp()) {
+    // Existing data does not affect the write, so there is no need to create an iterator.
+    return SetPrimitiveWithoutReads(
+        encoded_doc_key, doc_path.subkeys().data(), num_subkeys, value);
+  }
   const bool is_deletion = value.primitive_value().value_type() == ValueType::kTombstone;
   InternalDocIterator doc_iter(
       rocksdb_, &cache_, BloomFilterMode::USE_BLOOM_FILTER, encoded_doc_key,
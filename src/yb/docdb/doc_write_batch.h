@@ -69,6 +69,13 @@ class DocWriteBatch {
     return SetPrimitive(doc_path, Value(value, Value::kMaxTtl, user_timestamp), query_id);
   }
 
+  // Same as SetPrimitive(DocPath(encoded_doc_key, subkey), value), but does not build a DocPath.
+  // Used to set columns of a row, so that the encoded DocKey of the row is not copied for every
+  // column: the subkey is appended to it in a buffer reused by this batch.
+  CHECKED_STATUS SetPrimitive(
+      const KeyBytes& encoded_doc_key, const PrimitiveValue& subkey, const Value& value,
+      rocksdb::QueryId query_id = rocksdb::kDefaultQueryId);
+
   // Extend the SubDocument in the given key. We'll support List with Append and Prepend mode later.
   // TODO(akashnil): 03/20/17 ENG-1107
   // In each SetPrimitive call, some common work is repeated. It may be made more
@@ -147,6 +154,16 @@ class DocWriteBatch {
       bool is_deletion,
       int num_subkeys);
 
+  // Adds the key/value pair for the given path without reading from RocksDB. Could be used only
+  // when init markers are optional and there is no user timestamp, so that the existing data at
+  // the path does not affect the write.
+  CHECKED_STATUS SetPrimitiveWithoutReads(
+      const KeyBytes& encoded_doc_key, const PrimitiveValue* subkeys, size_t num_subkeys,
+      const Value& value);
+
+  // Returns the hybrid time for the next key/value pair added to this batch.
+  Result<DocHybridTime> NextWriteHybridTime() const;
+
   // Handle the user provided timestamp during writes.
   Result<bool> SetPrimitiveInternalHandleUserTimestamp(const Value &value,
                                                        InternalDocIterator* doc_iter);
@@ -167,6 +184,10 @@ class DocWriteBatch {
   std::atomic<int64_t>* monotonic_counter_;
   std::vector<std::pair<std::string, std::string>> put_batch_;
 
+  // Used to build keys of the key/value pairs added without reads, to avoid reallocating for
+  // every pair.
+  KeyBytes key_buffer_;
+
   int num_rocksdb_seeks_;
 };
 
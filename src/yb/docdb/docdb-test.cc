@@ -1497,6 +1497,50 @@ TEST_F(DocDBTest, BloomFilterTest) {
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
 }
 
+TEST_F(DocDBTest, BloomFilterOnFirstRangeComponentTest) {
+  ASSERT_OK(FlushRocksDB());
+
+  // Write rows of the same hashed key to several files, each file with its own value of the first
+  // range component (e.g. a time bucket).
+  constexpr int kNumFiles = 3;
+  constexpr int kRowsPerFile = 10;
+  for (int i = 0; i < kNumFiles; ++i) {
+    auto dwb = MakeDocWriteBatch();
+    for (int j = 0; j < kRowsPerFile; ++j) {
+      DocKey key(0, PrimitiveValues("h"), PrimitiveValues(i, j));
+      ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue("value")));
+    }
+    ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000 + i)));
+    ASSERT_OK(FlushRocksDB());
+  }
+
+  int total_bloom_useful = options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+  int total_table_iterators =
+      options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+
+  auto scan = [this](const DocKey& key) {
+    const KeyBytes encoded_key = key.Encode();
+    auto iter = CreateRocksDBIterator(
+        rocksdb(), BloomFilterMode::USE_BLOOM_FILTER, encoded_key.AsSlice(),
+        rocksdb::kDefaultQueryId);
+    iter->Seek(encoded_key.AsSlice());
+  };
+
+  // A scan within the hashed key has to read all files.
+  scan(DocKey(0, PrimitiveValues("h")));
+  ASSERT_NO_FATALS(CheckBloom(0, &total_bloom_useful, kNumFiles, &total_table_iterators));
+
+  // A scan within a single value of the first range component only reads the file that has it.
+  for (int i = 0; i < kNumFiles; ++i) {
+    scan(DocKey(0, PrimitiveValues("h"), PrimitiveValues(i)));
+    ASSERT_NO_FATALS(CheckBloom(kNumFiles - 1, &total_bloom_useful, 1, &total_table_iterators));
+  }
+
+  // No file has this value of the first range component.
+  scan(DocKey(0, PrimitiveValues("h"), PrimitiveValues(kNumFiles)));
+  ASSERT_NO_FATALS(CheckBloom(kNumFiles, &total_bloom_useful, 0, &total_table_iterators));
+}
+
 TEST_F(DocDBTest, MergingIterator) {
   // Test for the case described in https://yugabyte.atlassian.net/browse/ENG-1677.
 
@@ -1532,6 +1576,43 @@ TEST_F(DocDBTest, SetPrimitiveWithInitMarker) {
   }
 }
 
+// Setting columns through the encoded row key should produce the same key/value pairs as setting
+// them through DocPath. Also reports the per-row cost of both ways.
+TEST_F(DocDBTest, SetPrimitiveByEncodedDocKey) {
+  constexpr int kNumColumns = 50;
+  constexpr int kNumRows = 1000;
+  std::vector<KeyBytes> row_keys;
+  for (int i = 0; i != kNumRows; ++i) {
+    row_keys.push_back(
+        DocKey(i, PrimitiveValues(StringPrintf("key%05d", i)), PrimitiveValues(i)).Encode());
+  }
+  const Value value(PrimitiveValue("value"), Value::kMaxTtl);
+
+  auto by_doc_path = MakeDocWriteBatch(InitMarkerBehavior::kOptional);
+  auto start = MonoTime::Now();
+  for (const auto& row_key : row_keys) {
+    for (int column = 0; column != kNumColumns; ++column) {
+      ASSERT_OK(by_doc_path.SetPrimitive(
+          DocPath(row_key, PrimitiveValue(ColumnId(column))), value));
+    }
+  }
+  auto by_doc_path_time = MonoTime::Now().GetDeltaSince(start);
+
+  auto by_row_key = MakeDocWriteBatch(InitMarkerBehavior::kOptional);
+  start = MonoTime::Now();
+  for (const auto& row_key : row_keys) {
+    for (int column = 0; column != kNumColumns; ++column) {
+      ASSERT_OK(by_row_key.SetPrimitive(row_key, PrimitiveValue(ColumnId(column)), value));
+    }
+  }
+  auto by_row_key_time = MonoTime::Now().GetDeltaSince(start);
+
+  LOG(INFO) << "Per row encode time for " << kNumColumns << " columns, DocPath: "
+            << by_doc_path_time.ToNanoseconds() / kNumRows << "ns, encoded row key: "
+            << by_row_key_time.ToNanoseconds() / kNumRows << "ns";
+  ASSERT_EQ(by_doc_path.key_value_pairs(), by_row_key.key_value_pairs());
+}
+
 TEST_F(DocDBTest, TestInetSortOrder) {
   InsertInet("1.2.3.4");
   InsertInet("2.2.3.4");
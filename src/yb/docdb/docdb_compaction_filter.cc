@@ -39,13 +39,15 @@ namespace docdb {
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_full_compaction,
-                                             MonoDelta table_ttl)
+                                             MonoDelta table_ttl,
+                                             DocKeyHashBounds hash_bounds)
     : history_cutoff_(history_cutoff),
       is_full_compaction_(is_full_compaction),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
-      deleted_cols_(deleted_cols) {
+      deleted_cols_(deleted_cols),
+      hash_bounds_(hash_bounds) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -56,6 +58,12 @@ bool DocDBCompactionFilter::Filter(int level,
                                    const rocksdb::Slice& existing_value,
                                    std::string* new_value,
                                    bool* value_changed) const {
+  // The key belongs to the sibling of a tablet created by a split. All versions of such a key are
+  // outside of the tablet, so it is safe to remove it by a non-full compaction as well.
+  if (!hash_bounds_.IsFull() && !hash_bounds_.ContainsEncodedKey(key)) {
+    return true;
+  }
+
   if (!is_full_compaction_) {
     // By default, we only perform history garbage collection on full compactions
     // (or major compactions, in the HBase terminology).
@@ -214,9 +222,10 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    shared_ptr<HistoryRetentionPolicy> retention_policy)
+    shared_ptr<HistoryRetentionPolicy> retention_policy, DocKeyHashBounds hash_bounds)
     :
-    retention_policy_(retention_policy) {
+    retention_policy_(retention_policy),
+    hash_bounds_(hash_bounds) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -227,12 +236,23 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return unique_ptr<DocDBCompactionFilter>(
       new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction, retention_policy_->GetTableTTL(),
+                                hash_bounds_));
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+Slice DocDBCompactionFilterFactory::SubcompactionBoundary(const Slice& user_key) const {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    VLOG(1) << "Failed to decode subcompaction boundary " << user_key.ToDebugHexString() << ": "
+            << doc_key_size.status();
+    return user_key;
+  }
+  return Slice(user_key.data(), *doc_key_size);
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -32,7 +32,8 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_full_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        DocKeyHashBounds hash_bounds = DocKeyHashBounds());
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -100,6 +101,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
 
   ColumnIdsPtr deleted_cols_;
+
+  // Documents outside of these bounds belong to another tablet and are removed by any compaction.
+  DocKeyHashBounds hash_bounds_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -139,14 +143,20 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+                                        DocKeyHashBounds hash_bounds = DocKeyHashBounds());
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // Truncates the boundary to its DocKey, since the compaction filter tracks overwrites across
+  // the subkeys of a document.
+  Slice SubcompactionBoundary(const Slice& user_key) const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  DocKeyHashBounds hash_bounds_;
 };
 
 }  // namespace docdb
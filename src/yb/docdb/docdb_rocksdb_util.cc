@@ -13,17 +13,20 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "yb/common/transaction.h"
 
 #include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table.h"
+#include "yb/rocksdb/util/compression.h"
 
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
@@ -48,12 +51,43 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
              "The percentage upto which files that are larger are include in a compaction.");
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of key range subcompactions a single compaction is split into. "
+             "Subcompactions run in parallel and write separate output files. 1 disables "
+             "subcompactions.");
+TAG_FLAG(rocksdb_max_subcompactions, advanced);
+DEFINE_uint64(rocksdb_universal_compaction_min_subcompaction_size, 64_MB,
+             "Minimum amount of input data processed by a single subcompaction.");
+TAG_FLAG(rocksdb_universal_compaction_min_subcompaction_size, advanced);
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
              "Use to control write rate of flush and compaction.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_bool(rocksdb_use_direct_io_for_flush_and_compaction, false,
+            "Read compaction inputs and write flush and compaction outputs bypassing the OS page "
+            "cache, so that background I/O does not evict pages used by foreground reads.");
+TAG_FLAG(rocksdb_use_direct_io_for_flush_and_compaction, advanced);
+DEFINE_uint64(db_max_auto_readahead_size_bytes, 256_KB,
+              "Maximal size of the readahead done by iterators that read SST blocks "
+              "sequentially. 0 - disable automatic readahead.");
+TAG_FLAG(db_max_auto_readahead_size_bytes, advanced);
+
+DEFINE_string(rocksdb_compression_type, "snappy",
+              "Compression of SST files written by flushes and by compactions that do not include "
+              "the oldest SST file: none, snappy, zlib, lz4 or zstd.");
+DEFINE_string(rocksdb_bottommost_compression_type, "",
+              "Compression of SST files written by major compactions, i.e. compactions that "
+              "include the oldest SST file. These files hold most of the data and are rarely "
+              "rewritten, so they could be worth compressing better, e.g. with zlib. Empty to use "
+              "rocksdb_compression_type.");
+TAG_FLAG(rocksdb_bottommost_compression_type, advanced);
+DEFINE_int32(rocksdb_compression_dict_bytes, 0,
+             "Maximum size of the compression dictionary built for each SST file written by a "
+             "major compaction, e.g. 16KB. Only zlib, lz4 and zstd use dictionaries. 0 disables "
+             "compression dictionaries.");
+TAG_FLAG(rocksdb_compression_dict_bytes, advanced);
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -70,6 +104,33 @@ DEFINE_int64(db_min_keys_per_index_block, 100,
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
 
+DEFINE_int64(intents_db_write_buffer_size, -1,
+             "Size of RocksDB write buffer (in bytes) of the intents DB. -1 to use the size of the "
+             "regular DB write buffer.");
+TAG_FLAG(intents_db_write_buffer_size, advanced);
+
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, false,
+            "Whether large write batches are inserted into RocksDB memtables by several threads "
+            "concurrently. Disabled by default: a tablet applies its Raft operations one at a "
+            "time, so only the entries of a single batch could be inserted concurrently, while "
+            "the adaptive yield of the writer thread is paid by every write.");
+TAG_FLAG(rocksdb_allow_concurrent_memtable_write, advanced);
+
+DEFINE_int32(rocksdb_memtable_insert_min_entries_per_thread, 256,
+             "Minimum number of write batch entries inserted into a memtable by one thread, when "
+             "the batch is inserted concurrently.");
+TAG_FLAG(rocksdb_memtable_insert_min_entries_per_thread, advanced);
+
+DEFINE_int32(rocksdb_memtable_insert_max_threads, 4,
+             "Maximum number of threads inserting a single write batch into a memtable.");
+TAG_FLAG(rocksdb_memtable_insert_max_threads, advanced);
+
+DEFINE_int32(intents_db_universal_compaction_min_merge_width, 2,
+             "The minimum number of files in a single compaction run of the intents DB. Intents "
+             "are deleted soon after they are written, so merging often lets compactions drop "
+             "them.");
+TAG_FLAG(intents_db_universal_compaction_min_merge_width, advanced);
+
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
@@ -311,6 +372,29 @@ rocksdb::ReadOptions PrepareReadOptions(
   return read_opts;
 }
 
+rocksdb::CompressionType CompressionTypeFromFlag(const char* flag_name, const string& value) {
+  static const std::pair<const char*, rocksdb::CompressionType> kCompressionTypes[] = {
+      {"none", rocksdb::kNoCompression},
+      {"snappy", rocksdb::kSnappyCompression},
+      {"zlib", rocksdb::kZlibCompression},
+      {"lz4", rocksdb::kLZ4Compression},
+      {"zstd", rocksdb::kZSTDNotFinalCompression},
+  };
+  for (const auto& entry : kCompressionTypes) {
+    if (value == entry.first) {
+      if (rocksdb::CompressionTypeSupported(entry.second)) {
+        return entry.second;
+      }
+      LOG(WARNING) << "Compression " << value << " specified by --" << flag_name
+                   << " is not supported by this build, using snappy";
+      return rocksdb::kSnappyCompression;
+    }
+  }
+  LOG(WARNING) << "Unknown compression " << value << " specified by --" << flag_name
+               << ", using snappy";
+  return rocksdb::kSnappyCompression;
+}
+
 } // namespace
 
 unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
@@ -340,16 +424,31 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& tablet_id,
     const shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options) {
+    const tablet::TabletOptions& tablet_options,
+    StorageDbType db_type) {
+  const bool intents_db = db_type == StorageDbType::kIntents;
   options->create_if_missing = true;
   options->disableDataSync = true;
   options->statistics = statistics;
-  options->info_log = std::make_shared<YBRocksDBLogger>(Substitute("T $0: ", tablet_id));
+  options->info_log = std::make_shared<YBRocksDBLogger>(
+      Substitute(intents_db ? "T $0 [I]: " : "T $0: ", tablet_id));
   options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
-  if (FLAGS_db_write_buffer_size != -1) {
+  options->use_direct_io_for_flush_and_compaction =
+      FLAGS_rocksdb_use_direct_io_for_flush_and_compaction;
+  if (FLAGS_rocksdb_allow_concurrent_memtable_write) {
+    options->allow_concurrent_memtable_write = true;
+    options->enable_write_thread_adaptive_yield = true;
+    options->memtable_insert_thread_pool = tablet_options.memtable_insert_thread_pool;
+    options->memtable_insert_min_entries_per_thread =
+        std::max(FLAGS_rocksdb_memtable_insert_min_entries_per_thread, 1);
+    options->memtable_insert_max_threads = std::max(FLAGS_rocksdb_memtable_insert_max_threads, 1);
+  }
+  if (intents_db && FLAGS_intents_db_write_buffer_size != -1) {
+    options->write_buffer_size = FLAGS_intents_db_write_buffer_size;
+  } else if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
   options->listeners.insert(
@@ -362,6 +461,10 @@ void InitRocksDBOptions(
     table_options.block_cache = tablet_options.block_cache;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    // Keep index and filter blocks in the block cache longer than data blocks, while top level
+    // of the multi-level index stays in the table reader.
+    table_options.cache_index_and_filter_blocks_with_high_priority = true;
+    table_options.pin_top_level_index = true;
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
@@ -370,9 +473,11 @@ void InitRocksDBOptions(
   table_options.filter_block_size = FLAGS_db_filter_block_size_bytes;
   table_options.index_block_size = FLAGS_db_index_block_size_bytes;
   table_options.min_keys_per_index_block = FLAGS_db_min_keys_per_index_block;
+  table_options.mem_tracker = tablet_options.block_based_table_mem_tracker;
+  table_options.max_auto_readahead_size = FLAGS_db_max_auto_readahead_size_bytes;
 
   // Set our custom bloom filter that is docdb aware.
-  if (FLAGS_use_docdb_aware_bloom_filter) {
+  if (FLAGS_use_docdb_aware_bloom_filter && !intents_db) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
         table_options.filter_block_size * 8, options->info_log.get()));
   }
@@ -385,6 +490,18 @@ void InitRocksDBOptions(
 
   options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
 
+  options->compression = CompressionTypeFromFlag(
+      "rocksdb_compression_type", FLAGS_rocksdb_compression_type);
+  // Intents are removed soon after they are written, so there is no point in compressing them
+  // better.
+  if (!intents_db) {
+    if (!FLAGS_rocksdb_bottommost_compression_type.empty()) {
+      options->bottommost_compression = CompressionTypeFromFlag(
+          "rocksdb_bottommost_compression_type", FLAGS_rocksdb_bottommost_compression_type);
+    }
+    options->compression_opts.max_dict_bytes = std::max(FLAGS_rocksdb_compression_dict_bytes, 0);
+  }
+
   // Compaction related options.
 
   // Enable universal style compactions.
@@ -408,9 +525,15 @@ void InitRocksDBOptions(
         rocksdb::CompactionStopStyle::kCompactionStopStyleTotalSize;
     options->compaction_options_universal.size_ratio =
         FLAGS_rocksdb_universal_compaction_size_ratio;
-    options->compaction_options_universal.min_merge_width =
-        FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->compaction_options_universal.min_merge_width = intents_db
+        ? FLAGS_intents_db_universal_compaction_min_merge_width
+        : FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
+    options->compaction_options_universal.min_subcompaction_size =
+        FLAGS_rocksdb_universal_compaction_min_subcompaction_size;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
+    options->priority_thread_pool_for_compactions =
+        tablet_options.priority_thread_pool_for_compactions;
     if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
@@ -28,6 +28,7 @@
 
 #include "yb/tablet/tablet_options.h"
 
+#include "yb/util/enums.h"
 #include "yb/util/slice.h"
 
 namespace yb {
@@ -98,7 +99,9 @@ enum class BloomFilterMode {
 // keys with the same hashed components as key specified for seek operation.
 // Note: bloom_filter_mode should be specified explicitly to avoid using it incorrectly by default.
 // user_key_for_filter is used with BloomFilterMode::USE_BLOOM_FILTER to exclude SST files which
-// have the same hashed components as (Sub)DocKey encoded in user_key_for_filter.
+// have the same hashed components as (Sub)DocKey encoded in user_key_for_filter. If that key has
+// range components, files without its first range component are excluded too, so the scan must
+// also stay within the same first range component in this case.
 std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -117,13 +120,19 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr);
 
+// Kind of RocksDB instance of a tablet. Transactional tables keep provisional records (intents)
+// in a separate RocksDB instance, that is written once and deleted soon after.
+YB_DEFINE_ENUM(StorageDbType, (kRegular)(kIntents));
+
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
-// specified by 'tablet_id'.
+// specified by 'tablet_id'. Options of the intents DB have no bloom filter, since intents are
+// always read by prefix, and their own memtable size and compaction settings.
 void InitRocksDBOptions(
     rocksdb::Options* options, const std::string& tablet_id,
     const std::shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options);
+    const tablet::TabletOptions& tablet_options,
+    StorageDbType db_type = StorageDbType::kRegular);
 
 }  // namespace docdb
 }  // namespace yb
@@ -214,10 +214,20 @@ IntentAwareIterator::IntentAwareIterator(
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txp_op_context: " << txn_op_context_;
   if (txn_op_context.is_initialized()) {
-    intent_iter_ = docdb::CreateRocksDBIterator(rocksdb,
+    auto* intents_db = txn_op_context->intents_db;
+    intent_iter_ = docdb::CreateRocksDBIterator(intents_db ? intents_db : rocksdb,
                                                 docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                 boost::none,
                                                 rocksdb::kDefaultQueryId);
+    if (intents_db) {
+      // The intents DB contains nothing but intents and transaction metadata, so when there are no
+      // intents in the snapshot of this iterator, reads could skip intents entirely.
+      const char intent_prefix = static_cast<char>(ValueType::kIntentPrefix);
+      intent_iter_->Seek(Slice(&intent_prefix, 1));
+      if (!intent_iter_->Valid() || intent_iter_->key()[0] != intent_prefix) {
+        intent_iter_.reset();
+      }
+    }
   }
   iter_.reset(rocksdb->NewIterator(read_opts));
 }
@@ -48,6 +48,9 @@ class LockBatch {
   // @return whether the batch is empty. This is also used for checking if the batch is locked.
   bool empty() const { return key_to_type_.empty(); }
 
+  // @return the locked keys with their intent types, ordered by key.
+  const KeyToIntentTypeMap& key_to_intent_type() const { return key_to_type_; }
+
   // Unlocks this batch if it is non-empty.
   void Reset();
 
@@ -14,6 +14,8 @@
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
 #include "yb/integration-tests/mini_cluster.h"
 #include "yb/master/master.pb.h"
 #include "yb/master/master.proxy.h"
@@ -21,8 +23,12 @@
 #include "yb/rpc/messenger.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
+#include "yb/util/metrics.h"
 #include "yb/util/test_util.h"
 
+METRIC_DECLARE_entity(server);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
+
 namespace yb {
 namespace client {
 
@@ -202,5 +208,112 @@ TEST_F(PlacementInfoTest, TestSelectTServer) {
   }
 }
 
+// Checks that the bounded staleness reads are served by the replica in the zone of the client, and
+// fall back to the leader when the replica is too stale. Also compares their latency with the
+// latency of the reads served by the leader.
+TEST_F(PlacementInfoTest, FollowerReadLatency) {
+  constexpr int kNumRows = 100;
+  constexpr int kNumReads = 2000;
+  const YBTableName table_name("placement_test", "follower_reads");
+  ASSERT_OK(client_->CreateNamespaceIfNotExists(table_name.namespace_name()));
+  YBSchemaBuilder builder;
+  builder.AddColumn("key")->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn("value")->Type(INT32);
+  TableHandle table;
+  ASSERT_OK(table.Create(table_name, 1, client_.get(), &builder, kNumTservers));
+
+  auto session = client_->NewSession();
+  session->SetTimeout(MonoDelta::FromSeconds(15));
+  for (int i = 0; i != kNumRows; ++i) {
+    auto op = table.NewInsertOp();
+    auto* req = op->mutable_request();
+    QLAddInt32HashValue(req, i);
+    table.AddInt32ColumnValue(req, "value", i);
+    ASSERT_OK(session->Apply(op));
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+  }
+
+  // Place the reading client in the zone of a follower.
+  rpc::RpcController controller;
+  master::GetTableLocationsRequestPB req;
+  master::GetTableLocationsResponsePB resp;
+  table_name.SetIntoTableIdentifierPB(req.mutable_table());
+  ASSERT_OK(proxy_->GetTableLocations(req, &resp, &controller));
+  ASSERT_EQ(1, resp.tablet_locations_size());
+  int leader_index = -1;
+  int follower_index = -1;
+  for (const auto& replica : resp.tablet_locations(0).replicas()) {
+    if (replica.role() == consensus::RaftPeerPB::LEADER) {
+      leader_index = ts_uuid_to_index_[replica.ts_info().permanent_uuid()];
+    } else if (replica.role() == consensus::RaftPeerPB::FOLLOWER) {
+      follower_index = ts_uuid_to_index_[replica.ts_info().permanent_uuid()];
+    }
+  }
+  ASSERT_NE(-1, leader_index);
+  ASSERT_NE(-1, follower_index);
+
+  // Number of read RPCs received by each tablet server, to find which replica served the reads.
+  auto num_reads_received = [this](int index) {
+    return METRIC_handler_latency_yb_tserver_TabletServerService_Read.Instantiate(
+        cluster_->mini_tablet_server(index)->server()->metric_entity())->TotalCount();
+  };
+
+  CloudInfoPB cloud_info;
+  cloud_info.set_placement_cloud("aws");
+  cloud_info.set_placement_region(PlacementRegion(follower_index));
+  cloud_info.set_placement_zone(PlacementZone(follower_index));
+  YBClientBuilder client_builder;
+  client_builder.set_cloud_info_pb(cloud_info);
+  client_builder.add_master_server_addr(cluster_->leader_mini_master()->bound_rpc_addr_str());
+  std::shared_ptr<YBClient> follower_client;
+  ASSERT_OK(client_builder.Build(&follower_client));
+  TableHandle follower_table;
+  ASSERT_OK(follower_table.Open(table_name, follower_client.get()));
+  auto follower_session = follower_client->NewSession();
+  follower_session->SetTimeout(MonoDelta::FromSeconds(15));
+
+  auto read_rows = [&](int num_reads, YBConsistencyLevel consistency, MonoDelta max_staleness) {
+    auto start = MonoTime::Now();
+    for (int i = 0; i != num_reads; ++i) {
+      auto op = follower_table.NewReadOp();
+      auto* req = op->mutable_request();
+      QLAddInt32HashValue(req, i % kNumRows);
+      follower_table.AddColumns({"value"}, req);
+      op->set_yb_consistency_level(consistency);
+      op->set_max_staleness(max_staleness);
+      EXPECT_OK(follower_session->Apply(op));
+      EXPECT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+      auto rows = op->MakeRowBlock();
+      EXPECT_OK(rows);
+      if (rows.ok()) {
+        EXPECT_EQ(1, rows->row_count());
+      }
+    }
+    return MonoTime::Now().GetDeltaSince(start);
+  };
+
+  auto leader_reads = num_reads_received(leader_index);
+  auto follower_reads = num_reads_received(follower_index);
+  auto leader_time = read_rows(kNumReads, YBConsistencyLevel::STRONG, MonoDelta());
+  ASSERT_EQ(leader_reads + kNumReads, num_reads_received(leader_index));
+  ASSERT_EQ(follower_reads, num_reads_received(follower_index));
+
+  leader_reads = num_reads_received(leader_index);
+  auto follower_time = read_rows(
+      kNumReads, YBConsistencyLevel::CONSISTENT_PREFIX, MonoDelta::FromSeconds(10));
+  ASSERT_EQ(leader_reads, num_reads_received(leader_index));
+  ASSERT_EQ(follower_reads + kNumReads, num_reads_received(follower_index));
+  LOG(INFO) << "Average read latency, leader: "
+            << leader_time.ToMicroseconds() / kNumReads << "us, follower: "
+            << follower_time.ToMicroseconds() / kNumReads << "us";
+
+  // The follower could not satisfy zero staleness, so it responds with STALE_FOLLOWER to every
+  // read, which is then retried on the leader.
+  follower_reads = num_reads_received(follower_index);
+  read_rows(kNumRows, YBConsistencyLevel::CONSISTENT_PREFIX, MonoDelta::FromMilliseconds(0));
+  ASSERT_EQ(leader_reads + kNumRows, num_reads_received(leader_index));
+  ASSERT_EQ(follower_reads + kNumRows, num_reads_received(follower_index));
+}
+
 } // namespace client
 } // namespace yb
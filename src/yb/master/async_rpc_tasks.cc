@@ -627,6 +627,70 @@ bool AsyncTruncate::SendRequest(int attempt) {
   return true;
 }
 
+AsyncSplitTablet::AsyncSplitTablet(Master* master,
+                                   ThreadPool* callback_pool,
+                                   const scoped_refptr<TabletInfo>& tablet,
+                                   const std::vector<TabletId>& new_tablet_ids,
+                                   const std::string& split_partition_key)
+    : RetryingTSRpcTask(master,
+                        callback_pool,
+                        gscoped_ptr<TSPicker>(new PickLeaderReplica(tablet)),
+                        tablet->table().get()),
+      tablet_(tablet),
+      new_tablet_ids_(new_tablet_ids),
+      split_partition_key_(split_partition_key) {
+}
+
+string AsyncSplitTablet::description() const {
+  return tablet_->ToString() + " Split Tablet RPC";
+}
+
+TabletId AsyncSplitTablet::tablet_id() const {
+  return tablet_->tablet_id();
+}
+
+TabletServerId AsyncSplitTablet::permanent_uuid() const {
+  return target_ts_desc_ != nullptr ? target_ts_desc_->permanent_uuid() : "";
+}
+
+void AsyncSplitTablet::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    const Status s = StatusFromPB(resp_.error().status());
+    LOG(WARNING) << "TS " << permanent_uuid() << ": split failed for tablet " << tablet_id()
+                 << " with error code "
+                 << TabletServerErrorPB::Code_Name(resp_.error().code()) << ": " << s;
+    // The tablet leader rejects the split as not possible only when it was not replicated, so
+    // the split could be aborted. Other errors, e.g. from a replica that is not the leader anymore
+    // or does not host the tablet, could happen after the split was replicated, so the request is
+    // retried against the current leader.
+    if (resp_.error().code() == TabletServerErrorPB::OPERATION_NOT_SUPPORTED) {
+      PerformStateTransition(kStateRunning, kStateComplete);
+      WARN_NOT_OK(master_->catalog_manager()->AbortTabletSplit(tablet_),
+                  "Failed to abort split of tablet " + tablet_id());
+    }
+  } else {
+    VLOG(1) << "TS " << permanent_uuid() << ": split complete on tablet " << tablet_id();
+    PerformStateTransition(kStateRunning, kStateComplete);
+  }
+
+  server::UpdateClock(resp_, master_->clock());
+}
+
+bool AsyncSplitTablet::SendRequest(int attempt) {
+  tserver::SplitTabletRequestPB req;
+  req.set_dest_uuid(permanent_uuid());
+  req.set_tablet_id(tablet_id());
+  req.set_new_tablet1_id(new_tablet_ids_[0]);
+  req.set_new_tablet2_id(new_tablet_ids_[1]);
+  req.set_split_partition_key(split_partition_key_);
+  req.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  ts_admin_proxy_->SplitTabletAsync(req, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send split tablet request to " << permanent_uuid()
+          << " (attempt " << attempt << "):\n"
+          << req.DebugString();
+  return true;
+}
+
 // ============================================================================
 //  Class CommonInfoForRaftTask.
 // ============================================================================
@@ -14,6 +14,8 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_TEST_BASE_H
 #define YB_MASTER_CATALOG_MANAGER_TEST_BASE_H
 
+#include <limits>
+
 #include <gtest/gtest.h>
 
 #include "yb/gutil/strings/substitute.h"
@@ -129,6 +131,12 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs);
     TestBalancingLeaders();
 
+    PrepareTestState(ts_descs);
+    TestBalancingHotLeaders();
+
+    PrepareTestState(ts_descs);
+    TestBalancingWeightedLoad();
+
     gflags::SetCommandLineOption("leader_balance_threshold", "2");
     PrepareTestState(ts_descs);
     TestBalancingLeadersWithThreshold();
@@ -624,6 +632,68 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
   }
 
+  void TestBalancingHotLeaders() {
+    LOG(INFO) << "Testing moving overloaded leaders with a hot tablet";
+    // Move all leaders to ts0.
+    for (const auto tablet : tablets_) {
+      MoveTabletLeader(tablet.get(), ts_descs_[0]);
+    }
+    const TabletId hot_tablet_id = tablets_[2]->tablet_id();
+    ts_descs_[0]->set_hot_tablets({hot_tablet_id});
+    LOG(INFO) << "Leader distribution: 4 0 0. Hot tablet: " << hot_tablet_id;
+
+    AnalyzeTablets();
+
+    // The leader of the hot tablet should be moved first, then any other leader.
+    string placeholder, tablet_id_1, tablet_id_2, expected_from_ts, expected_to_ts;
+    expected_from_ts = ts_descs_[0]->permanent_uuid();
+    expected_to_ts = ts_descs_[1]->permanent_uuid();
+    TestMoveLeader(&tablet_id_1, expected_from_ts, expected_to_ts);
+    ASSERT_EQ(hot_tablet_id, tablet_id_1);
+    expected_to_ts = ts_descs_[2]->permanent_uuid();
+    TestMoveLeader(&tablet_id_2, expected_from_ts, expected_to_ts);
+    ASSERT_NE(hot_tablet_id, tablet_id_2);
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    ts_descs_[0]->set_hot_tablets({});
+  }
+
+  void TestBalancingWeightedLoad() {
+    LOG(INFO) << "Testing moving leaders and replicas to balance the weighted load";
+    // The leaders are distributed as 2 1 1, and ts0 leads both hot tablets.
+    const std::set<TabletId> hot_tablets = {tablets_[0]->tablet_id(), tablets_[3]->tablet_id()};
+    LOG(INFO) << "Leader distribution: 2 1 1. Hot tablets led by ts0.";
+
+    int num_runs = 0;
+    double spread = 0;
+    ASSERT_NO_FATALS(SimulateWeightedLoadBalancing(hot_tablets, &num_runs, &spread));
+
+    // A leader move spreads the hot tablets, then the loads are as balanced as they can be without
+    // unbalancing the leader counts.
+    ASSERT_EQ(2, num_runs);
+    ASSERT_NO_FATALS(AssertHotTabletsSpread(hot_tablets));
+    for (const auto& ts_desc : ts_descs_) {
+      ASSERT_LE(1, cb_->state_->GetLeaderLoad(ts_desc->permanent_uuid()));
+      ASSERT_GE(2, cb_->state_->GetLeaderLoad(ts_desc->permanent_uuid()));
+    }
+
+    // A new tablet server has no replica to take a leader, so the follower replicas of the hot
+    // tablets should be moved to it from the tablet servers leading the other hot tablet.
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    LOG(INFO) << "Added an empty tablet server";
+    const double spread_before_new_ts = spread;
+    ASSERT_NO_FATALS(SimulateWeightedLoadBalancing(hot_tablets, &num_runs, &spread));
+    ASSERT_EQ(2, num_runs);
+    ASSERT_LT(spread, spread_before_new_ts);
+    ASSERT_NO_FATALS(AssertHotTabletsSpread(hot_tablets));
+    const auto& new_ts_meta = cb_->state_->per_ts_meta_[ts_descs_[3]->permanent_uuid()];
+    ASSERT_EQ(hot_tablets, new_ts_meta.running_tablets);
+
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->set_tablet_loads(nullptr);
+    }
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -848,6 +918,135 @@ class TestLoadBalancerBase {
     tablet->SetReplicaLocations(replicas);
   }
 
+  // Reports the loads of the replicas, as the tablet servers would do in their heartbeats. Every
+  // replica applies the writes, and the leaders also serve the reads.
+  void ReportTabletLoads(const std::set<TabletId>& hot_tablets) {
+    std::map<TabletServerId, std::shared_ptr<TabletReplicaLoads>> ts_loads;
+    for (const auto& ts_desc : ts_descs_) {
+      ts_loads[ts_desc->permanent_uuid()] = std::make_shared<TabletReplicaLoads>();
+    }
+    for (const auto& tablet : tablets_) {
+      const bool is_hot = hot_tablets.count(tablet->tablet_id()) != 0;
+      TabletInfo::ReplicaMap replicas;
+      tablet->GetReplicaLocations(&replicas);
+      for (const auto& replica : replicas) {
+        auto& load = (*ts_loads[replica.first])[tablet->tablet_id()];
+        load.write_ops_per_sec = is_hot ? 10 : 0.5;
+        if (replica.second.role == consensus::RaftPeerPB::LEADER) {
+          load.read_ops_per_sec = is_hot ? 90 : 0.5;
+        }
+      }
+    }
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->set_tablet_loads(ts_loads[ts_desc->permanent_uuid()]);
+    }
+  }
+
+  // Recreates the state with the weighted load model, as done by a run of the load balancer.
+  void AnalyzeWeightedLoad() {
+    ResetState();
+    cb_->weighted_load_.Init(ts_descs_);
+    cb_->state_->weighted_load_ = &cb_->weighted_load_;
+    AnalyzeTablets();
+  }
+
+  // Simulates the runs of the load balancer until they stop moving leaders or replicas for the
+  // weighted load, with the tablet servers reporting their load after the moves of the previous
+  // run completed. Checks that every run stays within the limit of moves and reduces the
+  // difference between the most and least loaded tablet servers, so the loads converge instead of
+  // going back and forth. Returns the number of runs, including the last one that made no move,
+  // and the final difference of load.
+  void SimulateWeightedLoadBalancing(
+      const std::set<TabletId>& hot_tablets, int* num_runs, double* spread) {
+    const int kMaxRuns = 10;
+    const int kMaxMovesPerRun = 2;
+    double prev_spread = std::numeric_limits<double>::max();
+    for (*num_runs = 1; *num_runs <= kMaxRuns; ++*num_runs) {
+      ReportTabletLoads(hot_tablets);
+      AnalyzeWeightedLoad();
+      *spread = WeightedLoadSpread();
+      LOG(INFO) << "Run " << *num_runs << ": weighted load spread " << *spread;
+      ASSERT_LT(*spread, prev_spread);
+      prev_spread = *spread;
+
+      int remaining_moves = kMaxMovesPerRun;
+      while (remaining_moves > 0) {
+        string tablet_id, from_ts, to_ts;
+        int num_moves = 0;
+        if (!cb_->HandleWeightedLoadMoves(remaining_moves, &tablet_id, &from_ts, &to_ts,
+                                          &num_moves)) {
+          break;
+        }
+        LOG(INFO) << "Moved " << tablet_id << " from " << from_ts << " to " << to_ts << " with "
+                  << num_moves << " moves";
+        ASSERT_LE(1, num_moves);
+        ASSERT_GE(remaining_moves, num_moves);
+        remaining_moves -= num_moves;
+      }
+      if (remaining_moves == kMaxMovesPerRun) {
+        return;
+      }
+      ApplyPlannedMoves();
+    }
+    FAIL() << "Weighted load did not converge in " << kMaxRuns << " runs";
+  }
+
+  // Returns the difference between the most and least loaded tablet servers.
+  double WeightedLoadSpread() {
+    double min_load = std::numeric_limits<double>::max();
+    double max_load = 0;
+    for (const auto& ts_desc : ts_descs_) {
+      const double load = cb_->weighted_load_.GetLoad(ts_desc->permanent_uuid());
+      min_load = std::min(min_load, load);
+      max_load = std::max(max_load, load);
+    }
+    return max_load - min_load;
+  }
+
+  // Checks that the hot tablets are led by different tablet servers, which do not host the
+  // followers of the other hot tablets when another tablet server can.
+  void AssertHotTabletsSpread(const std::set<TabletId>& hot_tablets) {
+    const auto& state = *cb_->state_;
+    std::set<TabletServerId> hot_leaders;
+    for (const auto& tablet_id : hot_tablets) {
+      hot_leaders.insert(state.per_tablet_meta_.at(tablet_id).leader_uuid);
+    }
+    ASSERT_EQ(hot_tablets.size(), hot_leaders.size());
+    if (ts_descs_.size() < kNumReplicas + hot_leaders.size() - 1) {
+      return;
+    }
+    for (const auto& ts_uuid : hot_leaders) {
+      const auto& ts_meta = state.per_ts_meta_.at(ts_uuid);
+      for (const auto& tablet_id : hot_tablets) {
+        if (state.per_tablet_meta_.at(tablet_id).leader_uuid != ts_uuid) {
+          ASSERT_EQ(0U, ts_meta.running_tablets.count(tablet_id));
+        }
+      }
+    }
+  }
+
+  // Applies the leader and replica moves planned by the load balancer, as if they completed.
+  void ApplyPlannedMoves() {
+    for (const auto& tablet : tablets_) {
+      const auto& tablet_id = tablet->tablet_id();
+      const auto& leader_uuid = cb_->state_->per_tablet_meta_[tablet_id].leader_uuid;
+      TabletInfo::ReplicaMap replicas;
+      for (const auto& ts_desc : ts_descs_) {
+        const auto& ts_uuid = ts_desc->permanent_uuid();
+        const auto& ts_meta = cb_->state_->per_ts_meta_[ts_uuid];
+        if (ts_meta.running_tablets.count(tablet_id) || ts_meta.starting_tablets.count(tablet_id)) {
+          TabletReplica replica;
+          NewReplica(ts_desc.get(), tablet::RUNNING,
+                     ts_uuid == leader_uuid ? consensus::RaftPeerPB::LEADER
+                                            : consensus::RaftPeerPB::FOLLOWER,
+                     &replica);
+          InsertOrDie(&replicas, ts_uuid, replica);
+        }
+      }
+      tablet->SetReplicaLocations(replicas);
+    }
+  }
+
   // Clear the tablets_added_ field from the state, used for testing.
   void ClearTabletsAddedForTest() {
     cb_->state_->tablets_added_.clear();
@@ -116,6 +116,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/random_util.h"
 #include "yb/util/rw_mutex.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 #include "yb/util/thread_restrictions.h"
@@ -124,6 +125,8 @@
 #include "yb/util/uuid.h"
 #include "yb/tserver/remote_bootstrap_client.h"
 
+using namespace yb::size_literals;
+
 DEFINE_int32(master_ts_rpc_timeout_ms, 30 * 1000,  // 30 sec
              "Timeout used for the Master->TS async rpc calls.");
 TAG_FLAG(master_ts_rpc_timeout_ms, advanced);
@@ -188,6 +191,36 @@ DEFINE_test_flag(bool, catalog_manager_simulate_system_table_create_failure, fal
 DEFINE_string(cluster_uuid, "", "Cluster UUID to be used by this cluster");
 TAG_FLAG(cluster_uuid, hidden);
 
+DEFINE_bool(enable_automatic_tablet_splitting, false,
+            "Whether the master should split the tablets that are larger than "
+            "tablet_split_size_threshold_bytes or serve more than "
+            "tablet_split_ops_per_sec_threshold operations per second.");
+TAG_FLAG(enable_automatic_tablet_splitting, experimental);
+TAG_FLAG(enable_automatic_tablet_splitting, runtime);
+
+DEFINE_int64(tablet_split_size_threshold_bytes, 10_GB,
+             "Size of the SST files of a tablet replica, after which the tablet is split. "
+             "0 to disable splitting by size.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+TAG_FLAG(tablet_split_size_threshold_bytes, runtime);
+
+DEFINE_double(tablet_split_ops_per_sec_threshold, 0,
+              "Number of read and write operations per second served by a tablet replica, after "
+              "which the tablet is split. 0 to disable splitting by load.");
+TAG_FLAG(tablet_split_ops_per_sec_threshold, advanced);
+TAG_FLAG(tablet_split_ops_per_sec_threshold, runtime);
+
+DEFINE_int32(max_concurrent_tablet_splits, 1,
+             "Maximum number of tablet splits, started automatically, which could be in progress "
+             "at the same time.");
+TAG_FLAG(max_concurrent_tablet_splits, advanced);
+TAG_FLAG(max_concurrent_tablet_splits, runtime);
+
+DEFINE_int32(tablet_split_retry_interval_ms, 10000,
+             "Amount of time the master waits for the children of a split tablet to start, "
+             "before sending the split request again.");
+TAG_FLAG(tablet_split_retry_interval_ms, advanced);
+
 DECLARE_int32(yb_num_shards_per_tserver);
 
 namespace yb {
@@ -328,6 +361,12 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
       table_ids.push_back(metadata.table_id());
     }
 
+    // The children of a tablet being split are added to the table, replacing the parent, only
+    // when the split is completed.
+    if (!metadata.split_parent_tablet_id().empty()) {
+      table_ids.clear();
+    }
+
     for (auto table_id : table_ids) {
       scoped_refptr<TableInfo> table(FindPtrOrNull(catalog_manager_->table_ids_map_, table_id));
 
@@ -610,6 +649,9 @@ void CatalogManagerBgTasks::Run() {
       // Report metrics.
       catalog_manager_->ReportMetrics();
 
+      // Complete the finished tablet splits and start the new ones.
+      catalog_manager_->ProcessTabletSplits();
+
       TabletInfos to_delete;
       TabletInfos to_process;
 
@@ -638,6 +680,9 @@ void CatalogManagerBgTasks::Run() {
     //   // TODO: Run the cleaner
     // }
 
+    // Complete the tablet location watches that did not get any changes in time.
+    catalog_manager_->tablet_locations_watcher_.ExpireWatches();
+
     // Wait for a notification or a timeout expiration.
     //  - CreateTable will call Wake() to notify about the tablets to add
     //  - HandleReportedTablet/ProcessPendingAssignments will call WakeIfHasPendingUpdates()
@@ -670,7 +715,9 @@ CatalogManager::CatalogManager(Master* master)
       state_(kConstructed),
       leader_ready_term_(-1),
       leader_lock_(RWMutex::Priority::PREFER_WRITING),
-      load_balance_policy_(new YB_EDITION_NS_PREFIX ClusterLoadBalancer(this)) {
+      load_balance_policy_(new YB_EDITION_NS_PREFIX ClusterLoadBalancer(this)),
+      tablet_locations_watcher_(std::bind(&CatalogManager::GetTabletLocations, this,
+                                          std::placeholders::_1, std::placeholders::_2)) {
   CHECK_OK(ThreadPoolBuilder("leader-initialization")
            .set_max_threads(1)
            .Build(&worker_pool_));
@@ -780,6 +827,10 @@ void CatalogManager::LoadSysCatalogDataTask() {
     CHECK_OK(status);
   }
 
+  // Changes seen by the previous leader are unknown here, so clients have to start following
+  // a new history.
+  tablet_locations_watcher_.Reset();
+
   std::lock_guard<simple_spinlock> l(state_lock_);
   leader_ready_term_ = term;
   LOG(INFO) << "Completed load of sys catalog in term " << term;
@@ -1228,6 +1279,8 @@ void CatalogManager::Shutdown() {
     background_tasks_->Shutdown();
   }
 
+  tablet_locations_watcher_.Shutdown();
+
   // Mark all outstanding table tasks as aborted and wait for them to fail.
   //
   // There may be an outstanding table visitor thread modifying the table map,
@@ -1979,6 +2032,336 @@ void CatalogManager::SendTruncateTabletRequest(const scoped_refptr<TabletInfo>&
   WARN_NOT_OK(status, Substitute("Failed to send truncate request for tablet $0", tablet->id()));
 }
 
+Status CatalogManager::SplitTablet(const scoped_refptr<TabletInfo>& tablet,
+                                   const std::string& split_partition_key) {
+  scoped_refptr<TableInfo> table = tablet->table();
+  if (!table) {
+    return STATUS_FORMAT(NotFound, "Table of tablet $0 not found", tablet->tablet_id());
+  }
+
+  vector<TabletInfo*> new_tablets;
+  vector<TabletId> new_tablet_ids;
+  {
+    std::lock_guard<LockType> l(lock_);
+    auto table_lock = table->LockForRead();
+    if (!table_lock->data().is_running()) {
+      return STATUS_FORMAT(IllegalState, "Table $0 is not running", table->id());
+    }
+
+    auto tablet_lock = tablet->LockForWrite();
+    const SysTabletsEntryPB& tablet_pb = tablet_lock->data().pb;
+    if (!tablet_lock->data().is_running() || tablet_pb.split_child_tablet_ids_size() != 0 ||
+        !tablet_pb.split_parent_tablet_id().empty()) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 is not running or is being split",
+                           tablet->tablet_id());
+    }
+    const PartitionPB& partition = tablet_pb.partition();
+    if (split_partition_key <= partition.partition_key_start() ||
+        (!partition.partition_key_end().empty() &&
+         split_partition_key >= partition.partition_key_end())) {
+      return STATUS_FORMAT(InvalidArgument, "Split key is not inside of the tablet $0 partition",
+                           tablet->tablet_id());
+    }
+
+    PartitionPB child_partitions[2] = { partition, partition };
+    child_partitions[0].set_partition_key_end(split_partition_key);
+    child_partitions[1].set_partition_key_start(split_partition_key);
+    for (const PartitionPB& child_partition : child_partitions) {
+      TabletInfo* child = CreateTabletInfo(table.get(), child_partition);
+      SysTabletsEntryPB* child_pb = &child->mutable_metadata()->mutable_dirty()->pb;
+      child_pb->set_state(SysTabletsEntryPB::CREATING);
+      child_pb->set_split_parent_tablet_id(tablet->tablet_id());
+      // The children are hosted by the replicas of the parent, and elect their own leaders.
+      ConsensusStatePB* cstate = child_pb->mutable_committed_consensus_state();
+      cstate->CopyFrom(tablet_pb.committed_consensus_state());
+      cstate->clear_leader_uuid();
+      cstate->mutable_config()->set_opid_index(consensus::kInvalidOpIdIndex);
+      new_tablets.push_back(child);
+      new_tablet_ids.push_back(child->tablet_id());
+      tablet_lock->mutable_data()->pb.add_split_child_tablet_ids(child->tablet_id());
+    }
+
+    Status s = sys_catalog_->AddAndUpdateItems(new_tablets, {tablet.get()});
+    if (!s.ok()) {
+      for (TabletInfo* child : new_tablets) {
+        child->mutable_metadata()->AbortMutation();
+        // Release the tablets, which were not added to the tablet map.
+        scoped_refptr<TabletInfo> release(child);
+      }
+      return s.CloneAndPrepend("An error occurred while writing to sys-tablets");
+    }
+
+    tablet_lock->Commit();
+    for (TabletInfo* child : new_tablets) {
+      child->mutable_metadata()->CommitMutation();
+      InsertOrDie(&tablet_map_, child->tablet_id(), child);
+    }
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Splitting tablet " << tablet->tablet_id() << " into "
+                        << new_tablet_ids[0] << " and " << new_tablet_ids[1];
+  tablet->set_last_update_time(MonoTime::Now());
+  SendSplitTabletRequest(tablet, new_tablet_ids, split_partition_key);
+  return Status::OK();
+}
+
+void CatalogManager::SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                                            const std::vector<TabletId>& new_tablet_ids,
+                                            const std::string& split_partition_key) {
+  auto call = std::make_shared<AsyncSplitTablet>(
+      master_, worker_pool_.get(), tablet, new_tablet_ids, split_partition_key);
+  tablet->table()->AddTask(call);
+  auto status = call->Run();
+  WARN_NOT_OK(status, Substitute("Failed to send split request for tablet $0", tablet->id()));
+}
+
+Status CatalogManager::AbortTabletSplit(const scoped_refptr<TabletInfo>& parent) {
+  TabletInfos children;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    auto parent_lock = parent->LockForRead();
+    for (const auto& child_id : parent_lock->data().pb.split_child_tablet_ids()) {
+      auto child = FindPtrOrNull(tablet_map_, child_id);
+      if (child) {
+        children.push_back(child);
+      }
+    }
+  }
+
+  // Lock the tablets in the order of their ids, as the tablet report processing does.
+  TabletInfos tablets = children;
+  tablets.push_back(parent);
+  std::sort(tablets.begin(), tablets.end(),
+            [](const TabletInfoPtr& lhs, const TabletInfoPtr& rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
+  vector<TabletInfo*> tablets_to_update;
+  for (const auto& tablet : tablets) {
+    tablet->mutable_metadata()->StartMutation();
+    tablets_to_update.push_back(tablet.get());
+  }
+  parent->mutable_metadata()->mutable_dirty()->pb.clear_split_child_tablet_ids();
+  for (const auto& child : children) {
+    child->mutable_metadata()->mutable_dirty()->set_state(
+        SysTabletsEntryPB::DELETED,
+        Substitute("Split of tablet $0 was aborted", parent->tablet_id()));
+  }
+
+  Status s = sys_catalog_->UpdateItems(tablets_to_update);
+  for (const auto& tablet : tablets) {
+    if (s.ok()) {
+      tablet->mutable_metadata()->CommitMutation();
+    } else {
+      tablet->mutable_metadata()->AbortMutation();
+    }
+  }
+  RETURN_NOT_OK_PREPEND(s, "An error occurred while updating sys-tablets");
+  LOG_WITH_PREFIX(INFO) << "Aborted split of tablet " << parent->tablet_id();
+  return Status::OK();
+}
+
+Status CatalogManager::CompleteTabletSplit(const scoped_refptr<TabletInfo>& parent,
+                                           const TabletInfos& children) {
+  TabletInfos tablets = children;
+  tablets.push_back(parent);
+  std::sort(tablets.begin(), tablets.end(),
+            [](const TabletInfoPtr& lhs, const TabletInfoPtr& rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
+  vector<TabletInfo*> tablets_to_update;
+  for (const auto& tablet : tablets) {
+    tablet->mutable_metadata()->StartMutation();
+    tablets_to_update.push_back(tablet.get());
+  }
+  vector<TabletInfo*> new_tablets;
+  for (const auto& child : children) {
+    child->mutable_metadata()->mutable_dirty()->pb.clear_split_parent_tablet_id();
+    new_tablets.push_back(child.get());
+  }
+  parent->mutable_metadata()->mutable_dirty()->set_state(
+      SysTabletsEntryPB::DELETED,
+      Substitute("Split into $0 and $1", children[0]->tablet_id(), children[1]->tablet_id()));
+
+  Status s = sys_catalog_->UpdateItems(tablets_to_update);
+  if (!s.ok()) {
+    for (const auto& tablet : tablets) {
+      tablet->mutable_metadata()->AbortMutation();
+    }
+    return s.CloneAndPrepend("An error occurred while updating sys-tablets");
+  }
+
+  // The first child has the same partition start as the parent, so the parent is replaced in the
+  // table partition map by a single update, while the tablet locks are still held.
+  parent->table()->AddTablets(new_tablets);
+  for (const auto& tablet : tablets) {
+    tablet->mutable_metadata()->CommitMutation();
+  }
+  std::vector<TabletId> changed_tablet_ids;
+  for (const auto& tablet : tablets) {
+    changed_tablet_ids.push_back(tablet->tablet_id());
+  }
+  tablet_locations_watcher_.TabletLocationsChanged(changed_tablet_ids);
+  LOG_WITH_PREFIX(INFO) << "Completed split of tablet " << parent->tablet_id();
+  return Status::OK();
+}
+
+void CatalogManager::ProcessTabletSplits() {
+  struct SplitInProgress {
+    TabletInfoPtr parent;
+    TabletInfos children;
+  };
+  std::vector<SplitInProgress> splits;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const TabletInfoMap::value_type& entry : tablet_map_) {
+      auto tablet_lock = entry.second->LockForRead();
+      const auto& tablet_pb = tablet_lock->data().pb;
+      if (tablet_lock->data().is_deleted() || tablet_pb.split_child_tablet_ids_size() == 0) {
+        continue;
+      }
+      SplitInProgress split{entry.second, {}};
+      for (const auto& child_id : tablet_pb.split_child_tablet_ids()) {
+        auto child = FindPtrOrNull(tablet_map_, child_id);
+        if (child) {
+          split.children.push_back(child);
+        }
+      }
+      splits.push_back(std::move(split));
+    }
+  }
+
+  const MonoTime now = MonoTime::Now();
+  for (const auto& split : splits) {
+    if (split.children.size() != 2) {
+      LOG_WITH_PREFIX(DFATAL) << "Children of tablet " << split.parent->tablet_id()
+                              << " not found";
+      continue;
+    }
+    bool children_running = true;
+    for (const auto& child : split.children) {
+      if (!child->LockForRead()->data().is_running()) {
+        children_running = false;
+      }
+    }
+    if (children_running) {
+      WARN_NOT_OK(CompleteTabletSplit(split.parent, split.children),
+                  Substitute("Failed to complete split of tablet $0", split.parent->tablet_id()));
+      continue;
+    }
+
+    // The split request is idempotent, so it is resent if the tablet servers did not create the
+    // children in time, e.g. because the tablet leader has changed.
+    auto table = split.parent->table();
+    if (table && !table->HasTasks(MonitoredTask::ASYNC_SPLIT_TABLET) &&
+        now.GetDeltaSince(split.parent->last_update_time()).ToMilliseconds() >
+            FLAGS_tablet_split_retry_interval_ms) {
+      split.parent->set_last_update_time(now);
+      SendSplitTabletRequest(
+          split.parent,
+          {split.children[0]->tablet_id(), split.children[1]->tablet_id()},
+          split.children[1]->LockForRead()->data().pb.partition().partition_key_start());
+    }
+  }
+
+  if (!FLAGS_enable_automatic_tablet_splitting) {
+    return;
+  }
+  int num_splits_to_start = FLAGS_max_concurrent_tablet_splits - static_cast<int>(splits.size());
+  if (num_splits_to_start <= 0) {
+    return;
+  }
+
+  // Each tablet is measured by its most loaded replica.
+  struct TabletSplitLoad {
+    uint64_t sst_file_size = 0;
+    double ops_per_sec = 0;
+  };
+  std::unordered_map<TabletId, TabletSplitLoad> tablet_loads;
+  TSDescriptorVector ts_descs;
+  master_->ts_manager()->GetAllLiveDescriptors(&ts_descs);
+  for (const auto& ts_desc : ts_descs) {
+    auto replica_loads = ts_desc->tablet_loads();
+    if (!replica_loads) {
+      continue;
+    }
+    for (const auto& entry : *replica_loads) {
+      auto& load = tablet_loads[entry.first];
+      load.sst_file_size = std::max(load.sst_file_size, entry.second.sst_file_size);
+      load.ops_per_sec = std::max(
+          load.ops_per_sec, entry.second.read_ops_per_sec + entry.second.write_ops_per_sec);
+    }
+  }
+
+  // Candidates are ordered by how much they exceed the thresholds, the most exceeding first.
+  std::vector<std::pair<double, TabletInfoPtr>> candidates;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const auto& entry : tablet_loads) {
+      double excess = 0;
+      if (FLAGS_tablet_split_size_threshold_bytes > 0) {
+        excess = std::max(excess, static_cast<double>(entry.second.sst_file_size) /
+                                  FLAGS_tablet_split_size_threshold_bytes);
+      }
+      if (FLAGS_tablet_split_ops_per_sec_threshold > 0) {
+        excess = std::max(excess,
+                          entry.second.ops_per_sec / FLAGS_tablet_split_ops_per_sec_threshold);
+      }
+      if (excess < 1) {
+        continue;
+      }
+      auto tablet = FindPtrOrNull(tablet_map_, entry.first);
+      if (tablet && tablet->table()) {
+        candidates.emplace_back(excess, tablet);
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+  for (const auto& candidate : candidates) {
+    if (num_splits_to_start <= 0) {
+      break;
+    }
+    const auto& tablet = candidate.second;
+    std::string split_partition_key;
+    {
+      // Only the hash partitioned YCQL tables are split, at the middle of the tablet hash range.
+      auto table_lock = tablet->table()->LockForRead();
+      const auto& table_pb = table_lock->data().pb;
+      const auto hash_schema = table_pb.partition_schema().hash_schema();
+      if (!table_lock->data().is_running() ||
+          table_pb.table_type() != TableType::YQL_TABLE_TYPE ||
+          hash_schema != PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA ||
+          table_pb.schema().table_properties().is_transactional()) {
+        continue;
+      }
+      auto tablet_lock = tablet->LockForRead();
+      const auto& tablet_pb = tablet_lock->data().pb;
+      if (!tablet_lock->data().is_running() || tablet_pb.table_ids_size() > 1 ||
+          tablet_pb.split_child_tablet_ids_size() != 0 ||
+          !tablet_pb.split_parent_tablet_id().empty()) {
+        continue;
+      }
+      const auto& partition = tablet_pb.partition();
+      uint32_t hash_start = partition.partition_key_start().empty() ? 0 :
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+      uint32_t hash_end = partition.partition_key_end().empty() ? 0x10000 :
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end());
+      if (hash_end < hash_start + 2) {
+        continue;
+      }
+      split_partition_key = PartitionSchema::EncodeMultiColumnHashValue(
+          hash_start + (hash_end - hash_start) / 2);
+    }
+    Status s = SplitTablet(tablet, split_partition_key);
+    if (s.ok()) {
+      --num_splits_to_start;
+    } else {
+      LOG_WITH_PREFIX(WARNING) << "Failed to split tablet " << tablet->tablet_id() << ": " << s;
+    }
+  }
+}
+
 Status CatalogManager::IsTruncateTableDone(const IsTruncateTableDoneRequestPB* req,
                                            IsTruncateTableDoneResponsePB* resp) {
   LOG(INFO) << "Servicing IsTruncateTableDone request for table id " << req->table_id();
@@ -2798,35 +3181,79 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
             << ts_desc->permanent_uuid() << "): " << report.DebugString();
   }
 
-  if (!ts_desc->has_tablet_report() && report.is_incremental()) {
+  // The chunks following the first one of a full report are sent as incremental reports.
+  const bool has_tablet_report = ts_desc->has_tablet_report();
+  const bool continues_full_report = !has_tablet_report && ts_desc->has_partial_tablet_report();
+  if (!has_tablet_report && !continues_full_report && report.is_incremental()) {
     string msg = "Received an incremental tablet report when a full one was needed";
     LOG(WARNING) << "Invalid tablet report from " << ts_desc->permanent_uuid() << ": " << msg;
     // We should respond with success in order to send reply that we need full report.
     return Status::OK();
   }
 
+  RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
+      "This master is no longer the leader, unable to handle tablet report");
+
   // TODO: on a full tablet report, we may want to iterate over the tablets we think
   // the server should have, compare vs the ones being reported, and somehow mark
   // any that have been "lost" (eg somehow the tablet metadata got corrupted or something).
 
+  // Handle the tablets in the order of their ids, since tablets whose metadata is modified stay
+  // write locked until the whole report is persisted. Reports from different tablet servers
+  // are handled concurrently and this way they always acquire the tablet locks in the same order.
+  std::vector<const ReportedTabletPB*> reported_tablets;
+  reported_tablets.reserve(report.updated_tablets_size());
   for (const ReportedTabletPB& reported : report.updated_tablets()) {
-    ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
-    tablet_report->set_tablet_id(reported.tablet_id());
-    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablet_report),
-                          Substitute("Error handling $0", reported.ShortDebugString()));
+    reported_tablets.push_back(&reported);
   }
+  std::sort(reported_tablets.begin(), reported_tablets.end(),
+            [](const ReportedTabletPB* lhs, const ReportedTabletPB* rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
 
-  if (!ts_desc->has_tablet_report()) {
-    LOG(INFO) << ts_desc->permanent_uuid() << " now has full report for "
-              << report.updated_tablets_size() << " tablets.";
+  // Look up all the reported tablets with a single acquisition of the catalog manager lock.
+  std::vector<scoped_refptr<TabletInfo>> tablet_infos;
+  tablet_infos.reserve(reported_tablets.size());
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const ReportedTabletPB* reported : reported_tablets) {
+      tablet_infos.push_back(FindPtrOrNull(tablet_map_, reported->tablet_id()));
+    }
   }
 
-  if (!report.is_incremental()) {
-    if (report.updated_tablets_size() == 0) {
+  ReportedTablets updates;
+  Status s;
+  for (size_t i = 0; i != reported_tablets.size(); ++i) {
+    const ReportedTabletPB& reported = *reported_tablets[i];
+    ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
+    tablet_report->set_tablet_id(reported.tablet_id());
+    s = HandleReportedTablet(ts_desc, reported, tablet_infos[i], tablet_report, &updates);
+    if (!s.ok()) {
+      s = s.CloneAndPrepend(Substitute("Error handling $0", reported.ShortDebugString()));
+      break;
+    }
+  }
+  // Persist the changes made by the tablets handled so far even if some tablet failed, the same
+  // way as they would be persisted if every tablet was written separately.
+  RETURN_NOT_OK(CommitReportedTablets(&updates));
+  RETURN_NOT_OK(s);
+
+  if (!report.is_incremental() || continues_full_report) {
+    if (!report.is_incremental() && report.updated_tablets_size() == 0) {
       LOG(INFO) << ts_desc->permanent_uuid() << " sent full tablet report with 0 tablets.";
     }
-    // Do not unset full tablet report missing for ts desc for an incremental case.
-    ts_desc->set_has_tablet_report(true);
+    // The full report is complete only once its last chunk was handled. Do not unset full tablet
+    // report missing for ts desc for a regular incremental case.
+    if (report.remaining_tablet_count() == 0) {
+      if (!has_tablet_report) {
+        LOG(INFO) << ts_desc->permanent_uuid() << " now has full tablet report";
+      }
+      ts_desc->set_has_tablet_report(true);
+    } else {
+      VLOG(1) << ts_desc->permanent_uuid() << " sent a chunk of full tablet report, "
+              << report.remaining_tablet_count() << " tablets remaining";
+      ts_desc->set_has_partial_tablet_report();
+    }
   }
 
   if (report.updated_tablets_size() > 0) {
@@ -2856,17 +3283,11 @@ bool ShouldTransitionTabletToRunning(const ReportedTabletPB& report) {
 
 Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
                                             const ReportedTabletPB& report,
-                                            ReportedTabletUpdatesPB *report_updates) {
+                                            const scoped_refptr<TabletInfo>& tablet,
+                                            ReportedTabletUpdatesPB *report_updates,
+                                            ReportedTablets* reported_tablets) {
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
-  scoped_refptr<TabletInfo> tablet;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
-  }
-  RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
-      Substitute("This master is no longer the leader, unable to handle report for tablet $0",
-                 report.tablet_id()));
   if (!tablet) {
     LOG(INFO) << "Got report from unknown tablet " << report.tablet_id()
               << ": Sending delete request for this orphan tablet";
@@ -2946,6 +3367,12 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     return Status::OK();
   }
 
+  // Whether the persistent metadata of the tablet was changed by this report. Reports that match
+  // the state already known to the master do not need to be written to the sys catalog.
+  bool modified = false;
+  // Whether the replicas or the leader of the tablet visible to clients have changed.
+  bool locations_changed = false;
+
   // The report will not have a committed_consensus_state if it is in the
   // middle of starting up, such as during tablet bootstrap.
   if (report.has_committed_consensus_state()) {
@@ -2980,12 +3407,12 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
       DCHECK_EQ(SysTabletsEntryPB::CREATING, tablet_lock->data().pb.state())
           << "Tablet in unexpected state: " << tablet->ToString()
           << ": " << tablet_lock->data().pb.ShortDebugString();
-      // Mark the tablet as running
-      // TODO: we could batch the IO onto a background thread, or at least
-      // across multiple tablets in the same report.
+      // Mark the tablet as running. The sys catalog write is batched with the other tablets
+      // of the same report.
       VLOG(1) << "Tablet " << tablet->ToString() << " is now online";
       tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::RUNNING,
                                              "Tablet reported with an active leader");
+      modified = true;
     }
 
     // The Master only accepts committed consensus configurations since it needs the committed index
@@ -3049,6 +3476,8 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
 
       RETURN_NOT_OK(ResetTabletReplicasFromReportedConfig(*final_report, tablet,
                                                           tablet_lock.get(), table_lock.get()));
+      modified = true;
+      locations_changed = true;
 
       // Sanity check replicas for this tablet.
       TabletInfo::ReplicaMap replica_map;
@@ -3063,30 +3492,74 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
       // been added as replica, add it.
       LOG(INFO) << "Peer " << ts_desc->permanent_uuid() << " sent full tablet report for "
                 << tablet->tablet_id() << ". Consensus state: " << cstate.ShortDebugString();
-      AddReplicaToTabletIfNotFound(ts_desc, report, tablet);
+      locations_changed = AddReplicaToTabletIfNotFound(ts_desc, report, tablet);
     }
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get());
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
+
+  ReportedTablet reported_tablet;
+  reported_tablet.info = tablet;
+  reported_tablet.report = &report;
+  reported_tablet.needs_alter = tablet_needs_alter;
+  reported_tablet.locations_changed = locations_changed;
+  if (modified) {
+    // Keep the tablet locked until the mutation is persisted together with the rest of the report.
+    reported_tablet.lock = std::move(tablet_lock);
+  } else {
+    tablet_lock->Unlock();
+  }
+  reported_tablets->push_back(std::move(reported_tablet));
+
+  return Status::OK();
+}
+
+Status CatalogManager::CommitReportedTablets(ReportedTablets* reported_tablets) {
+  std::vector<TabletInfo*> modified_tablets;
+  for (const auto& reported_tablet : *reported_tablets) {
+    if (reported_tablet.lock) {
+      modified_tablets.push_back(reported_tablet.info.get());
+    }
+  }
+
+  if (!modified_tablets.empty()) {
+    TRACE_EVENT1("master", "CommitReportedTablets",
+                 "num_tablets", modified_tablets.size());
+    Status s = sys_catalog_->UpdateItems(modified_tablets);
+    if (!s.ok()) {
+      LOG(WARNING) << "Error updating " << modified_tablets.size() << " reported tablets: "
+                   << s.ToString();
+      // Mutations are aborted when the locks are released.
+      return s;
+    }
+    for (auto& reported_tablet : *reported_tablets) {
+      if (reported_tablet.lock) {
+        reported_tablet.lock->Commit();
+        reported_tablet.lock.reset();
+      }
+    }
   }
-  tablet_lock->Commit();
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
   // request needs to know who the most recent leader is.
-  if (tablet_needs_alter) {
-    SendAlterTabletRequest(tablet);
-  } else if (report.has_schema_version()) {
-    RETURN_NOT_OK(HandleTabletSchemaVersionReport(tablet.get(), report.schema_version()));
+  for (const auto& reported_tablet : *reported_tablets) {
+    if (reported_tablet.needs_alter) {
+      SendAlterTabletRequest(reported_tablet.info);
+    } else if (reported_tablet.report->has_schema_version()) {
+      RETURN_NOT_OK(HandleTabletSchemaVersionReport(
+          reported_tablet.info.get(), reported_tablet.report->schema_version()));
+    }
   }
 
+  std::vector<TabletId> changed_tablet_ids;
+  for (const auto& reported_tablet : *reported_tablets) {
+    if (reported_tablet.locations_changed) {
+      changed_tablet_ids.push_back(reported_tablet.info->tablet_id());
+    }
+  }
+  tablet_locations_watcher_.TabletLocationsChanged(changed_tablet_ids);
+
   return Status::OK();
 }
 
@@ -3850,13 +4323,13 @@ Status CatalogManager::ResetTabletReplicasFromReportedConfig(
   return Status::OK();
 }
 
-void CatalogManager::AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
+bool CatalogManager::AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
                                                   const ReportedTabletPB& report,
                                                   const scoped_refptr<TabletInfo>& tablet) {
   TabletReplica replica;
   NewReplica(ts_desc, report, &replica);
   // Only inserts if a replica with a matching UUID was not already present.
-  ignore_result(tablet->AddToReplicaLocations(replica));
+  return tablet->AddToReplicaLocations(replica);
 }
 
 void CatalogManager::NewReplica(TSDescriptor* ts_desc,
@@ -4252,9 +4725,21 @@ void CatalogManager::ExtractTabletsToProcess(
       continue;
     }
 
+    // Children of a tablet being split are created by the tablet servers, as a part of the split.
+    if (!tablet_lock->data().pb.split_parent_tablet_id().empty()) {
+      continue;
+    }
+
     // Tablets not yet assigned or with a report just received
     tablets_to_process->push_back(tablet);
   }
+
+  // Tablets to process are write locked all together, so use the same order as tablet report
+  // processing does to avoid lock order inversion.
+  std::sort(tablets_to_process->begin(), tablets_to_process->end(),
+            [](const scoped_refptr<TabletInfo>& lhs, const scoped_refptr<TabletInfo>& rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
 }
 
 struct DeferredAssignmentActions {
@@ -4911,6 +5396,12 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id,
   return s;
 }
 
+void CatalogManager::WatchTabletLocations(const WatchTabletLocationsRequestPB* req,
+                                          WatchTabletLocationsResponsePB* resp,
+                                          rpc::RpcContext rpc) {
+  tablet_locations_watcher_.Watch(req, resp, std::move(rpc));
+}
+
 Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
                                          GetTableLocationsResponsePB* resp) {
   RETURN_NOT_OK(CheckOnline());
@@ -4949,6 +5440,9 @@ Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
   vector<scoped_refptr<TabletInfo>> tablets_in_range;
   table->GetTabletsInRange(req, &tablets_in_range);
 
+  // A tablet being split stays in the table until its children are running, so its locations
+  // are returned until then. Its replicas respond with TABLET_SPLIT once they applied the split,
+  // and the client looks the tablets up again.
   for (const scoped_refptr<TabletInfo>& tablet : tablets_in_range) {
     if (!BuildLocationsForTablet(tablet, resp->add_tablet_locations()).ok()) {
       // Not running.
@@ -52,6 +52,7 @@
 #include "yb/master/master_defaults.h"
 #include "yb/master/master.pb.h"
 #include "yb/master/system_tables_handler.h"
+#include "yb/master/tablet_locations_watcher.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/yql_virtual_table.h"
 #include "yb/server/monitored_task.h"
@@ -789,6 +790,12 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS GetTableLocations(const GetTableLocationsRequestPB* req,
                                    GetTableLocationsResponsePB* resp);
 
+  // Start splitting the specified tablet into two tablets at split_partition_key: the child
+  // tablets are persisted in the sys catalog and the split request is sent to the tablet leader.
+  // The split is completed by the background task, once both children are running.
+  CHECKED_STATUS SplitTablet(const scoped_refptr<TabletInfo>& tablet,
+                             const std::string& split_partition_key);
+
   // Look up the locations of the given tablet. The locations
   // vector is overwritten (not appended to).
   // If the tablet is not found, returns Status::NotFound.
@@ -798,6 +805,13 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS GetTabletLocations(const TabletId& tablet_id,
                                     TabletLocationsPB* locs_pb);
 
+  // Responds with the tablets whose locations changed after the version seen by the client.
+  // If there are no such tablets, the response is delayed until the first change or until the
+  // wait timeout of the request expires.
+  void WatchTabletLocations(const WatchTabletLocationsRequestPB* req,
+                            WatchTabletLocationsResponsePB* resp,
+                            rpc::RpcContext rpc);
+
   // Retrieves a SystemTablet instance based on the existing system tablets already created in our
   // syscatalog.
   CHECKED_STATUS RetrieveSystemTablet(const TabletId& tablet_id,
@@ -1168,11 +1182,31 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS FindTable(const TableIdentifierPB& table_identifier,
                            scoped_refptr<TableInfo>* table_info);
 
-  // Handle one of the tablets in a tablet reported.
-  // Requires that the lock is already held.
+  // A tablet from a tablet report together with the work that is deferred until all tablets of
+  // the report have been handled. Tablets whose persistent metadata was changed by the report keep
+  // their write lock here, so that the whole report is persisted with a single sys catalog write.
+  struct ReportedTablet {
+    scoped_refptr<TabletInfo> info;
+    const ReportedTabletPB* report = nullptr;
+    // Set only if the persistent metadata of the tablet has to be written to the sys catalog.
+    std::unique_ptr<TabletInfo::lock_type> lock;
+    bool needs_alter = false;
+    // Set if the replicas or the leader of the tablet have changed.
+    bool locations_changed = false;
+  };
+  typedef std::vector<ReportedTablet> ReportedTablets;
+
+  // Handle one of the tablets in a tablet report. 'tablet' is null if the tablet is not known
+  // to this master. Mutations and follow-up actions are appended to 'reported_tablets'.
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
-                              const ReportedTabletPB& report,
-                              ReportedTabletUpdatesPB *report_updates);
+                                      const ReportedTabletPB& report,
+                                      const scoped_refptr<TabletInfo>& tablet,
+                                      ReportedTabletUpdatesPB *report_updates,
+                                      ReportedTablets* reported_tablets);
+
+  // Persist the mutations collected in 'reported_tablets' using one sys catalog write, commit them
+  // and run the actions that have to follow the commit.
+  CHECKED_STATUS CommitReportedTablets(ReportedTablets* reported_tablets);
 
   CHECKED_STATUS ResetTabletReplicasFromReportedConfig(const ReportedTabletPB& report,
                                                const scoped_refptr<TabletInfo>& tablet,
@@ -1184,7 +1218,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // server that is part of a consensus configuration has not heartbeated to the Master yet, we
   // leave it out of the consensus configuration reported to clients.
   // TODO: See if we can remove this logic, as it seems confusing.
-  void AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
+  //
+  // Returns true if the replica was added.
+  bool AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
                                     const ReportedTabletPB& report,
                                     const scoped_refptr<TabletInfo>& tablet);
 
@@ -1195,6 +1231,19 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   void ExtractTabletsToProcess(TabletInfos *tablets_to_delete,
                                TabletInfos *tablets_to_process);
 
+  // Completes the tablet splits whose children are running, resends the stuck split requests
+  // and, if automatic tablet splitting is enabled, starts splitting the oversized or hot tablets.
+  void ProcessTabletSplits();
+
+  // Replaces the parent tablet with its children in the table partition map, and marks the
+  // parent as deleted, in a single sys catalog write.
+  CHECKED_STATUS CompleteTabletSplit(const scoped_refptr<TabletInfo>& parent,
+                                     const TabletInfos& children);
+
+  // Drops the children of the tablet which could not be split, so that the tablet keeps
+  // serving its whole partition.
+  CHECKED_STATUS AbortTabletSplit(const scoped_refptr<TabletInfo>& parent);
+
   // Task that takes care of the tablet assignments/creations.
   // Loops through the "not created" tablets and sends a CreateTablet() request.
   CHECKED_STATUS ProcessPendingAssignments(const TabletInfos& tablets);
@@ -1271,6 +1320,11 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Start the background task to send the TruncateTable() RPC to the leader for this tablet.
   void SendTruncateTabletRequest(const scoped_refptr<TabletInfo>& tablet);
 
+  // Start the background task to send the SplitTablet() RPC to the leader for this tablet.
+  void SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                              const std::vector<TabletId>& new_tablet_ids,
+                              const std::string& split_partition_key);
+
   // Delete the specified table in memory. The TableInfo, DeletedTableInfo and lock of the deleted
   // table are appended to the lists. The caller will be responsible for committing the change and
   // deleting the actual table and tablets.
@@ -1480,6 +1534,7 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Async operations are accessing some private methods
   // (TODO: this stuff should be deferred and done in the background thread)
   friend class AsyncAlterTable;
+  friend class AsyncSplitTablet;
 
   // Number of live tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_live_;
@@ -1489,6 +1544,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Policy for load balancing tablets on tablet servers.
   std::unique_ptr<ClusterLoadBalancer> load_balance_policy_;
 
+  // Tracks tablet location changes for clients watching them.
+  TabletLocationsWatcher tablet_locations_watcher_;
+
   // Tablet peer for the sys catalog tablet's peer.
   const scoped_refptr<tablet::TabletPeer> tablet_peer() const;
 
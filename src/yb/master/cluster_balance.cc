@@ -14,12 +14,15 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <memory>
 
 #include <boost/thread/locks.hpp>
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -60,6 +63,52 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_double(load_balancer_weight_ops, 1.0,
+              "Weight of the operations per second served by a tablet replica in the load used to "
+              "balance the tablet servers, once the numbers of tablets and leaders are balanced.");
+TAG_FLAG(load_balancer_weight_ops, advanced);
+TAG_FLAG(load_balancer_weight_ops, runtime);
+
+DEFINE_double(load_balancer_weight_bytes, 1.0,
+              "Weight of the bytes per second read and written by a tablet replica in the load "
+              "used to balance the tablet servers.");
+TAG_FLAG(load_balancer_weight_bytes, advanced);
+TAG_FLAG(load_balancer_weight_bytes, runtime);
+
+DEFINE_double(load_balancer_weight_cpu, 1.0,
+              "Weight of the CPU time used by a tablet replica in the load used to balance the "
+              "tablet servers. Only reported by the tablet servers with --tablet_track_cpu_time.");
+TAG_FLAG(load_balancer_weight_cpu, advanced);
+TAG_FLAG(load_balancer_weight_cpu, runtime);
+
+DEFINE_double(load_balancer_weight_sst_size, 1.0,
+              "Weight of the SST files size of a tablet replica in the load used to balance the "
+              "tablet servers.");
+TAG_FLAG(load_balancer_weight_sst_size, advanced);
+TAG_FLAG(load_balancer_weight_sst_size, runtime);
+
+DEFINE_double(load_balancer_weighted_imbalance_threshold, 0.25,
+              "Move a leader or a replica between two tablet servers if the difference of their "
+              "weighted loads is above this fraction of the mean weighted load. 0 disables the "
+              "balancing of the weighted load.");
+TAG_FLAG(load_balancer_weighted_imbalance_threshold, advanced);
+TAG_FLAG(load_balancer_weighted_imbalance_threshold, runtime);
+
+DEFINE_int32(load_balancer_max_concurrent_weighted_moves,
+             2,
+             "Maximum number of leader step downs or replica moves in any one run of the load "
+             "balancer, to balance the weighted load of the tablet servers. A swap of two leaders "
+             "counts as two step downs.");
+TAG_FLAG(load_balancer_max_concurrent_weighted_moves, advanced);
+TAG_FLAG(load_balancer_max_concurrent_weighted_moves, runtime);
+
+DEFINE_int32(load_balancer_weighted_move_interval_ms,
+             60 * 1000,
+             "Minimum time between the runs of the load balancer moving leaders or replicas to "
+             "balance the weighted load, so that the reported load reflects the previous moves.");
+TAG_FLAG(load_balancer_weighted_move_interval_ms, advanced);
+TAG_FLAG(load_balancer_weighted_move_interval_ms, runtime);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -176,6 +225,22 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
   set_remaining(pending_remove_replica_tasks, &remaining_removals);
   set_remaining(pending_stepdown_leader_tasks, &remaining_leader_moves);
 
+  // Moves of the weighted load wait for the previous moves to complete, and for the reported load
+  // to reflect them.
+  TSDescriptorVector ts_descs;
+  GetAllReportedDescriptors(&ts_descs);
+  weighted_load_.Init(ts_descs);
+  int remaining_weighted_moves = options->kMaxConcurrentWeightedMoves;
+  const auto now = MonoTime::Now();
+  const int pending_tasks =
+      pending_add_replica_tasks + pending_remove_replica_tasks + pending_stepdown_leader_tasks;
+  if (pending_tasks > 0 ||
+      (last_weighted_move_time_ &&
+       now < last_weighted_move_time_ +
+                 MonoDelta::FromMilliseconds(FLAGS_load_balancer_weighted_move_interval_ms))) {
+    remaining_weighted_moves = 0;
+  }
+
   // Loop over all tables.
   for (const auto& table : GetTableMap()) {
 
@@ -185,6 +250,7 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
 
     ResetState();
     state_->options_ = options;
+    state_->weighted_load_ = &weighted_load_;
 
     // Prepare the in-memory structures.
     if (!AnalyzeTablets(table.first)) {
@@ -197,12 +263,15 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
     TabletServerId out_from_ts;
     TabletServerId out_to_ts;
 
+    bool table_moved = false;
+
     // Handle adding and moving replicas.
     for (int i = 0; i < remaining_adds; ++i) {
       if (!HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts)) {
         break;
       }
       --remaining_adds;
+      table_moved = true;
     }
 
     // Handle cleanup after over-replication.
@@ -211,6 +280,7 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
         break;
       }
       --remaining_removals;
+      table_moved = true;
     }
 
     // Handle tablet servers with too many leaders.
@@ -219,9 +289,22 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
         break;
       }
       --remaining_leader_moves;
+      table_moved = true;
+    }
+
+    // Handle tablet servers using too many resources, once the counts of the table are balanced.
+    while (!table_moved && remaining_weighted_moves > 0) {
+      int num_moves = 0;
+      if (!HandleWeightedLoadMoves(remaining_weighted_moves, &out_tablet_id, &out_from_ts,
+                                   &out_to_ts, &num_moves)) {
+        break;
+      }
+      remaining_weighted_moves -= num_moves;
+      last_weighted_move_time_ = now;
     }
 
-    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
+    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0 &&
+        remaining_weighted_moves == 0) {
       break;
     }
   }
@@ -620,9 +703,12 @@ bool ClusterLoadBalancer::GetLeaderToMove(
       // If there are, we have a candidate we want, so fill in the output params and return.
       const set<TabletId>& leaders = state_->per_ts_meta_[high_load_uuid].leaders;
       const set<TabletId>& peers = state_->per_ts_meta_[low_load_uuid].running_tablets;
-      set<TabletId> intersection;
-      const auto& itr = std::inserter(intersection, intersection.begin());
-      std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
+      vector<TabletId> intersection;
+      std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(),
+                            std::back_inserter(intersection));
+      // Try to move the leaders of the hot tablets first.
+      std::stable_partition(intersection.begin(), intersection.end(),
+                            [this](const TabletId& id) { return state_->IsHotTablet(id); });
 
       for (const auto& tablet_id : intersection) {
         *moving_tablet_id = tablet_id;
@@ -740,6 +826,170 @@ bool ClusterLoadBalancer::HandleLeaderMoves(
   return false;
 }
 
+bool ClusterLoadBalancer::HandleWeightedLoadMoves(
+    int max_moves, TabletId* out_tablet_id, TabletServerId* out_from_ts,
+    TabletServerId* out_to_ts, int* num_moves) {
+  const double threshold = state_->options_->kMinWeightedLoadImbalanceToBalance;
+  if (!state_->weighted_load_ || state_->weighted_load_->empty() || threshold <= 0) {
+    return false;
+  }
+  const ClusterWeightedLoad& weighted_load = *state_->weighted_load_;
+
+  // Consider the same tablet servers as for the leaders, i.e. the responsive ones that are not
+  // blacklisted, sorted by their weighted load.
+  vector<TabletServerId> sorted_ts = state_->sorted_leader_load_;
+  std::sort(sorted_ts.begin(), sorted_ts.end(),
+            [&weighted_load](const TabletServerId& a, const TabletServerId& b) {
+              return weighted_load.GetLoad(a) < weighted_load.GetLoad(b);
+            });
+
+  // As in GetLeaderToMove, try the pairs of tablet servers from the largest difference of load
+  // down, until the difference gets below the threshold. Every move reduces the difference by at
+  // least the threshold, so the weighted loads converge instead of moving small tablets around.
+  const double min_imbalance = threshold * weighted_load.mean_load();
+  int last_pos = sorted_ts.size() - 1;
+  for (int left = 0; left < last_pos; ++left) {
+    for (int right = last_pos; right > left; --right) {
+      const TabletServerId& low_load_uuid = sorted_ts[left];
+      const TabletServerId& high_load_uuid = sorted_ts[right];
+      const double imbalance =
+          weighted_load.GetLoad(high_load_uuid) - weighted_load.GetLoad(low_load_uuid);
+      if (imbalance <= min_imbalance) {
+        if (right == last_pos) {
+          return false;
+        }
+        break;
+      }
+
+      // Leader moves are cheaper than replica moves, so try them first.
+      if (MoveWeightedLeader(high_load_uuid, low_load_uuid, imbalance, min_imbalance,
+                             max_moves, out_tablet_id, num_moves) ||
+          MoveWeightedReplica(high_load_uuid, low_load_uuid, imbalance, min_imbalance,
+                              out_tablet_id, num_moves)) {
+        *out_from_ts = high_load_uuid;
+        *out_to_ts = low_load_uuid;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+vector<TabletId> ClusterLoadBalancer::GetMovableLeaders(
+    const TabletServerId& leader_ts, const TabletServerId& follower_ts) {
+  const set<TabletId>& leaders = state_->per_ts_meta_[leader_ts].leaders;
+  const set<TabletId>& peers = state_->per_ts_meta_[follower_ts].running_tablets;
+  vector<TabletId> result;
+  std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(),
+                        std::back_inserter(result));
+  // Skip the tablets that recently failed to step down to the same tablet server.
+  result.erase(std::remove_if(result.begin(), result.end(),
+                              [this, &follower_ts](const TabletId& tablet_id) {
+                                return state_->per_tablet_meta_[tablet_id]
+                                    .leader_stepdown_failures.count(follower_ts) != 0;
+                              }),
+               result.end());
+  return result;
+}
+
+bool ClusterLoadBalancer::MoveWeightedLeader(
+    const TabletServerId& from_ts, const TabletServerId& to_ts, double imbalance,
+    double min_gain, int max_moves, TabletId* moving_tablet_id, int* num_moves) {
+  const ClusterWeightedLoad& weighted_load = *state_->weighted_load_;
+
+  // A single leader move should not unbalance the leader counts. If it would, swap the moved
+  // leader with the leader of to_ts that carries the least load. The swap takes two step downs.
+  TabletId swap_tablet_id;
+  double swap_load = 0;
+  if (state_->GetLeaderLoad(from_ts) <= state_->GetLeaderLoad(to_ts)) {
+    if (max_moves < 2) {
+      return false;
+    }
+    for (const auto& tablet_id : GetMovableLeaders(to_ts, from_ts)) {
+      const double load = weighted_load.GetLeaderMoveLoad(tablet_id, to_ts, from_ts);
+      if (swap_tablet_id.empty() || load < swap_load) {
+        swap_tablet_id = tablet_id;
+        swap_load = load;
+      }
+    }
+    if (swap_tablet_id.empty()) {
+      return false;
+    }
+  }
+
+  // Pick the leader that brings the loads of both tablet servers the closest to each other, if it
+  // reduces their difference by at least min_gain.
+  TabletId best_tablet_id;
+  double best_imbalance = imbalance - min_gain;
+  for (const auto& tablet_id : GetMovableLeaders(from_ts, to_ts)) {
+    const double moved_load =
+        weighted_load.GetLeaderMoveLoad(tablet_id, from_ts, to_ts) - swap_load;
+    const double new_imbalance = std::abs(imbalance - 2 * moved_load);
+    if (new_imbalance < best_imbalance) {
+      best_tablet_id = tablet_id;
+      best_imbalance = new_imbalance;
+    }
+  }
+  if (best_tablet_id.empty()) {
+    return false;
+  }
+
+  *moving_tablet_id = best_tablet_id;
+  weighted_load_.MoveLeader(best_tablet_id, from_ts, to_ts);
+  MoveLeader(best_tablet_id, from_ts, to_ts);
+  *num_moves = 1;
+  if (!swap_tablet_id.empty()) {
+    weighted_load_.MoveLeader(swap_tablet_id, to_ts, from_ts);
+    MoveLeader(swap_tablet_id, to_ts, from_ts);
+    *num_moves = 2;
+  }
+  return true;
+}
+
+bool ClusterLoadBalancer::MoveWeightedReplica(
+    const TabletServerId& from_ts, const TabletServerId& to_ts, double imbalance,
+    double min_gain, TabletId* moving_tablet_id, int* num_moves) {
+  // A replica move should not unbalance the tablet counts.
+  if (state_->GetLoad(from_ts) <= state_->GetLoad(to_ts)) {
+    return false;
+  }
+
+  const ClusterWeightedLoad& weighted_load = *state_->weighted_load_;
+  bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
+                        state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  TabletId best_tablet_id;
+  double best_imbalance = imbalance - min_gain;
+  for (const auto& tablet_id : state_->per_ts_meta_[from_ts].running_tablets) {
+    // Leaders are moved above, and the checks follow GetTabletToMove.
+    if (state_->per_tablet_meta_[tablet_id].leader_uuid == from_ts ||
+        state_->tablets_over_replicated_.count(tablet_id)) {
+      continue;
+    }
+    const auto& placement_info = GetPlacementByTablet(tablet_id);
+    if (!placement_info.placement_blocks().empty() && !same_placement) {
+      continue;
+    }
+    if (!state_->CanAddTabletToTabletServer(tablet_id, to_ts, &placement_info)) {
+      continue;
+    }
+    const double new_imbalance =
+        std::abs(imbalance - 2 * weighted_load.GetReplicaLoad(from_ts, tablet_id));
+    if (new_imbalance < best_imbalance) {
+      best_tablet_id = tablet_id;
+      best_imbalance = new_imbalance;
+    }
+  }
+  if (best_tablet_id.empty()) {
+    return false;
+  }
+
+  *moving_tablet_id = best_tablet_id;
+  weighted_load_.MoveReplica(best_tablet_id, from_ts, to_ts);
+  MoveReplica(best_tablet_id, from_ts, to_ts);
+  *num_moves = 1;
+  return true;
+}
+
 void ClusterLoadBalancer::MoveReplica(
     const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
   LOG(INFO) << Substitute("Moving tablet $0 from $1 to $2", tablet_id, from_ts, to_ts);
@@ -70,6 +70,10 @@ namespace master {
 //  leaders and moving some leaders to the servers with less to achieve an even distribution. If
 //  a threshold is set in the configuration, the balancer will just keep the numbers of leaders
 //  on each server below it instead of maintaining an even distribution.
+//
+//  Once the numbers of tablets and leaders of a table are balanced, the leaders and replicas are
+//  also moved to even out the weighted load of the tablet servers, i.e. the operations, bytes,
+//  CPU time and SST file size of their replicas, as reported in the heartbeats.
 class ClusterLoadBalancer {
  public:
   explicit ClusterLoadBalancer(CatalogManager* cm);
@@ -197,6 +201,40 @@ class ClusterLoadBalancer {
   virtual bool HandleLeaderMoves(
       TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts);
 
+  // Moves a leader or a replica from the tablet server using the most resources to the one using
+  // the least, as estimated by the weighted load, if their difference is above the threshold.
+  // Only moves that keep the tablet and leader counts balanced are considered, and at most
+  // max_moves leader step downs or replica moves are made.
+  //
+  // Returns true if a move was actually made, and sets num_moves to the number of step downs or
+  // replica moves it takes.
+  bool HandleWeightedLoadMoves(
+      int max_moves, TabletId* out_tablet_id, TabletServerId* out_from_ts,
+      TabletServerId* out_to_ts, int* num_moves);
+
+  // Returns the tablets led by leader_ts that could move their leader to follower_ts.
+  std::vector<TabletId> GetMovableLeaders(
+      const TabletServerId& leader_ts, const TabletServerId& follower_ts);
+
+  // Moves the leader that best evens out the weighted loads of from_ts and to_ts, which differ by
+  // imbalance, if the difference is reduced by at least min_gain. If from_ts does not have more
+  // leaders than to_ts, a leader of to_ts is moved back to from_ts as well, which is only done if
+  // max_moves allows both step downs.
+  //
+  // Returns true if a move was actually made, and sets num_moves to the number of step downs.
+  bool MoveWeightedLeader(
+      const TabletServerId& from_ts, const TabletServerId& to_ts, double imbalance,
+      double min_gain, int max_moves, TabletId* moving_tablet_id, int* num_moves);
+
+  // Moves the replica that best evens out the weighted loads of from_ts and to_ts, which differ by
+  // imbalance, if the difference is reduced by at least min_gain. Only done if from_ts has more
+  // tablets than to_ts.
+  //
+  // Returns true if a move was actually made, and sets num_moves to 1.
+  bool MoveWeightedReplica(
+      const TabletServerId& from_ts, const TabletServerId& to_ts, double imbalance,
+      double min_gain, TabletId* moving_tablet_id, int* num_moves);
+
   // Go through sorted_load_ and figure out which tablet to rebalance and from which TS that is
   // serving it to which other TS.
   //
@@ -262,6 +300,12 @@ class ClusterLoadBalancer {
   // The state of the load in the cluster, as far as this run of the algorithm is concerned.
   std::unique_ptr<ClusterLoadState> state_;
 
+  // The resources used by the tablet servers, as far as this run of the algorithm is concerned.
+  ClusterWeightedLoad weighted_load_;
+
+  // Time of the last run of the algorithm that moved leaders or replicas for the weighted load.
+  MonoTime last_weighted_move_time_;
+
   // The catalog manager of the Master that actually has the Tablet and TS state. The object is not
   // managed by this class, but by the Master's unique_ptr.
   CatalogManager* catalog_manager_;
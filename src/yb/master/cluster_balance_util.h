@@ -16,6 +16,7 @@
 
 #include <unordered_set>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <set>
@@ -48,6 +49,18 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_double(load_balancer_weight_ops);
+
+DECLARE_double(load_balancer_weight_bytes);
+
+DECLARE_double(load_balancer_weight_cpu);
+
+DECLARE_double(load_balancer_weight_sst_size);
+
+DECLARE_double(load_balancer_weighted_imbalance_threshold);
+
+DECLARE_int32(load_balancer_max_concurrent_weighted_moves);
+
 namespace yb {
 namespace master {
 
@@ -164,9 +177,151 @@ struct Options {
   // Max number of tablet leaders on tablet servers to move in any one run of the load balancer.
   int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
+  // If the difference between the weighted loads of two tablet servers goes past this fraction of
+  // the mean weighted load, we should try to move a leader or a replica between them.
+  double kMinWeightedLoadImbalanceToBalance = FLAGS_load_balancer_weighted_imbalance_threshold;
+
+  // Max number of leaders or replicas to move in any one run of the load balancer, to even out
+  // the weighted load once the counts are balanced.
+  int kMaxConcurrentWeightedMoves = FLAGS_load_balancer_max_concurrent_weighted_moves;
+
   // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
 };
 
+// Model of the resources used by the tablet servers, built from the loads of the tablet replicas
+// reported in the heartbeats. Operations, bytes, CPU time and SST file size are each normalized
+// by their total over the cluster and scaled by the load_balancer_weight_* flags, so the load of
+// a replica is its weighted share of the cluster resources, and the load of a tablet server is
+// the sum of the loads of its replicas. Leaders serve most of the reads, so moving a leader moves
+// the difference between the leader and the follower loads.
+class ClusterWeightedLoad {
+ public:
+  ClusterWeightedLoad() {}
+
+  // Rebuilds the model from the latest loads reported by the given tablet servers.
+  void Init(const TSDescriptorVector& ts_descs) {
+    per_ts_load_.clear();
+    total_load_ = 0;
+
+    double total_ops = 0;
+    double total_bytes = 0;
+    double total_cpu = 0;
+    double total_sst_size = 0;
+    std::vector<std::pair<TabletServerId, std::shared_ptr<const TabletReplicaLoads>>> reports;
+    for (const auto& ts_desc : ts_descs) {
+      auto tablet_loads = ts_desc->tablet_loads();
+      reports.emplace_back(ts_desc->permanent_uuid(), tablet_loads);
+      if (!tablet_loads) {
+        continue;
+      }
+      for (const auto& entry : *tablet_loads) {
+        const auto& load = entry.second;
+        total_ops += load.read_ops_per_sec + load.write_ops_per_sec;
+        total_bytes += load.read_bytes_per_sec + load.write_bytes_per_sec;
+        total_cpu += load.cpu_usec_per_sec;
+        total_sst_size += load.sst_file_size;
+      }
+    }
+
+    for (const auto& report : reports) {
+      auto& ts_load = per_ts_load_[report.first];
+      if (!report.second) {
+        continue;
+      }
+      for (const auto& entry : *report.second) {
+        const auto& load = entry.second;
+        double replica_load =
+            Share(FLAGS_load_balancer_weight_ops,
+                  load.read_ops_per_sec + load.write_ops_per_sec, total_ops) +
+            Share(FLAGS_load_balancer_weight_bytes,
+                  load.read_bytes_per_sec + load.write_bytes_per_sec, total_bytes) +
+            Share(FLAGS_load_balancer_weight_cpu, load.cpu_usec_per_sec, total_cpu) +
+            Share(FLAGS_load_balancer_weight_sst_size, load.sst_file_size, total_sst_size);
+        ts_load.replicas[entry.first] = replica_load;
+        ts_load.total += replica_load;
+        total_load_ += replica_load;
+      }
+    }
+  }
+
+  // Returns true if no tablet server reported any load.
+  bool empty() const { return total_load_ <= 0; }
+
+  // Mean weighted load of the tablet servers.
+  double mean_load() const {
+    return per_ts_load_.empty() ? 0 : total_load_ / per_ts_load_.size();
+  }
+
+  // Get the weighted load of a certain TS.
+  double GetLoad(const TabletServerId& ts_uuid) const {
+    auto it = per_ts_load_.find(ts_uuid);
+    return it == per_ts_load_.end() ? 0 : it->second.total;
+  }
+
+  // Get the weighted load of the replica of a tablet hosted by a certain TS.
+  double GetReplicaLoad(const TabletServerId& ts_uuid, const TabletId& tablet_id) const {
+    auto it = per_ts_load_.find(ts_uuid);
+    if (it == per_ts_load_.end()) {
+      return 0;
+    }
+    auto replica_it = it->second.replicas.find(tablet_id);
+    return replica_it == it->second.replicas.end() ? 0 : replica_it->second;
+  }
+
+  // Get the load that moves with the leader of a tablet from the leader TS to the follower TS.
+  double GetLeaderMoveLoad(
+      const TabletId& tablet_id, const TabletServerId& leader_ts,
+      const TabletServerId& follower_ts) const {
+    return std::max(
+        0.0, GetReplicaLoad(leader_ts, tablet_id) - GetReplicaLoad(follower_ts, tablet_id));
+  }
+
+  // Updates the model for a leader moved from one TS to another: the replica loads are swapped.
+  void MoveLeader(
+      const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
+    auto& from_load = per_ts_load_[from_ts];
+    auto& to_load = per_ts_load_[to_ts];
+    const double leader_load = from_load.replicas[tablet_id];
+    const double follower_load = to_load.replicas[tablet_id];
+    from_load.replicas[tablet_id] = follower_load;
+    to_load.replicas[tablet_id] = leader_load;
+    from_load.total += follower_load - leader_load;
+    to_load.total += leader_load - follower_load;
+  }
+
+  // Updates the model for a replica moved from one TS to another.
+  void MoveReplica(
+      const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
+    auto& from_load = per_ts_load_[from_ts];
+    auto it = from_load.replicas.find(tablet_id);
+    if (it == from_load.replicas.end()) {
+      return;
+    }
+    const double replica_load = it->second;
+    from_load.replicas.erase(it);
+    from_load.total -= replica_load;
+    auto& to_load = per_ts_load_[to_ts];
+    to_load.replicas[tablet_id] = replica_load;
+    to_load.total += replica_load;
+  }
+
+ private:
+  static double Share(double weight, double value, double total) {
+    return total > 0 ? weight * value / total : 0;
+  }
+
+  struct TabletServerLoad {
+    double total = 0;
+    std::unordered_map<TabletId, double> replicas;
+  };
+
+  std::unordered_map<TabletServerId, TabletServerLoad> per_ts_load_;
+
+  double total_load_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ClusterWeightedLoad);
+};
+
 class ClusterLoadState {
  public:
   ClusterLoadState()
@@ -179,6 +334,12 @@ class ClusterLoadState {
     int load_a = GetLoad(a);
     int load_b = GetLoad(b);
     if (load_a == load_b) {
+      // With the same number of tablets, the tablet server using less resources is less loaded.
+      const double weighted_load_a = GetWeightedLoad(a);
+      const double weighted_load_b = GetWeightedLoad(b);
+      if (weighted_load_a != weighted_load_b) {
+        return weighted_load_a < weighted_load_b;
+      }
       return a < b;
     } else {
       return load_a < load_b;
@@ -208,7 +369,19 @@ class ClusterLoadState {
   struct LeaderLoadComparator {
     explicit LeaderLoadComparator(ClusterLoadState* state) : state_(state) {}
     bool operator()(const TabletServerId& a, const TabletServerId& b) {
-      return state_->GetLeaderLoad(a) < state_->GetLeaderLoad(b);
+      const int a_load = state_->GetLeaderLoad(a);
+      const int b_load = state_->GetLeaderLoad(b);
+      if (a_load != b_load) {
+        return a_load < b_load;
+      }
+      // With the same number of leaders, the tablet server leading fewer hot tablets is less
+      // loaded.
+      const int a_hot_load = state_->GetHotLeaderLoad(a);
+      const int b_hot_load = state_->GetHotLeaderLoad(b);
+      if (a_hot_load != b_hot_load) {
+        return a_hot_load < b_hot_load;
+      }
+      return state_->GetWeightedLoad(a) < state_->GetWeightedLoad(b);
     }
     ClusterLoadState* state_;
   };
@@ -224,6 +397,24 @@ class ClusterLoadState {
     return per_ts_meta_.at(ts_uuid).leaders.size();
   }
 
+  // Get the number of hot tablets led by a certain TS.
+  int GetHotLeaderLoad(const TabletServerId& ts_uuid) const {
+    int result = 0;
+    for (const auto& tablet_id : per_ts_meta_.at(ts_uuid).leaders) {
+      result += hot_tablets_.count(tablet_id);
+    }
+    return result;
+  }
+
+  // Get the weighted load for a certain TS, or 0 if there is no weighted load model.
+  double GetWeightedLoad(const TabletServerId& ts_uuid) const {
+    return weighted_load_ ? weighted_load_->GetLoad(ts_uuid) : 0;
+  }
+
+  bool IsHotTablet(const TabletId& tablet_id) const {
+    return hot_tablets_.count(tablet_id) != 0;
+  }
+
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
   // Update the per-tablet information for this tablet.
@@ -388,6 +579,9 @@ class ClusterLoadState {
       LOG(INFO) << "tablet server " << ts_uuid << " has a pending delete";
       servers_with_pending_deletes_.insert(ts_uuid);
     }
+
+    const auto hot_tablets = ts_desc->hot_tablets();
+    hot_tablets_.insert(hot_tablets.begin(), hot_tablets.end());
   }
 
   bool CanAddTabletToTabletServer(
@@ -629,6 +823,14 @@ class ClusterLoadState {
   // List of tablet ids that have been added to a new tablet server.
   std::set<TabletId> tablets_added_;
 
+  // Tablets reported by their leaders to have a key with a large share of the accesses. Leaders of
+  // such tablets are spread first, since a single one could overload a tablet server.
+  std::set<TabletId> hot_tablets_;
+
+  // Model of the resources used by the tablet servers, shared by all the tables in a run of the
+  // load balancer. Not owned, and could be null if the load is not known.
+  ClusterWeightedLoad* weighted_load_ = nullptr;
+
   // Number of leaders per each tablet server to balance below.
   int leader_balance_threshold_ = 0;
 
@@ -408,6 +408,86 @@ TEST_F(MasterTest, TestRegisterAndHeartbeat) {
   }
 }
 
+TEST_F(MasterTest, TestChunkedFullTabletReport) {
+  const char *kTsUUID = "my-ts-uuid";
+
+  TSToMasterCommonPB common;
+  common.mutable_ts_instance()->set_permanent_uuid(kTsUUID);
+  common.mutable_ts_instance()->set_instance_seqno(1);
+
+  TSRegistrationPB fake_reg;
+  MakeHostPortPB("localhost", 1000, fake_reg.mutable_common()->add_rpc_addresses());
+  MakeHostPortPB("localhost", 2000, fake_reg.mutable_common()->add_http_addresses());
+
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    req.mutable_registration()->CopyFrom(fake_reg);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+    ASSERT_TRUE(resp.needs_full_tablet_report());
+  }
+
+  shared_ptr<TSDescriptor> ts_desc;
+  ASSERT_TRUE(mini_master_->master()->ts_manager()->LookupTSByUUID(kTsUUID, &ts_desc));
+
+  // Sends a tablet report, the full report is split into three chunks, where only the first one
+  // is not incremental.
+  auto send_report = [&](bool is_incremental, int sequence_number, int remaining,
+                         TSHeartbeatResponsePB* resp) {
+    TSHeartbeatRequestPB req;
+    req.mutable_common()->CopyFrom(common);
+    TabletReportPB* tr = req.mutable_tablet_report();
+    tr->set_is_incremental(is_incremental);
+    tr->set_sequence_number(sequence_number);
+    tr->set_remaining_tablet_count(remaining);
+    return proxy_->TSHeartbeat(req, resp, ResetAndGetController());
+  };
+
+  // An incremental report is still rejected before the full report has started.
+  {
+    TSHeartbeatResponsePB resp;
+    ASSERT_OK(send_report(true /* is_incremental */, 0, 0, &resp));
+    ASSERT_TRUE(resp.needs_full_tablet_report());
+    ASSERT_FALSE(ts_desc->has_tablet_report());
+  }
+
+  {
+    TSHeartbeatResponsePB resp;
+    ASSERT_OK(send_report(false /* is_incremental */, 1, 2, &resp));
+    ASSERT_FALSE(resp.needs_full_tablet_report());
+    ASSERT_FALSE(ts_desc->has_tablet_report());
+    ASSERT_TRUE(ts_desc->has_partial_tablet_report());
+  }
+
+  {
+    TSHeartbeatResponsePB resp;
+    ASSERT_OK(send_report(true /* is_incremental */, 2, 1, &resp));
+    ASSERT_FALSE(resp.needs_full_tablet_report());
+    ASSERT_FALSE(ts_desc->has_tablet_report());
+  }
+
+  {
+    TSHeartbeatResponsePB resp;
+    ASSERT_OK(send_report(true /* is_incremental */, 3, 0, &resp));
+    ASSERT_FALSE(resp.needs_full_tablet_report());
+    ASSERT_TRUE(ts_desc->has_tablet_report());
+    ASSERT_FALSE(ts_desc->has_partial_tablet_report());
+  }
+
+  // Re-registering requires a new full report, even if it is interrupted in the middle.
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    common.mutable_ts_instance()->set_instance_seqno(2);
+    req.mutable_common()->CopyFrom(common);
+    req.mutable_registration()->CopyFrom(fake_reg);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+    ASSERT_TRUE(resp.needs_full_tablet_report());
+    ASSERT_FALSE(ts_desc->has_tablet_report());
+  }
+}
+
 Status MasterTest::CreateTable(const NamespaceName& namespace_name,
                                const TableName& table_name,
                                const Schema& schema) {
@@ -651,6 +731,54 @@ TEST_F(MasterTest, TestInvalidGetTableLocations) {
   }
 }
 
+TEST_F(MasterTest, TestWatchTabletLocations) {
+  std::string history_id;
+  {
+    // A client that has not seen any history starts following the current one right away.
+    WatchTabletLocationsRequestPB req;
+    WatchTabletLocationsResponsePB resp;
+    req.set_wait_timeout_ms(60000);
+    ASSERT_OK(proxy_->WatchTabletLocations(req, &resp, ResetAndGetController()));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+    ASSERT_FALSE(resp.history_id().empty());
+    ASSERT_EQ(0, resp.tablet_locations_size());
+    ASSERT_EQ(0, resp.invalidated_tablet_ids_size());
+    ASSERT_FALSE(resp.needs_full_refresh());
+    history_id = resp.history_id();
+  }
+
+  {
+    // Without tablet servers nothing changes, so the watch is held until its wait timeout.
+    WatchTabletLocationsRequestPB req;
+    WatchTabletLocationsResponsePB resp;
+    req.set_history_id(history_id);
+    req.set_since_version(0);
+    req.set_wait_timeout_ms(100);
+    ASSERT_OK(proxy_->WatchTabletLocations(req, &resp, ResetAndGetController()));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+    ASSERT_EQ(history_id, resp.history_id());
+    ASSERT_EQ(0, resp.version());
+    ASSERT_EQ(0, resp.tablet_locations_size());
+  }
+
+  {
+    // A client from another history is switched to the current one and has to refresh all
+    // locations, since changes that happened between the histories are unknown.
+    WatchTabletLocationsRequestPB req;
+    WatchTabletLocationsResponsePB resp;
+    req.set_history_id("unknown");
+    req.set_since_version(10);
+    req.set_wait_timeout_ms(60000);
+    ASSERT_OK(proxy_->WatchTabletLocations(req, &resp, ResetAndGetController()));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_EQ(history_id, resp.history_id());
+    ASSERT_EQ(0, resp.version());
+    ASSERT_TRUE(resp.needs_full_refresh());
+  }
+}
+
 TEST_F(MasterTest, TestInvalidPlacementInfo) {
   const TableName kTableName = "test";
   Schema schema({ColumnSchema("key", INT32)}, 1);
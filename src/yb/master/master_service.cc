@@ -166,6 +166,22 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->set_total_sst_file_size(req->metrics().total_sst_file_size());
     ts_desc->set_write_ops_per_sec(req->metrics().write_ops_per_sec());
     ts_desc->set_read_ops_per_sec(req->metrics().read_ops_per_sec());
+    std::set<TabletId> hot_tablets;
+    for (const auto& hot_tablet : req->metrics().hot_tablets()) {
+      hot_tablets.insert(hot_tablet.tablet_id());
+    }
+    ts_desc->set_hot_tablets(std::move(hot_tablets));
+    auto tablet_loads = std::make_shared<TabletReplicaLoads>();
+    for (const auto& tablet_load_pb : req->metrics().tablet_loads()) {
+      auto& tablet_load = (*tablet_loads)[tablet_load_pb.tablet_id()];
+      tablet_load.read_ops_per_sec = tablet_load_pb.read_ops_per_sec();
+      tablet_load.read_bytes_per_sec = tablet_load_pb.read_bytes_per_sec();
+      tablet_load.write_ops_per_sec = tablet_load_pb.write_ops_per_sec();
+      tablet_load.write_bytes_per_sec = tablet_load_pb.write_bytes_per_sec();
+      tablet_load.cpu_usec_per_sec = tablet_load_pb.cpu_usec_per_sec();
+      tablet_load.sst_file_size = tablet_load_pb.sst_file_size();
+    }
+    ts_desc->set_tablet_loads(std::move(tablet_loads));
   }
 
   if (req->has_tablet_report()) {
@@ -177,7 +193,7 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     }
   }
 
-  if (!ts_desc->has_tablet_report()) {
+  if (!ts_desc->has_tablet_report() && !ts_desc->has_partial_tablet_report()) {
     resp->set_needs_full_tablet_report(true);
   }
 
@@ -219,6 +235,17 @@ void MasterServiceImpl::GetTabletLocations(const GetTabletLocationsRequestPB* re
   rpc.RespondSuccess();
 }
 
+void MasterServiceImpl::WatchTabletLocations(const WatchTabletLocationsRequestPB* req,
+                                             WatchTabletLocationsResponsePB* resp,
+                                             RpcContext rpc) {
+  CatalogManager::ScopedLeaderSharedLock l(server_->catalog_manager());
+  if (!l.CheckIsInitializedAndIsLeaderOrRespond(resp, &rpc)) {
+    return;
+  }
+
+  server_->catalog_manager()->WatchTabletLocations(req, resp, std::move(rpc));
+}
+
 void MasterServiceImpl::CreateTable(const CreateTableRequestPB* req,
                                     CreateTableResponsePB* resp,
                                     RpcContext rpc) {
@@ -55,6 +55,10 @@ class MasterServiceImpl : public MasterServiceIf,
                                   GetTabletLocationsResponsePB* resp,
                                   rpc::RpcContext rpc) override;
 
+  virtual void WatchTabletLocations(const WatchTabletLocationsRequestPB* req,
+                                    WatchTabletLocationsResponsePB* resp,
+                                    rpc::RpcContext rpc) override;
+
   virtual void CreateTable(const CreateTableRequestPB* req,
                            CreateTableResponsePB* resp,
                            rpc::RpcContext rpc) override;
@@ -0,0 +1,242 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/tablet_locations_watcher.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include <glog/logging.h>
+
+#include "yb/common/wire_protocol.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/oid_generator.h"
+
+DEFINE_int32(master_tablet_locations_history_size, 100000,
+             "Number of tablet location changes kept by the leader master for clients watching "
+             "tablet locations. Clients that fall further behind have to refresh all locations.");
+TAG_FLAG(master_tablet_locations_history_size, advanced);
+
+DEFINE_int32(master_tablet_locations_watch_max_wait_ms, 30000,
+             "Maximum time the master holds a WatchTabletLocations request when there are no "
+             "changes to report.");
+TAG_FLAG(master_tablet_locations_watch_max_wait_ms, advanced);
+
+DEFINE_int32(master_tablet_locations_watch_max_tablets, 1000,
+             "Maximum number of tablets reported in a single WatchTabletLocations response.");
+TAG_FLAG(master_tablet_locations_watch_max_tablets, advanced);
+
+namespace yb {
+namespace master {
+
+TabletLocationsWatcher::TabletLocationsWatcher(LocationsProvider locations_provider)
+    : locations_provider_(std::move(locations_provider)),
+      history_id_(ObjectIdGenerator().Next()) {
+  CHECK_OK(ThreadPoolBuilder("tablet-locations-watcher")
+           .set_max_threads(1)
+           .Build(&pool_));
+}
+
+TabletLocationsWatcher::~TabletLocationsWatcher() {
+  Shutdown();
+}
+
+void TabletLocationsWatcher::Reset() {
+  PendingWatches watches;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    history_id_ = ObjectIdGenerator().Next();
+    version_ = 0;
+    changes_.clear();
+    watches.swap(pending_watches_);
+  }
+  Respond(&watches);
+}
+
+void TabletLocationsWatcher::TabletLocationsChanged(const std::vector<TabletId>& tablet_ids) {
+  if (tablet_ids.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& tablet_id : tablet_ids) {
+      changes_.emplace_back(++version_, tablet_id);
+    }
+    const size_t history_size = std::max(FLAGS_master_tablet_locations_history_size, 1);
+    while (changes_.size() > history_size) {
+      changes_.pop_front();
+    }
+    if (shutdown_ || respond_scheduled_ || pending_watches_.empty()) {
+      return;
+    }
+    respond_scheduled_ = true;
+  }
+  Status s = pool_->SubmitFunc(std::bind(&TabletLocationsWatcher::RespondPendingWatches, this));
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to schedule tablet locations watch responses: " << s;
+    RespondPendingWatches();
+  }
+}
+
+void TabletLocationsWatcher::RespondPendingWatches() {
+  PendingWatches watches;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    respond_scheduled_ = false;
+    // Watches that arrived after the changes were recorded have nothing to report yet.
+    auto it = pending_watches_.begin();
+    while (it != pending_watches_.end()) {
+      auto next = std::next(it);
+      if (it->req->history_id() != history_id_ || it->req->since_version() < version_) {
+        watches.splice(watches.end(), pending_watches_, it);
+      }
+      it = next;
+    }
+  }
+  Respond(&watches);
+}
+
+void TabletLocationsWatcher::Watch(const WatchTabletLocationsRequestPB* req,
+                                   WatchTabletLocationsResponsePB* resp,
+                                   rpc::RpcContext context) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shutdown_ && req->history_id() == history_id_ && req->since_version() >= version_) {
+      auto wait_ms = std::min<int64_t>(req->wait_timeout_ms(),
+                                       FLAGS_master_tablet_locations_watch_max_wait_ms);
+      auto deadline = MonoTime::Now() + MonoDelta::FromMilliseconds(wait_ms);
+      pending_watches_.push_back(PendingWatch{req, resp, std::move(context), deadline});
+      return;
+    }
+  }
+
+  FillChanges(*req, resp);
+  context.RespondSuccess();
+}
+
+void TabletLocationsWatcher::ExpireWatches() {
+  PendingWatches expired;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = MonoTime::Now();
+    auto it = pending_watches_.begin();
+    while (it != pending_watches_.end()) {
+      auto next = std::next(it);
+      if (it->deadline.ComesBefore(now)) {
+        expired.splice(expired.end(), pending_watches_, it);
+      }
+      it = next;
+    }
+  }
+  Respond(&expired);
+}
+
+void TabletLocationsWatcher::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  // Waits for the running task, the watches of a queued task are completed below.
+  pool_->Shutdown();
+
+  PendingWatches watches;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    watches.swap(pending_watches_);
+  }
+  Respond(&watches);
+}
+
+bool TabletLocationsWatcher::FillChanges(const WatchTabletLocationsRequestPB& req,
+                                         WatchTabletLocationsResponsePB* resp,
+                                         LocationsCache* cache) {
+  std::vector<TabletId> tablet_ids;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resp->set_history_id(history_id_);
+    resp->set_version(version_);
+
+    if (req.history_id() != history_id_) {
+      // A client that has just started watching follows the current history from now on. A client
+      // that followed another history could have missed changes made between the last change it
+      // saw there and the start of this history, e.g. while the master leader was moving.
+      if (!req.history_id().empty()) {
+        resp->set_needs_full_refresh(true);
+      }
+      return true;
+    }
+
+    if (req.since_version() >= version_) {
+      return false;
+    }
+
+    if (changes_.empty() || req.since_version() + 1 < changes_.front().first) {
+      // Changes that the client has not seen were already dropped from the history.
+      resp->set_needs_full_refresh(true);
+      return true;
+    }
+
+    auto it = std::upper_bound(
+        changes_.begin(), changes_.end(), req.since_version(),
+        [](int64_t version, const std::pair<int64_t, TabletId>& change) {
+      return version < change.first;
+    });
+    std::unordered_set<TabletId> added;
+    const size_t max_tablets = std::max(FLAGS_master_tablet_locations_watch_max_tablets, 1);
+    for (; it != changes_.end(); ++it) {
+      if (added.insert(it->second).second) {
+        if (tablet_ids.size() == max_tablets) {
+          break;
+        }
+        tablet_ids.push_back(it->second);
+      }
+      resp->set_version(it->first);
+    }
+  }
+
+  LocationsCache local_cache;
+  if (!cache) {
+    cache = &local_cache;
+  }
+  for (const auto& tablet_id : tablet_ids) {
+    auto it = cache->find(tablet_id);
+    if (it == cache->end()) {
+      std::unique_ptr<TabletLocationsPB> locations(new TabletLocationsPB());
+      Status s = locations_provider_(tablet_id, locations.get());
+      if (!s.ok()) {
+        VLOG(1) << "Failed to get locations of " << tablet_id << ": " << s;
+        locations.reset();
+      }
+      it = cache->emplace(tablet_id, std::move(locations)).first;
+    }
+    if (it->second) {
+      *resp->add_tablet_locations() = *it->second;
+    } else {
+      resp->add_invalidated_tablet_ids(tablet_id);
+    }
+  }
+
+  return true;
+}
+
+void TabletLocationsWatcher::Respond(PendingWatches* watches) {
+  LocationsCache cache;
+  for (auto& watch : *watches) {
+    FillChanges(*watch.req, watch.resp, &cache);
+    watch.context.RespondSuccess();
+  }
+  watches->clear();
+}
+
+} // namespace master
+} // namespace yb
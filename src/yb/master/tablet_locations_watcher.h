@@ -0,0 +1,125 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_MASTER_TABLET_LOCATIONS_WATCHER_H
+#define YB_MASTER_TABLET_LOCATIONS_WATCHER_H
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/entity_ids.h"
+#include "yb/master/master.pb.h"
+#include "yb/rpc/rpc_context.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+#include "yb/util/threadpool.h"
+
+namespace yb {
+namespace master {
+
+// Keeps a bounded history of tablets whose replica locations or leader have changed, and serves
+// WatchTabletLocations long-poll requests from clients, so that clients can update their meta
+// caches without waiting for an RPC to a moved tablet to fail.
+//
+// Every change gets a version number, which is only meaningful together with the id of the
+// history. A new history is started each time the master becomes the leader.
+//
+// This class is thread-safe.
+class TabletLocationsWatcher {
+ public:
+  // Fills the locations of the given tablet.
+  typedef std::function<Status(const TabletId&, TabletLocationsPB*)> LocationsProvider;
+
+  explicit TabletLocationsWatcher(LocationsProvider locations_provider);
+  ~TabletLocationsWatcher();
+
+  // Drops the history and starts a new one. Pending watches are completed.
+  void Reset();
+
+  // Records that the locations of the given tablets have changed. Pending watches are completed
+  // by the watcher's own thread, so the caller does not wait for the locations to be looked up.
+  void TabletLocationsChanged(const std::vector<TabletId>& tablet_ids);
+
+  // Responds to the request right away if there are changes the client has not seen yet,
+  // otherwise keeps it until the first change or until its wait timeout expires.
+  void Watch(const WatchTabletLocationsRequestPB* req,
+             WatchTabletLocationsResponsePB* resp,
+             rpc::RpcContext context);
+
+  // Completes the pending watches whose wait timeout has expired.
+  void ExpireWatches();
+
+  // Completes all pending watches.
+  void Shutdown();
+
+  // Locations looked up while completing a batch of watches, so each tablet is looked up once
+  // no matter how many watches report it. Tablets whose lookup failed are mapped to nullptr.
+  typedef std::unordered_map<TabletId, std::unique_ptr<TabletLocationsPB>> LocationsCache;
+
+  // Fills 'resp' with the changes newer than those requested. Returns false if the client is
+  // up to date. Asks the client for a full refresh when the changes it has not seen are no longer
+  // known, i.e. they were dropped from the history or belong to another history.
+  bool FillChanges(const WatchTabletLocationsRequestPB& req, WatchTabletLocationsResponsePB* resp,
+                   LocationsCache* cache = nullptr);
+
+ private:
+  struct PendingWatch {
+    const WatchTabletLocationsRequestPB* req;
+    WatchTabletLocationsResponsePB* resp;
+    rpc::RpcContext context;
+    MonoTime deadline;
+  };
+
+  typedef std::list<PendingWatch> PendingWatches;
+
+  void Respond(PendingWatches* watches);
+
+  // Completes the watches that were pending when the task was scheduled, runs on 'pool_'.
+  void RespondPendingWatches();
+
+  const LocationsProvider locations_provider_;
+
+  // Single thread that completes the watches woken up by location changes.
+  std::unique_ptr<ThreadPool> pool_;
+
+  std::mutex mutex_;
+
+  std::string history_id_;
+
+  // Version of the latest change.
+  int64_t version_ = 0;
+
+  // Changed tablets, ordered by version.
+  std::deque<std::pair<int64_t, TabletId>> changes_;
+
+  PendingWatches pending_watches_;
+
+  // Whether RespondPendingWatches() is already queued, so a burst of changes is reported by a
+  // single task.
+  bool respond_scheduled_ = false;
+
+  bool shutdown_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(TabletLocationsWatcher);
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_TABLET_LOCATIONS_WATCHER_H
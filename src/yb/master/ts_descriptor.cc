@@ -62,6 +62,7 @@ TSDescriptor::TSDescriptor(std::string perm_id)
       latest_seqno_(-1),
       last_heartbeat_(MonoTime::Now()),
       has_tablet_report_(false),
+      has_partial_tablet_report_(false),
       recent_replica_creations_(0),
       last_replica_creations_decay_(MonoTime::Now()),
       num_live_replicas_(0) {
@@ -91,6 +92,7 @@ Status TSDescriptor::Register(const NodeInstancePB& instance,
   latest_seqno_ = instance.instance_seqno();
   // After re-registering, make the TS re-report its tablets.
   has_tablet_report_ = false;
+  has_partial_tablet_report_ = false;
 
   registration_.reset(new TSRegistrationPB(registration));
   placement_id_ = generate_placement_id(registration.common().cloud_info());
@@ -134,6 +136,18 @@ bool TSDescriptor::has_tablet_report() const {
 void TSDescriptor::set_has_tablet_report(bool has_report) {
   std::lock_guard<simple_spinlock> l(lock_);
   has_tablet_report_ = has_report;
+  has_partial_tablet_report_ = false;
+}
+
+bool TSDescriptor::has_partial_tablet_report() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return has_partial_tablet_report_;
+}
+
+void TSDescriptor::set_has_partial_tablet_report() {
+  std::lock_guard<simple_spinlock> l(lock_);
+  has_tablet_report_ = false;
+  has_partial_tablet_report_ = true;
 }
 
 void TSDescriptor::DecayRecentReplicaCreationsUnlocked() {
@@ -34,8 +34,11 @@
 
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
+#include <unordered_map>
 
+#include "yb/common/entity_ids.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/tserver/tserver_service.proxy.h"
 #include "yb/util/locks.h"
@@ -65,6 +68,18 @@ typedef util::SharedPtrTuple<tserver::TabletServerAdminServiceProxy,
                              tserver::TabletServerServiceProxy,
                              consensus::ConsensusServiceProxy> ProxyTuple;
 
+// Load of a tablet replica, as reported by the tablet server hosting it.
+struct TabletReplicaLoad {
+  double read_ops_per_sec = 0;
+  double read_bytes_per_sec = 0;
+  double write_ops_per_sec = 0;
+  double write_bytes_per_sec = 0;
+  double cpu_usec_per_sec = 0;
+  uint64_t sst_file_size = 0;
+};
+
+typedef std::unordered_map<TabletId, TabletReplicaLoad> TabletReplicaLoads;
+
 // Master-side view of a single tablet server.
 //
 // Tracks the last heartbeat, status, instance identifier, etc.
@@ -96,6 +111,10 @@ class TSDescriptor {
   bool has_tablet_report() const;
   void set_has_tablet_report(bool has_report);
 
+  // Whether the first chunks of a full tablet report were received, but not its last one.
+  bool has_partial_tablet_report() const;
+  void set_has_partial_tablet_report();
+
   // Copy the current registration info into the given PB object.
   // A safe copy is returned because the internal Registration object
   // may be mutated at any point if the tablet server re-registers.
@@ -187,6 +206,28 @@ class TSDescriptor {
     return tsMetrics_.write_ops_per_sec;
   }
 
+  // Tablets led by this tserver, that have a key with a large share of the accesses.
+  void set_hot_tablets(std::set<TabletId> hot_tablets) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.hot_tablets = std::move(hot_tablets);
+  }
+
+  std::set<TabletId> hot_tablets() {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return tsMetrics_.hot_tablets;
+  }
+
+  // Loads of the tablet replicas hosted by this tserver, from the latest metrics report.
+  void set_tablet_loads(std::shared_ptr<const TabletReplicaLoads> tablet_loads) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.tablet_loads = std::move(tablet_loads);
+  }
+
+  std::shared_ptr<const TabletReplicaLoads> tablet_loads() {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return tsMetrics_.tablet_loads;
+  }
+
   void ClearMetrics() {
     tsMetrics_.ClearMetrics();
   }
@@ -239,11 +280,17 @@ class TSDescriptor {
 
     double write_ops_per_sec = 0;
 
+    std::set<TabletId> hot_tablets;
+
+    std::shared_ptr<const TabletReplicaLoads> tablet_loads;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
+      hot_tablets.clear();
+      tablet_loads.reset();
     }
   };
 
@@ -258,6 +305,9 @@ class TSDescriptor {
   // Set to true once this instance has reported all of its tablets.
   bool has_tablet_report_;
 
+  // Set to true while the full tablet report is received in chunks, until its last chunk.
+  bool has_partial_tablet_report_;
+
   // The number of times this tablet server has recently been selected to create a
   // tablet replica. This value decays back to 0 over time.
   double recent_replica_creations_;
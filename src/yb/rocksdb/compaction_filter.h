@@ -146,6 +146,13 @@ class CompactionFilterFactory {
 
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
+
+  // Subcompactions process disjoint key ranges with separate compaction filters. Filters that
+  // keep state between keys could return a prefix of the proposed range boundary here, so that
+  // all keys sharing this prefix are processed by the same filter.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) const {
+    return user_key;
+  }
 };
 
 }  // namespace rocksdb
@@ -799,6 +799,12 @@ class DB {
     return Status::OK();
   }
 
+  // Same as SetFlushedFrontier, but allows the frontier to go backwards. Used for a DB created
+  // from a checkpoint of another DB, whose flushed frontier does not make sense for the new one.
+  virtual CHECKED_STATUS ResetFlushedFrontier(UserFrontierPtr values) {
+    return Status::OK();
+  }
+
   // Obtains the meta data of the specified column family of the DB.
   // STATUS(NotFound, "") will be returned if the current DB does not have
   // any column family match the specified name.
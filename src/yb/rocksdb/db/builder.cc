@@ -50,6 +50,14 @@ namespace rocksdb {
 
 class TableFactory;
 
+CompressionOptions GetCompressionOptions(const ImmutableCFOptions& ioptions, bool bottommost) {
+  CompressionOptions result = ioptions.compression_opts;
+  if (!bottommost) {
+    result.max_dict_bytes = 0;
+  }
+  return result;
+}
+
 TableBuilder* NewTableBuilder(const ImmutableCFOptions& ioptions,
                               const InternalKeyComparatorPtr& internal_comparator,
                               const IntTblPropCollectorFactories& int_tbl_prop_collector_factories,
@@ -70,6 +70,10 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               const CompressionOptions& compression_opts,
                               const bool skip_filters = false);
 
+// Returns the compression options to use for a new table file. Compression dictionaries are only
+// built for files written to the bottommost level, see ColumnFamilyOptions::bottommost_compression.
+CompressionOptions GetCompressionOptions(const ImmutableCFOptions& ioptions, bool bottommost);
+
 // Build a Table file from the contents of *iter.  The generated file
 // will be named according to number specified in meta. On success, the rest of
 // *meta will be filled with metadata about the generated table.
@@ -136,6 +136,13 @@ Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options) {
           " is not linked with the binary.");
     }
   }
+  if (cf_options.bottommost_compression != kDisableCompressionOption &&
+      !CompressionTypeSupported(cf_options.bottommost_compression)) {
+    return STATUS(InvalidArgument,
+        "Compression type " +
+        CompressionTypeToString(cf_options.bottommost_compression) +
+        " is not linked with the binary.");
+  }
   return Status::OK();
 }
 
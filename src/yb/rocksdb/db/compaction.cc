@@ -504,7 +504,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level, files written by sub-compactions stay in level 0. Their sequence number
+    // ranges overlap, so UniversalCompactionPicker treats them as a single sorted run.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
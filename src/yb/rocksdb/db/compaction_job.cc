@@ -439,9 +439,15 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
+  uint64_t max_file_size = cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl);
+  if (max_file_size == std::numeric_limits<uint64_t>::max()) {
+    // Universal compaction writes a single file to level 0, so limit the number of
+    // subcompactions by their minimal size instead.
+    max_file_size = std::max<uint64_t>(
+        cfd->ioptions()->compaction_options_universal.min_subcompaction_size, 1);
+  }
   uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+      sum / min_file_fill_percent / max_file_size));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -451,6 +457,12 @@ void CompactionJob::GenSubcompactionBoundaries() {
                                     : std::numeric_limits<double>::max();
 
   if (subcompactions > 1) {
+    // Compaction filters that keep state between keys could require related keys to be processed
+    // by the same subcompaction.
+    CompactionFilterFactory* compaction_filter_factory =
+        cfd->ioptions()->compaction_filter == nullptr
+            ? cfd->ioptions()->compaction_filter_factory : nullptr;
+
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
     sum = 0;
@@ -462,7 +474,15 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (compaction_filter_factory != nullptr) {
+          boundary = compaction_filter_factory->SubcompactionBoundary(boundary);
+        }
+        // Moving a boundary could make it equal to the previous one, just merge such ranges.
+        if (!boundaries_.empty() && cfd_comparator->Compare(boundaries_.back(), boundary) >= 0) {
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -1060,7 +1080,8 @@ Status CompactionJob::OpenCompactionOutputFile(
       *cfd->ioptions(), cfd->internal_comparator(),
       cfd->int_tbl_prop_collector_factories(), cfd->GetID(),
       sub_compact->base_outfile.get(), sub_compact->data_outfile.get(),
-      sub_compact->compaction->output_compression(), cfd->ioptions()->compression_opts,
+      sub_compact->compaction->output_compression(),
+      GetCompressionOptions(*cfd->ioptions(), bottommost_level_),
       skip_filters));
   LogFlush(db_options_.info_log);
   return s;
@@ -1033,6 +1033,101 @@ TEST_P(CompactionJobStatsTest, UniversalCompactionTest) {
   ASSERT_EQ(stats_checker->NumberOfUnverifiedStats(), 0U);
 }
 
+namespace {
+
+class CompactionElapsedTimeListener : public EventListener {
+ public:
+  void OnCompactionCompleted(DB* db, const CompactionJobInfo& ci) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    elapsed_micros_ += ci.stats.elapsed_micros;
+  }
+
+  uint64_t elapsed_micros() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return elapsed_micros_;
+  }
+
+ private:
+  std::mutex mutex_;
+  uint64_t elapsed_micros_ = 0;
+};
+
+}  // namespace
+
+// Checks that a single level universal compaction is split into key range subcompactions, whose
+// outputs form a single sorted run, and compares the compaction wall time with and without them.
+TEST_P(CompactionJobStatsTest, UniversalSubcompactionTest) {
+  Random rnd(301);
+  const uint64_t kKeyBase = 100000000l;
+  const int kNumKeysPerTable = 500;
+  const uint64_t kKeyInterval = kKeyBase / kNumKeysPerTable;
+  const int kNumTables = 8;
+  const int kKeySize = 10;
+  const int kValueSize = 900;
+  const uint32_t kMaxSubcompactions = 4;
+
+  uint64_t elapsed_micros[2];
+  for (uint32_t max_subcompactions : {1U, kMaxSubcompactions}) {
+    auto* listener = new CompactionElapsedTimeListener();
+    Options options;
+    options.listeners.emplace_back(listener);
+    options.create_if_missing = true;
+    options.num_levels = 1;
+    options.compression = kNoCompression;
+    options.level0_file_num_compaction_trigger = kNumTables + 1;
+    options.compaction_style = kCompactionStyleUniversal;
+    options.compaction_options_universal.min_subcompaction_size = 64 * 1024;
+    options.max_subcompactions = max_subcompactions;
+    DestroyAndReopen(options);
+
+    // Each table covers its own key range, so that there are enough boundaries to split on.
+    for (int i = 0; i < kNumTables; ++i) {
+      const uint64_t start_key = kKeyBase * (i + 1);
+      MakeTableWithKeyValues(
+          &rnd, start_key, start_key + kKeyBase, kKeySize, kValueSize, kKeyInterval, 1.0);
+    }
+    ASSERT_EQ(kNumTables, NumTableFilesAtLevel(0));
+
+    Compact(Key(kKeyBase, kKeySize), Key(kKeyBase * (kNumTables + 1), kKeySize));
+    elapsed_micros[max_subcompactions == 1 ? 0 : 1] = listener->elapsed_micros();
+
+    ColumnFamilyMetaData metadata;
+    db_->GetColumnFamilyMetaData(&metadata);
+    const auto& files = metadata.levels[0].files;
+    if (max_subcompactions == 1) {
+      ASSERT_EQ(1U, files.size());
+    } else {
+      ASSERT_GT(files.size(), 1U);
+      ASSERT_LE(files.size(), max_subcompactions);
+      // Outputs of subcompactions cover disjoint key ranges.
+      std::vector<std::pair<std::string, std::string>> ranges;
+      for (const auto& file : files) {
+        ranges.emplace_back(file.smallest.key, file.largest.key);
+      }
+      std::sort(ranges.begin(), ranges.end());
+      for (size_t i = 1; i < ranges.size(); ++i) {
+        ASSERT_LT(ranges[i - 1].second, ranges[i].first);
+      }
+    }
+
+    // Subcompaction outputs should be picked as a single sorted run, so the next compaction
+    // should not pick them apart.
+    ASSERT_OK(Put(Key(kKeyBase, kKeySize), "new_value"));
+    ASSERT_OK(Flush());
+    Compact(Key(kKeyBase, kKeySize), Key(kKeyBase * (kNumTables + 1), kKeySize));
+    ASSERT_EQ("new_value", Get(Key(kKeyBase, kKeySize)));
+    for (int i = 0; i < kNumTables; ++i) {
+      const uint64_t key = kKeyBase * (i + 1) + kKeyInterval;
+      ASSERT_EQ(static_cast<size_t>(kValueSize), Get(Key(key, kKeySize)).size());
+    }
+  }
+
+  // Timing depends on the machine, so the comparison is only logged.
+  LOG(INFO) << "Universal compaction time without subcompactions: " << elapsed_micros[0]
+            << "us, with up to " << kMaxSubcompactions << " subcompactions: "
+            << elapsed_micros[1] << "us";
+}
+
 INSTANTIATE_TEST_CASE_P(CompactionJobStatsTest, CompactionJobStatsTest,
                         ::testing::Values(1, 4));
 }  // namespace rocksdb
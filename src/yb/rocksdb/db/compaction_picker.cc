@@ -132,11 +132,15 @@ SmallestKeyHeap create_level_heap(Compaction* c, const Comparator* ucmp) {
 // Otherwise, the compression type is determined based on options and level.
 CompressionType GetCompressionType(const ImmutableCFOptions& ioptions,
                                    int level, int base_level,
-                                   const bool enable_compression) {
+                                   const bool enable_compression,
+                                   const bool bottommost) {
   if (!enable_compression) {
     // disable compression
     return kNoCompression;
   }
+  if (bottommost && ioptions.bottommost_compression != kDisableCompressionOption) {
+    return ioptions.bottommost_compression;
+  }
   // If the use has specified a different compression level for each level,
   // then pick the compression for that level.
   if (!ioptions.compression_per_level.empty()) {
@@ -515,7 +519,8 @@ Compaction* CompactionPicker::CompactRange(
         vstorage, mutable_cf_options, std::move(inputs), output_level,
         mutable_cf_options.MaxFileSizeForLevel(output_level),
         /* max_grandparent_overlap_bytes */ LLONG_MAX, output_path_id,
-        GetCompressionType(ioptions_, output_level, 1),
+        GetCompressionType(ioptions_, output_level, 1, /* enable_compression */ true,
+                           /* bottommost */ true),
         /* grandparents */ {}, /* is manual */ true);
     if (start_level == 0) {
       level0_compactions_in_progress_.insert(c);
@@ -616,7 +621,9 @@ Compaction* CompactionPicker::CompactRange(
       mutable_cf_options.MaxFileSizeForLevel(output_level),
       mutable_cf_options.MaxGrandParentOverlapBytes(input_level),
       output_path_id,
-      GetCompressionType(ioptions_, output_level, vstorage->base_level()),
+      GetCompressionType(ioptions_, output_level, vstorage->base_level(),
+                         /* enable_compression */ true,
+                         /* bottommost */ output_level == vstorage->num_levels() - 1),
       std::move(grandparents), /* is manual compaction */ true);
 
   TEST_SYNC_POINT_CALLBACK("CompactionPicker::CompactRange:Return", compaction);
@@ -1171,10 +1178,29 @@ struct UniversalCompactionPicker::SortedRun {
   void DumpSizeInfo(char* out_buf, size_t out_buf_size,
                     size_t sorted_run_count) const;
 
+  // Adds a level 0 file written by the same compaction as the other files of this sorted run.
+  void AddLevel0File(FileMetaData* f) {
+    assert(level == 0);
+    level0_files.push_back(f);
+    size += f->fd.GetTotalFileSize();
+    compensated_file_size += f->compensated_file_size;
+    being_compacted = being_compacted || f->being_compacted;
+  }
+
+  // Adds files of this sorted run to the compaction inputs.
+  void AppendLevel0Files(std::vector<FileMetaData*>* files) const {
+    assert(level == 0);
+    files->push_back(file);
+    files->insert(files->end(), level0_files.begin(), level0_files.end());
+  }
+
   int level;
   // `file` Will be null for level > 0. For level = 0, the sorted run is
   // for this file.
   FileMetaData* file;
+  // Other level 0 files of the sorted run. Subcompactions write several level 0 files with
+  // disjoint key ranges and overlapping sequence number ranges, that should be compacted together.
+  std::vector<FileMetaData*> level0_files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1209,8 +1235,7 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             file->fd.GetNumber(), sorted_run_count, size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1225,10 +1250,23 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
-  for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
-          f->being_compacted);
+  const auto& level0_files = vstorage.LevelFiles(0);
+  for (size_t i = 0; i != level0_files.size();) {
+    FileMetaData* f = level0_files[i];
+    SortedRun sorted_run(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
+                         f->being_compacted);
+    bool too_large = f->fd.GetTotalFileSize() > max_file_size;
+    // Level 0 files are sorted from newest to oldest, so files written by subcompactions of the
+    // same compaction follow each other.
+    SequenceNumber smallest_seqno = f->smallest.seqno;
+    for (++i; i != level0_files.size() && level0_files[i]->largest.seqno >= smallest_seqno; ++i) {
+      f = level0_files[i];
+      sorted_run.AddLevel0File(f);
+      too_large = too_large || f->fd.GetTotalFileSize() > max_file_size;
+      smallest_seqno = std::min(smallest_seqno, f->smallest.seqno);
+    }
+    if (!too_large) {
+      ret.back().push_back(std::move(sorted_run));
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
@@ -1457,10 +1495,13 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
+        prev_smallest_seqno = f->smallest.seqno;
+      } else if (prev_smallest_seqno > f->largest.seqno) {
+        prev_smallest_seqno = f->smallest.seqno;
       } else {
-        DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
+        // Files written by subcompactions of the same compaction.
+        prev_smallest_seqno = std::min(prev_smallest_seqno, f->smallest.seqno);
       }
-      prev_smallest_seqno = f->smallest.seqno;
     }
     level_index = 1U;
   }
@@ -1688,8 +1729,7 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      picking_sr.AppendLevel0Files(&inputs[0].files);
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1711,7 +1751,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   return new Compaction(
       vstorage, mutable_cf_options, std::move(inputs), output_level,
       mutable_cf_options.MaxFileSizeForLevel(output_level), LLONG_MAX, path_id,
-      GetCompressionType(ioptions_, start_level, 1, enable_compression),
+      GetCompressionType(ioptions_, start_level, 1, enable_compression,
+                         /* bottommost */ first_index_after == sorted_runs.size()),
       /* grandparents */ {}, /* is manual */ false, score,
       false /* deletion_compaction */, compaction_reason);
 }
@@ -1814,8 +1855,7 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      picking_sr.AppendLevel0Files(&inputs[0].files);
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1833,7 +1873,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
       vstorage->num_levels() - 1,
       mutable_cf_options.MaxFileSizeForLevel(vstorage->num_levels() - 1),
       /* max_grandparent_overlap_bytes */ LLONG_MAX, path_id,
-      GetCompressionType(ioptions_, vstorage->num_levels() - 1, 1),
+      GetCompressionType(ioptions_, vstorage->num_levels() - 1, 1, /* enable_compression */ true,
+                         /* bottommost */ true),
       /* grandparents */ {}, /* is manual */ false, score,
       false /* deletion_compaction */,
       CompactionReason::kUniversalSizeAmplification);
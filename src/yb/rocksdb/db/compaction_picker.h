@@ -361,9 +361,12 @@ bool HaveOverlappingKeyRanges(const Comparator* c,
                               const SstFileMetaData& a,
                               const SstFileMetaData& b);
 
+// bottommost should be true if the compaction output has no older data for its keys, see
+// ColumnFamilyOptions::bottommost_compression.
 CompressionType GetCompressionType(const ImmutableCFOptions& ioptions,
                                    int level, int base_level,
-                                   const bool enable_compression = true);
+                                   const bool enable_compression = true,
+                                   const bool bottommost = false);
 
 }  // namespace rocksdb
 
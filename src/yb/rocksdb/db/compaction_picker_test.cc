@@ -474,6 +474,56 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+// Level 0 files written by subcompactions of one universal compaction have disjoint key ranges
+// and overlapping sequence number ranges. They should be counted and picked as one sorted run.
+TEST_F(CompactionPickerTest, UniversalSubcompactionOutputsFormOneSortedRun) {
+  const uint64_t kFileSize = 100000;
+
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  // Outputs of subcompactions. Taken separately, the first one would be small enough to be merged
+  // with the newer files, while the others would not.
+  Add(0, 1U, "100", "199", kFileSize, 0, 10, 300);
+  Add(0, 2U, "200", "299", kFileSize * 10, 0, 12, 299);
+  Add(0, 3U, "300", "399", kFileSize * 10, 0, 11, 298);
+  // A newer flushed file.
+  Add(0, 4U, "150", "250", kFileSize, 0, 301, 350);
+  UpdateVersionStorageInfo();
+
+  // Two sorted runs do not reach the compaction trigger, while four separate files would.
+  ASSERT_EQ(4, mutable_cf_options_.level0_file_num_compaction_trigger);
+  ASSERT_LT(vstorage_->CompactionScore(0), 1);
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 1U, "100", "199", kFileSize, 0, 10, 300);
+  Add(0, 2U, "200", "299", kFileSize * 10, 0, 12, 299);
+  Add(0, 3U, "300", "399", kFileSize * 10, 0, 11, 298);
+  Add(0, 4U, "150", "250", kFileSize, 0, 301, 350);
+  Add(0, 5U, "150", "250", kFileSize, 0, 351, 400);
+  Add(0, 6U, "150", "250", kFileSize, 0, 401, 450);
+  UpdateVersionStorageInfo();
+
+  // Four sorted runs reach the trigger.
+  ASSERT_GE(vstorage_->CompactionScore(0), 1);
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // The subcompaction outputs are much larger than the newer files together, so only the newer
+  // files are picked, and none of the subcompaction outputs are picked apart from the others.
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  std::vector<uint64_t> input_file_numbers;
+  for (size_t i = 0; i != compaction->num_input_files(0); ++i) {
+    input_file_numbers.push_back(compaction->input(0, i)->fd.GetNumber());
+  }
+  std::sort(input_file_numbers.begin(), input_file_numbers.end());
+  ASSERT_EQ(std::vector<uint64_t>({4U, 5U, 6U}), input_file_numbers);
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
@@ -115,8 +115,11 @@
 #include "yb/rocksdb/util/thread_status_util.h"
 #include "yb/rocksdb/util/xfunc.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/fault_injection.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_bool(dump_dbimpl_info, false, "Dump RocksDB info during constructor.");
 DEFINE_bool(flush_rocksdb_on_shutdown, true,
@@ -208,6 +211,11 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   }
 
+  if (result.use_direct_io_for_flush_and_compaction && result.compaction_readahead_size == 0) {
+    // OS does not read ahead for direct I/O, so compaction inputs are read ahead explicitly.
+    result.compaction_readahead_size = 2 * 1024 * 1024;
+  }
+
   if (result.compaction_readahead_size > 0) {
     result.new_table_reader_for_compaction_inputs = true;
   }
@@ -307,6 +315,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(
+          env_->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -379,6 +389,10 @@ DBImpl::~DBImpl() {
   // marker. After this we do a variant of the waiting and unschedule work
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
   CancelAllBackgroundWork(false);
+  if (db_options_.priority_thread_pool_for_compactions != nullptr) {
+    // Aborted compactions are accounted in bg_compaction_scheduled_ by the aborted tasks.
+    db_options_.priority_thread_pool_for_compactions->Remove(this);
+  }
   int compactions_unscheduled = env_->UnSchedule(this, Env::Priority::LOW);
   int flushes_unscheduled = env_->UnSchedule(this, Env::Priority::HIGH);
   mutex_.Lock();
@@ -1494,7 +1508,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
       s = BuildTable(dbname_,
                      env_,
                      *cfd->ioptions(),
-                     env_options_,
+                     env_options_for_compaction_,
                      cfd->table_cache(),
                      iter.get(),
                      &meta,
@@ -1504,7 +1518,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                      snapshot_seqs,
                      earliest_write_conflict_snapshot,
                      GetCompressionFlush(*cfd->ioptions()),
-                     cfd->ioptions()->compression_opts,
+                     GetCompressionOptions(*cfd->ioptions(), /* bottommost */ false),
                      paranoid_file_checks,
                      cfd->internal_stats(),
                      db_options_.boundary_extractor.get(),
@@ -1569,7 +1583,7 @@ Status DBImpl::FlushMemTableToOutputFile(
   }
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options, env_options_for_compaction_,
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, mem_table_flush_filter,
       job_context, log_buffer, directories_.GetDbDir(), directories_.GetDataDir(0U),
@@ -1954,7 +1968,7 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, table_cache_,
@@ -2501,8 +2515,7 @@ Status DBImpl::RunManualCompaction(ColumnFamilyData* cfd, int input_level,
       ca->m = &manual;
       manual.incomplete = false;
       bg_compaction_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                     &DBImpl::UnscheduleCallback);
+      ScheduleCompaction(ca);
       scheduled = true;
     }
   }
@@ -2647,9 +2660,77 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
-    env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                   &DBImpl::UnscheduleCallback);
+    ScheduleCompaction(ca);
+  }
+}
+
+void DBImpl::ScheduleCompaction(CompactionArg* ca) {
+  mutex_.AssertHeld();
+  auto* pool = db_options_.priority_thread_pool_for_compactions;
+  if (pool != nullptr) {
+    auto priority = CompactionPriority(ca->m != nullptr ? ca->m->compaction : nullptr);
+    auto status = pool->Submit(priority, this, [ca](const Status& status) {
+      if (status.ok()) {
+        BGWorkCompaction(ca);
+        return;
+      }
+      // The compaction was removed from the pool without running.
+      DBImpl* db = ca->db;
+      ManualCompaction* m = ca->m;
+      delete ca;
+      InstrumentedMutexLock lock(&db->mutex_);
+      if (m != nullptr) {
+        // RunManualCompaction waits for this compaction, so complete it with the abort status.
+        if (m->compaction != nullptr) {
+          m->compaction->ReleaseCompactionFiles(status);
+          delete m->compaction;
+          m->compaction = nullptr;
+        }
+        m->status = status;
+        m->done = true;
+        m->in_progress = false;
+      } else {
+        // The column family is still in the compaction queue, let it be picked up again.
+        db->unscheduled_compactions_++;
+      }
+      db->bg_compaction_scheduled_--;
+      db->MaybeScheduleFlushOrCompaction();
+      db->bg_cv_.SignalAll();
+    });
+    if (status.ok()) {
+      return;
+    }
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+        "Failed to schedule compaction in %s, falling back to the LOW priority pool: %s",
+        pool->name().c_str(), status.ToString().c_str());
   }
+  env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
+                 &DBImpl::UnscheduleCallback);
+}
+
+int64_t DBImpl::CompactionPriority(const Compaction* manual_compaction) {
+  mutex_.AssertHeld();
+  int64_t read_amplification = 0;
+  double score_per_gb = 0;
+  constexpr double kGB = 1ULL << 30;
+  auto update = [&read_amplification, &score_per_gb](const Compaction* c) {
+    const auto* vstorage = c->input_version()->storage_info();
+    read_amplification = std::max<int64_t>(
+        read_amplification, vstorage->NumLevelFiles(0) + vstorage->num_non_empty_levels() - 1);
+    score_per_gb = std::max(
+        score_per_gb, c->score() * kGB / std::max<uint64_t>(c->CalculateTotalInputSize(), 1));
+  };
+  if (manual_compaction != nullptr) {
+    update(manual_compaction);
+  }
+  for (const auto* queue : {&small_compaction_queue_, &large_compaction_queue_}) {
+    for (const auto* c : *queue) {
+      update(c);
+    }
+  }
+  constexpr double kMaxScorePerGb = std::numeric_limits<uint32_t>::max();
+  return (read_amplification << 32) +
+         static_cast<int64_t>(std::min(score_per_gb, kMaxScorePerGb));
 }
 
 int DBImpl::BGCompactionsAllowed() const {
@@ -2768,6 +2849,7 @@ void DBImpl::UnscheduleCallback(void* arg) {
   delete reinterpret_cast<CompactionArg*>(arg);
   if ((ca.m != nullptr) && (ca.m->compaction != nullptr)) {
     delete ca.m->compaction;
+    ca.m->compaction = nullptr;
   }
   TEST_SYNC_POINT("DBImpl::UnscheduleCallback");
 }
@@ -3188,7 +3270,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -4373,6 +4455,56 @@ Status DBImpl::WriteWithCallback(const WriteOptions& write_options,
 }
 #endif  // ROCKSDB_LITE
 
+bool DBImpl::ShouldInsertIntoMemTableConcurrently(const WriteBatch& batch) const {
+  if (!db_options_.allow_concurrent_memtable_write ||
+      db_options_.memtable_insert_thread_pool == nullptr ||
+      db_options_.memtable_insert_max_threads < 2) {
+    return false;
+  }
+  const size_t min_entries =
+      std::max<size_t>(db_options_.memtable_insert_min_entries_per_thread, 1);
+  return WriteBatchInternal::Count(&batch) >= 2 * min_entries && !batch.HasMerge();
+}
+
+Status DBImpl::InsertIntoMemTableConcurrently(
+    const WriteOptions& write_options, WriteBatch* batch, SequenceNumber sequence) {
+  const size_t min_entries =
+      std::max<size_t>(db_options_.memtable_insert_min_entries_per_thread, 1);
+  const size_t num_parts = std::min(
+      db_options_.memtable_insert_max_threads, WriteBatchInternal::Count(batch) / min_entries);
+  WriteBatchInternal::SetSequence(batch, sequence);
+  std::vector<WriteBatch> parts;
+  RETURN_NOT_OK(WriteBatchInternal::Split(batch, num_parts, &parts));
+
+  std::vector<Status> statuses(parts.size());
+  auto insert_part = [this, &write_options, &parts, &statuses](size_t idx) {
+    // ColumnFamilyMemTablesImpl caches the current column family, so each thread needs its own.
+    ColumnFamilyMemTablesImpl column_family_memtables(versions_->GetColumnFamilySet());
+    statuses[idx] = WriteBatchInternal::InsertInto(
+        &parts[idx], &column_family_memtables, &flush_scheduler_,
+        write_options.ignore_missing_column_families, 0 /* log_number */, this,
+        true /* dont_filter_deletes */, true /* concurrent_memtable_writes */);
+  };
+
+  yb::CountDownLatch latch(static_cast<int>(parts.size() - 1));
+  for (size_t idx = 1; idx < parts.size(); ++idx) {
+    auto task = [&insert_part, &latch, idx] {
+      insert_part(idx);
+      latch.CountDown();
+    };
+    if (!db_options_.memtable_insert_thread_pool->SubmitFunc(task).ok()) {
+      task();
+    }
+  }
+  insert_part(0);
+  latch.Wait();
+
+  for (const auto& status : statuses) {
+    RETURN_NOT_OK(status);
+  }
+  return Status::OK();
+}
+
 Status DBImpl::WriteImpl(const WriteOptions& write_options,
                          WriteBatch* my_batch, WriteCallback* callback) {
 
@@ -4717,7 +4849,13 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         }
       }
 
-      if (!parallel) {
+      if (!parallel && write_group.size() == 1 && !w.CallbackFailed() &&
+          ShouldInsertIntoMemTableConcurrently(*w.batch)) {
+        // A single large batch, e.g. a big DocDB write, is split into parts that are inserted by
+        // this thread and by threads of memtable_insert_thread_pool.
+        w.status = InsertIntoMemTableConcurrently(write_options, w.batch, current_sequence);
+        status = w.FinalStatus();
+      } else if (!parallel) {
         status = WriteBatchInternal::InsertInto(
             write_group, current_sequence, column_family_memtables_.get(),
             &flush_scheduler_, write_options.ignore_missing_column_families,
@@ -5490,6 +5628,12 @@ Status DBImpl::SetFlushedFrontier(UserFrontierPtr frontier) {
   return ApplyVersionEdit(&edit);
 }
 
+Status DBImpl::ResetFlushedFrontier(UserFrontierPtr frontier) {
+  VersionEdit edit;
+  edit.SetFlushedFrontier(std::move(frontier), /* force = */ true);
+  return ApplyVersionEdit(&edit);
+}
+
 void DBImpl::GetColumnFamilyMetaData(
     ColumnFamilyHandle* column_family,
     ColumnFamilyMetaData* cf_meta) {
@@ -215,6 +215,8 @@ class DBImpl : public DB {
 
   CHECKED_STATUS SetFlushedFrontier(UserFrontierPtr frontier) override;
 
+  CHECKED_STATUS ResetFlushedFrontier(UserFrontierPtr frontier) override;
+
   // Obtains the meta data of the specified column family of the DB.
   // STATUS(NotFound, "") will be returned if the current DB does not have
   // any column family match the specified name.
@@ -548,6 +550,14 @@ class DBImpl : public DB {
   // and blocked by any other pending_outputs_ calls)
   void ReleaseFileNumberFromPendingOutputs(std::list<uint64_t>::iterator v);
 
+  // Whether the batch is large enough to be inserted into the memtable by several threads.
+  bool ShouldInsertIntoMemTableConcurrently(const WriteBatch& batch) const;
+
+  // Splits the batch into parts and inserts them into the memtable concurrently, using the
+  // calling thread and threads of memtable_insert_thread_pool.
+  Status InsertIntoMemTableConcurrently(
+      const WriteOptions& write_options, WriteBatch* batch, SequenceNumber sequence);
+
   // Flush the in-memory write buffer to storage.  Switches to a new
   // log-file/memtable and writes a new descriptor iff successful.
   Status FlushMemTableToOutputFile(ColumnFamilyData* cfd,
@@ -600,6 +610,13 @@ class DBImpl : public DB {
   static void BGWorkCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void UnscheduleCallback(void* arg);
+  struct CompactionArg;
+  // Schedules the compaction on the shared priority thread pool if it is set, otherwise on the
+  // LOW priority pool of the Env.
+  void ScheduleCompaction(CompactionArg* ca);
+  // Priority of the compaction in the shared priority thread pool. DBs with more files in level 0
+  // go first, then compactions that reduce the compaction score the most per byte of input.
+  int64_t CompactionPriority(const Compaction* manual_compaction);
   void BackgroundCallCompaction(void* arg);
   void BackgroundCallFlush();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
@@ -903,6 +920,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write table files by flushes and compactions
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
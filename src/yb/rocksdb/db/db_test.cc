@@ -85,7 +85,10 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/util/mock_env.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 #include "yb/rocksdb/util/xfunc.h"
 #include "yb/util/tsan_util.h"
@@ -5319,6 +5322,183 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
 
 #endif  // ROCKSDB_LITE
 
+TEST_F(DBTest, ConcurrentMemTableInsertOfLargeBatch) {
+  std::unique_ptr<yb::ThreadPool> pool;
+  ASSERT_OK(yb::ThreadPoolBuilder("memtable-insert").Build(&pool));
+
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.memtable_insert_thread_pool = pool.get();
+  options.memtable_insert_min_entries_per_thread = 16;
+  options.memtable_insert_max_threads = 4;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  WriteBatch batch;
+  batch.Put("overwritten", "first");
+  batch.Put("deleted", "value");
+  for (int i = 0; i < kNumKeys; ++i) {
+    batch.Put(Key(i), "v" + ToString(i));
+  }
+  // These entries go to the last part of the batch, so their sequence numbers should win over
+  // the first ones.
+  batch.Put("overwritten", "last");
+  batch.Delete("deleted");
+
+  const auto sequence_before = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(sequence_before + batch.Count(), db_->GetLatestSequenceNumber());
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+  ASSERT_EQ("last", Get("overwritten"));
+  ASSERT_EQ("NOT_FOUND", Get("deleted"));
+
+  ASSERT_OK(Flush());
+  ASSERT_EQ("last", Get("overwritten"));
+  ASSERT_EQ("NOT_FOUND", Get("deleted"));
+  Close();
+  pool->Shutdown();
+}
+
+TEST_F(DBTest, CompactionsOnPriorityThreadPool) {
+  yb::PriorityThreadPool pool("compaction", 1);
+
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.priority_thread_pool_for_compactions = &pool;
+  DestroyAndReopen(options);
+
+  // Block the LOW priority pool of the Env, compactions should not need it.
+  env_->SetBackgroundThreads(1, Env::LOW);
+  test::SleepingBackgroundTask sleeping_task_low;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task_low,
+                 Env::Priority::LOW);
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+  dbfull()->TEST_WaitForCompact();
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_EQ("v0", Get(Key(0)));
+  ASSERT_EQ("v1", Get(Key(1)));
+
+  sleeping_task_low.WakeUp();
+  sleeping_task_low.WaitUntilDone();
+
+  // Block the priority pool, so that the next compaction stays in its queue, and check that the
+  // DB could be closed with a queued compaction.
+  yb::CountDownLatch started(1);
+  yb::CountDownLatch release(1);
+  ASSERT_OK(pool.Submit(std::numeric_limits<int64_t>::max(), nullptr,
+                        [&started, &release](const yb::Status& status) {
+    started.CountDown();
+    release.Wait();
+  }));
+  started.Wait();
+  for (int i = 2; i < 4; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(1U, pool.queue_length());
+  Close();
+  ASSERT_EQ(0U, pool.queue_length());
+  release.CountDown();
+  pool.Shutdown();
+}
+
+TEST_F(DBTest, PriorityThreadPoolShutdownWithQueuedManualCompaction) {
+  yb::PriorityThreadPool pool("compaction", 1);
+
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 10;
+  options.priority_thread_pool_for_compactions = &pool;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  // Block the priority pool, so that the manual compaction stays in its queue.
+  yb::CountDownLatch started(1);
+  yb::CountDownLatch release(1);
+  ASSERT_OK(pool.Submit(std::numeric_limits<int64_t>::max(), nullptr,
+                        [&started, &release](const yb::Status& status) {
+    started.CountDown();
+    release.Wait();
+  }));
+  started.Wait();
+
+  Status compact_status;
+  std::thread compact_thread([this, &compact_status] {
+    compact_status = db_->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+  });
+  while (pool.queue_length() == 0) {
+    env_->SleepForMicroseconds(10000);
+  }
+
+  // Shutdown aborts the queued compaction and then waits for the blocking task.
+  std::thread shutdown_thread([&pool] { pool.Shutdown(); });
+  compact_thread.join();
+  ASSERT_TRUE(compact_status.IsAborted()) << compact_status.ToString();
+  release.CountDown();
+  shutdown_thread.join();
+
+  // The input files of the aborted compaction were released, so they could be compacted on the
+  // LOW priority pool of the Env.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_EQ("v0", Get(Key(0)));
+  ASSERT_EQ("v1", Get(Key(1)));
+  Close();
+}
+
+TEST_F(DBTest, DirectIOForFlushAndCompaction) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 3;
+  options.use_direct_io_for_flush_and_compaction = true;
+  DestroyAndReopen(options);
+  ASSERT_EQ(2_MB, dbfull()->GetOptions().compaction_readahead_size);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int file = 0; file < 3; ++file) {
+    for (int i = 0; i < 100; ++i) {
+      values.push_back(RandomString(&rnd, 1000));
+      ASSERT_OK(Put(Key(file * 100 + i), values.back()));
+    }
+    ASSERT_OK(Flush());
+  }
+  dbfull()->TEST_WaitForCompact();
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], Get(Key(static_cast<int>(i))));
+  }
+
+  // Scan with explicit readahead.
+  ReadOptions read_options;
+  read_options.readahead_size = 64_KB;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  size_t num_keys = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(values[num_keys], iter->value().ToString());
+    ++num_keys;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(values.size(), num_keys);
+}
+
 TEST_F(DBTest, SanitizeNumThreads) {
   for (int attempt = 0; attempt < 2; attempt++) {
     const size_t kTotalTasks = 8;
@@ -877,6 +877,78 @@ TEST_P(DBTestUniversalCompaction, UniversalCompactionCompressRatio2) {
   ASSERT_LT(TotalSize(), 120000U * 12 * 0.8 + 120000 * 2);
 }
 
+// Fresh files are written uncompressed, while the output of a full compaction is compressed with
+// bottommost_compression, optionally with a dictionary.
+TEST_P(DBTestUniversalCompaction, UniversalCompactionBottommostCompressionDict) {
+  if (!Zlib_Supported()) {
+    return;
+  }
+  constexpr int kNumWords = 16;
+  constexpr int kWordSize = 64;
+  constexpr int kWordsPerValue = 4;
+  constexpr int kNumKeys = 2000;
+
+  // Values are made of a small set of random words, so that a block only compresses well if the
+  // compressor knows the words from the dictionary.
+  Random rnd(301);
+  std::vector<std::string> words;
+  for (int i = 0; i < kNumWords; i++) {
+    words.push_back(RandomString(&rnd, kWordSize));
+  }
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string value;
+    for (int j = 0; j < kWordsPerValue; j++) {
+      value += words[rnd.Uniform(kNumWords)];
+    }
+    values.push_back(std::move(value));
+  }
+  const uint64_t raw_size = kNumKeys * kWordSize * kWordsPerValue;
+
+  uint64_t size_without_dict = 0;
+  for (bool use_dict : {false, true}) {
+    Options options;
+    options.compaction_style = kCompactionStyleUniversal;
+    options.num_levels = num_levels_;
+    options.write_buffer_size = 100 << 10;  // 100KB
+    options.disable_auto_compactions = true;
+    options.compression = kNoCompression;
+    options.bottommost_compression = kZlibCompression;
+    options.compression_opts.max_dict_bytes = use_dict ? 4 << 10 : 0;
+    options = CurrentOptions(options);
+    BlockBasedTableOptions bbto;
+    bbto.block_size = 1 << 10;
+    options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+    DestroyAndReopen(options);
+
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_GT(TotalSize(), raw_size);
+
+    CompactRangeOptions compact_options;
+    compact_options.exclusive_manual_compaction = exclusive_manual_compaction_;
+    ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+    const uint64_t size = TotalSize();
+    ASSERT_LT(size, raw_size);
+
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+    Reopen(options);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+
+    if (use_dict) {
+      ASSERT_LT(size, size_without_dict);
+    } else {
+      size_without_dict = size;
+    }
+  }
+}
+
 // Test that checks trivial move in universal compaction
 TEST_P(DBTestUniversalCompaction, UniversalCompactionTrivialMoveTest1) {
   int32_t trivial_move = 0;
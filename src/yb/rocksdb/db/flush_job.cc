@@ -270,7 +270,7 @@ Status FlushJob::WriteLevel0Table(const autovector<MemTable*>& mems,
                      existing_snapshots_,
                      earliest_write_conflict_snapshot_,
                      output_compression_,
-                     cfd_->ioptions()->compression_opts,
+                     GetCompressionOptions(*cfd_->ioptions(), /* bottommost */ false),
                      mutable_cf_options_.paranoid_file_checks,
                      cfd_->internal_stats(),
                      db_options_.boundary_extractor.get(),
@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,7 @@
 #include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/dynamic_bloom.h"
 #include "yb/rocksdb/util/instrumented_mutex.h"
+#include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/mutable_cf_options.h"
 
 namespace rocksdb {
@@ -325,7 +327,9 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be called concurrently by writers that insert into the memtable in parallel.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<SpinMutex> l(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->Merge(value);
     } else {
@@ -384,6 +388,7 @@ class MemTable {
 
   Env* env_;
 
+  SpinMutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
@@ -150,7 +150,13 @@ class VersionBuilder::Rep {
         auto f2 = level_files[i];
         if (level == 0) {
           assert(level_zero_cmp_(f1, f2));
+          const auto* icmp = vstorage->InternalComparator().get();
           assert(f1->largest.seqno > f2->largest.seqno ||
+                 // Files written by subcompactions of one universal compaction could have the
+                 // same largest sequence number, but their key ranges are disjoint.
+                 (f1->largest.seqno == f2->largest.seqno &&
+                  (icmp->Compare(f1->largest.key, f2->smallest.key) < 0 ||
+                   icmp->Compare(f2->largest.key, f1->smallest.key) < 0)) ||
                  // We can have multiple files with seqno = 0 as a result of
                  // using DB::AddFile()
                  (f1->largest.seqno == 0 && f2->largest.seqno == 0));
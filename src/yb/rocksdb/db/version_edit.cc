@@ -99,6 +99,7 @@ void VersionEdit::Clear() {
   column_family_name_.reset();
   is_column_family_drop_ = false;
   flushed_frontier_.reset();
+  force_flushed_frontier_ = false;
 }
 
 void EncodeBoundaryValues(const FileBoundaryValues<InternalKey>& values, BoundaryValuesPB* out) {
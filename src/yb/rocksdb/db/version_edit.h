@@ -156,8 +156,11 @@ class VersionEdit {
   void SetLastSequence(SequenceNumber seq) {
     last_sequence_ = seq;
   }
-  void SetFlushedFrontier(UserFrontierPtr value) {
+  // If force is true, the flushed frontier of the version set is replaced even if it would go
+  // backwards.
+  void SetFlushedFrontier(UserFrontierPtr value, bool force = false) {
     flushed_frontier_ = std::move(value);
+    force_flushed_frontier_ = force;
   }
   void SetMaxColumnFamily(uint32_t max_column_family) {
     max_column_family_ = max_column_family;
@@ -263,6 +266,7 @@ class VersionEdit {
   boost::optional<uint32_t> max_column_family_;
   boost::optional<SequenceNumber> last_sequence_;
   UserFrontierPtr flushed_frontier_;
+  bool force_flushed_frontier_ = false;
 
   DeletedFileSet deleted_files_;
   std::vector<std::pair<int, FileMetaData>> new_files_;
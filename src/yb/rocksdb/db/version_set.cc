@@ -1236,10 +1236,21 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      // Level 0 files written by subcompactions of one universal compaction have overlapping
+      // sequence number ranges and form a single sorted run.
+      SequenceNumber sorted_run_smallest_seqno = 0;
+      bool sorted_run_started = false;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
+          if (compaction_style_ == kCompactionStyleUniversal && sorted_run_started &&
+              f->largest.seqno >= sorted_run_smallest_seqno) {
+            sorted_run_smallest_seqno = std::min(sorted_run_smallest_seqno, f->smallest.seqno);
+            continue;
+          }
           num_sorted_runs++;
+          sorted_run_started = true;
+          sorted_run_smallest_seqno = f->smallest.seqno;
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
@@ -2090,7 +2101,7 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(env_->OptimizeForCompactionTableRead(env_options_, *db_options)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -2344,7 +2355,11 @@ Status VersionSet::LogAndApply(ColumnFamilyData* column_family_data,
     manifest_file_size_ = new_manifest_file_size;
     prev_log_number_ = edit->prev_log_number_.get_value_or(0);
     if (edit->flushed_frontier_) {
-      SetFlushedFrontier(edit->flushed_frontier_);
+      if (edit->force_flushed_frontier_) {
+        SetFlushedFrontierNoSanityChecking(edit->flushed_frontier_);
+      } else {
+        SetFlushedFrontier(edit->flushed_frontier_);
+      }
     }
   } else {
     RLOG(InfoLogLevel::ERROR_LEVEL, db_options_->info_log,
@@ -3482,7 +3497,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
         // Create concatenating iterator for the files from this level
         list[num++] = NewTwoLevelIterator(
             new LevelFileIteratorState(
-                cfd->table_cache(), read_options, env_options_,
+                cfd->table_cache(), read_options, env_options_compactions_,
                 cfd->internal_comparator(),
                 nullptr /* no per level latency histogram */,
                 true /* for_compaction */, false /* prefix enabled */,
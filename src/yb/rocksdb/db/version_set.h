@@ -809,8 +809,8 @@ class VersionSet {
   // env options for all reads and writes except compactions
   const EnvOptions& env_options_;
 
-  // env options used for compactions. This is a copy of
-  // env_options_ but with readaheads set to readahead_compactions_.
+  // env options used for compactions. This is a copy of env_options_ optimized for reading
+  // compaction inputs, see Env::OptimizeForCompactionTableRead.
   const EnvOptions env_options_compactions_;
 
   // No copying allowed
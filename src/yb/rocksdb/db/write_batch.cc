@@ -43,6 +43,7 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include <algorithm>
 #include <stack>
 #include <stdexcept>
 #include <vector>
@@ -887,6 +888,74 @@ Status WriteBatchInternal::InsertInto(const WriteBatch* batch,
   return batch->Iterate(&inserter);
 }
 
+namespace {
+
+class WriteBatchSplitter : public WriteBatch::Handler {
+ public:
+  WriteBatchSplitter(SequenceNumber sequence, size_t entries_per_part,
+                     std::vector<WriteBatch>* parts)
+      : sequence_(sequence), entries_per_part_(entries_per_part), parts_(parts) {}
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key,
+                       const Slice& value) override {
+    WriteBatchInternal::Put(CurrentPart(), column_family_id, key, value);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    WriteBatchInternal::Delete(CurrentPart(), column_family_id, key);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    WriteBatchInternal::SingleDelete(CurrentPart(), column_family_id, key);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t, const Slice&, const Slice&) override {
+    return STATUS(NotSupported, "Merge operands could not be inserted concurrently");
+  }
+
+  CHECKED_STATUS Frontiers(const UserFrontiers&) override {
+    // Frontiers are set by the caller.
+    return Status::OK();
+  }
+
+ private:
+  WriteBatch* CurrentPart() {
+    if (parts_->empty() || entries_in_part_ == entries_per_part_) {
+      parts_->emplace_back();
+      WriteBatchInternal::SetSequence(&parts_->back(), sequence_);
+      entries_in_part_ = 0;
+    }
+    ++entries_in_part_;
+    ++sequence_;
+    return &parts_->back();
+  }
+
+  SequenceNumber sequence_;
+  const size_t entries_per_part_;
+  std::vector<WriteBatch>* parts_;
+  size_t entries_in_part_ = 0;
+};
+
+} // namespace
+
+Status WriteBatchInternal::Split(
+    const WriteBatch* batch, size_t num_parts, std::vector<WriteBatch>* parts) {
+  DCHECK_GT(num_parts, 0);
+  const size_t count = Count(batch);
+  parts->clear();
+  parts->reserve(num_parts);
+  WriteBatchSplitter splitter(
+      Sequence(batch), std::max<size_t>((count + num_parts - 1) / num_parts, 1), parts);
+  RETURN_NOT_OK(batch->Iterate(&splitter));
+  if (!parts->empty()) {
+    parts->front().SetFrontiers(batch->Frontiers());
+  }
+  return Status::OK();
+}
+
 void WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   DCHECK_GE(contents.size(), kHeader);
   b->rep_.assign(contents.cdata(), contents.size());
@@ -170,6 +170,12 @@ class WriteBatchInternal {
                            const bool dont_filter_deletes = true,
                            bool concurrent_memtable_writes = false);
 
+  // Splits the batch into num_parts batches with roughly the same number of entries, so that
+  // they could be inserted into the memtable concurrently. Each part starts with the sequence
+  // number its first entry has in the original batch, and the first part gets the frontiers of
+  // the original batch. Returns NotSupported if the batch contains merge operands.
+  static Status Split(const WriteBatch* batch, size_t num_parts, std::vector<WriteBatch>* parts);
+
   static void Append(WriteBatch* dst, const WriteBatch* src);
 
   // Returns the byte size of appending a WriteBatch with ByteSize
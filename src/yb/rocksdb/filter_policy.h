@@ -148,6 +148,12 @@ class FilterPolicy {
 
     // Transform a key.
     virtual Slice Transform(Slice key) const = 0;
+
+    // Returns a longer prefix of the key than Transform(key) that is also added to the filter, or
+    // an empty slice if there is none. It allows to filter by a more selective prefix, while the
+    // filter block is still chosen by Transform(key). Used for fixed-size bloom filter only.
+    // Requires: the result starts with Transform(key).
+    virtual Slice ExtendedTransform(Slice key) const { return Slice(); }
   };
 
   // Filter policy can optionally return key transformer to be used before writing key to filter or
@@ -43,6 +43,13 @@
 #undef max
 #endif
 
+namespace yb {
+
+class PriorityThreadPool;
+class ThreadPool;
+
+} // namespace yb
+
 namespace rocksdb {
 
 class BoundaryValuesExtractor;
@@ -85,6 +92,10 @@ enum CompressionType : char {
   kLZ4HCCompression = 0x5,
   // zstd format is not finalized yet so it's subject to changes.
   kZSTDNotFinalCompression = 0x40,
+
+  // kDisableCompressionOption is used to disable some compression options. It is never written to
+  // disk. Its value fits into char whether char is signed or not.
+  kDisableCompressionOption = 0x7F,
 };
 
 enum CompactionStyle : char {
@@ -158,9 +169,15 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary used to compress data blocks of an SST file. The dictionary is
+  // built from samples of the first data blocks of the file, and is stored in the file's
+  // "rocksdb.compression_dict" meta block. It is only used with zlib, LZ4 and ZSTD.
+  //
+  // Default: 0, i.e. no dictionary.
+  uint32_t max_dict_bytes;
+  CompressionOptions() : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -368,6 +385,15 @@ struct ColumnFamilyOptions {
   // change when data grows.
   std::vector<CompressionType> compression_per_level;
 
+  // Compression algorithm used for files written by compactions to the bottommost level, i.e.
+  // compactions after which there is no older data for the keys they output. With universal
+  // compaction that is any compaction which includes the oldest file. Such files hold the bulk of
+  // the data and are rewritten rarely, so it makes sense to compress them better than fresh files.
+  // Compression dictionaries (compression_opts.max_dict_bytes) are only built for these files.
+  //
+  // Default: kDisableCompressionOption, i.e. use 'compression' / 'compression_per_level'.
+  CompressionType bottommost_compression;
+
   // different options for compression algorithms
   CompressionOptions compression_opts;
 
@@ -997,6 +1023,16 @@ struct DBOptions {
   // Default: 1 (i.e. no subcompactions)
   uint32_t max_subcompactions;
 
+  // Thread pool shared by several DBs, that is used to run background compactions instead of
+  // the LOW priority pool of the Env. Compactions of the DB with the highest read amplification
+  // are run first, then the ones that reduce the compaction score the most per byte of input.
+  // max_background_compactions still limits the number of compactions of a single DB.
+  //
+  // The pool should outlive the DB.
+  //
+  // Default: nullptr (use Env::Priority::LOW)
+  yb::PriorityThreadPool* priority_thread_pool_for_compactions;
+
   // Maximum number of concurrent background memtable flush jobs, submitted to
   // the HIGH priority thread pool.
   //
@@ -1088,6 +1124,14 @@ struct DBOptions {
   // If false, fallocate() calls are bypassed
   bool allow_fallocate;
 
+  // Use direct I/O (O_DIRECT) for reading compaction inputs and for writing files produced by
+  // flushes and compactions, so that background jobs do not evict hot pages from the OS page cache
+  // and do not duplicate data that is already in the block cache. Falls back to buffered I/O on
+  // file systems that do not support direct I/O.
+  // When set and compaction_readahead_size is 0, compaction_readahead_size is set to 2MB.
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction;
+
   // Disable child process inherit open files. Default: true
   bool is_fd_close_on_exec;
 
@@ -1251,6 +1295,29 @@ struct DBOptions {
   // Default: false
   bool enable_write_thread_adaptive_yield;
 
+  // Thread pool used to insert large write batches into the memtable concurrently. When it is set
+  // and allow_concurrent_memtable_write is true, a write group consisting of a single batch with
+  // at least 2 * memtable_insert_min_entries_per_thread entries is split into parts that are
+  // inserted by the writing thread and by threads of this pool. Sequence numbers of the entries
+  // are the same as if the batch was inserted by a single thread.
+  //
+  // The pool should outlive the DB.
+  //
+  // Default: nullptr (disabled)
+  yb::ThreadPool* memtable_insert_thread_pool;
+
+  // Minimal number of write batch entries inserted by one thread when the batch is inserted
+  // into the memtable concurrently.
+  //
+  // Default: 1024
+  size_t memtable_insert_min_entries_per_thread;
+
+  // Maximal number of threads, including the writing thread, that insert a single write batch
+  // into the memtable.
+  //
+  // Default: 4
+  size_t memtable_insert_max_threads;
+
   // The maximum number of microseconds that a write operation will use
   // a yielding spin loop to coordinate with other write threads before
   // blocking on a mutex.  (Assuming write_thread_slow_yield_usec is
@@ -1475,6 +1542,12 @@ struct ReadOptions {
   // Query id designated for the read.
   QueryId query_id = kDefaultQueryId;
 
+  // If non-zero, table iterators read this many bytes ahead when they read a data block from file.
+  // If zero, table iterators start reading ahead once they detect sequential reads of data blocks,
+  // see BlockBasedTableOptions::max_auto_readahead_size.
+  // Default: 0
+  size_t readahead_size = 0;
+
   // Filter for pruning SST files. RocksDB user can provide its own implementation to exclude SST
   // files from being added to MergeIterator. By default doesn't filter files.
   std::shared_ptr<TableAwareReadFileFilter> table_aware_file_filter;
@@ -43,6 +43,12 @@
 #include "yb/rocksdb/status.h"
 #include "yb/util/size_literals.h"
 
+namespace yb {
+
+class MemTracker;
+
+} // namespace yb
+
 namespace rocksdb {
 
 // -- Block-based Table
@@ -97,6 +103,16 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // For tables with kMultiLevelBinarySearch index: keep the top level index block in the table
+  // reader for the lifetime of the table, even if cache_index_and_filter_blocks is set. Lower
+  // index levels are read through the block cache, so a lookup never has to re-read the whole
+  // index of a large table after it was evicted.
+  bool pin_top_level_index = false;
+
+  // Insert lower level index blocks and fixed-size filter blocks to the multi-touch part of the
+  // block cache, so that they are evicted after data blocks that were accessed only once.
+  bool cache_index_and_filter_blocks_with_high_priority = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -157,6 +173,11 @@ struct BlockBasedTableOptions {
   // used to avoid too many index levels in case we have large keys.
   size_t min_keys_per_index_block = 64;
 
+  // Maximum number of bytes table iterators read ahead once they detect sequential reads of data
+  // blocks from file. Readahead starts from 8KB and doubles on each readahead up to this value.
+  // 0 disables automatic readahead, ReadOptions::readahead_size is applied anyway.
+  size_t max_auto_readahead_size = 256_KB;
+
   // Use delta encoding to compress keys in blocks.
   // Iterator::PinData() requires this option to be disabled.
   //
@@ -201,6 +222,10 @@ struct BlockBasedTableOptions {
   // This option only affects newly written tables. When reading exising tables,
   // the information about version is read from the footer.
   uint32_t format_version = 2;
+
+  // If set, tracks memory used by index and filter blocks that table readers keep outside of the
+  // block cache.
+  std::shared_ptr<yb::MemTracker> mem_tracker;
 };
 
 // Table Properties that are specific to block-based table properties.
@@ -213,6 +238,9 @@ struct BlockBasedTablePropertyNames {
   static const char kWholeKeyFiltering[];
   // value is "1" for true and "0" for false.
   static const char kPrefixFiltering[];
+  // value is "1" if the filter contains the keys produced by
+  // FilterPolicy::KeyTransformer::ExtendedTransform, "0" or missing otherwise.
+  static const char kExtendedFilterKeys[];
 };
 
 // Create default block based table factory.
@@ -27,11 +27,13 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "yb/rocksdb/db/dbformat.h"
 
@@ -104,10 +106,49 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   return compressed_size < raw_size - (raw_size / 8u);
 }
 
+// Data blocks are kept in memory until there are this many times max_dict_bytes of them, so that
+// the compression dictionary of a file is built from a representative part of its data.
+constexpr size_t kCompressionDictSampleRatio = 64;
+
+// Size of a single sample taken from data blocks into the compression dictionary.
+constexpr size_t kCompressionDictSampleSize = 64;
+
+// Builds a compression dictionary of at most max_dict_bytes from samples evenly spread over the
+// given blocks. Dictionary compressors look for matches of the input in the dictionary, so the
+// samples capture the key prefixes, value types and hybrid times common to most entries.
+std::string BuildCompressionDict(
+    const std::vector<Slice>& blocks, size_t total_size, size_t max_dict_bytes) {
+  std::string result;
+  result.reserve(std::min(total_size, max_dict_bytes));
+  if (total_size <= max_dict_bytes) {
+    for (const auto& block : blocks) {
+      result.append(block.cdata(), block.size());
+    }
+    return result;
+  }
+  const size_t num_samples = std::max<size_t>(max_dict_bytes / kCompressionDictSampleSize, 1);
+  const size_t stride = total_size / num_samples;
+  size_t next_sample = 0;
+  size_t block_begin = 0;
+  for (const auto& block : blocks) {
+    const size_t block_end = block_begin + block.size();
+    while (next_sample < block_end && result.size() < max_dict_bytes) {
+      const size_t offset = next_sample - block_begin;
+      const size_t sample_size = std::min(
+          {kCompressionDictSampleSize, block.size() - offset, max_dict_bytes - result.size()});
+      result.append(block.cdata() + offset, sample_size);
+      next_sample += stride;
+    }
+    block_begin = block_end;
+  }
+  return result;
+}
+
 // format_version is the block format as defined in include/rocksdb/table.h
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -127,7 +168,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -145,7 +186,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -161,7 +202,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -285,10 +326,27 @@ struct BlockBasedTableBuilder::Rep {
 
   std::string last_key;
   std::string last_filter_key;
+  // Last key produced by filter_key_transformer->ExtendedTransform that was added to the filter.
+  std::string last_extended_filter_key;
+  // Whether the filter block became full before all extended keys for last_filter_key were added.
+  bool extended_filter_keys_truncated = false;
+  bool has_extended_filter_keys = false;
   const CompressionType compression_type;
   const CompressionOptions compression_opts;
   TableProperties props;
 
+  // Dictionary the data blocks are compressed with, see CompressionOptions::max_dict_bytes.
+  std::string compression_dict;
+  // Whether data blocks are kept in memory until the compression dictionary is built.
+  bool buffer_data_blocks;
+  struct BufferedDataBlock {
+    std::string contents;
+    std::string last_key;
+    std::string next_block_first_key;
+  };
+  std::vector<BufferedDataBlock> buffered_data_blocks;
+  size_t buffered_data_size = 0;
+
   bool closed = false;  // Either Finish() or Abandon() has been called.
 
   BlockHandle data_pending_handle;    // Handle to add to data index block
@@ -324,6 +382,9 @@ Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
   properties->emplace(
       BlockBasedTablePropertyNames::kPrefixFiltering,
       ToBlockBasedTablePropertyValue(prefix_filtering_));
+  properties->emplace(
+      BlockBasedTablePropertyNames::kExtendedFilterKeys,
+      ToBlockBasedTablePropertyValue(rep_->has_extended_filter_keys));
   val.clear();
   PutFixed32(&val, rep_->data_index_builder->NumLevels());
   properties->emplace(BlockBasedTablePropertyNames::kNumIndexLevels, val);
@@ -364,6 +425,13 @@ BlockBasedTableBuilder::Rep::Rep(
               nullptr /* prefix_extractor */, table_options)),
       compression_type(_compression_type),
       compression_opts(_compression_opts),
+      // Block-based filters and hash index have to see data blocks in the order they are written,
+      // so the dictionary is not used with them.
+      buffer_data_blocks(
+          compression_opts.max_dict_bytes > 0 &&
+          CompressionTypeSupportsDictionary(compression_type) &&
+          filter_type != FilterType::kBlockBasedFilter &&
+          table_options.index_type != IndexType::kHashSearch),
       flush_block_policy(
           table_options.flush_block_policy_factory->NewFlushBlockPolicy(
               table_options, data_block_builder)) {
@@ -457,6 +525,11 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       }
       r->filter_block_builder->Add(filter_key);
       r->last_filter_key.assign(filter_key.cdata(), filter_key.size());
+      r->last_extended_filter_key.clear();
+      r->extended_filter_keys_truncated = false;
+    }
+    if (r->filter_key_transformer && !r->extended_filter_keys_truncated) {
+      AddExtendedFilterKey(r->filter_key_transformer->ExtendedTransform(user_key));
     }
   }
 
@@ -473,15 +546,84 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       r->ioptions.info_log);
 }
 
+void BlockBasedTableBuilder::AddExtendedFilterKey(const Slice& extended_filter_key) {
+  Rep* const r = rep_;
+  if (extended_filter_key.empty() ||
+      BytewiseComparator()->Compare(r->last_extended_filter_key, extended_filter_key) == 0) {
+    return;
+  }
+  if (r->filter_block_builder->ShouldFlush()) {
+    // Filter blocks are only switched when the filter key changes, so that all extended keys of a
+    // filter key are in the same block as the filter key itself. When the block is full, we add
+    // a marker telling readers that the extended keys of this filter key are incomplete in this
+    // block instead of overfilling it.
+    std::string marker = r->last_filter_key;
+    marker.push_back(kExtendedFilterKeysTruncatedMarker);
+    r->filter_block_builder->Add(marker);
+    r->extended_filter_keys_truncated = true;
+    return;
+  }
+  r->filter_block_builder->Add(extended_filter_key);
+  r->last_extended_filter_key.assign(extended_filter_key.cdata(), extended_filter_key.size());
+  r->has_extended_filter_keys = true;
+}
+
 void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
+
+  if (r->buffer_data_blocks) {
+    if (!r->data_block_builder.empty()) {
+      const Slice contents = r->data_block_builder.Finish();
+      r->buffered_data_size += contents.size();
+      r->buffered_data_blocks.push_back(Rep::BufferedDataBlock{
+          contents.ToBuffer(), r->last_key, next_block_first_key.ToBuffer()});
+      r->data_block_builder.Reset();
+    }
+    if (next_block_first_key.empty() ||
+        r->buffered_data_size >= r->compression_opts.max_dict_bytes * kCompressionDictSampleRatio) {
+      FlushBufferedDataBlocks();
+    }
+    return;
+  }
+
+  if (r->data_block_builder.empty()) {
+    WriteDataBlock(Slice(), &r->last_key, next_block_first_key);
+  } else {
+    WriteDataBlock(r->data_block_builder.Finish(), &r->last_key, next_block_first_key);
+    r->data_block_builder.Reset();
+  }
+}
+
+void BlockBasedTableBuilder::FlushBufferedDataBlocks() {
+  Rep* const r = rep_;
+  r->buffer_data_blocks = false;
+
+  std::vector<Slice> blocks;
+  blocks.reserve(r->buffered_data_blocks.size());
+  for (const auto& block : r->buffered_data_blocks) {
+    blocks.emplace_back(block.contents);
+  }
+  r->compression_dict = BuildCompressionDict(
+      blocks, r->buffered_data_size, r->compression_opts.max_dict_bytes);
+
+  for (auto& block : r->buffered_data_blocks) {
+    WriteDataBlock(block.contents, &block.last_key, block.next_block_first_key);
+    if (!ok()) break;
+  }
+  r->buffered_data_blocks.clear();
+  r->buffered_data_size = 0;
+}
+
+void BlockBasedTableBuilder::WriteDataBlock(
+    const Slice& contents, std::string* last_key, const Slice& next_block_first_key) {
+  Rep* const r = rep_;
   size_t data_block_size = 0;
 
-  if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+  if (!contents.empty()) {
+    data_block_size = WriteBlock(contents, &r->data_pending_handle, r->data_writer.get(),
+        r->compression_dict);
   }
   if (!ok()) return;
 
@@ -505,7 +647,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -562,7 +704,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -575,7 +718,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict, &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -692,6 +835,9 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (!r->buffered_data_blocks.empty()) {
+    FlushBufferedDataBlocks();
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(end_slice);  // no more filter block
   }
@@ -718,6 +864,13 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && !r->compression_dict.empty()) {
+    BlockHandle compression_dict_handle;
+    WriteRawBlock(r->compression_dict, kNoCompression, &compression_dict_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(block_based_table::kCompressionDictBlock, compression_dict_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -840,8 +993,9 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::TotalFileSize() const {
-  return rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
-      rep_->metadata_writer->offset;
+  // Buffered data blocks are accounted as if they were written uncompressed.
+  return rep_->buffered_data_size + (rep_->is_split_sst() ?
+      rep_->metadata_writer->offset + rep_->data_writer->offset : rep_->metadata_writer->offset);
 }
 
 uint64_t BlockBasedTableBuilder::BaseFileSize() const {
@@ -112,7 +112,8 @@ class BlockBasedTableBuilder : public TableBuilder {
       FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const Slice& compression_dict = Slice());
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -130,6 +131,18 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Build the compression dictionary from the buffered data blocks and write them to disk.
+  void FlushBufferedDataBlocks();
+
+  // Write the data block and add it to the index. last_key is the last key of the block, which
+  // the index builder may shorten.
+  void WriteDataBlock(
+      const Slice& contents, std::string* last_key, const Slice& next_block_first_key);
+
+  // Add a key produced by FilterPolicy::KeyTransformer::ExtendedTransform to the current filter
+  // block, unless it is empty or the same as the last one.
+  void AddExtendedFilterKey(const Slice& extended_filter_key);
+
   // Flush the current filter block into disk. next_block_first_key should be nullptr if this is the
   // last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
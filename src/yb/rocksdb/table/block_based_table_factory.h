@@ -99,6 +99,10 @@ inline const char* ToBlockBasedTablePropertyValue(bool value) {
   return value ? kPropTrue : kPropFalse;
 }
 
+// Appended to a filter key to mark that not all extended keys produced for it by
+// FilterPolicy::KeyTransformer::ExtendedTransform were added to the filter block.
+constexpr char kExtendedFilterKeysTruncatedMarker = '\xff';
+
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_TABLE_BLOCK_BASED_TABLE_FACTORY_H
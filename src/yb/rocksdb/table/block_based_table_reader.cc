@@ -64,6 +64,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/util/logging.h"
 #include "yb/util/atomic.h"
+#include "yb/util/mem_tracker.h"
 
 namespace rocksdb {
 
@@ -209,14 +210,25 @@ struct BlockBasedTable::Rep {
   std::mutex data_index_reader_mutex;
   yb::AtomicUniquePtr<IndexReader> data_index_reader;
   unique_ptr<IndexReader> filter_index_reader;
+  // Whether data index reader is kept in rep even when cache_index_and_filter_blocks is set, see
+  // BlockBasedTableOptions::pin_top_level_index.
+  bool pin_data_index = false;
+  // Memory used by index readers kept in rep, accounted to table_options.mem_tracker.
+  unique_ptr<yb::ScopedTrackedConsumption> data_index_consumption;
+  unique_ptr<yb::ScopedTrackedConsumption> filter_index_consumption;
   unique_ptr<FilterBlockReader> filter;
 
   FilterType filter_type;
+  // Whether the filter contains the keys produced by filter_key_transformer->ExtendedTransform.
+  bool extended_filter_keys = false;
 
   // Handle of fixed-size bloom filter index block or simply filter block for filters of other
   // types.
   BlockHandle filter_handle;
 
+  // Dictionary the data blocks are compressed with, empty if there is none.
+  BlockContents compression_dict_block;
+
   std::shared_ptr<const TableProperties> table_properties;
   IndexType index_type;
   bool hash_index_allow_collision;
@@ -228,6 +240,20 @@ struct BlockBasedTable::Rep {
   // block to extract prefix without knowing if a key is internal or not.
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
+
+  // Returns query id to be used for index and filter blocks stored in the block cache.
+  QueryId IndexAndFilterBlocksQueryId(QueryId query_id) const {
+    return table_options.cache_index_and_filter_blocks_with_high_priority &&
+           query_id != kNoCacheQueryId ? kInMultiTouchId : query_id;
+  }
+
+  unique_ptr<yb::ScopedTrackedConsumption> TrackMemory(const IndexReader* reader) const {
+    if (!table_options.mem_tracker || !reader) {
+      return nullptr;
+    }
+    return std::make_unique<yb::ScopedTrackedConsumption>(
+        table_options.mem_tracker, reader->ApproximateMemoryUsage());
+  }
 };
 
 class BlockBasedTable::IndexIteratorHolder {
@@ -286,7 +312,18 @@ bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
         read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
     FilterBlockReader* filter = filter_entry.value;
     // If bloom filter was not useful, then take this file into account.
-    const bool use_file = table->NonBlockBasedFilterKeyMayMatch(filter, filter_key);
+    bool use_file = table->NonBlockBasedFilterKeyMayMatch(filter, filter_key);
+    if (use_file && table->rep_->extended_filter_keys) {
+      // Also check the extended key, unless the block is marked as not having all of them.
+      const Slice extended_filter_key =
+          table->rep_->filter_key_transformer->ExtendedTransform(user_key_);
+      if (!extended_filter_key.empty()) {
+        std::string marker(filter_key.cdata(), filter_key.size());
+        marker.push_back(kExtendedFilterKeysTruncatedMarker);
+        use_file = table->NonBlockBasedFilterKeyMayMatch(filter, marker) ||
+                   table->NonBlockBasedFilterKeyMayMatch(filter, extended_filter_key);
+      }
+    }
     if (!use_file) {
       // Record that the bloom filter was useful.
       RecordTick(table->rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
@@ -393,6 +430,20 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the compression dictionary, if there is one.
+  {
+    BlockHandle compression_dict_handle;
+    if (FindMetaBlock(meta_iter.get(), block_based_table::kCompressionDictBlock,
+                      &compression_dict_handle).ok()) {
+      s = ReadBlockContents(rep->base_reader_with_cache_prefix->reader.get(), rep->footer,
+          ReadOptions::kDefault, compression_dict_handle, &rep->compression_dict_block,
+          rep->ioptions.env, /* do_uncompress */ false);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+
   // Read the properties
   bool found_properties_block = true;
   s = SeekToPropertiesBlock(meta_iter.get(), &found_properties_block);
@@ -430,11 +481,19 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     rep->prefix_filtering &= IsFeatureSupported(
         *(rep->table_properties),
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
+    // Unlike the features above, older files do not have extended filter keys.
+    const auto& props = rep->table_properties->user_collected_properties;
+    const auto it = props.find(BlockBasedTablePropertyNames::kExtendedFilterKeys);
+    rep->extended_filter_keys = it != props.end() && it->second == kPropTrue;
   }
+  // Top level of multi-level index is small, so we keep it in the table reader instead of the block
+  // cache, while lower levels are loaded through the block cache on demand.
+  rep->pin_data_index = table_options.pin_top_level_index &&
+                        new_table->DataIndexTypeOnFile() == IndexType::kMultiLevelBinarySearch;
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
-    if (table_options.cache_index_and_filter_blocks) {
+    if (table_options.cache_index_and_filter_blocks && !rep->pin_data_index) {
       DCHECK_ONLY_NOTNULL(table_options.block_cache.get());
       // Hack: Call NewIndexIterator() to implicitly add index to the
       // block_cache
@@ -446,6 +505,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
       // NOTE: Table reader objects are cached in table cache (table_cache.cc).
       std::unique_ptr<IndexReader> index_reader;
       s = new_table->CreateDataBlockIndexReader(&index_reader, meta_iter.get());
+      rep->data_index_consumption = rep->TrackMemory(index_reader.get());
       rep->data_index_reader.reset(index_reader.release());
     }
   }
@@ -457,6 +517,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
       // TODO: may be put it in block cache instead of table reader in case
       // table_options.cache_index_and_filter_blocks is set?
       s = new_table->CreateFilterIndexReader(&rep->filter_index_reader);
+      rep->filter_index_consumption = rep->TrackMemory(rep->filter_index_reader.get());
     }
 
     // Will use block cache for filter blocks access?
@@ -635,7 +696,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-    uint32_t format_version, BlockType block_type) {
+    uint32_t format_version, BlockType block_type, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -680,7 +741,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(),
                               compressed_block->size(), &contents,
-                              format_version);
+                              format_version, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -707,7 +768,8 @@ Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
-    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version) {
+    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+    const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -716,7 +778,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version);
+                                format_version, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -907,7 +969,8 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
 
   Statistics* statistics = rep_->ioptions.statistics;
   auto cache_handle = GetEntryFromCache(block_cache, filter_block_cache_key,
-      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, query_id);
+      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics,
+      rep_->IndexAndFilterBlocksQueryId(query_id));
 
   FilterBlockReader* filter = nullptr;
   if (cache_handle != nullptr) {
@@ -922,7 +985,8 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      Status s = block_cache->Insert(filter_block_cache_key,
+                                     rep_->IndexAndFilterBlocksQueryId(query_id),
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -966,14 +1030,15 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
   Cache* const block_cache = rep_->table_options.block_cache.get();
 
   if (block_cache && (rep_->data_index_load_mode == DataIndexLoadMode::USE_CACHE ||
-      rep_->table_options.cache_index_and_filter_blocks)) {
+      (rep_->table_options.cache_index_and_filter_blocks && !rep_->pin_data_index))) {
     char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
     Statistics* statistics = rep_->ioptions.statistics;
     auto cache_handle =
         GetEntryFromCache(block_cache, key, BLOCK_CACHE_INDEX_MISS,
-            BLOCK_CACHE_INDEX_HIT, statistics, read_options.query_id);
+            BLOCK_CACHE_INDEX_HIT, statistics,
+            rep_->IndexAndFilterBlocksQueryId(read_options.query_id));
 
     if (cache_handle == nullptr && no_io) {
       return ReturnNoIOErrorIterator(input_iter);
@@ -986,7 +1051,8 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     std::unique_ptr<IndexReader> index_reader_unique;
     Status s = CreateDataBlockIndexReader(&index_reader_unique);
     if (s.ok()) {
-      s = block_cache->Insert(key, read_options.query_id, index_reader_unique.get(),
+      s = block_cache->Insert(key, rep_->IndexAndFilterBlocksQueryId(read_options.query_id),
+                              index_reader_unique.get(),
                               index_reader_unique->usable_size(),
                               &DeleteCachedEntry<IndexReader>, &cache_handle, statistics);
     }
@@ -1023,6 +1089,7 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
         Status s = CreateDataBlockIndexReader(&index_reader_holder,
             nullptr /* preloaded_meta_index_iter */);
         if (s.ok()) {
+          rep_->data_index_consumption = rep_->TrackMemory(index_reader_holder.get());
           index_reader = index_reader_holder.release();
           rep_->data_index_reader.reset(index_reader, std::memory_order_acq_rel);
         } else {
@@ -1034,12 +1101,69 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
   }
 }
 
+// Reads ahead data blocks for a single table iterator. When ReadOptions::readahead_size is set,
+// each read from file fetches at least that many bytes. Otherwise readahead is started once the
+// iterator reads several consecutive blocks from file, and its size is doubled on every read up to
+// BlockBasedTableOptions::max_auto_readahead_size.
+class BlockPrefetcher {
+ public:
+  // Returns the buffer that contains the block referenced by handle, or nullptr if the block
+  // should be read from file as usual.
+  FilePrefetchBuffer* Prefetch(
+      RandomAccessFileReader* reader, const BlockHandle& handle, size_t readahead_size,
+      size_t max_auto_readahead_size);
+
+ private:
+  static constexpr size_t kInitialAutoReadaheadSize = 8_KB;
+  static constexpr int kMinSequentialReadsForAutoReadahead = 2;
+
+  FilePrefetchBuffer buffer_;
+  // End of the last block requested from this prefetcher, including its trailer.
+  uint64_t prev_block_end_ = 0;
+  int num_sequential_reads_ = 0;
+  size_t auto_readahead_size_ = kInitialAutoReadaheadSize;
+};
+
+FilePrefetchBuffer* BlockPrefetcher::Prefetch(
+    RandomAccessFileReader* reader, const BlockHandle& handle, size_t readahead_size,
+    size_t max_auto_readahead_size) {
+  const uint64_t offset = handle.offset();
+  const size_t len = handle.size() + kBlockTrailerSize;
+  const bool sequential = offset == prev_block_end_;
+  prev_block_end_ = offset + len;
+
+  Slice buffered;
+  if (buffer_.TryReadFromCache(offset, len, &buffered)) {
+    return &buffer_;
+  }
+
+  if (readahead_size == 0) {
+    if (!sequential) {
+      num_sequential_reads_ = 0;
+      auto_readahead_size_ = kInitialAutoReadaheadSize;
+    }
+    if (max_auto_readahead_size == 0 ||
+        ++num_sequential_reads_ < kMinSequentialReadsForAutoReadahead) {
+      return nullptr;
+    }
+    readahead_size = std::min(auto_readahead_size_, max_auto_readahead_size);
+    auto_readahead_size_ = std::min(auto_readahead_size_ * 2, max_auto_readahead_size);
+  }
+
+  // On failure the block is read from file directly, so that the error is reported from there.
+  if (!buffer_.Prefetch(reader, offset, len + readahead_size).ok()) {
+    return nullptr;
+  }
+  return &buffer_;
+}
+
 // Convert an index iterator value (i.e., an encoded BlockHandle)
 // into an iterator over the contents of the corresponding block.
 // If input_iter is null, new a iterator
 // If input_iter is not null, update this iter and return it
 InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
-    const Slice& index_value, BlockType block_type, BlockIter* input_iter) {
+    const Slice& index_value, BlockType block_type, BlockIter* input_iter,
+    BlockPrefetcher* prefetcher) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
   const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -1064,6 +1188,14 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  // Only data blocks are compressed with the dictionary.
+  const Slice compression_dict =
+      block_type == BlockType::kData ? rep_->compression_dict_block.data : Slice();
+  auto prefetch = [&]() -> FilePrefetchBuffer* {
+    return prefetcher ? prefetcher->Prefetch(reader->reader.get(), handle, ro.readahead_size,
+                                             rep_->table_options.max_auto_readahead_size)
+                      : nullptr;
+  };
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1084,7 +1216,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type);
+        rep_->table_options.format_version, block_type, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1092,13 +1224,13 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            block_cache_compressed == nullptr);
+            block_cache_compressed == nullptr, compression_dict, prefetch());
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version);
+                                rep_->table_options.format_version, compression_dict);
       }
     }
   }
@@ -1116,7 +1248,8 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     }
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
-        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env);
+        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
+        /* do_uncompress */ true, compression_dict, prefetch());
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1154,7 +1287,9 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         block_type_(block_type) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
-    return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
+    return table_->NewDataBlockIterator(
+        read_options_, index_value, block_type_, /* input_iter = */ nullptr,
+        block_type_ == BlockType::kData ? &prefetcher_ : nullptr);
   }
 
   bool PrefixMayMatch(const Slice& internal_key) override {
@@ -1170,6 +1305,7 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+  BlockPrefetcher prefetcher_;
 };
 
 // This will be broken if the user specifies an unusual implementation
@@ -1453,7 +1589,7 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Slice ckey;
 
   s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData);
+      rep_->table_options.format_version, BlockType::kData, rep_->compression_dict_block.data);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1468,19 +1604,22 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
 //  3. options
 //  4. internal_comparator
 //  5. index_type
-Status BlockBasedTable::CreateDataBlockIndexReader(
-    std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter) {
+IndexType BlockBasedTable::DataIndexTypeOnFile() const {
   // Some old version of block-based tables don't have index type present in
   // table properties. If that's the case we can safely use the kBinarySearch.
-  auto index_type_on_file = IndexType::kBinarySearch;
   if (rep_->table_properties) {
     auto& props = rep_->table_properties->user_collected_properties;
     auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
     if (pos != props.end()) {
-      index_type_on_file = static_cast<IndexType>(
-          DecodeFixed32(pos->second.c_str()));
+      return static_cast<IndexType>(DecodeFixed32(pos->second.c_str()));
     }
   }
+  return IndexType::kBinarySearch;
+}
+
+Status BlockBasedTable::CreateDataBlockIndexReader(
+    std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter) {
+  auto index_type_on_file = DataIndexTypeOnFile();
 
   auto file = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
@@ -1539,8 +1678,10 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
       int num_levels = DecodeFixed32(pos->second.c_str());
       // Filters are already checked before seeking the index.
       const bool skip_filters = true;
+      ReadOptions index_read_options;
+      index_read_options.query_id = rep_->IndexAndFilterBlocksQueryId(kDefaultQueryId);
       auto state = std::make_unique<BlockEntryIteratorState>(
-          this, ReadOptions::kDefault, skip_filters, BlockType::kIndex);
+          this, index_read_options, skip_filters, BlockType::kIndex);
       auto result = MultiLevelIndexReader::Create(
           this, file, footer, num_levels, footer.index_handle(), env, comparator, std::move(state));
       RETURN_NOT_OK(result);
@@ -44,6 +44,7 @@ namespace rocksdb {
 class Block;
 class BlockIter;
 class BlockHandle;
+class BlockPrefetcher;
 class Cache;
 class FilterBlockReader;
 class BlockBasedFilterBlockReader;
@@ -86,7 +87,9 @@ YB_DEFINE_ENUM(BlockType, (kData)(kIndex));
 // the key and it should be used together with DocDbAwareFilterPolicy which only takes into account
 // hashed components of key for filtering.
 // BloomFilterAwareFileFilter ignores an SST file completely if there are no keys with the same
-// hashed components as the key specified in constructor.
+// hashed components as the key specified in constructor. If the filter policy provides extended
+// filter keys (hashed and first range components for DocDB) and the file has them, the file is
+// also ignored if there are no keys with the extended key of the key specified in constructor.
 class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
  public:
   BloomFilterAwareFileFilter(const ReadOptions& read_options, const Slice& user_key);
@@ -180,9 +183,10 @@ class BlockBasedTable : public TableReader {
   Status DumpTable(WritableFile* out_file) override;
 
   // input_iter: if it is not null, update this one and return it as Iterator
+  // prefetcher: if it is not null, it is used to read ahead blocks that are read from file.
   InternalIterator* NewDataBlockIterator(
       const ReadOptions& ro, const Slice& index_value, BlockType block_type,
-      BlockIter* input_iter = nullptr);
+      BlockIter* input_iter = nullptr, BlockPrefetcher* prefetcher = nullptr);
 
   const ImmutableCFOptions& ioptions();
 
@@ -247,7 +251,7 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-      uint32_t format_version, BlockType block_type);
+      uint32_t format_version, BlockType block_type, const Slice& compression_dict);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -261,7 +265,8 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
-      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version);
+      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+      const Slice& compression_dict);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -272,6 +277,9 @@ class BlockBasedTable : public TableReader {
 
   void ReadMeta(const Footer& footer);
 
+  // Returns data index type stored in the table properties.
+  IndexType DataIndexTypeOnFile() const;
+
   // Create a index reader based on the index type stored in the table.
   // Optionally, user can pass a preloaded meta_index_iter for the index that
   // need to access extra meta blocks for index construction. This parameter
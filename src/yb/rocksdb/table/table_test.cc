@@ -63,6 +63,7 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/util/enums.h"
+#include "yb/util/mem_tracker.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -1864,6 +1865,58 @@ void ValidateBlockRestartInterval(int value, int expected) {
   delete factory;
 }
 
+// Top level of multi-level index should be kept in the table reader and accounted to the mem
+// tracker, even when index and filter blocks are cached.
+TEST_F(BlockBasedTableTest, PinTopLevelIndex) {
+  Options options;
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+
+  auto mem_tracker = yb::MemTracker::CreateTracker(-1, "PinTopLevelIndex");
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(16 * 1024 * 1024);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.cache_index_and_filter_blocks_with_high_priority = true;
+  table_options.pin_top_level_index = true;
+  table_options.index_type = IndexType::kMultiLevelBinarySearch;
+  table_options.block_size = 64;
+  table_options.index_block_size = 64;
+  table_options.min_keys_per_index_block = 2;
+  table_options.mem_tracker = mem_tracker;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  {
+    TableConstructor c(BytewiseComparator());
+    for (int i = 0; i != 100; ++i) {
+      c.Add(yb::Format("key$0", 1000 + i), std::string(32, 'v'));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableCFOptions ioptions(options);
+    c.Finish(options, ioptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    {
+      auto props = c.GetTableProperties().user_collected_properties;
+      auto pos = props.find(BlockBasedTablePropertyNames::kNumIndexLevels);
+      ASSERT_TRUE(pos != props.end());
+      ASSERT_GT(DecodeFixed32(pos->second.c_str()), 1);
+    }
+    auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+
+    unique_ptr<InternalIterator> iter(reader->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+
+    // Top level is kept in the table reader, while lower levels are loaded through block cache.
+    ASSERT_TRUE(reader->TEST_index_reader_loaded());
+    ASSERT_GT(options.statistics->getTickerCount(BLOCK_CACHE_INDEX_MISS), 0);
+    ASSERT_GT(mem_tracker->consumption(), 0);
+  }
+
+  ASSERT_EQ(0, mem_tracker->consumption());
+}
+
 TEST_F(BlockBasedTableTest, InvalidOptions) {
   // invalid values for block_size_deviation (<0 or >100) are silently set to 0
   ValidateBlockSizeDeviation(-10, 0);
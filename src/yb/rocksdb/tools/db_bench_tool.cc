@@ -79,6 +79,7 @@
 #include "yb/rocksdb/util/xxhash.h"
 #include "yb/rocksdb/hdfs/env_hdfs.h"
 #include "yb/rocksdb/utilities/merge_operators.h"
+#include "yb/util/threadpool.h"
 
 #ifdef OS_WIN
 #include <io.h>  // open/close
@@ -382,6 +383,13 @@ DEFINE_int32(new_table_reader_for_compaction_inputs, true,
 
 DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
+DEFINE_bool(use_direct_io_for_flush_and_compaction, false,
+            "Use O_DIRECT for compaction inputs and for flush and compaction outputs");
+
+DEFINE_int32(readahead_size, 0,
+             "Readahead size used by iterators of the sequential read benchmarks. "
+             "0 - use automatic readahead.");
+
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
              "Maximum windows randomaccess buffer size");
 
@@ -583,6 +591,14 @@ static bool ValidateCompressionLevel(const char* flagname, int32_t value) {
 static const bool FLAGS_compression_level_dummy __attribute__((unused)) =
     RegisterFlagValidator(&FLAGS_compression_level, &ValidateCompressionLevel);
 
+DEFINE_string(bottommost_compression_type, "",
+              "Algorithm to use to compress files written to the bottommost level. Empty means "
+              "the same as compression_type.");
+
+DEFINE_int32(compression_max_dict_bytes, 0,
+             "Maximum size of the dictionary used to compress data blocks of files written to "
+             "the bottommost level. 0 disables dictionaries.");
+
 DEFINE_int32(min_level_to_compress, -1, "If non-negative, compression starts"
              " from this level. Levels with number < min_level_to_compress are"
              " not compressed. Otherwise, apply compression_type to "
@@ -652,6 +668,14 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(allow_concurrent_memtable_write, false,
             "Allow multi-writers to update mem tables in parallel.");
 
+DEFINE_int32(memtable_insert_threads, 0,
+             "If greater than 1 and allow_concurrent_memtable_write is set, large write batches "
+             "are inserted into the memtable by up to this number of threads.");
+
+DEFINE_uint64(memtable_insert_min_entries_per_thread, 1024,
+              "Minimum number of write batch entries inserted by one thread, when the batch is "
+              "inserted into the memtable concurrently.");
+
 DEFINE_bool(enable_write_thread_adaptive_yield, false,
             "Use a yielding spin loop for brief writer thread waits.");
 
@@ -1565,6 +1589,7 @@ class Duration {
 class Benchmark {
  private:
   std::shared_ptr<Cache> cache_;
+  std::unique_ptr<yb::ThreadPool> memtable_insert_pool_;
   std::shared_ptr<Cache> compressed_cache_;
   std::shared_ptr<const FilterPolicy> filter_policy_;
   const SliceTransform* prefix_extractor_;
@@ -2389,6 +2414,8 @@ class Benchmark {
     options.new_table_reader_for_compaction_inputs =
         FLAGS_new_table_reader_for_compaction_inputs;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.use_direct_io_for_flush_and_compaction =
+        FLAGS_use_direct_io_for_flush_and_compaction;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
     options.statistics = dbstats;
@@ -2557,6 +2584,11 @@ class Benchmark {
       FLAGS_level0_slowdown_writes_trigger;
     options.compression = FLAGS_compression_type_e;
     options.compression_opts.level = FLAGS_compression_level;
+    options.compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
+    if (!FLAGS_bottommost_compression_type.empty()) {
+      options.bottommost_compression =
+          StringToCompressionType(FLAGS_bottommost_compression_type.c_str());
+    }
     options.WAL_ttl_seconds = FLAGS_wal_ttl_seconds;
     options.WAL_size_limit_MB = FLAGS_wal_size_limit_MB;
     options.max_total_wal_size = FLAGS_max_total_wal_size;
@@ -2583,6 +2615,17 @@ class Benchmark {
         FLAGS_allow_concurrent_memtable_write;
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
+    if (FLAGS_memtable_insert_threads > 1) {
+      if (!memtable_insert_pool_) {
+        CHECK_OK(yb::ThreadPoolBuilder("memtable-insert")
+                     .set_max_threads(FLAGS_memtable_insert_threads - 1)
+                     .Build(&memtable_insert_pool_));
+      }
+      options.memtable_insert_thread_pool = memtable_insert_pool_.get();
+      options.memtable_insert_max_threads = FLAGS_memtable_insert_threads;
+      options.memtable_insert_min_entries_per_thread =
+          FLAGS_memtable_insert_min_entries_per_thread;
+    }
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.rate_limit_delay_max_milliseconds =
@@ -2912,6 +2955,7 @@ class Benchmark {
   void ReadSequential(ThreadState* thread, DB* db) {
     ReadOptions options(FLAGS_verify_checksum, true);
     options.tailing = FLAGS_use_tailing_iterator;
+    options.readahead_size = FLAGS_readahead_size;
 
     Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
@@ -2936,7 +2980,9 @@ class Benchmark {
   }
 
   void ReadReverse(ThreadState* thread, DB* db) {
-    Iterator* iter = db->NewIterator(ReadOptions(FLAGS_verify_checksum, true));
+    ReadOptions options(FLAGS_verify_checksum, true);
+    options.readahead_size = FLAGS_readahead_size;
+    Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
     int64_t bytes = 0;
     for (iter->SeekToLast(); i < reads_ && iter->Valid(); iter->Prev()) {
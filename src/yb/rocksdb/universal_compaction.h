@@ -89,6 +89,12 @@ class CompactionOptionsUniversal {
   // Default: false
   bool allow_trivial_move;
 
+  // When max_subcompactions is greater than 1 and all files are in level 0, a compaction is split
+  // into key ranges of at least this size, which are compacted in parallel. The resulting files
+  // stay in level 0 and form a single sorted run.
+  // Default: 64MB
+  uint64_t min_subcompaction_size;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -97,7 +103,8 @@ class CompactionOptionsUniversal {
         max_size_amplification_percent(200),
         compression_size_percent(-1),
         stop_style(kCompactionStopStyleTotalSize),
-        allow_trivial_move(false) {}
+        allow_trivial_move(false),
+        min_subcompaction_size(64 * 1024 * 1024) {}
 };
 
 }  // namespace rocksdb
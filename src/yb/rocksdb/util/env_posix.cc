@@ -126,6 +126,35 @@ static int LockOrUnlock(const std::string& fname, int fd, bool lock) {
   return value;
 }
 
+// Opens the file, with direct I/O if *direct is true. File systems that do not support direct I/O
+// (e.g. tmpfs) fail such open with EINVAL, in this case the file is opened for buffered I/O and
+// *direct is reset.
+int OpenFile(const std::string& fname, int flags, mode_t mode, bool* direct) {
+  int fd = -1;
+#if defined(O_DIRECT)
+  if (*direct) {
+    do {
+      IOSTATS_TIMER_GUARD(open_nanos);
+      fd = open(fname.c_str(), flags | O_DIRECT, mode);
+    } while (fd < 0 && errno == EINTR);
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+  }
+#endif
+  do {
+    IOSTATS_TIMER_GUARD(open_nanos);
+    fd = open(fname.c_str(), flags, mode);
+  } while (fd < 0 && errno == EINTR);
+#if !defined(O_DIRECT) && defined(F_NOCACHE)
+  if (fd >= 0 && *direct && fcntl(fd, F_NOCACHE, 1) != -1) {
+    return fd;
+  }
+#endif
+  *direct = false;
+  return fd;
+}
+
 class PosixFileLock : public FileLock {
  public:
   int fd_;
@@ -179,14 +208,13 @@ class PosixEnv : public Env {
                                      const EnvOptions& options) override {
     result->reset();
     Status s;
-    int fd;
-    {
-      IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
-    }
+    EnvOptions file_options = options;
+    int fd = OpenFile(fname, O_RDONLY, 0, &file_options.use_direct_reads);
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
       s = IOError(fname, errno);
+    } else if (file_options.use_direct_reads) {
+      result->reset(new PosixRandomAccessFile(fname, fd, file_options));
     } else if (options.use_mmap_reads && sizeof(void*) >= 8) {
       // Use of mmap for random reads has been removed because it
       // kills performance when storage is fast.
@@ -204,7 +232,7 @@ class PosixEnv : public Env {
       }
       close(fd);
     } else {
-      result->reset(new PosixRandomAccessFile(fname, fd, options));
+      result->reset(new PosixRandomAccessFile(fname, fd, file_options));
     }
     return s;
   }
@@ -214,13 +242,14 @@ class PosixEnv : public Env {
                                  const EnvOptions& options) override {
     result->reset();
     Status s;
-    int fd = -1;
-    do {
-      IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
-    } while (fd < 0 && errno == EINTR);
+    EnvOptions file_options = options;
+    int fd = OpenFile(fname, O_CREAT | O_RDWR | O_TRUNC, 0644, &file_options.use_direct_writes);
     if (fd < 0) {
       s = IOError(fname, errno);
+    } else if (file_options.use_direct_writes) {
+      SetFD_CLOEXEC(fd, &options);
+      file_options.use_mmap_writes = false;
+      result->reset(new PosixWritableFile(fname, fd, file_options));
     } else {
       SetFD_CLOEXEC(fd, &options);
       if (options.use_mmap_writes) {
@@ -237,7 +266,7 @@ class PosixEnv : public Env {
         result->reset(new PosixMmapFile(fname, fd, page_size_, options));
       } else {
         // disable mmap writes
-        EnvOptions no_mmap_writes_options = options;
+        EnvOptions no_mmap_writes_options = file_options;
         no_mmap_writes_options.use_mmap_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
@@ -283,6 +312,7 @@ class PosixEnv : public Env {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
         no_mmap_writes_options.use_mmap_writes = false;
+        no_mmap_writes_options.use_direct_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
       }
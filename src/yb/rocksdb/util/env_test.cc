@@ -46,6 +46,7 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/util/string_util.h"
@@ -967,6 +968,50 @@ TEST_F(EnvPosixTest, Preallocation) {
   ASSERT_EQ(last_allocated_block, 7UL);
 }
 
+// Writes and reads a file using direct I/O. File systems that do not support O_DIRECT fall back to
+// buffered I/O, so data should be the same in both cases.
+TEST_F(EnvPosixTest, DirectIO) {
+  const std::string fname = test::TmpDir() + "/" + "testfile";
+  EnvOptions soptions;
+  soptions.use_direct_writes = true;
+  soptions.use_direct_reads = true;
+
+  Random rnd(301);
+  std::string data;
+  RandomString(&rnd, 3 * 4096 + 123, &data);
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    WritableFileWriter writer(std::move(wfile), soptions);
+    // Unaligned appends with flushes in between, so partial pages are rewritten.
+    ASSERT_OK(writer.Append(Slice(data.data(), 1000)));
+    ASSERT_OK(writer.Flush());
+    ASSERT_OK(writer.Append(Slice(data.data() + 1000, data.size() - 1000)));
+    ASSERT_OK(writer.Close());
+  }
+
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  std::string scratch(data.size(), 0);
+  for (auto range : {std::make_pair(0, 4096), std::make_pair(1, 100), std::make_pair(4000, 5000),
+                     std::make_pair(8192, static_cast<int>(data.size() - 8192))}) {
+    Slice result;
+    ASSERT_OK(file->Read(range.first, range.second, &result, &scratch[0]));
+    ASSERT_EQ(Slice(data.data() + range.first, range.second), result);
+  }
+
+  // Read past the end of file.
+  Slice result;
+  ASSERT_OK(file->Read(data.size() - 10, 100, &result, &scratch[0]));
+  ASSERT_EQ(Slice(data.data() + data.size() - 10, 10), result);
+
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 // Test that the two ways to get children file attributes (in bulk or
 // individually) behave consistently.
 TEST_F(EnvPosixTest, ConsistentChildrenAttributes) {
@@ -60,6 +60,47 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+namespace {
+
+// Alignment of reads issued by FilePrefetchBuffer.
+constexpr size_t kPrefetchAlignment = 4096;
+
+} // namespace
+
+FilePrefetchBuffer::FilePrefetchBuffer() {
+  buffer_.Alignment(kPrefetchAlignment);
+}
+
+Status FilePrefetchBuffer::Prefetch(RandomAccessFileReader* reader, uint64_t offset, size_t n) {
+  const uint64_t aligned_offset = TruncateToPageBoundary(kPrefetchAlignment, offset);
+  const size_t aligned_size = Roundup(offset + n - aligned_offset, kPrefetchAlignment);
+  if (buffer_.Capacity() < aligned_size) {
+    buffer_.AllocateNewBuffer(aligned_size);
+  }
+  buffer_.Clear();
+
+  Slice result;
+  Status s = reader->Read(aligned_offset, aligned_size, &result, buffer_.Destination());
+  if (!s.ok()) {
+    return s;
+  }
+  if (result.cdata() != buffer_.BufferStart()) {
+    // File implementation returned its own buffer (e.g. mmap), copy the data.
+    memcpy(buffer_.Destination(), result.cdata(), result.size());
+  }
+  buffer_offset_ = aligned_offset;
+  buffer_.Size(result.size());
+  return Status::OK();
+}
+
+bool FilePrefetchBuffer::TryReadFromCache(uint64_t offset, size_t n, Slice* result) const {
+  if (offset < buffer_offset_ || offset + n > buffer_offset_ + buffer_.CurrentSize()) {
+    return false;
+  }
+  *result = Slice(buffer_.BufferStart() + (offset - buffer_offset_), n);
+  return true;
+}
+
 Status WritableFileWriter::Append(const Slice& data) {
   const char* src = data.cdata();
   size_t left = data.size();
@@ -106,6 +106,25 @@ class RandomAccessFileReader {
   RandomAccessFile* file() { return file_.get(); }
 };
 
+// Buffer for data read ahead from a file. Reads are extended to be aligned, so that they could be
+// served by direct I/O without extra copying.
+// Not thread-safe, it is intended to be used by a single iterator.
+class FilePrefetchBuffer {
+ public:
+  FilePrefetchBuffer();
+
+  // Reads [offset, offset + n) from the file to the buffer, replacing its previous contents.
+  Status Prefetch(RandomAccessFileReader* reader, uint64_t offset, size_t n);
+
+  // Returns true and sets *result to the buffered data if [offset, offset + n) is in the buffer.
+  bool TryReadFromCache(uint64_t offset, size_t n, Slice* result) const;
+
+ private:
+  AlignedBuffer buffer_;
+  // File offset of the first byte in the buffer.
+  uint64_t buffer_offset_ = 0;
+};
+
 // Use posix write to write data to a file.
 class WritableFileWriter {
  private:
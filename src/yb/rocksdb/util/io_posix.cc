@@ -42,6 +42,7 @@
 #endif
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/posix_logger.h"
@@ -155,15 +156,15 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const EnvOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
+    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer),
+      use_direct_io_(options.use_direct_reads) {
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
 }
 
 PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 
-Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
-                                   char* scratch) const {
-  Status s;
+Status PosixRandomAccessFile::ReadFully(uint64_t offset, size_t n, char* scratch,
+                                        size_t* read) const {
   ssize_t r = -1;
   size_t left = n;
   char* ptr = scratch;
@@ -171,7 +172,7 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
     r = pread(fd_, ptr, left, static_cast<off_t>(offset));
 
     if (r <= 0) {
-      if (errno == EINTR) {
+      if (r < 0 && errno == EINTR) {
         continue;
       }
       break;
@@ -181,12 +182,42 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
     left -= r;
   }
 
-  *result = Slice(scratch, (r < 0) ? 0 : n - left);
+  *read = n - left;
   if (r < 0) {
     // An error: return a non-ok status
-    s = IOError(filename_, errno);
+    *read = 0;
+    return IOError(filename_, errno);
   }
-  if (!use_os_buffer_) {
+  return Status::OK();
+}
+
+Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
+                                   char* scratch) const {
+  Status s;
+  size_t read = 0;
+  const auto IsAligned = [](uint64_t value) { return value % kDirectIOAlignment == 0; };
+  if (!use_direct_io_ ||
+      (IsAligned(offset) && IsAligned(n) && IsAligned(reinterpret_cast<uintptr_t>(scratch)))) {
+    s = ReadFully(offset, n, scratch, &read);
+  } else {
+    // Direct I/O requires aligned offset, size and buffer, so we read the enclosing pages to an
+    // aligned buffer and copy the requested range from it.
+    const uint64_t aligned_offset = TruncateToPageBoundary(kDirectIOAlignment, offset);
+    const size_t offset_in_buffer = offset - aligned_offset;
+    const size_t aligned_size = Roundup(offset_in_buffer + n, kDirectIOAlignment);
+    AlignedBuffer buffer;
+    buffer.Alignment(kDirectIOAlignment);
+    buffer.AllocateNewBuffer(aligned_size);
+    size_t aligned_read = 0;
+    s = ReadFully(aligned_offset, aligned_size, buffer.Destination(), &aligned_read);
+    if (aligned_read > offset_in_buffer) {
+      read = std::min(aligned_read - offset_in_buffer, n);
+      memcpy(scratch, buffer.BufferStart() + offset_in_buffer, read);
+    }
+  }
+
+  *result = Slice(scratch, read);
+  if (!use_os_buffer_ && !use_direct_io_) {
     // we need to fadvise away the entire range of pages because
     // we do not want readahead pages to be cached.
     Fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);  // free OS pages
@@ -517,7 +548,7 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
                                      const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+    : filename_(fname), fd_(fd), filesize_(0), use_direct_io_(options.use_direct_writes) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +580,39 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  assert(use_direct_io_);
+  assert(offset % kDirectIOAlignment == 0);
+  assert(data.size() % kDirectIOAlignment == 0);
+  const char* src = data.cdata();
+  size_t left = data.size();
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOError(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    offset += done;
+  }
+  filesize_ = std::max<uint64_t>(filesize_, offset);
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!use_direct_io_) {
+    return Status::OK();
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+    return IOError(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
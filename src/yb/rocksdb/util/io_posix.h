@@ -39,6 +39,9 @@
 
 namespace rocksdb {
 
+// Alignment of file offsets, sizes and memory buffers used for direct I/O.
+constexpr size_t kDirectIOAlignment = 4096;
+
 static Status IOError(const std::string& context, int err_number) {
   return STATUS(IOError, context, strerror(err_number));
 }
@@ -65,6 +68,11 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  // File is opened with O_DIRECT, so reads should be aligned to kDirectIOAlignment.
+  bool use_direct_io_;
+
+  // Reads until n bytes are read or end of file is reached, returns number of read bytes in *read.
+  Status ReadFully(uint64_t offset, size_t n, char* scratch, size_t* read) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -85,6 +93,8 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // File is opened with O_DIRECT, so it is written with aligned PositionedAppend calls.
+  const bool use_direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -95,17 +105,21 @@ class PosixWritableFile : public WritableFile {
                     const EnvOptions& options);
   ~PosixWritableFile();
 
-  // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  // With buffered I/O Close() will properly take care of truncate and it does not need any
+  // additional information. With direct I/O whole pages are written, so the file is truncated to
+  // the size of written data.
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
   virtual Status Append(const Slice& data) override;
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
   virtual bool IsSyncThreadSafe() const override;
   virtual uint64_t GetFileSize() override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
+  virtual size_t GetRequiredBufferAlignment() const override { return kDirectIOAlignment; }
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   virtual Status Allocate(uint64_t offset, uint64_t len) override;
   virtual Status RangeSync(uint64_t offset, uint64_t nbytes) override;
@@ -85,6 +85,7 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       use_fsync(options.use_fsync),
       compression(options.compression),
       compression_per_level(options.compression_per_level),
+      bottommost_compression(options.bottommost_compression),
       compression_opts(options.compression_opts),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
@@ -107,6 +108,7 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       min_write_buffer_number_to_merge(1),
       max_write_buffer_number_to_maintain(0),
       compression(Snappy_Supported() ? kSnappyCompression : kNoCompression),
+      bottommost_compression(kDisableCompressionOption),
       prefix_extractor(nullptr),
       num_levels(7),
       level0_file_num_compaction_trigger(4),
@@ -165,6 +167,7 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
           options.max_write_buffer_number_to_maintain),
       compression(options.compression),
       compression_per_level(options.compression_per_level),
+      bottommost_compression(options.bottommost_compression),
       compression_opts(options.compression_opts),
       prefix_extractor(options.prefix_extractor),
       num_levels(options.num_levels),
@@ -253,6 +256,7 @@ DBOptions::DBOptions()
       num_reserved_small_compaction_threads(-1),
       compaction_size_threshold_bytes(std::numeric_limits<uint64_t>::max()),
       max_subcompactions(1),
+      priority_thread_pool_for_compactions(nullptr),
       max_background_flushes(1),
       max_log_file_size(0),
       log_file_time_to_roll(0),
@@ -267,6 +271,7 @@ DBOptions::DBOptions()
       allow_mmap_reads(false),
       allow_mmap_writes(false),
       allow_fallocate(true),
+      use_direct_io_for_flush_and_compaction(false),
       is_fd_close_on_exec(true),
       skip_log_error_on_recovery(false),
       stats_dump_period_sec(600),
@@ -285,6 +290,9 @@ DBOptions::DBOptions()
       delayed_write_rate(2 * 1024U * 1024U),
       allow_concurrent_memtable_write(false),
       enable_write_thread_adaptive_yield(false),
+      memtable_insert_thread_pool(nullptr),
+      memtable_insert_min_entries_per_thread(1024),
+      memtable_insert_max_threads(4),
       write_thread_max_yield_usec(100),
       write_thread_slow_yield_usec(3),
       skip_stats_update_on_db_open(false),
@@ -326,6 +334,8 @@ void DBOptions::Dump(Logger* log) const {
   RHEADER(log, "       Options.allow_os_buffer: %d", allow_os_buffer);
   RHEADER(log, "      Options.allow_mmap_reads: %d", allow_mmap_reads);
   RHEADER(log, "      Options.allow_fallocate: %d", allow_fallocate);
+  RHEADER(log, "      Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(log, "     Options.allow_mmap_writes: %d", allow_mmap_writes);
   RHEADER(log, "         Options.create_missing_column_families: %d",
       create_missing_column_families);
@@ -404,6 +414,10 @@ void DBOptions::Dump(Logger* log) const {
       allow_concurrent_memtable_write);
   RHEADER(log, "      Options.enable_write_thread_adaptive_yield: %d",
       enable_write_thread_adaptive_yield);
+  RHEADER(log, "  Options.memtable_insert_min_entries_per_thread: %" ROCKSDB_PRIszt,
+      memtable_insert_min_entries_per_thread);
+  RHEADER(log, "             Options.memtable_insert_max_threads: %" ROCKSDB_PRIszt,
+      memtable_insert_max_threads);
   RHEADER(log, "             Options.write_thread_max_yield_usec: %" PRIu64,
       write_thread_max_yield_usec);
   RHEADER(log, "            Options.write_thread_slow_yield_usec: %" PRIu64,
@@ -445,6 +459,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       RHEADER(log, "         Options.compression: %s",
           CompressionTypeToString(compression).c_str());
     }
+    RHEADER(log, "      Options.bottommost_compression: %s",
+        bottommost_compression == kDisableCompressionOption
+            ? "Disabled" : CompressionTypeToString(bottommost_compression).c_str());
   RHEADER(log, "      Options.prefix_extractor: %s",
       prefix_extractor == nullptr ? "nullptr" : prefix_extractor->Name());
   RHEADER(log, "            Options.num_levels: %d", num_levels);
@@ -458,6 +475,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -521,6 +540,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "Options.compaction_options_universal.compression_size_percent: %d",
       compaction_options_universal.compression_size_percent);
+  RHEADER(log,
+      "Options.compaction_options_universal.min_subcompaction_size: %" PRIu64,
+      compaction_options_universal.min_subcompaction_size);
   RHEADER(log,
       "Options.compaction_options_fifo.max_table_files_size: %" PRIu64,
       compaction_options_fifo.max_table_files_size);
@@ -182,6 +182,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"allow_fallocate",
      {offsetof(struct DBOptions, allow_fallocate), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
+    {"use_direct_io_for_flush_and_compaction",
+     {offsetof(struct DBOptions, use_direct_io_for_flush_and_compaction), OptionType::kBoolean,
+      OptionVerificationType::kNormal}},
     {"allow_mmap_writes",
      {offsetof(struct DBOptions, allow_mmap_writes), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
@@ -326,6 +329,12 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"enable_write_thread_adaptive_yield",
      {offsetof(struct DBOptions, enable_write_thread_adaptive_yield),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"memtable_insert_min_entries_per_thread",
+     {offsetof(struct DBOptions, memtable_insert_min_entries_per_thread),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"memtable_insert_max_threads",
+     {offsetof(struct DBOptions, memtable_insert_max_threads),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
     {"write_thread_slow_yield_usec",
      {offsetof(struct DBOptions, write_thread_slow_yield_usec),
       OptionType::kUInt64T, OptionVerificationType::kNormal}},
@@ -485,6 +494,9 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
     {"compression_per_level",
      {offsetof(struct ColumnFamilyOptions, compression_per_level),
       OptionType::kVectorCompressionType, OptionVerificationType::kNormal}},
+    {"bottommost_compression",
+     {offsetof(struct ColumnFamilyOptions, bottommost_compression),
+      OptionType::kCompressionType, OptionVerificationType::kNormal}},
     {"comparator",
      {offsetof(struct ColumnFamilyOptions, comparator), OptionType::kComparator,
       OptionVerificationType::kByName}},
@@ -522,6 +534,12 @@ static std::unordered_map<std::string,
     {"cache_index_and_filter_blocks",
      {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"pin_top_level_index",
+     {offsetof(struct BlockBasedTableOptions, pin_top_level_index),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"cache_index_and_filter_blocks_with_high_priority",
+     {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks_with_high_priority),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"index_type",
      {offsetof(struct BlockBasedTableOptions, index_type),
       OptionType::kBlockBasedTableIndexType, OptionVerificationType::kNormal}},
@@ -555,6 +573,9 @@ static std::unordered_map<std::string,
     {"min_keys_per_index_block",
      {offsetof(struct BlockBasedTableOptions, min_keys_per_index_block), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
+    {"max_auto_readahead_size",
+     {offsetof(struct BlockBasedTableOptions, max_auto_readahead_size), OptionType::kSizeT,
+      OptionVerificationType::kNormal}},
     {"filter_policy",
      {offsetof(struct BlockBasedTableOptions, filter_policy),
       OptionType::kFilterPolicy, OptionVerificationType::kByName}},
@@ -602,7 +623,8 @@ static std::unordered_map<std::string, CompressionType>
         {"kBZip2Compression", kBZip2Compression},
         {"kLZ4Compression", kLZ4Compression},
         {"kLZ4HCCompression", kLZ4HCCompression},
-        {"kZSTDNotFinalCompression", kZSTDNotFinalCompression}};
+        {"kZSTDNotFinalCompression", kZSTDNotFinalCompression},
+        {"kDisableCompressionOption", kDisableCompressionOption}};
 
 static std::unordered_map<std::string, IndexType>
     block_base_table_index_type_string_map = {
@@ -127,7 +127,8 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
        "kLZ4Compression:"
        "kLZ4HCCompression:"
        "kZSTDNotFinalCompression"},
-      {"compression_opts", "4:5:6"},
+      {"compression_opts", "4:5:6:7"},
+      {"bottommost_compression", "kLZ4Compression"},
       {"num_levels", "7"},
       {"level0_file_num_compaction_trigger", "8"},
       {"level0_slowdown_writes_trigger", "9"},
@@ -223,6 +224,8 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.compression_opts.window_bits, 4);
   ASSERT_EQ(new_cf_opt.compression_opts.level, 5);
   ASSERT_EQ(new_cf_opt.compression_opts.strategy, 6);
+  ASSERT_EQ(new_cf_opt.compression_opts.max_dict_bytes, 7U);
+  ASSERT_EQ(new_cf_opt.bottommost_compression, kLZ4Compression);
   ASSERT_EQ(new_cf_opt.num_levels, 7);
   ASSERT_EQ(new_cf_opt.level0_file_num_compaction_trigger, 8);
   ASSERT_EQ(new_cf_opt.level0_slowdown_writes_trigger, 9);
@@ -484,14 +487,17 @@ TEST_F(OptionsTest, GetBlockBasedTableOptionsFromString) {
   BlockBasedTableOptions new_opt;
   // make sure default values are overwritten by something else
   ASSERT_OK(GetBlockBasedTableOptionsFromString(table_opt,
-            "cache_index_and_filter_blocks=1;index_type=kHashSearch;"
+            "cache_index_and_filter_blocks=1;pin_top_level_index=1;"
+            "cache_index_and_filter_blocks_with_high_priority=1;index_type=kHashSearch;"
             "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
             "block_cache=1M;block_cache_compressed=1k;block_size=1024;filter_block_size=4096;"
             "block_size_deviation=8;block_restart_interval=4;index_block_size=16384;"
-            "min_keys_per_index_block=16;filter_policy=bloomfilter:4:true;whole_key_filtering=1;"
-            "skip_table_builder_flush=1",
+            "min_keys_per_index_block=16;max_auto_readahead_size=65536;"
+            "filter_policy=bloomfilter:4:true;whole_key_filtering=1;skip_table_builder_flush=1",
             &new_opt));
   ASSERT_TRUE(new_opt.cache_index_and_filter_blocks);
+  ASSERT_TRUE(new_opt.pin_top_level_index);
+  ASSERT_TRUE(new_opt.cache_index_and_filter_blocks_with_high_priority);
   ASSERT_EQ(new_opt.index_type, IndexType::kHashSearch);
   ASSERT_EQ(new_opt.checksum, ChecksumType::kxxHash);
   ASSERT_TRUE(new_opt.hash_index_allow_collision);
@@ -506,6 +512,7 @@ TEST_F(OptionsTest, GetBlockBasedTableOptionsFromString) {
   ASSERT_EQ(new_opt.block_restart_interval, 4);
   ASSERT_EQ(new_opt.index_block_size, 16384UL);
   ASSERT_EQ(new_opt.min_keys_per_index_block, 16);
+  ASSERT_EQ(new_opt.max_auto_readahead_size, 65536UL);
   ASSERT_TRUE(new_opt.filter_policy != nullptr);
   ASSERT_TRUE(new_opt.skip_table_builder_flush);
 
@@ -1617,11 +1624,13 @@ void InitDefault(BlockBasedTableOptions*) {}
 
 Status GetFromString(BlockBasedTableOptions* source, BlockBasedTableOptions* destination) {
   const char* const kOptionsString =
-      "cache_index_and_filter_blocks=1;index_type=kHashSearch;"
+      "cache_index_and_filter_blocks=1;pin_top_level_index=1;"
+      "cache_index_and_filter_blocks_with_high_priority=1;index_type=kHashSearch;"
       "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;filter_block_size=16384;"
       "block_size_deviation=8;block_restart_interval=4; "
       "index_block_restart_interval=4;index_block_size=16384;min_keys_per_index_block=16;"
+      "max_auto_readahead_size=65536;"
       "filter_policy=bloomfilter:4:true;whole_key_filtering=1;"
       "skip_table_builder_flush=1;format_version=1;"
       "hash_index_allow_collision=false;";
@@ -1683,6 +1692,7 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "allow_mmap_writes=true;"
       "stats_dump_period_sec=70127;"
       "allow_fallocate=true;"
+      "use_direct_io_for_flush_and_compaction=true;"
       "allow_mmap_reads=true;"
       "max_log_file_size=4607;"
       "random_access_max_buffer_size=1048576;"
@@ -1691,6 +1701,8 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "allow_concurrent_memtable_write=true;"
       "wal_recovery_mode=kPointInTimeRecovery;"
       "enable_write_thread_adaptive_yield=true;"
+      "memtable_insert_min_entries_per_thread=517;"
+      "memtable_insert_max_threads=7;"
       "write_thread_slow_yield_usec=5;"
       "write_thread_max_yield_usec=1000;"
       "access_hint_on_compaction_start=NONE;"
@@ -1890,6 +1902,7 @@ TEST_F(OptionsParserTest, BlockBasedTableOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache_compressed),
       BLACKLIST_ENTRY(BlockBasedTableOptions, filter_policy),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, mem_tracker),
   };
 
   // In this test, we catch a new option of BlockBasedTableOptions that is not
@@ -1918,8 +1931,10 @@ TEST_F(OptionsParserTest, DBOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(DBOptions, db_paths),
       BLACKLIST_ENTRY(DBOptions, db_log_dir),
       BLACKLIST_ENTRY(DBOptions, wal_dir),
+      BLACKLIST_ENTRY(DBOptions, priority_thread_pool_for_compactions),
       BLACKLIST_ENTRY(DBOptions, memory_monitor),
       BLACKLIST_ENTRY(DBOptions, listeners),
+      BLACKLIST_ENTRY(DBOptions, memtable_insert_thread_pool),
       BLACKLIST_ENTRY(DBOptions, row_cache),
       BLACKLIST_ENTRY(DBOptions, wal_filter),
       BLACKLIST_ENTRY(DBOptions, boundary_extractor),
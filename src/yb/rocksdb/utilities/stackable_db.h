@@ -273,6 +273,10 @@ class StackableDB : public DB {
     return db_->SetFlushedFrontier(std::move(values));
   }
 
+  CHECKED_STATUS ResetFlushedFrontier(UserFrontierPtr values) override {
+    return db_->ResetFlushedFrontier(std::move(values));
+  }
+
   virtual void GetColumnFamilyMetaData(
       ColumnFamilyHandle *column_family,
       ColumnFamilyMetaData* cf_meta) override {
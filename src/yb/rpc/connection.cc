@@ -443,7 +443,7 @@ Status Connection::DoWrite() {
     const int iov_len = static_cast<int>(std::min(kMaxIov, sending_.size()));
     size_t offset = send_position_;
     for (auto i = 0; i != iov_len; ++i) {
-      iov[i].iov_base = sending_[i].data() + offset;
+      iov[i].iov_base = const_cast<uint8_t*>(sending_[i].data()) + offset;
       iov[i].iov_len = sending_[i].size() - offset;
       offset = 0;
     }
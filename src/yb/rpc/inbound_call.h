@@ -101,6 +101,11 @@ class InboundCall : public RpcCall {
 
   Trace* trace();
 
+  // Time when this call was received.
+  MonoTime ReceiveTime() const {
+    return timing_.time_received;
+  }
+
   // When this InboundCall was received (instantiated).
   // Should only be called once on a given instance.
   // Not thread-safe. Should only be called by the current "owner" thread.
@@ -38,7 +38,7 @@ Status LocalOutboundCall::SetRequestParam(const google::protobuf::Message& req)
   return Status::OK();
 }
 
-void LocalOutboundCall::Serialize(std::deque<RefCntBuffer> *output) const {
+void LocalOutboundCall::Serialize(std::deque<RefCntSlice> *output) const {
   LOG(FATAL) << "local call should not require serialization";
 }
 
@@ -61,6 +61,15 @@ Status LocalOutboundCall::GetSidecar(int idx, Slice* sidecar) const {
   return Status::OK();
 }
 
+Status LocalOutboundCall::GetSidecarHolder(int idx, RefCntSlice* sidecar) const {
+  if (idx < 0 || idx >= inbound_call_->sidecars().size()) {
+    return STATUS(InvalidArgument, strings::Substitute(
+        "Index $0 does not reference a valid sidecar", idx));
+  }
+  *sidecar = inbound_call_->sidecars()[idx];
+  return Status::OK();
+}
+
 LocalYBInboundCall::LocalYBInboundCall(
     const RemoteMethod& remote_method, std::weak_ptr<LocalOutboundCall> outbound_call,
     const MonoTime& deadline)
@@ -223,7 +223,7 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
   }
 }
 
-void OutboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void OutboundCall::Serialize(std::deque<RefCntSlice>* output) const {
   output->push_back(buffer_);
 }
 
@@ -466,6 +466,10 @@ Status OutboundCall::GetSidecar(int idx, Slice* sidecar) const {
   return call_response_.GetSidecar(idx, sidecar);
 }
 
+Status OutboundCall::GetSidecarHolder(int idx, RefCntSlice* sidecar) const {
+  return call_response_.GetSidecarHolder(idx, sidecar);
+}
+
 string OutboundCall::ToString() const {
   return Format("RPC call $0 -> $1 , state=$2.", *remote_method_, conn_id_, StateName(state_));
 }
@@ -547,12 +551,19 @@ Status CallResponse::GetSidecar(int idx, Slice* sidecar) const {
   return Status::OK();
 }
 
+Status CallResponse::GetSidecarHolder(int idx, RefCntSlice* sidecar) const {
+  Slice slice;
+  RETURN_NOT_OK(GetSidecar(idx, &slice));
+  *sidecar = RefCntSlice(response_data_, slice);
+  return Status::OK();
+}
+
 Status CallResponse::ParseFrom(Slice source) {
   CHECK(!parsed_);
   Slice entire_message;
 
-  response_data_.assign(source.data(), source.end());
-  source = Slice(response_data_.data(), response_data_.size());
+  response_data_ = RefCntBuffer(source.data(), source.size());
+  source = Slice(response_data_.udata(), response_data_.size());
   RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
 
   // Use information from header to extract the payload slices.
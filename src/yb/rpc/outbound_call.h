@@ -157,6 +157,9 @@ class CallResponse {
   // See RpcController::GetSidecar()
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  // See RpcController::GetSidecarHolder()
+  CHECKED_STATUS GetSidecarHolder(int idx, RefCntSlice* sidecar) const;
+
  private:
   // True once ParseFrom() is called.
   bool parsed_;
@@ -174,7 +177,7 @@ class CallResponse {
 
   // The incoming transfer data - retained because serialized_response_
   // and sidecar_slices_ refer into its data.
-  std::vector<uint8_t> response_data_;
+  RefCntBuffer response_data_;
 
   DISALLOW_COPY_AND_ASSIGN(CallResponse);
 };
@@ -206,7 +209,7 @@ class OutboundCall : public RpcCall {
 
   // Serialize the call for the wire. Requires that SetRequestParam()
   // is called first. This is called from the Reactor thread.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(std::deque<RefCntSlice>* output) const override;
 
   // Callback after the call has been put on the outbound connection queue.
   void SetQueued();
@@ -263,6 +266,8 @@ class OutboundCall : public RpcCall {
 
   virtual CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  virtual CHECKED_STATUS GetSidecarHolder(int idx, RefCntSlice* sidecar) const;
+
   const ConnectionId conn_id_;
   MonoTime start_;
   RpcController* const controller_;
@@ -62,6 +62,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
+#include "yb/util/sampling_profiler.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/thread_restrictions.h"
@@ -426,6 +427,7 @@ void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
   DVLOG(6) << "Calling Reactor::RunThread()...";
+  ScopedProfilerTag profiler_tag("rpc", "reactor");
   loop_.run(0);
   VLOG(1) << name() << " thread exiting.";
 
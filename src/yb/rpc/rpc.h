@@ -113,6 +113,10 @@ class RpcRetrier {
   // Callers should ensure that 'rpc' remains alive.
   CHECKED_STATUS DelayedRetry(RpcCommand* rpc, const Status& why_status);
 
+  // Same as DelayedRetry, but sends the RPC again without a backoff delay. Should be used only
+  // when the RPC is known to succeed on retry, e.g. because it is sent to another server.
+  CHECKED_STATUS RetryWithoutDelay(RpcCommand* rpc, const Status& why_status);
+
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
 
@@ -137,6 +141,8 @@ class RpcRetrier {
   }
 
  private:
+  CHECKED_STATUS DoDelayedRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay);
+
   // Called when an RPC comes up for retrying. Actually sends the RPC.
   void DoRetry(RpcCommand* rpc, const Status& status);
 
@@ -191,6 +191,10 @@ MonoTime RpcContext::GetClientDeadline() const {
   return call_->GetClientDeadline();
 }
 
+MonoTime RpcContext::ReceiveTime() const {
+  return call_->ReceiveTime();
+}
+
 Trace* RpcContext::trace() {
   return call_->trace();
 }
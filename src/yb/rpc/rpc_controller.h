@@ -44,6 +44,8 @@
 
 namespace yb {
 
+class RefCntSlice;
+
 namespace rpc {
 
 class ErrorStatusPB;
@@ -136,6 +138,10 @@ class RpcController {
   // May fail if index is invalid.
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  // Same as GetSidecar(), but the returned sidecar keeps the response data alive, so it could be
+  // used after this controller is Reset() or destroyed.
+  CHECKED_STATUS GetSidecarHolder(int idx, RefCntSlice* sidecar) const;
+
  private:
   friend class OutboundCall;
   friend class Proxy;
@@ -48,6 +48,7 @@
 
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/metrics.h"
+#include "yb/util/sampling_profiler.h"
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
 #include "yb/util/trace.h"
@@ -59,7 +60,8 @@ METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
                         yb::MetricUnit::kMicroseconds,
                         "Number of microseconds incoming RPC requests spend in the worker queue",
-                        60000000LU, 3);
+                        60000000LU, 2,
+                        yb::STRIPED_HISTOGRAM);
 
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
@@ -188,6 +190,7 @@ class ServicePoolImpl {
 
     TRACE_TO(incoming->trace(), "Handling call");
 
+    ScopedProfilerTag profiler_tag(incoming->service_name(), incoming->method_name());
     service_->Handle(std::move(incoming));
   }
 
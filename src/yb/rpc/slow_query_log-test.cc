@@ -0,0 +1,124 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/rpc/slow_query_log.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/net/sockaddr.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(slow_query_log_max_query_size);
+DECLARE_int32(slow_query_log_request_trace_threshold_percent);
+DECLARE_int32(slow_query_log_size);
+DECLARE_int32(slow_query_log_threshold_ms);
+
+namespace yb {
+namespace rpc {
+
+class SlowQueryLogTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    DumpSlowQueriesResponsePB resp;
+    DumpSlowQueries(/* reset */ true, &resp);
+  }
+};
+
+TEST_F(SlowQueryLogTest, Bounded) {
+  FLAGS_slow_query_log_size = 3;
+  Endpoint remote(IpAddress::from_string("127.0.0.1"), 9042);
+  for (int i = 0; i != 5; ++i) {
+    RpcCallInProgressPB call;
+    call.set_micros_elapsed(i);
+    call.set_trace_buffer(Format("trace $0", i));
+    AddSlowQuery(remote, std::move(call));
+  }
+
+  DumpSlowQueriesResponsePB resp;
+  DumpSlowQueries(/* reset */ false, &resp);
+  // Only the most recent calls are kept, and they are listed starting from the most recent one.
+  ASSERT_EQ(3, resp.queries_size());
+  for (int i = 0; i != resp.queries_size(); ++i) {
+    const auto& query = resp.queries(i);
+    ASSERT_EQ(yb::ToString(remote), query.remote_ip());
+    ASSERT_EQ(static_cast<uint64_t>(4 - i), query.call().micros_elapsed());
+    ASSERT_EQ(Format("trace $0", 4 - i), query.call().trace_buffer());
+  }
+
+  resp.Clear();
+  DumpSlowQueries(/* reset */ true, &resp);
+  ASSERT_EQ(3, resp.queries_size());
+  resp.Clear();
+  DumpSlowQueries(/* reset */ false, &resp);
+  ASSERT_EQ(0, resp.queries_size());
+}
+
+TEST_F(SlowQueryLogTest, QueryTruncated) {
+  FLAGS_slow_query_log_size = 3;
+  FLAGS_slow_query_log_max_query_size = 10;
+  Endpoint remote(IpAddress::from_string("127.0.0.1"), 9042);
+  RpcCallInProgressPB call;
+  auto* details = call.mutable_cql_details();
+  details->set_type("BATCH");
+  for (const auto* text : {"INSERT 1", "INSERT 22", "INSERT 333"}) {
+    details->add_call_details()->set_sql_string(text);
+  }
+  AddSlowQuery(remote, std::move(call));
+
+  DumpSlowQueriesResponsePB resp;
+  DumpSlowQueries(/* reset */ true, &resp);
+  ASSERT_EQ(1, resp.queries_size());
+  // The statements that do not fit into the limit are truncated or dropped.
+  const auto& call_details = resp.queries(0).call().cql_details().call_details();
+  ASSERT_EQ(2, call_details.size());
+  ASSERT_EQ("INSERT 1", call_details.Get(0).sql_string());
+  ASSERT_EQ("IN", call_details.Get(1).sql_string());
+}
+
+TEST_F(SlowQueryLogTest, MemTracked) {
+  FLAGS_slow_query_log_size = 3;
+  const auto tracker = MemTracker::FindOrCreateTracker(-1, "Slow Query Log");
+  ASSERT_EQ(0, tracker->consumption());
+  Endpoint remote(IpAddress::from_string("127.0.0.1"), 9042);
+  for (int i = 0; i != 5; ++i) {
+    RpcCallInProgressPB call;
+    call.set_trace_buffer(std::string(10000, 'x'));
+    AddSlowQuery(remote, std::move(call));
+  }
+  // Only the kept calls are charged.
+  ASSERT_GT(tracker->consumption(), 3 * 10000);
+  ASSERT_LT(tracker->consumption(), 4 * 10000);
+
+  DumpSlowQueriesResponsePB resp;
+  DumpSlowQueries(/* reset */ true, &resp);
+  ASSERT_EQ(0, tracker->consumption());
+}
+
+TEST_F(SlowQueryLogTest, Threshold) {
+  FLAGS_slow_query_log_threshold_ms = 500;
+  ASSERT_TRUE(IsSlowQueryLogEnabled());
+  ASSERT_EQ(500, SlowQueryLogThreshold().ToMilliseconds());
+  // Tablet server requests return their traces when they take a fraction of the threshold.
+  FLAGS_slow_query_log_request_trace_threshold_percent = 10;
+  ASSERT_EQ(50, SlowQueryLogRequestTraceThreshold().ToMilliseconds());
+  FLAGS_slow_query_log_threshold_ms = 0;
+  ASSERT_FALSE(IsSlowQueryLogEnabled());
+}
+
+} // namespace rpc
+} // namespace yb
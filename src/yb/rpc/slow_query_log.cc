@@ -0,0 +1,190 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rpc/slow_query_log.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/walltime.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/net/sockaddr.h"
+
+DEFINE_int32(slow_query_log_threshold_ms, 1000,
+             "CQL and Redis calls that take longer than this threshold (in ms) are added to the "
+             "slow query log, with their traces. Non-positive value disables the slow query log.");
+TAG_FLAG(slow_query_log_threshold_ms, advanced);
+TAG_FLAG(slow_query_log_threshold_ms, runtime);
+
+DEFINE_int32(slow_query_log_size, 100,
+             "Maximal number of calls kept in the slow query log.");
+TAG_FLAG(slow_query_log_size, advanced);
+TAG_FLAG(slow_query_log_size, runtime);
+
+DEFINE_int32(slow_query_log_request_trace_threshold_percent, 10,
+             "Tablet server requests sent by a call, that could be added to the slow query log, "
+             "return their traces when handling them takes at least this percentage of "
+             "slow_query_log_threshold_ms.");
+TAG_FLAG(slow_query_log_request_trace_threshold_percent, advanced);
+TAG_FLAG(slow_query_log_request_trace_threshold_percent, runtime);
+
+DEFINE_int32(slow_query_log_max_query_size, 1024,
+             "Maximal total size of the query text kept for a call in the slow query log. Longer "
+             "queries are truncated, and the statements of a batch that do not fit are dropped.");
+TAG_FLAG(slow_query_log_max_query_size, advanced);
+TAG_FLAG(slow_query_log_max_query_size, runtime);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+// Truncates the statements, so that their total size does not exceed *budget, and drops the ones
+// that do not fit at all.
+template <class Details, class Mutator>
+void TruncateStatements(Details* details, size_t* budget, const Mutator& mutable_text) {
+  for (int i = 0; i != details->size(); ++i) {
+    if (*budget == 0) {
+      details->DeleteSubrange(i, details->size() - i);
+      return;
+    }
+    std::string* text = mutable_text(details->Mutable(i));
+    if (text->size() > *budget) {
+      text->resize(*budget);
+    }
+    *budget -= text->size();
+  }
+}
+
+void TruncateQuery(RpcCallInProgressPB* call) {
+  size_t budget = std::max(FLAGS_slow_query_log_max_query_size, 0);
+  if (call->has_cql_details()) {
+    TruncateStatements(
+        call->mutable_cql_details()->mutable_call_details(), &budget,
+        [](CQLStatementsDetailsPB* details) { return details->mutable_sql_string(); });
+  } else if (call->has_redis_details()) {
+    TruncateStatements(
+        call->mutable_redis_details()->mutable_call_details(), &budget,
+        [](RedisStatementsDetailsPB* details) { return details->mutable_redis_string(); });
+  }
+}
+
+// The memory used by the kept calls is charged to the "Slow Query Log" memory tracker.
+class SlowQueryLog {
+ public:
+  SlowQueryLog() : mem_tracker_(MemTracker::FindOrCreateTracker(-1, "Slow Query Log")) {}
+
+  ~SlowQueryLog() {
+    mem_tracker_->Release(consumption_);
+  }
+
+  void Add(SlowQueryPB query) {
+    const int64_t size = query.SpaceUsed();
+    mem_tracker_->Consume(size);
+    std::deque<Entry> evicted;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      consumption_ += size;
+      entries_.push_back(Entry{std::move(query), size});
+      const size_t max_size = std::max(FLAGS_slow_query_log_size, 0);
+      while (entries_.size() > max_size) {
+        evicted.push_back(std::move(entries_.front()));
+        entries_.pop_front();
+      }
+      ReleaseUnlocked(evicted);
+    }
+  }
+
+  void Dump(bool reset, DumpSlowQueriesResponsePB* resp) {
+    std::deque<Entry> entries;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (reset) {
+        entries.swap(entries_);
+        ReleaseUnlocked(entries);
+      } else {
+        entries = entries_;
+      }
+    }
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+      resp->add_queries()->Swap(&it->query);
+    }
+  }
+
+ private:
+  struct Entry {
+    SlowQueryPB query;
+    // Memory charged for the query.
+    int64_t size;
+  };
+
+  // Releases the memory charged for the entries, that were removed from the log.
+  void ReleaseUnlocked(const std::deque<Entry>& entries) {
+    int64_t size = 0;
+    for (const auto& entry : entries) {
+      size += entry.size;
+    }
+    consumption_ -= size;
+    mem_tracker_->Release(size);
+  }
+
+  const std::shared_ptr<MemTracker> mem_tracker_;
+  std::mutex mutex_;
+  std::deque<Entry> entries_;
+  // Memory charged to mem_tracker_. Protected by mutex_.
+  int64_t consumption_ = 0;
+};
+
+SlowQueryLog& GetSlowQueryLog() {
+  static SlowQueryLog log;
+  return log;
+}
+
+} // namespace
+
+bool IsSlowQueryLogEnabled() {
+  return FLAGS_slow_query_log_threshold_ms > 0 && FLAGS_slow_query_log_size > 0;
+}
+
+MonoDelta SlowQueryLogThreshold() {
+  return MonoDelta::FromMilliseconds(FLAGS_slow_query_log_threshold_ms);
+}
+
+MonoDelta SlowQueryLogRequestTraceThreshold() {
+  return MonoDelta::FromMicroseconds(
+      FLAGS_slow_query_log_threshold_ms * 1000LL *
+      std::max(FLAGS_slow_query_log_request_trace_threshold_percent, 0) / 100);
+}
+
+void AddSlowQuery(const Endpoint& remote, RpcCallInProgressPB call) {
+  TruncateQuery(&call);
+  SlowQueryPB query;
+  query.set_remote_ip(yb::ToString(remote));
+  query.set_received_micros(GetCurrentTimeMicros() - call.micros_elapsed());
+  query.mutable_call()->Swap(&call);
+  GetSlowQueryLog().Add(std::move(query));
+}
+
+void DumpSlowQueries(bool reset, DumpSlowQueriesResponsePB* resp) {
+  GetSlowQueryLog().Dump(reset, resp);
+}
+
+} // namespace rpc
+} // namespace yb
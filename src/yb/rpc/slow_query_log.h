@@ -0,0 +1,53 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_RPC_SLOW_QUERY_LOG_H
+#define YB_RPC_SLOW_QUERY_LOG_H
+
+#include "yb/rpc/rpc_introspection.pb.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/net/net_fwd.h"
+
+namespace yb {
+namespace rpc {
+
+// Process wide log of the most recent CQL and Redis calls that took longer than
+// slow_query_log_threshold_ms. The log keeps up to slow_query_log_size calls, the oldest ones are
+// evicted first. Every call is kept together with its trace, that has a time delta for each stage
+// the call went through: parsing, tablet lookup, batching, RPC queueing and the tablet server
+// stages.
+
+// Returns true if the slow query log is enabled.
+bool IsSlowQueryLogEnabled();
+
+// Returns the threshold for a call to be added to the slow query log.
+MonoDelta SlowQueryLogThreshold();
+
+// Returns how long handling of a tablet server request should take for the request to return its
+// trace. A call could send several requests, each of them taking only a part of the call time, so
+// this is a fraction of SlowQueryLogThreshold().
+MonoDelta SlowQueryLogRequestTraceThreshold();
+
+// Adds the call to the log.
+void AddSlowQuery(const Endpoint& remote, RpcCallInProgressPB call);
+
+// Fills resp with the calls from the log. If reset is true, the log is cleared.
+void DumpSlowQueries(bool reset, DumpSlowQueriesResponsePB* resp);
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_SLOW_QUERY_LOG_H
@@ -0,0 +1,39 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/server/profilez-path-handler.h"
+
+#include <sstream>
+#include <string>
+
+#include "yb/gutil/map-util.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/server/webserver.h"
+#include "yb/util/sampling_profiler.h"
+
+namespace yb {
+
+namespace {
+
+void ProfilezPathHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  std::string reset = FindWithDefault(req.parsed_args, "reset", "false");
+  DumpSamplingProfile(output, ParseLeadingBoolValue(reset.c_str(), false));
+}
+
+} // anonymous namespace
+
+void AddProfilezPathHandlers(Webserver* webserver) {
+  webserver->RegisterPathHandler("/profilez", "Profile", ProfilezPathHandler, false, false);
+}
+
+} // namespace yb
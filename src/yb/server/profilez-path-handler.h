@@ -0,0 +1,28 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_SERVER_PROFILEZ_PATH_HANDLER_H
+#define YB_SERVER_PROFILEZ_PATH_HANDLER_H
+
+namespace yb {
+
+class Webserver;
+
+// Adds the /profilez handler, which serves the samples of the continuous sampling profiler in the
+// folded stacks format, ready to be rendered as a flame graph. Pass reset=true to drop the
+// aggregated samples after they are served.
+void AddProfilezPathHandlers(Webserver* webserver);
+
+} // namespace yb
+
+#endif // YB_SERVER_PROFILEZ_PATH_HANDLER_H
@@ -41,12 +41,14 @@
 #include "yb/gutil/strings/numbers.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/slow_query_log.h"
 #include "yb/server/webserver.h"
 
 namespace yb {
 
 using yb::rpc::DumpRunningRpcsRequestPB;
 using yb::rpc::DumpRunningRpcsResponsePB;
+using yb::rpc::DumpSlowQueriesResponsePB;
 using yb::rpc::Messenger;
 using std::shared_ptr;
 using std::stringstream;
@@ -70,11 +72,23 @@ void RpczPathHandler(const shared_ptr<Messenger>& messenger,
   writer.Protobuf(dump_resp);
 }
 
+void SlowQueryzPathHandler(const Webserver::WebRequest& req, stringstream* output) {
+  DumpSlowQueriesResponsePB dump_resp;
+
+  string arg = FindWithDefault(req.parsed_args, "reset", "false");
+  rpc::DumpSlowQueries(ParseLeadingBoolValue(arg.c_str(), false), &dump_resp);
+
+  JsonWriter writer(output, JsonWriter::PRETTY);
+  writer.Protobuf(dump_resp);
+}
+
 } // anonymous namespace
 
 void AddRpczPathHandlers(const shared_ptr<Messenger>& messenger, Webserver* webserver) {
   webserver->RegisterPathHandler(
       "/rpcz", "RPCs", std::bind(RpczPathHandler, messenger, _1, _2), false, false);
+  webserver->RegisterPathHandler(
+      "/slowqueryz", "Slow Queries", SlowQueryzPathHandler, false, false);
 }
 
 } // namespace yb
@@ -40,6 +40,9 @@ namespace yb {
 
 class Webserver;
 
+// Adds the /rpcz handler, which lists the RPCs in flight, and the /slowqueryz handler, which lists
+// the calls from the slow query log with their traces. Pass reset=true to /slowqueryz to clear the
+// log after it is served.
 void AddRpczPathHandlers(const std::shared_ptr<rpc::Messenger>& messenger,
                          Webserver* webserver);
 
@@ -50,6 +50,7 @@
 #include "yb/server/glog_metrics.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/server/logical_clock.h"
+#include "yb/server/profilez-path-handler.h"
 #include "yb/server/rpc_server.h"
 #include "yb/server/rpcz-path-handler.h"
 #include "yb/server/server_base.pb.h"
@@ -68,6 +69,7 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/rolling_log.h"
+#include "yb/util/sampling_profiler.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/thread.h"
 #include "yb/util/version_info.h"
@@ -168,6 +170,8 @@ Status RpcServerBase::Init() {
 
   SetStackTraceSignal(SIGUSR2);
 
+  WARN_NOT_OK(StartSamplingProfiler(), "Failed to start the sampling profiler");
+
   // Initialize the clock immediately. This checks that the clock is synchronized
   // so we're less likely to get into a partially initialized state on disk during startup
   // if we're having clock problems.
@@ -470,6 +474,7 @@ Status RpcAndWebServerBase::Start() {
 
   AddDefaultPathHandlers(web_server_.get());
   AddRpczPathHandlers(messenger_, web_server_.get());
+  AddProfilezPathHandlers(web_server_.get());
   RegisterMetricsJsonHandler(web_server_.get(), metric_registry_.get());
   TracingPathHandlers::RegisterHandlers(web_server_.get());
   web_server_->RegisterPathHandler("/utilz", "Utilities", HandleDebugPage,
@@ -0,0 +1,143 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/tablet/hot_keys.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(tablet_hot_keys_sampling_interval);
+DECLARE_int32(tablet_hot_keys_num_counters);
+DECLARE_int32(tablet_hot_keys_decay_samples);
+DECLARE_int32(tablet_hot_keys_min_samples);
+
+namespace yb {
+namespace tablet {
+
+class HotKeysTrackerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_tablet_hot_keys_num_counters = 4;
+    FLAGS_tablet_hot_keys_decay_samples = 1000000;
+    FLAGS_tablet_hot_keys_min_samples = 10;
+  }
+
+  // Records the keys interleaved, so that key i is recorded counts[i] times.
+  void RecordInterleaved(const std::vector<std::string>& keys, std::vector<int> counts) {
+    bool recorded = true;
+    while (recorded) {
+      recorded = false;
+      for (size_t i = 0; i != keys.size(); ++i) {
+        if (counts[i] > 0) {
+          tracker_.Record(keys[i]);
+          --counts[i];
+          recorded = true;
+        }
+      }
+    }
+  }
+
+  HotKeysTracker tracker_;
+};
+
+TEST_F(HotKeysTrackerTest, Sample) {
+  FLAGS_tablet_hot_keys_sampling_interval = 0;
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_FALSE(HotKeysTracker::Sample());
+  }
+
+  FLAGS_tablet_hot_keys_sampling_interval = 1;
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_TRUE(HotKeysTracker::Sample());
+  }
+
+  FLAGS_tablet_hot_keys_sampling_interval = 16;
+  int num_sampled = 0;
+  for (int i = 0; i != 16000; ++i) {
+    num_sampled += HotKeysTracker::Sample();
+  }
+  ASSERT_GT(num_sampled, 500);
+  ASSERT_LT(num_sampled, 2000);
+}
+
+TEST_F(HotKeysTrackerTest, TopKeys) {
+  ASSERT_EQ(0.0, tracker_.MaxShare());
+  RecordInterleaved({"a", "b", "c", "d"}, {50, 30, 10, 5});
+  ASSERT_EQ(95U, tracker_.num_samples());
+
+  auto top = tracker_.TopKeys(3);
+  ASSERT_EQ(3U, top.size());
+  ASSERT_EQ("a", top[0].key);
+  ASSERT_EQ(50U, top[0].count);
+  ASSERT_EQ(0U, top[0].error);
+  ASSERT_DOUBLE_EQ(50.0 / 95, top[0].share);
+  ASSERT_EQ("b", top[1].key);
+  ASSERT_EQ("c", top[2].key);
+  ASSERT_DOUBLE_EQ(50.0 / 95, tracker_.MaxShare());
+}
+
+TEST_F(HotKeysTrackerTest, Eviction) {
+  RecordInterleaved({"a", "b", "c", "d"}, {50, 30, 10, 5});
+
+  // The new key takes over the counter of the least frequent one, and inherits its count as the
+  // error bound.
+  tracker_.Record("e");
+  auto top = tracker_.TopKeys(10);
+  ASSERT_EQ(4U, top.size());
+  for (const auto& key : top) {
+    ASSERT_NE("d", key.key);
+  }
+  ASSERT_EQ("e", top[3].key);
+  ASSERT_EQ(6U, top[3].count);
+  ASSERT_EQ(5U, top[3].error);
+
+  // Many distinct cold keys keep evicting each other, while the hot keys keep their counters.
+  for (int i = 0; i != 20; ++i) {
+    tracker_.Record("cold-" + std::to_string(i));
+  }
+  top = tracker_.TopKeys(2);
+  ASSERT_EQ("a", top[0].key);
+  ASSERT_EQ("b", top[1].key);
+  ASSERT_EQ(0U, top[0].error);
+  // The error bound of a cold key could be high, but its guaranteed count is not, so it does not
+  // affect the estimated skew.
+  ASSERT_DOUBLE_EQ(50.0 / tracker_.num_samples(), tracker_.MaxShare());
+}
+
+TEST_F(HotKeysTrackerTest, Decay) {
+  FLAGS_tablet_hot_keys_decay_samples = 100;
+  RecordInterleaved({"a", "b"}, {60, 39});
+  ASSERT_EQ(99U, tracker_.num_samples());
+  tracker_.Record("b");
+  ASSERT_EQ(50U, tracker_.num_samples());
+  auto top = tracker_.TopKeys(10);
+  ASSERT_EQ(2U, top.size());
+  ASSERT_EQ(30U, top[0].count);
+  ASSERT_EQ(20U, top[1].count);
+
+  // The new access pattern takes over after a few decays.
+  for (int i = 0; i != 300; ++i) {
+    tracker_.Record("b");
+  }
+  top = tracker_.TopKeys(1);
+  ASSERT_EQ("b", top[0].key);
+  ASSERT_GT(tracker_.MaxShare(), 0.9);
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,144 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_keys.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+
+DEFINE_int32(tablet_hot_keys_sampling_interval, 64,
+             "On average, one of that many key accesses is recorded by the tablet hot keys "
+             "tracker. Non-positive value disables the tracking.");
+TAG_FLAG(tablet_hot_keys_sampling_interval, advanced);
+TAG_FLAG(tablet_hot_keys_sampling_interval, runtime);
+
+DEFINE_int32(tablet_hot_keys_num_counters, 32,
+             "Number of keys tracked by the tablet hot keys tracker, for reads and for writes "
+             "separately.");
+TAG_FLAG(tablet_hot_keys_num_counters, advanced);
+
+DEFINE_int32(tablet_hot_keys_decay_samples, 10000,
+             "The counts of the tablet hot keys tracker are halved after that many samples.");
+TAG_FLAG(tablet_hot_keys_decay_samples, advanced);
+
+DEFINE_int32(tablet_hot_keys_min_samples, 100,
+             "Minimal number of samples for the tablet hot keys tracker to estimate access skew.");
+TAG_FLAG(tablet_hot_keys_min_samples, advanced);
+
+namespace yb {
+namespace tablet {
+
+bool HotKeysTracker::Sample() {
+  const int interval = FLAGS_tablet_hot_keys_sampling_interval;
+  if (interval <= 0) {
+    return false;
+  }
+  // The distance to the next sample is random, so that periodic access patterns, like batches of
+  // a fixed size, are not sampled at the same position every time.
+  static thread_local int countdown = 0;
+  if (--countdown > 0) {
+    return false;
+  }
+  countdown = RandomUniformInt(1, 2 * interval - 1);
+  return true;
+}
+
+void HotKeysTracker::Record(std::string key) {
+  const size_t num_counters = std::max(FLAGS_tablet_hot_keys_num_counters, 1);
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  ++num_samples_;
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    ++counters_[it->second].count;
+  } else if (counters_.size() < num_counters) {
+    index_.emplace(key, counters_.size());
+    counters_.push_back(Counter{std::move(key), 1, 0});
+  } else {
+    auto min_it = std::min_element(
+        counters_.begin(), counters_.end(),
+        [](const Counter& lhs, const Counter& rhs) { return lhs.count < rhs.count; });
+    index_.erase(min_it->key);
+    index_.emplace(key, min_it - counters_.begin());
+    min_it->error = min_it->count;
+    ++min_it->count;
+    min_it->key = std::move(key);
+  }
+
+  if (++samples_since_decay_ >= static_cast<uint64_t>(FLAGS_tablet_hot_keys_decay_samples)) {
+    DecayUnlocked();
+  }
+}
+
+void HotKeysTracker::DecayUnlocked() {
+  samples_since_decay_ = 0;
+  num_samples_ /= 2;
+  std::vector<Counter> counters;
+  counters.reserve(counters_.size());
+  index_.clear();
+  for (auto& counter : counters_) {
+    counter.count /= 2;
+    counter.error /= 2;
+    if (counter.count != 0) {
+      index_.emplace(counter.key, counters.size());
+      counters.push_back(std::move(counter));
+    }
+  }
+  counters_.swap(counters);
+}
+
+std::vector<HotKey> HotKeysTracker::TopKeys(size_t limit) const {
+  std::vector<HotKey> result;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    result.reserve(counters_.size());
+    for (const auto& counter : counters_) {
+      result.push_back(HotKey{
+          counter.key, counter.count, counter.error,
+          num_samples_ ? static_cast<double>(counter.count) / num_samples_ : 0.0});
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const HotKey& lhs, const HotKey& rhs) {
+    return lhs.count > rhs.count;
+  });
+  if (result.size() > limit) {
+    result.resize(limit);
+  }
+  return result;
+}
+
+double HotKeysTracker::MaxShare() const {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  if (num_samples_ < static_cast<uint64_t>(std::max(FLAGS_tablet_hot_keys_min_samples, 1))) {
+    return 0.0;
+  }
+  uint64_t max_count = 0;
+  for (const auto& counter : counters_) {
+    // Use the guaranteed count, so a key that just took over a counter does not look hot.
+    max_count = std::max(max_count, counter.count - counter.error);
+  }
+  return static_cast<double>(max_count) / num_samples_;
+}
+
+uint64_t HotKeysTracker::num_samples() const {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  return num_samples_;
+}
+
+} // namespace tablet
+} // namespace yb
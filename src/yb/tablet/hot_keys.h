@@ -0,0 +1,93 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_HOT_KEYS_H
+#define YB_TABLET_HOT_KEYS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/locks.h"
+
+namespace yb {
+namespace tablet {
+
+struct HotKey {
+  std::string key;
+
+  // Estimated number of sampled accesses to the key.
+  uint64_t count;
+
+  // Upper bound of the overestimation of count.
+  uint64_t error;
+
+  // Estimated fraction of the sampled accesses that went to the key.
+  double share;
+};
+
+// Tracks the most frequently accessed keys of a tablet, using the space-saving algorithm
+// ("Efficient Computation of Frequent and Top-k Elements in Data Streams" by Metwally et al.) over
+// a sample of the accesses.
+//
+// The tracker keeps tablet_hot_keys_num_counters counters. When a key without a counter is
+// sampled, it takes over the counter of the least frequent key, and the count of that key becomes
+// the error bound of the new one. So the count of a key is never underestimated, and any key with
+// more than 1/num_counters of the accesses is guaranteed to have a counter.
+//
+// To reflect the recent access pattern, all counts are halved once tablet_hot_keys_decay_samples
+// accesses were sampled.
+class HotKeysTracker {
+ public:
+  HotKeysTracker() {}
+
+  // Returns true if the current access should be recorded. It is cheap and should be called for
+  // every access, while the key for Record is built only for the sampled ones.
+  static bool Sample();
+
+  void Record(std::string key);
+
+  // Returns up to limit keys with the highest counts, the hottest key first.
+  std::vector<HotKey> TopKeys(size_t limit) const;
+
+  // Returns the estimated fraction of the accesses that went to the hottest key, or 0 if there
+  // are not enough samples to tell.
+  double MaxShare() const;
+
+  // Number of sampled accesses, after the decay.
+  uint64_t num_samples() const;
+
+ private:
+  struct Counter {
+    std::string key;
+    uint64_t count;
+    uint64_t error;
+  };
+
+  void DecayUnlocked();
+
+  mutable simple_spinlock lock_;
+  std::vector<Counter> counters_;
+  // Maps the key to its index in counters_.
+  std::unordered_map<std::string, size_t> index_;
+  uint64_t num_samples_ = 0;
+  uint64_t samples_since_decay_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HotKeysTracker);
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_HOT_KEYS_H
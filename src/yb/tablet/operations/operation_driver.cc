@@ -43,6 +43,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/logging.h"
+#include "yb/util/sampling_profiler.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 
@@ -322,6 +323,7 @@ void OperationDriver::HandleFailure(const Status& s) {
 }
 
 void OperationDriver::ReplicationFinished(const Status& status) {
+  TRACE_TO(trace(), "Replication finished: $0", status.ToString(false));
   consensus::OpId op_id_local;
   {
     std::lock_guard<simple_spinlock> op_id_lock(opid_lock_);
@@ -408,6 +410,8 @@ Status OperationDriver::ApplyAsync() {
 void OperationDriver::ApplyTask() {
   TRACE_EVENT_FLOW_END0("operation", "ApplyTask", this);
   ADOPT_TRACE(trace());
+  ScopedProfilerTag profiler_tag("tablet", "apply");
+  ScopedProfilerTag::SetTablet(operation_->state()->tablet()->tablet_id());
 
 #ifndef NDEBUG
   {
@@ -0,0 +1,98 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/split_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::SPLIT_OP;
+using consensus::DriverType;
+using strings::Substitute;
+
+string SplitOperationState::ToString() const {
+  return Format("SplitOperationState [hybrid_time=$0, request=$1]",
+                hybrid_time_even_if_unset(),
+                request_ ? request_->ShortDebugString() : "<none>");
+}
+
+SplitOperation::SplitOperation(std::unique_ptr<SplitOperationState> state, DriverType type)
+    : Operation(std::move(state), type, OperationType::kSplit) {
+}
+
+consensus::ReplicateMsgPtr SplitOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(SPLIT_OP);
+  result->mutable_split_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+Status SplitOperation::Prepare() {
+  // Writes prepared after this operation would be replicated after it, so they would not get to
+  // the new tablets.
+  state()->tablet()->set_split_started(true);
+  return Status::OK();
+}
+
+void SplitOperation::DoStart() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START SPLIT: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status RecordTabletSplit(Tablet* tablet, const tserver::SplitTabletRequestPB& request) {
+  // Writes are rejected once the split is prepared, and requests once it is recorded.
+  tablet->set_split_started(true);
+  auto* metadata = tablet->metadata();
+  const std::vector<TabletId> child_ids = { request.new_tablet1_id(), request.new_tablet2_id() };
+  if (metadata->split_child_tablet_ids() == child_ids) {
+    return Status::OK();
+  }
+  metadata->set_split_child_tablet_ids(child_ids, request.split_partition_key());
+  return metadata->Flush();
+}
+
+Status SplitOperation::Apply() {
+  TRACE("APPLY SPLIT: started");
+
+  auto* tablet = state()->tablet();
+  RETURN_NOT_OK(RecordTabletSplit(tablet, *state()->request()));
+  // The new tablets are created after the apply, so that their creation could fail and be retried.
+  if (tablet->tablet_splitter()) {
+    tablet->tablet_splitter()->CreateSplitChildrenAsync(tablet->tablet_id());
+  }
+
+  TRACE("APPLY SPLIT: finished");
+  return Status::OK();
+}
+
+void SplitOperation::Finish(OperationResult result) {
+  if (result == Operation::ABORTED) {
+    state()->tablet()->set_split_started(false);
+  }
+}
+
+string SplitOperation::ToString() const {
+  return Substitute("SplitOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
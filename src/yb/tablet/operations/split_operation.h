@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
+#define YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
+
+#include <string>
+
+#include "yb/common/entity_ids.h"
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+#include "yb/tserver/tserver_admin.pb.h"
+
+namespace yb {
+namespace tablet {
+
+class SplitOperationState;
+
+// Creates the tablets a tablet is split into. It is implemented by the tablet manager, since the
+// new tablets are registered and started along with the other tablets of the server.
+class TabletSplitter {
+ public:
+  // Starts creating and starting the new tablets in the background, using a checkpoint of the
+  // split tablet as their RocksDB. Called once the split is applied, so the I/O is done outside
+  // of the Raft apply, and retried until it succeeds. Does nothing for the tablets that were
+  // already created.
+  virtual void CreateSplitChildrenAsync(const TabletId& tablet_id) = 0;
+
+ protected:
+  ~TabletSplitter() {}
+};
+
+// Records the split in the metadata of the split tablet, which stops serving requests. Used by
+// the apply of the split operation and by its replay during bootstrap.
+CHECKED_STATUS RecordTabletSplit(Tablet* tablet, const tserver::SplitTabletRequestPB& request);
+
+// Operation Context for the Split operation.
+// Keeps track of the Operation states (request, result, ...)
+class SplitOperationState : public OperationState {
+ public:
+  explicit SplitOperationState(Tablet* tablet,
+                               const tserver::SplitTabletRequestPB* request = nullptr)
+      : OperationState(tablet), request_(request) {}
+  ~SplitOperationState() {}
+
+  const tserver::SplitTabletRequestPB* request() const override { return request_; }
+
+  void UpdateRequestFromConsensusRound() override {
+    request_ = consensus_round()->replicate_msg()->mutable_split_request();
+  }
+
+  virtual std::string ToString() const override;
+
+ private:
+  // The original RPC request.
+  const tserver::SplitTabletRequestPB *request_;
+
+  DISALLOW_COPY_AND_ASSIGN(SplitOperationState);
+};
+
+// Executes the split transaction. The split tablet stops accepting writes once the operation is
+// prepared, and stops serving requests once it is applied.
+class SplitOperation : public Operation {
+ public:
+  SplitOperation(std::unique_ptr<SplitOperationState> operation_state,
+                 consensus::DriverType type);
+
+  SplitOperationState* state() override {
+    return down_cast<SplitOperationState*>(Operation::state());
+  }
+
+  const SplitOperationState* state() const override {
+    return down_cast<const SplitOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  CHECKED_STATUS Prepare() override;
+
+  // Executes an Apply for the split transaction.
+  CHECKED_STATUS Apply() override;
+
+  void Finish(OperationResult result) override;
+
+  std::string ToString() const override;
+
+ private:
+  // Starts the SplitOperation by assigning it a timestamp.
+  void DoStart() override;
+
+  DISALLOW_COPY_AND_ASSIGN(SplitOperation);
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
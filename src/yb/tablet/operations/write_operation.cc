@@ -84,6 +84,14 @@ consensus::ReplicateMsgPtr WriteOperation::NewReplicateMsg() {
 
 Status WriteOperation::Prepare() {
   TRACE_EVENT0("txn", "WriteOperation::Prepare");
+  // Operations are prepared in order, so writes prepared after the split operation are rejected
+  // here. The client retries them on the new tablets.
+  if (type() == consensus::LEADER && state()->tablet()->split_started()) {
+    Status s = STATUS_FORMAT(
+        IllegalState, "Tablet $0 is being split", state()->tablet()->tablet_id());
+    state()->completion_callback()->set_error(s, TabletServerErrorPB::TABLET_SPLIT);
+    return s;
+  }
   return Status::OK();
 }
 
@@ -22,9 +22,11 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/consensus/consensus.h"
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/util/logging.h"
+#include "yb/util/sampling_profiler.h"
 #include "yb/util/threadpool.h"
 
 DEFINE_int32(max_group_replicate_batch_size, 16,
@@ -160,6 +162,8 @@ Status PreparerImpl::Submit(OperationDriver* operation_driver) {
 
 void PreparerImpl::Run() {
   VLOG(1) << "Starting prepare task:" << this;
+  ScopedProfilerTag profiler_tag("tablet", "prepare");
+  ScopedProfilerTag::SetTablet(consensus_->tablet_id());
   for (;;) {
     OperationDriver *item = nullptr;
     while (queue_.pop(item)) {
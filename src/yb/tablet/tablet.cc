@@ -45,6 +45,7 @@
 #include <boost/scope_exit.hpp>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
@@ -54,6 +55,7 @@
 #include "yb/common/hybrid_time.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_rowblock.h"
+#include "yb/common/ql_value.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/opid_util.h"
@@ -270,6 +272,7 @@ struct WriteOperationData {
 };
 
 const char* Tablet::kDMSMemTrackerId = "DeltaMemStores";
+const char* Tablet::kBlockBasedTableMemTrackerId = "BlockBasedTable";
 
 Tablet::Tablet(
     const scoped_refptr<TabletMetadata>& metadata,
@@ -279,7 +282,8 @@ Tablet::Tablet(
     const scoped_refptr<LogAnchorRegistry>& log_anchor_registry,
     const TabletOptions& tablet_options,
     TransactionParticipantContext* transaction_participant_context,
-    TransactionCoordinatorContext* transaction_coordinator_context)
+    TransactionCoordinatorContext* transaction_coordinator_context,
+    TabletSplitter* tablet_splitter)
     : key_schema_(metadata->schema().CreateKeyProjection()),
       metadata_(metadata),
       table_type_(metadata->table_type()),
@@ -287,10 +291,19 @@ Tablet::Tablet(
       mem_tracker_(
           MemTracker::CreateTracker(-1, Substitute("tablet-$0", tablet_id()), parent_mem_tracker)),
       dms_mem_tracker_(MemTracker::CreateTracker(-1, kDMSMemTrackerId, mem_tracker_)),
+      block_based_table_mem_tracker_(
+          MemTracker::CreateTracker(-1, kBlockBasedTableMemTrackerId, mem_tracker_)),
       clock_(clock),
       mvcc_(Format("T $0 ", metadata_->tablet_id()), clock),
-      tablet_options_(tablet_options) {
+      tablet_options_(tablet_options),
+      tablet_splitter_(tablet_splitter) {
   CHECK(schema()->has_column_ids());
+  split_started_.store(!metadata_->split_child_tablet_ids().empty(), std::memory_order_release);
+  if (!metadata_->split_parent_tablet_id().empty() &&
+      metadata_->partition_schema().hash_schema() == YBHashSchema::kMultiColumnHash) {
+    hash_bounds_ = docdb::DocKeyHashBounds::FromPartition(metadata_->partition());
+  }
+  tablet_options_.block_based_table_mem_tracker = block_based_table_mem_tracker_;
 
   if (metric_registry) {
     MetricEntity::AttributeMap attrs;
@@ -339,6 +352,7 @@ Tablet::Tablet(
 Tablet::~Tablet() {
   Shutdown();
   dms_mem_tracker_->UnregisterFromParent();
+  block_based_table_mem_tracker_->UnregisterFromParent();
   mem_tracker_->UnregisterFromParent();
 }
 
@@ -362,6 +376,59 @@ Status Tablet::Open() {
   return Status::OK();
 }
 
+namespace {
+
+Status OpenRocksDB(const rocksdb::Options& options, const string& db_dir,
+                   std::unique_ptr<rocksdb::DB>* result) {
+  LOG(INFO) << "Opening RocksDB at: " << db_dir;
+  rocksdb::DB* db = nullptr;
+  rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(options, db_dir, &db);
+  if (!rocksdb_open_status.ok()) {
+    LOG(ERROR) << "Failed to open a RocksDB database in directory " << db_dir << ": "
+               << rocksdb_open_status.ToString();
+    if (db != nullptr) {
+      delete db;
+    }
+    return STATUS(IllegalState, rocksdb_open_status.ToString());
+  }
+  result->reset(db);
+  LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir << ", obj: " << db;
+  return Status::OK();
+}
+
+// Returns true if the DB has writes that are not flushed to SSTables yet.
+bool HasUnflushedData(rocksdb::DB* db) {
+  uint64_t active_entries = 0;
+  uint64_t immutable_entries = 0;
+  db->GetIntProperty(rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries);
+  db->GetIntProperty(rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries);
+  return active_entries != 0 || immutable_entries != 0;
+}
+
+yb::OpId MaxPersistentOpIdForDb(rocksdb::DB* db) {
+  auto frontier = db->GetFlushedFrontier();
+  if (!frontier) {
+    return yb::OpId();
+  }
+  return down_cast<docdb::ConsensusFrontier*>(frontier.get())->op_id();
+}
+
+// Invokes the callback each time a memtable of the DB is flushed.
+class FlushCompletedListener : public rocksdb::EventListener {
+ public:
+  explicit FlushCompletedListener(std::function<void()> callback)
+      : callback_(std::move(callback)) {}
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override {
+    callback_();
+  }
+
+ private:
+  std::function<void()> callback_;
+};
+
+} // namespace
+
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
@@ -369,7 +436,7 @@ Status Tablet::OpenKeyValueTablet() {
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      make_shared<TabletRetentionPolicy>(this), hash_bounds_);
 
   auto mem_table_flush_filter_factory = [this] {
     if (mem_table_flush_filter_factory_) {
@@ -395,23 +462,117 @@ Status Tablet::OpenKeyValueTablet() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    db_dir));
 
-  LOG(INFO) << "Opening RocksDB at: " << db_dir;
-  rocksdb::DB* db = nullptr;
-  rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
-  if (!rocksdb_open_status.ok()) {
-    LOG(ERROR) << "Failed to open a RocksDB database in directory " << db_dir << ": "
-               << rocksdb_open_status.ToString();
-    if (db != nullptr) {
-      delete db;
-    }
-    return STATUS(IllegalState, rocksdb_open_status.ToString());
+  if (transaction_participant_) {
+    // Intents memtables whose flush was postponed by IntentsDbFlushFilter are flushed as soon as
+    // the regular DB catches up.
+    rocksdb_options.listeners.push_back(std::make_shared<FlushCompletedListener>(
+        std::bind(&Tablet::RegularDbFlushed, this)));
   }
-  rocksdb_.reset(db);
+
+  RETURN_NOT_OK(OpenRocksDB(rocksdb_options, db_dir, &rocksdb_));
   ql_storage_.reset(new docdb::QLRocksDBStorage(rocksdb_.get()));
+
   if (transaction_participant_) {
-    transaction_participant_->SetDB(db);
+    // Intents are written once and deleted soon after the transaction is applied, so they are kept
+    // in a separate DB, which does not slow down reads and compactions of the regular one.
+    rocksdb::Options intents_rocksdb_options;
+    docdb::InitRocksDBOptions(&intents_rocksdb_options, tablet_id(), rocksdb_statistics_,
+                              tablet_options_, docdb::StorageDbType::kIntents);
+    auto& listeners = intents_rocksdb_options.listeners;
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), flush_stats_),
+                    listeners.end());
+    auto intents_mem_table_flush_filter_factory = [this]() -> rocksdb::MemTableFilter {
+      // Intents memtables are subject to the same conditions as regular ones, e.g. the operations
+      // must be written to the log, with the regular DB ordering on top of them.
+      rocksdb::MemTableFilter regular_filter;
+      if (mem_table_flush_filter_factory_) {
+        regular_filter = mem_table_flush_filter_factory_();
+      }
+      return [this, regular_filter](const rocksdb::MemTable& memtable) -> Result<bool> {
+        if (regular_filter) {
+          auto result = regular_filter(memtable);
+          if (!result.ok() || !result.get()) {
+            return result;
+          }
+        }
+        return IntentsDbFlushFilter(memtable);
+      };
+    };
+    intents_rocksdb_options.mem_table_flush_filter_factory =
+        std::make_shared<MemTableFlushFilterFactoryType>(intents_mem_table_flush_filter_factory);
+
+    const string intents_db_dir = metadata()->intents_rocksdb_dir();
+    RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->CreateDirIfMissing(intents_db_dir),
+                          Substitute("Failed to create intents RocksDB directory $0",
+                                     intents_db_dir));
+    std::unique_ptr<rocksdb::DB> intents_db;
+    RETURN_NOT_OK(OpenRocksDB(intents_rocksdb_options, intents_db_dir, &intents_db));
+    {
+      std::lock_guard<std::mutex> lock(intents_db_mutex_);
+      intents_db_ = std::move(intents_db);
+    }
+    RETURN_NOT_OK(MoveIntentsFromRegularDb());
+    transaction_participant_->SetDB(intents_db_.get());
   }
-  LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir << ", obj: " << db;
+  return Status::OK();
+}
+
+Status Tablet::MoveIntentsFromRegularDb() {
+  // Intents, the transaction reverse index and transaction metadata all start with the intent
+  // prefix, which sorts before all other keys.
+  const char intent_prefix = static_cast<char>(docdb::ValueType::kIntentPrefix);
+  auto is_intent = [intent_prefix](const rocksdb::Iterator& iter) {
+    return iter.Valid() && !iter.key().empty() && iter.key()[0] == intent_prefix;
+  };
+  std::unique_ptr<rocksdb::Iterator> iter(rocksdb_->NewIterator(rocksdb::ReadOptions()));
+  iter->Seek(rocksdb::Slice(&intent_prefix, 1));
+  if (!is_intent(*iter)) {
+    return iter->status();
+  }
+
+  // The regular DB has no unflushed data while the tablet is opened, so the moved intents are
+  // persistent up to its flushed frontier.
+  docdb::ConsensusFrontiers frontiers;
+  auto flushed_frontier = rocksdb_->GetFlushedFrontier();
+  if (flushed_frontier) {
+    const auto* frontier = down_cast<docdb::ConsensusFrontier*>(flushed_frontier.get());
+    frontiers.Smallest() = *frontier;
+    frontiers.Largest() = *frontier;
+  }
+
+  static constexpr int kMaxBatchSize = 1000;
+  size_t num_intents = 0;
+  rocksdb::WriteBatch write_batch;
+  for (; is_intent(*iter); iter->Next()) {
+    write_batch.Put(iter->key(), iter->value());
+    ++num_intents;
+    if (write_batch.Count() >= kMaxBatchSize) {
+      WriteToRocksDB(intents_db_.get(), &write_batch, &frontiers);
+      write_batch.Clear();
+    }
+  }
+  RETURN_NOT_OK(iter->status());
+  WriteToRocksDB(intents_db_.get(), &write_batch, &frontiers);
+  write_batch.Clear();
+
+  // The intents must be persistent in the intents DB before they are deleted from the regular DB.
+  // If the tablet is restarted before the deletions are flushed, the intents are moved again.
+  rocksdb::FlushOptions flush_options;
+  flush_options.wait = true;
+  RETURN_NOT_OK(intents_db_->Flush(flush_options));
+
+  for (iter->Seek(rocksdb::Slice(&intent_prefix, 1)); is_intent(*iter); iter->Next()) {
+    write_batch.Delete(iter->key());
+    if (write_batch.Count() >= kMaxBatchSize) {
+      WriteToRocksDB(rocksdb_.get(), &write_batch, &frontiers);
+      write_batch.Clear();
+    }
+  }
+  RETURN_NOT_OK(iter->status());
+  WriteToRocksDB(rocksdb_.get(), &write_batch, &frontiers);
+
+  LOG(INFO) << "Tablet " << tablet_id() << ": moved " << num_intents
+            << " intents from the regular DB to the intents DB";
   return Status::OK();
 }
 
@@ -438,7 +599,9 @@ void Tablet::Shutdown() {
   }
 
   std::lock_guard<rw_spinlock> lock(component_lock_);
-  // Shutdown the RocksDB instance for this table, if present.
+  // Shutdown the RocksDB instances for this table, if present. The intents DB goes first, because
+  // its flush filter refers to the regular DB.
+  ResetIntentsDb();
   rocksdb_.reset();
   state_ = kShutdown;
 }
@@ -482,6 +645,7 @@ void Tablet::StartOperation(WriteOperationState* operation_state) {
 }
 
 void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
+  ScopedTabletCpuTracker cpu_tracker(metrics_.get());
   last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
   const KeyValueWriteBatchPB& put_batch =
       operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
@@ -489,6 +653,10 @@ void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
           ? operation_state->consensus_round()->replicate_msg()->write_request().write_batch()
           // Bootstrap case.
           : operation_state->request()->write_batch();
+  if (metrics_) {
+    metrics_->write_ops->IncrementBy(put_batch.kv_pairs_size());
+    metrics_->write_bytes->IncrementBy(put_batch.ByteSize());
+  }
 
   docdb::ConsensusFrontiers frontiers;
   set_op_id({operation_state->op_id().term(), operation_state->op_id().index()}, &frontiers);
@@ -496,6 +664,35 @@ void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
   ApplyKeyValueRowOperations(put_batch, &frontiers, operation_state->hybrid_time());
 }
 
+namespace {
+
+// Adds files of the checkpoint in 'dir' to 'rocksdb_files', prepending 'name_prefix' to their
+// names. The intents DB subdirectory is not listed, its files are added separately.
+Status ListCheckpointFiles(rocksdb::Env* env, FsManager* fs_manager, const std::string& dir,
+                           const std::string& name_prefix,
+                           google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files) {
+  vector<rocksdb::Env::FileAttributes> files_attrs;
+  auto status = env->GetChildrenFileAttributes(dir, &files_attrs);
+  if (!status.ok()) {
+    return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
+                                           status.ToString()));
+  }
+
+  for (const auto& file_attrs : files_attrs) {
+    if (file_attrs.name == "." || file_attrs.name == ".." || file_attrs.name == kIntentsSubdir) {
+      continue;
+    }
+    auto rocksdb_file_pb = rocksdb_files->Add();
+    rocksdb_file_pb->set_name(name_prefix + file_attrs.name);
+    rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
+    rocksdb_file_pb->set_inode(VERIFY_RESULT(
+        fs_manager->env()->GetFileINode(JoinPathSegments(dir, file_attrs.name))));
+  }
+  return Status::OK();
+}
+
+} // namespace
+
 Status Tablet::CreateCheckpoint(const std::string& dir,
                                 google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files) {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
@@ -509,25 +706,28 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
     LOG(WARNING) << "Create checkpoint status: " << status.ToString();
     return STATUS(IllegalState, Substitute("Unable to create checkpoint: $0", status.ToString()));
   }
-  LOG(INFO) << "Checkpoint created in " << dir;
 
-  if (rocksdb_files != nullptr) {
-    vector<rocksdb::Env::FileAttributes> files_attrs;
-    status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
+  // The intents DB checkpoint is placed in the same subdirectory of the checkpoint, where the
+  // intents DB is placed in the tablet directory, so it is copied along with the regular one.
+  const auto intents_dir = JoinPathSegments(dir, kIntentsSubdir);
+  if (intents_db_) {
+    status = rocksdb::checkpoint::CreateCheckpoint(intents_db_.get(), intents_dir);
     if (!status.ok()) {
-      return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
+      LOG(WARNING) << "Create intents checkpoint status: " << status.ToString();
+      return STATUS(IllegalState, Substitute("Unable to create intents checkpoint: $0",
                                              status.ToString()));
     }
+  }
+  LOG(INFO) << "Checkpoint created in " << dir;
 
-    for (const auto& file_attrs : files_attrs) {
-      if (file_attrs.name == "." || file_attrs.name == "..") {
-        continue;
-      }
-      auto rocksdb_file_pb = rocksdb_files->Add();
-      rocksdb_file_pb->set_name(file_attrs.name);
-      rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
-      rocksdb_file_pb->set_inode(VERIFY_RESULT(
-          metadata_->fs_manager()->env()->GetFileINode(JoinPathSegments(dir, file_attrs.name))));
+  if (rocksdb_files != nullptr) {
+    auto* fs_manager = metadata_->fs_manager();
+    RETURN_NOT_OK(ListCheckpointFiles(
+        rocksdb_->GetEnv(), fs_manager, dir, std::string(), rocksdb_files));
+    if (intents_db_) {
+      RETURN_NOT_OK(ListCheckpointFiles(
+          intents_db_->GetEnv(), fs_manager, intents_dir, std::string(kIntentsSubdir) + "/",
+          rocksdb_files));
     }
   }
 
@@ -536,6 +736,45 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
   return Status::OK();
 }
 
+Status Tablet::CreateSplitCheckpoint(const std::string& dir) {
+  {
+    ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+    RETURN_NOT_OK(scoped_read_operation);
+
+    std::lock_guard<std::mutex> lock(create_checkpoint_lock_);
+
+    rocksdb::Status status = rocksdb::checkpoint::CreateCheckpoint(rocksdb_.get(), dir);
+    if (!status.ok()) {
+      LOG(WARNING) << "Create split checkpoint status: " << status.ToString();
+      return STATUS(IllegalState, Substitute("Unable to create split checkpoint: $0",
+                                             status.ToString()));
+    }
+  }
+
+  // The checkpoint shares SST files with this tablet via hard links, only its manifest is
+  // rewritten here.
+  rocksdb::Options rocksdb_options;
+  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), nullptr /* statistics */,
+                            tablet_options_);
+  std::unique_ptr<rocksdb::DB> checkpoint_db;
+  RETURN_NOT_OK(OpenRocksDB(rocksdb_options, dir, &checkpoint_db));
+
+  docdb::ConsensusFrontier frontier;
+  auto flushed_frontier = checkpoint_db->GetFlushedFrontier();
+  if (flushed_frontier) {
+    frontier.set_hybrid_time(
+        down_cast<docdb::ConsensusFrontier*>(flushed_frontier.get())->hybrid_time());
+  }
+  frontier.set_op_id(yb::OpId());
+  const rocksdb::Status status = checkpoint_db->ResetFlushedFrontier(frontier.Clone());
+  if (!status.ok()) {
+    return STATUS(IllegalState, "Failed to reset flushed frontier of split checkpoint",
+                  status.ToString());
+  }
+  LOG(INFO) << "Split checkpoint of tablet " << tablet_id() << " created in " << dir;
+  return Status::OK();
+}
+
 void Tablet::PrepareTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
@@ -569,23 +808,35 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     return;
   }
 
-  rocksdb_write_batch->SetFrontiers(frontiers);
-
   if (put_batch.has_transaction()) {
     PrepareTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    if (intents_db_) {
+      WriteToRocksDB(intents_db_.get(), rocksdb_write_batch, frontiers);
+      return;
+    }
   } else {
     PrepareNonTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
   }
 
+  flush_stats_->AboutToWriteToDb(hybrid_time);
+  WriteToRocksDB(rocksdb_.get(), rocksdb_write_batch, frontiers);
+}
+
+void Tablet::WriteToRocksDB(
+    rocksdb::DB* db, rocksdb::WriteBatch* write_batch, const rocksdb::UserFrontiers* frontiers) {
+  if (write_batch->Count() == 0) {
+    return;
+  }
+  write_batch->SetFrontiers(frontiers);
+
   // We are using Raft replication index for the RocksDB sequence number for
   // all members of this write batch.
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
 
-  flush_stats_->AboutToWriteToDb(hybrid_time);
-  auto rocksdb_write_status = rocksdb_->Write(write_options, rocksdb_write_batch);
+  auto rocksdb_write_status = db->Write(write_options, write_batch);
   if (!rocksdb_write_status.ok()) {
-    LOG(FATAL) << "Failed to write a batch with " << rocksdb_write_batch->Count() << " operations"
+    LOG(FATAL) << "Failed to write a batch with " << write_batch->Count() << " operations"
                << " into RocksDB: " << rocksdb_write_status.ToString();
   }
 }
@@ -607,6 +858,19 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
   }
 }
 
+// Returns the key of the CQL partition accessed by the request, for the hot keys trackers.
+template <class Request>
+std::string HashedKeyToString(const Request& request) {
+  std::string result;
+  for (const auto& expr : request.hashed_column_values()) {
+    if (!result.empty()) {
+      result += ", ";
+    }
+    result += expr.has_value() ? QLValue(expr.value()).ToString() : "?";
+  }
+  return result;
+}
+
 } // namespace
 
 Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data) {
@@ -620,6 +884,9 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data)
 
   doc_ops.reserve(redis_write_batch->size());
   for (size_t i = 0; i < redis_write_batch->size(); i++) {
+    if (HotKeysTracker::Sample()) {
+      write_hot_keys_.Record(redis_write_batch->Get(i).key_value().key());
+    }
     doc_ops.emplace_back(new RedisWriteOperation(redis_write_batch->Mutable(i)));
   }
   RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
@@ -642,10 +909,17 @@ Status Tablet::HandleRedisReadRequest(const ReadHybridTime& read_time,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  ScopedTabletCpuTracker cpu_tracker(metrics_.get());
+
+  if (redis_read_request.has_key_value() && HotKeysTracker::Sample()) {
+    read_hot_keys_.Record(redis_read_request.key_value().key());
+  }
 
   docdb::RedisReadOperation doc_op(redis_read_request, rocksdb_.get(), read_time);
   RETURN_NOT_OK(doc_op.Execute());
   *response = std::move(doc_op.response());
+  metrics_->read_ops->Increment();
+  metrics_->read_bytes->IncrementBy(response->ByteSize());
   return Status::OK();
 }
 
@@ -657,17 +931,41 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  ScopedTabletCpuTracker cpu_tracker(metrics_.get());
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     return Status::OK();
   }
 
+  if (!ql_read_request.hashed_column_values().empty() && HotKeysTracker::Sample()) {
+    read_hot_keys_.Record(HashedKeyToString(ql_read_request));
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
-  return AbstractTablet::HandleQLReadRequest(
-      read_time, ql_read_request, *txn_op_ctx, result);
+
+  // RocksDB of a tablet created by a split could still contain rows of its sibling, so scans are
+  // limited to the hash range of this tablet.
+  if (!hash_bounds_.IsFull() && ql_read_request.hashed_column_values().empty()) {
+    QLReadRequestPB bounded_request = ql_read_request;
+    if (!bounded_request.has_hash_code() || bounded_request.hash_code() < hash_bounds_.lower) {
+      bounded_request.set_hash_code(hash_bounds_.lower);
+    }
+    if (!bounded_request.has_max_hash_code() ||
+        bounded_request.max_hash_code() >= hash_bounds_.upper) {
+      bounded_request.set_max_hash_code(hash_bounds_.upper - 1);
+    }
+    RETURN_NOT_OK(AbstractTablet::HandleQLReadRequest(
+        read_time, bounded_request, *txn_op_ctx, result));
+  } else {
+    RETURN_NOT_OK(AbstractTablet::HandleQLReadRequest(
+        read_time, ql_read_request, *txn_op_ctx, result));
+  }
+  metrics_->read_ops->Increment();
+  metrics_->read_bytes->IncrementBy(result->rows_data.size());
+  return Status::OK();
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
@@ -729,6 +1027,9 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   RETURN_NOT_OK(txn_op_ctx);
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
+    if (HotKeysTracker::Sample()) {
+      write_hot_keys_.Record(HashedKeyToString(*req));
+    }
     QLResponsePB* resp = data.operation_state->response()->add_ql_response_batch();
     if (metadata_->schema_version() != req->schema_version()) {
       resp->set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
@@ -758,6 +1059,7 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
 
 Status Tablet::AcquireLocksAndPerformDocOperations(
     WriteOperationState *state, HybridTime* restart_read_ht) {
+  ScopedTabletCpuTracker cpu_tracker(metrics_.get());
   LockBatch locks_held;
   WriteRequestPB* key_value_write_request = state->mutable_request();
 
@@ -807,9 +1109,64 @@ Status Tablet::Flush(FlushMode mode) {
   rocksdb::FlushOptions options;
   options.wait = mode == FlushMode::kSync;
   rocksdb_->Flush(options);
+  // The intents DB is flushed after the regular one, see IntentsDbFlushFilter.
+  if (intents_db_) {
+    intents_db_->Flush(options);
+  }
   return Status::OK();
 }
 
+Result<bool> Tablet::IntentsDbFlushFilter(const rocksdb::MemTable& memtable) {
+  auto frontiers = memtable.Frontiers();
+  if (!frontiers) {
+    return STATUS(IllegalState, "A memtable with no frontiers set found when deciding what "
+                                "intents memtables to flush");
+  }
+  const auto& intents_largest = down_cast<const docdb::ConsensusFrontier&>(frontiers->Largest());
+
+  // Bootstrap replays the log starting from the minimal op id flushed to both DBs. So deletions of
+  // applied intents could be flushed only after values written by the same apply operations,
+  // otherwise those values would be lost in case of restart.
+  if (!HasUnflushedData(rocksdb_.get()) ||
+      MaxPersistentOpIdForDb(rocksdb_.get()).index >= intents_largest.op_id().index) {
+    return true;
+  }
+
+  rocksdb::FlushOptions options;
+  options.wait = false;
+  rocksdb_->Flush(options);
+  return false;
+}
+
+void Tablet::RegularDbFlushed() {
+  std::lock_guard<std::mutex> lock(intents_db_mutex_);
+  if (!intents_db_) {
+    return;
+  }
+  // Only flushes postponed by IntentsDbFlushFilter are retried, the active memtable is flushed
+  // as usual.
+  uint64_t num_immutable_memtables = 0;
+  intents_db_->GetIntProperty(
+      rocksdb::DB::Properties::kNumImmutableMemTable, &num_immutable_memtables);
+  if (num_immutable_memtables == 0) {
+    return;
+  }
+  rocksdb::FlushOptions options;
+  options.wait = false;
+  intents_db_->Flush(options);
+}
+
+void Tablet::ResetIntentsDb() {
+  std::unique_ptr<rocksdb::DB> intents_db;
+  {
+    std::lock_guard<std::mutex> lock(intents_db_mutex_);
+    intents_db.swap(intents_db_);
+  }
+  // Destroyed outside of the mutex, because the destructor waits for background flushes, while
+  // RegularDbFlushed could be called from the same background threads.
+  intents_db.reset();
+}
+
 Status Tablet::ImportData(const std::string& source_dir) {
   return rocksdb_->Import(source_dir);
 }
@@ -829,13 +1186,14 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // TODO(dtxn) use separate thread for applying intents.
 // TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
+  rocksdb::DB* intents_db = intents_db_ ? intents_db_.get() : rocksdb_.get();
   auto reverse_index_iter = docdb::CreateRocksDBIterator(
-      rocksdb_.get(),
+      intents_db,
       docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
       boost::none,
       rocksdb::kDefaultQueryId);
 
-  auto intent_iter = docdb::CreateRocksDBIterator(rocksdb_.get(),
+  auto intent_iter = docdb::CreateRocksDBIterator(intents_db,
                                                   docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                   boost::none,
                                                   rocksdb::kDefaultQueryId);
@@ -846,7 +1204,9 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
 
   reverse_index_iter->Seek(txn_reverse_index_prefix.data());
 
-  WriteBatch rocksdb_write_batch;
+  // Applied values go to the regular DB, while intents are deleted from the intents DB.
+  WriteBatch regular_write_batch;
+  WriteBatch intents_write_batch;
 
   docdb::DocHybridTimeBuffer doc_ht_buffer;
 
@@ -890,25 +1250,27 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
             intent->doc_ht,
             intent_value,
         }};
-        rocksdb_write_batch.Put(key_parts, value_parts);
+        regular_write_batch.Put(key_parts, value_parts);
         ++write_id;
       }
 
-      rocksdb_write_batch.Delete(intent_iter->key());
+      intents_write_batch.Delete(intent_iter->key());
     }
 
-    rocksdb_write_batch.Delete(reverse_index_iter->key());
+    intents_write_batch.Delete(reverse_index_iter->key());
 
     reverse_index_iter->Next();
   }
 
   // data.hybrid_time contains transaction commit time.
-  // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
   set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
   set_hybrid_time(data.log_ht, &frontiers);
-  ApplyKeyValueRowOperations(
-      KeyValueWriteBatchPB(), &frontiers, data.commit_ht, &rocksdb_write_batch);
+  // Regular records are written first, so intents are never missing for a transaction that is not
+  // applied yet.
+  flush_stats_->AboutToWriteToDb(data.commit_ht);
+  WriteToRocksDB(rocksdb_.get(), &regular_write_batch, &frontiers);
+  WriteToRocksDB(intents_db, &intents_write_batch, &frontiers);
   return Status::OK();
 }
 
@@ -990,13 +1352,18 @@ Result<ScopedPendingOperationPause> Tablet::PauseReadWriteOperations() {
 }
 
 Status Tablet::SetFlushedFrontier(const docdb::ConsensusFrontier& frontier) {
-  const Status s = rocksdb_->SetFlushedFrontier(frontier.Clone());
-  if (PREDICT_FALSE(!s.ok())) {
-    auto status = STATUS(IllegalState, "Failed to set flushed frontier", s.ToString());
-    LOG(WARNING) << status;
-    return status;
+  for (auto* db : {rocksdb_.get(), intents_db_.get()}) {
+    if (!db) {
+      continue;
+    }
+    const Status s = db->SetFlushedFrontier(frontier.Clone());
+    if (PREDICT_FALSE(!s.ok())) {
+      auto status = STATUS(IllegalState, "Failed to set flushed frontier", s.ToString());
+      LOG(WARNING) << status;
+      return status;
+    }
+    DCHECK_EQ(frontier, *db->GetFlushedFrontier());
   }
-  DCHECK_EQ(frontier, *rocksdb_->GetFlushedFrontier());
   return Flush(FlushMode::kAsync);
 }
 
@@ -1012,6 +1379,19 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const rocksdb::SequenceNumber sequence_number = rocksdb_->GetLatestSequenceNumber();
   const string db_dir = rocksdb_->GetName();
 
+  if (intents_db_) {
+    const string intents_db_dir = intents_db_->GetName();
+    ResetIntentsDb();
+    rocksdb::Options rocksdb_options;
+    docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+                              docdb::StorageDbType::kIntents);
+    Status s = rocksdb::DestroyDB(intents_db_dir, rocksdb_options);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG(WARNING) << "Failed to clean up intents db dir " << intents_db_dir << ": " << s;
+      return STATUS(IllegalState, "Failed to clean up intents db dir", s.ToString());
+    }
+  }
+
   rocksdb_ = nullptr;
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
@@ -1060,20 +1440,50 @@ Result<bool> Tablet::HasSSTables() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
-  std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
-  rocksdb_->GetLiveFilesMetaData(&live_files_metadata);
-  return !live_files_metadata.empty();
+  for (auto* db : {rocksdb_.get(), intents_db_.get()}) {
+    if (db) {
+      std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
+      db->GetLiveFilesMetaData(&live_files_metadata);
+      if (!live_files_metadata.empty()) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 Result<yb::OpId> Tablet::MaxPersistentOpId() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
-  auto temp = rocksdb_->GetFlushedFrontier();
-  if (!temp) {
-    return yb::OpId();
+  auto result = MaxPersistentOpIdForDb(rocksdb_.get());
+  if (intents_db_) {
+    result.MakeAtMost(MaxPersistentOpIdForDb(intents_db_.get()));
+  }
+  return result;
+}
+
+Status Tablet::AdvanceIdleIntentsFlushedFrontier(int64_t min_running_index) {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  if (!intents_db_) {
+    return Status::OK();
+  }
+  auto regular_frontier = rocksdb_->GetFlushedFrontier();
+  if (!regular_frontier) {
+    return Status::OK();
+  }
+  const auto regular_op_id =
+      down_cast<docdb::ConsensusFrontier*>(regular_frontier.get())->op_id();
+  // Operations up to the regular DB frontier have finished writing to both DBs, so when the intents
+  // DB has nothing to flush, all their intents are already flushed.
+  if (regular_op_id.index >= min_running_index ||
+      MaxPersistentOpIdForDb(intents_db_.get()).index >= regular_op_id.index ||
+      HasUnflushedData(intents_db_.get())) {
+    return Status::OK();
   }
-  return down_cast<docdb::ConsensusFrontier*>(temp.get())->op_id();
+  return intents_db_->SetFlushedFrontier(std::move(regular_frontier));
 }
 
 Status Tablet::DebugDump(vector<string> *lines) {
@@ -1090,6 +1500,11 @@ void Tablet::DocDBDebugDump(vector<string> *lines) {
   LOG_STRING(INFO, lines) << "Dumping tablet:";
   LOG_STRING(INFO, lines) << "---------------------------";
   yb::docdb::DocDBDebugDump(rocksdb_.get(), LOG_STRING(INFO, lines));
+  if (intents_db_) {
+    LOG_STRING(INFO, lines) << "Dumping intents:";
+    LOG_STRING(INFO, lines) << "---------------------------";
+    yb::docdb::DocDBDebugDump(intents_db_.get(), LOG_STRING(INFO, lines));
+  }
 }
 
 namespace {
@@ -1130,6 +1545,7 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
   docdb::PrepareDocWriteOperation(
       doc_ops, metrics_->write_lock_latency, *isolation_level, &shared_lock_manager_,
       data.keys_locked, &need_read_snapshot);
+  TRACE("Locked $0 keys", data.keys_locked->size());
 
   auto read_op = need_read_snapshot
       ? ScopedReadOperation(this, RequireLease::kTrue, data.read_time())
@@ -1141,11 +1557,13 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
       metadata_->schema().table_properties().is_transactional()) {
     auto now = clock_->Now();
     auto result = docdb::ResolveOperationConflicts(
-        doc_ops, now, rocksdb_.get(), transaction_participant_.get());
+        *data.keys_locked, now, rocksdb_.get(), intents_db_.get(),
+        transaction_participant_.get());
     RETURN_NOT_OK(result);
     if (now != *result) {
       clock_->Update(*result);
     }
+    TRACE("Resolved operation conflicts");
   }
 
   // We expect all read operations for this transaction to be done in ExecuteDocWriteOperation.
@@ -1156,6 +1574,7 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
                                                  : InitMarkerBehavior::kOptional,
       &monotonic_counter_,
       data.restart_read_ht));
+  TRACE("Executed doc write operations");
 
   if (data.restart_read_ht->is_valid()) {
     return Status::OK();
@@ -1165,11 +1584,13 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
     auto result = docdb::ResolveTransactionConflicts(*write_batch,
                                                      clock_->Now(),
                                                      rocksdb_.get(),
+                                                     intents_db_.get(),
                                                      transaction_participant_.get());
     if (!result.ok()) {
       *data.keys_locked = LockBatch();  // Unlock the keys.
       return result;
     }
+    TRACE("Resolved transaction conflicts");
   }
 
   return Status::OK();
@@ -1244,7 +1665,11 @@ void Tablet::ForceRocksDBCompactInTest() {
 }
 
 std::string Tablet::DocDBDumpStrInTest() {
-  return docdb::DocDBDebugDumpToStr(rocksdb_.get());
+  auto result = docdb::DocDBDebugDumpToStr(rocksdb_.get());
+  if (intents_db_) {
+    result += docdb::DocDBDebugDumpToStr(intents_db_.get());
+  }
+  return result;
 }
 
 void Tablet::LostLeadership() {
@@ -1262,7 +1687,36 @@ uint64_t Tablet::GetTotalSSTFileSizes() const {
   if (!pending_op_counter_.IsReady() || !rocksdb_) {
     return 0;
   }
-  return rocksdb_->GetTotalSSTFileSize();
+  auto result = rocksdb_->GetTotalSSTFileSize();
+  if (intents_db_) {
+    result += intents_db_->GetTotalSSTFileSize();
+  }
+  return result;
+}
+
+uint64_t Tablet::GetOwnSSTFileSizes() const {
+  if (hash_bounds_.IsFull()) {
+    return GetTotalSSTFileSizes();
+  }
+
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+
+  if (!pending_op_counter_.IsReady() || !rocksdb_) {
+    return 0;
+  }
+  std::vector<rocksdb::LiveFileMetaData> live_files;
+  rocksdb_->GetLiveFilesMetaData(&live_files);
+  uint64_t result = 0;
+  for (const auto& file : live_files) {
+    // Files written after the split only contain keys of this tablet, so their share is 1.
+    result += static_cast<uint64_t>(
+        file.total_size * hash_bounds_.ShareOfRange(file.smallest.key, file.largest.key));
+  }
+  if (intents_db_) {
+    result += intents_db_->GetTotalSSTFileSize();
+  }
+  return result;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1275,12 +1729,13 @@ Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext
           transaction_metadata.transaction_id());
       RETURN_NOT_OK(txn_id);
       return Result<TransactionOperationContextOpt>(boost::make_optional(
-          TransactionOperationContext(*txn_id, transaction_participant())));
+          TransactionOperationContext(*txn_id, transaction_participant(), intents_db_.get())));
     } else {
       // We still need context with transaction participant in order to resolve intents during
       // possible reads.
       return Result<TransactionOperationContextOpt>(boost::make_optional(
-          TransactionOperationContext(GenerateTransactionId(), transaction_participant())));
+          TransactionOperationContext(
+              GenerateTransactionId(), transaction_participant(), intents_db_.get())));
     }
   } else {
     return Result<TransactionOperationContextOpt>(boost::none);
@@ -1291,11 +1746,13 @@ TransactionOperationContextOpt Tablet::CreateTransactionOperationContext(
     const boost::optional<TransactionId>& transaction_id) const {
   if (metadata_->schema().table_properties().is_transactional()) {
     if (transaction_id.is_initialized()) {
-      return TransactionOperationContext(transaction_id.get(), transaction_participant());
+      return TransactionOperationContext(
+          transaction_id.get(), transaction_participant(), intents_db_.get());
     } else {
       // We still need context with transaction participant in order to resolve intents during
       // possible reads.
-      return TransactionOperationContext(GenerateTransactionId(), transaction_participant());
+      return TransactionOperationContext(
+          GenerateTransactionId(), transaction_participant(), intents_db_.get());
     }
   } else {
     return boost::none;
@@ -63,6 +63,7 @@
 #include "yb/gutil/macros.h"
 
 #include "yb/tablet/abstract_tablet.h"
+#include "yb/tablet/hot_keys.h"
 #include "yb/tablet/lock_manager.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
@@ -112,6 +113,7 @@ struct TabletMetrics;
 struct TransactionApplyData;
 class TransactionCoordinator;
 class TransactionCoordinatorContext;
+class TabletSplitter;
 class TransactionParticipant;
 class TruncateOperationState;
 class WriteOperationState;
@@ -178,7 +180,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const scoped_refptr<log::LogAnchorRegistry>& log_anchor_registry,
       const TabletOptions& tablet_options,
       TransactionParticipantContext* transaction_participant_context,
-      TransactionCoordinatorContext* transaction_coordinator_context);
+      TransactionCoordinatorContext* transaction_coordinator_context,
+      TabletSplitter* tablet_splitter = nullptr);
 
   ~Tablet();
 
@@ -275,6 +278,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   CHECKED_STATUS CreateCheckpoint(const std::string& dir,
       google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files = nullptr);
 
+  // Create a checkpoint of the regular RocksDB, that could be opened as a DB of a tablet created by
+  // splitting this one. Its flushed frontier is reset, so that the new tablet would not skip the
+  // entries of its own Raft log, whose op ids start from the beginning.
+  CHECKED_STATUS CreateSplitCheckpoint(const std::string& dir);
+
   // Create a new row iterator which yields the rows as of the current MVCC
   // state of this tablet.
   // The returned iterator is not initialized.
@@ -332,6 +340,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
+  // Trackers of the most frequently read and written keys of this tablet.
+  const HotKeysTracker& read_hot_keys() const { return read_hot_keys_; }
+  const HotKeysTracker& write_hot_keys() const { return write_hot_keys_; }
+
   // Returns a reference to this tablet's memory tracker.
   const std::shared_ptr<MemTracker>& mem_tracker() const { return mem_tracker_; }
 
@@ -340,9 +352,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
-  // Returns the maximum persistent op id from all SSTables in RocksDB.
+  // Returns the maximum persistent op id from all SSTables in RocksDB. For a transactional tablet
+  // it is the minimum of those of the regular and intents DBs. Both bootstrap and log GC use it.
   Result<yb::OpId> MaxPersistentOpId() const;
 
+  // Moves the flushed frontier of an intents DB without unflushed data up to that of the regular
+  // DB, so that an intents DB without recent writes does not hold back log GC. Operations with
+  // index 'min_running_index' or above could still be writing to the DBs.
+  CHECKED_STATUS AdvanceIdleIntentsFlushedFrontier(int64_t min_running_index);
+
   // Returns the location of the last rocksdb checkpoint. Used for tests only.
   std::string GetLastRocksDBCheckpointDirForTest() { return last_rocksdb_checkpoint_dir_; }
 
@@ -352,6 +370,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       WriteOperationState *state, HybridTime* restart_read_ht);
 
   static const char* kDMSMemTrackerId;
+  static const char* kBlockBasedTableMemTrackerId;
 
   // Returns the timestamp corresponding to the oldest active reader. If none exists returns
   // the latest timestamp that is safe to read.
@@ -386,6 +405,27 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return transaction_participant_.get();
   }
 
+  TabletSplitter* tablet_splitter() const {
+    return tablet_splitter_;
+  }
+
+  // Whether the split of this tablet was started. Writes are rejected after that, so that they
+  // would not be lost by the new tablets.
+  bool split_started() const {
+    return split_started_.load(std::memory_order_acquire);
+  }
+
+  void set_split_started(bool value) {
+    split_started_.store(value, std::memory_order_release);
+  }
+
+  // Range of the DocKey hashes that belongs to this tablet. It is narrower than the whole space
+  // only for tablets created by a split, whose RocksDB still contains keys of the sibling tablet
+  // until they are compacted away.
+  const docdb::DocKeyHashBounds& hash_bounds() const {
+    return hash_bounds_;
+  }
+
   void ForceRocksDBCompactInTest();
 
   std::string DocDBDumpStrInTest();
@@ -401,6 +441,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   uint64_t GetTotalSSTFileSizes() const;
 
+  // Same as GetTotalSSTFileSizes, but for the SST files that a split tablet shares with its
+  // sibling, only the share of this tablet's hash range is counted. Otherwise both new tablets
+  // would look as large as their parent until those files are compacted, and be split again.
+  uint64_t GetOwnSSTFileSizes() const;
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -413,6 +458,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return rocksdb_.get();
   }
 
+  rocksdb::DB* TEST_intents_db() const {
+    return intents_db_.get();
+  }
+
   CHECKED_STATUS TEST_SwitchMemtable();
 
  protected:
@@ -427,6 +476,24 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS OpenKeyValueTablet();
 
+  // Allows flushing an intents DB memtable only when regular records written by the same
+  // operations are flushed.
+  Result<bool> IntentsDbFlushFilter(const rocksdb::MemTable& memtable);
+
+  // Called after a regular DB memtable is flushed, schedules the intents DB flushes that were
+  // postponed by IntentsDbFlushFilter.
+  void RegularDbFlushed();
+
+  // Closes the intents DB, so that RegularDbFlushed no longer refers to it.
+  void ResetIntentsDb();
+
+  // Moves the intents that were written to the regular DB before the tablet had an intents DB to
+  // the intents DB.
+  CHECKED_STATUS MoveIntentsFromRegularDb();
+
+  void WriteToRocksDB(
+      rocksdb::DB* db, rocksdb::WriteBatch* write_batch, const rocksdb::UserFrontiers* frontiers);
+
   void DocDBDebugDump(std::vector<std::string> *lines);
 
   // Register/Unregister a read operation, with an associated timestamp, for the purpose of
@@ -494,6 +561,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
   std::shared_ptr<MemTracker> mem_tracker_;
   std::shared_ptr<MemTracker> dms_mem_tracker_;
+  // Tracks memory of index and filter blocks pinned by RocksDB table readers.
+  std::shared_ptr<MemTracker> block_based_table_mem_tracker_;
 
   MetricEntityPtr metric_entity_;
   gscoped_ptr<TabletMetrics> metrics_;
@@ -543,11 +612,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // RocksDB database for key-value tables.
   std::unique_ptr<rocksdb::DB> rocksdb_;
 
+  // RocksDB database for provisional records (intents) of transactions. Only transactional
+  // tablets have it, and it is placed in a subdirectory of the regular DB directory.
+  std::unique_ptr<rocksdb::DB> intents_db_;
+
+  // Protects intents_db_ from being reset while RegularDbFlushed uses it.
+  std::mutex intents_db_mutex_;
+
   std::unique_ptr<common::QLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
   docdb::SharedLockManager shared_lock_manager_;
 
+  HotKeysTracker read_hot_keys_;
+  HotKeysTracker write_hot_keys_;
+
   // For the block cache and memory manager shared across tablets
   TabletOptions tablet_options_;
 
@@ -576,6 +655,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<TransactionParticipant> transaction_participant_;
 
+  TabletSplitter* const tablet_splitter_;
+
+  std::atomic<bool> split_started_{false};
+
+  docdb::DocKeyHashBounds hash_bounds_;
+
   std::atomic<int64_t> last_committed_write_index_{0};
 
   // Remembers he HybridTime of the oldest write that is still not scheduled to
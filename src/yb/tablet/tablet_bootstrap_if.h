@@ -72,6 +72,7 @@ class Clock;
 namespace tablet {
 class Tablet;
 class TabletMetadata;
+class TabletSplitter;
 class TransactionCoordinatorContext;
 class TransactionParticipantContext;
 struct TabletOptions;
@@ -118,6 +119,7 @@ struct BootstrapTabletData {
   TabletOptions tablet_options;
   TransactionParticipantContext* transaction_participant_context;
   TransactionCoordinatorContext* transaction_coordinator_context;
+  TabletSplitter* tablet_splitter;
 };
 
 // Bootstraps a tablet, initializing it with the provided metadata. If the tablet
@@ -80,6 +80,7 @@ namespace yb {
 namespace tablet {
 
 const int64 kNoDurableMemStore = -1;
+const char* const kIntentsSubdir = "intents";
 
 // ============================================================================
 //  Tablet Metadata
@@ -204,6 +205,17 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
   docdb::InitRocksDBOptions(
       &rocksdb_options, tablet_id_, nullptr /* statistics */, tablet_options);
 
+  // The intents DB lives inside the regular DB directory, so it is destroyed first.
+  const auto intents_dir = intents_rocksdb_dir();
+  if (fs_manager_->env()->FileExists(intents_dir)) {
+    LOG(INFO) << "Destroying intents RocksDB at: " << intents_dir;
+    rocksdb::Status status = rocksdb::DestroyDB(intents_dir, rocksdb_options);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to destroy intents RocksDB at: " << intents_dir << ": "
+                 << status.ToString();
+    }
+  }
+
   LOG(INFO) << "Destroying RocksDB at: " << rocksdb_dir_;
   rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options);
 
@@ -362,6 +374,11 @@ Status TabletMetadata::LoadFromSuperBlock(const TabletSuperBlockPB& superblock)
     } else {
       tombstone_last_logged_opid_ = OpId();
     }
+
+    split_parent_tablet_id_ = superblock.split_parent_tablet_id();
+    split_child_tablet_ids_.assign(superblock.split_child_tablet_ids().begin(),
+                                   superblock.split_child_tablet_ids().end());
+    split_partition_key_ = superblock.split_partition_key();
   }
 
   // Now is a good time to clean up any orphaned blocks that may have been
@@ -534,6 +551,16 @@ Status TabletMetadata::ToSuperBlockUnlocked(TabletSuperBlockPB* super_block) con
     tombstone_last_logged_opid_.ToPB(pb.mutable_tombstone_last_logged_opid());
   }
 
+  if (!split_parent_tablet_id_.empty()) {
+    pb.set_split_parent_tablet_id(split_parent_tablet_id_);
+  }
+  for (const TabletId& tablet_id : split_child_tablet_ids_) {
+    pb.add_split_child_tablet_ids(tablet_id);
+  }
+  if (!split_partition_key_.empty()) {
+    pb.set_split_partition_key(split_partition_key_);
+  }
+
   for (const BlockId& block_id : orphaned_blocks_) {
     block_id.CopyToPB(pb.mutable_orphaned_blocks()->Add());
   }
@@ -603,6 +630,10 @@ uint32_t TabletMetadata::schema_version() const {
   return schema_version_;
 }
 
+string TabletMetadata::intents_rocksdb_dir() const {
+  return JoinPathSegments(rocksdb_dir_, kIntentsSubdir);
+}
+
 string TabletMetadata::data_root_dir() const {
   if (rocksdb_dir_.empty()) {
     return "";
@@ -641,5 +672,32 @@ TabletDataState TabletMetadata::tablet_data_state() const {
   return tablet_data_state_;
 }
 
+void TabletMetadata::set_split_parent_tablet_id(const TabletId& tablet_id) {
+  std::lock_guard<LockType> l(data_lock_);
+  split_parent_tablet_id_ = tablet_id;
+}
+
+TabletId TabletMetadata::split_parent_tablet_id() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_parent_tablet_id_;
+}
+
+void TabletMetadata::set_split_child_tablet_ids(const std::vector<TabletId>& tablet_ids,
+                                                const std::string& split_partition_key) {
+  std::lock_guard<LockType> l(data_lock_);
+  split_child_tablet_ids_ = tablet_ids;
+  split_partition_key_ = split_partition_key;
+}
+
+std::vector<TabletId> TabletMetadata::split_child_tablet_ids() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_child_tablet_ids_;
+}
+
+std::string TabletMetadata::split_partition_key() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_partition_key_;
+}
+
 } // namespace tablet
 } // namespace yb
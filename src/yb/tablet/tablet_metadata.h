@@ -39,6 +39,7 @@
 
 #include <boost/optional/optional_fwd.hpp>
 
+#include "yb/common/entity_ids.h"
 #include "yb/common/index.h"
 #include "yb/common/partition.h"
 #include "yb/common/schema.h"
@@ -63,6 +64,9 @@ namespace tablet {
 
 extern const int64 kNoDurableMemStore;
 
+// Subdirectory of the tablet RocksDB directory that holds the intents DB of transactional tables.
+extern const char* const kIntentsSubdir;
+
 // Manages the "blocks tracking" for the specified tablet.
 //
 // TabletMetadata is owned by the Tablet. As new blocks are written to store
@@ -135,6 +139,8 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   std::string rocksdb_dir() const { return rocksdb_dir_; }
 
+  std::string intents_rocksdb_dir() const;
+
   std::string wal_dir() const { return wal_dir_; }
 
   // Given the data directory of a tablet, returns the data root dir for that tablet.
@@ -177,6 +183,18 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   void set_tablet_data_state(TabletDataState state);
   TabletDataState tablet_data_state() const;
 
+  // Set / get the id of the tablet this tablet was split from. Empty if the tablet was not split
+  // from another one, or its RocksDB does not contain the keys of its sibling anymore.
+  void set_split_parent_tablet_id(const TabletId& tablet_id);
+  TabletId split_parent_tablet_id() const;
+
+  // Set / get the ids of the tablets this tablet was split into, and the partition key it was
+  // split at. The child tablets might not be created yet.
+  void set_split_child_tablet_ids(const std::vector<TabletId>& tablet_ids,
+                                  const std::string& split_partition_key);
+  std::vector<TabletId> split_child_tablet_ids() const;
+  std::string split_partition_key() const;
+
   // Increments flush pin count by one: if flush pin count > 0,
   // metadata will _not_ be flushed to disk during Flush().
   void PinFlush();
@@ -361,6 +379,10 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // tombstoned. Has no meaning for non-tombstoned tablets.
   yb::OpId tombstone_last_logged_opid_;
 
+  TabletId split_parent_tablet_id_;
+  std::vector<TabletId> split_child_tablet_ids_;
+  std::string split_partition_key_;
+
   // If this counter is > 0 then Flush() will not write any data to
   // disk.
   int32_t num_flush_pins_ = 0;
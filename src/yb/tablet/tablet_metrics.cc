@@ -31,10 +31,20 @@
 //
 #include "yb/tablet/tablet_metrics.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(tablet_track_cpu_time, false,
+            "Whether to account the CPU time spent on reads and writes to the tablets, which is "
+            "used by the load balancer on the master. Adds two getrusage calls to every read, "
+            "write and apply.");
+TAG_FLAG(tablet_track_cpu_time, advanced);
+TAG_FLAG(tablet_track_cpu_time, runtime);
+
 // Tablet-specific metrics.
 METRIC_DEFINE_counter(tablet, rows_inserted, "Rows Inserted",
     yb::MetricUnit::kRows,
@@ -109,6 +119,22 @@ METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, read_ops, "Read Operations",
+  yb::MetricUnit::kOperations,
+  "Number of QL and Redis read operations served by this tablet since service start.");
+METRIC_DEFINE_counter(tablet, read_bytes, "Bytes Read",
+  yb::MetricUnit::kBytes,
+  "Number of bytes returned by the read operations served by this tablet since service start.");
+METRIC_DEFINE_counter(tablet, write_ops, "Write Operations",
+  yb::MetricUnit::kOperations,
+  "Number of key-value pairs applied to this tablet since service start.");
+METRIC_DEFINE_counter(tablet, write_bytes, "Bytes Written",
+  yb::MetricUnit::kBytes,
+  "Number of bytes of the write batches applied to this tablet since service start.");
+METRIC_DEFINE_counter(tablet, cpu_time_us, "CPU Time",
+  yb::MetricUnit::kMicroseconds,
+  "CPU time spent on the reads and writes to this tablet since service start.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -121,7 +147,12 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
     MINIT(write_op_duration_client_propagated_consistency),
-    MINIT(leader_memory_pressure_rejections) {
+    MINIT(leader_memory_pressure_rejections),
+    MINIT(read_ops),
+    MINIT(read_bytes),
+    MINIT(write_ops),
+    MINIT(write_bytes),
+    MINIT(cpu_time_us) {
 }
 #undef MINIT
 
@@ -131,5 +162,20 @@ ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram>
 ScopedTabletMetricsTracker::~ScopedTabletMetricsTracker() {
   latency_->Increment(MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds());
 }
+
+ScopedTabletCpuTracker::ScopedTabletCpuTracker(TabletMetrics* metrics)
+    : metrics_(FLAGS_tablet_track_cpu_time ? metrics : nullptr) {
+  if (metrics_) {
+    stopwatch_.start();
+  }
+}
+
+ScopedTabletCpuTracker::~ScopedTabletCpuTracker() {
+  if (metrics_) {
+    stopwatch_.stop();
+    const CpuTimes times = stopwatch_.elapsed();
+    metrics_->cpu_time_us->IncrementBy((times.user + times.system) / 1000);
+  }
+}
 } // namespace tablet
 } // namespace yb
@@ -36,6 +36,7 @@
 #include "yb/gutil/ref_counted.h"
 
 #include "yb/util/monotime.h"
+#include "yb/util/stopwatch.h"
 
 namespace yb {
 
@@ -61,6 +62,13 @@ struct TabletMetrics {
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+
+  // Load served by the tablet, reported to the master for load-aware balancing.
+  scoped_refptr<Counter> read_ops;
+  scoped_refptr<Counter> read_bytes;
+  scoped_refptr<Counter> write_ops;
+  scoped_refptr<Counter> write_bytes;
+  scoped_refptr<Counter> cpu_time_us;
 };
 
 class ScopedTabletMetricsTracker {
@@ -73,6 +81,20 @@ class ScopedTabletMetricsTracker {
   MonoTime start_time_;
 };
 
+// Adds the CPU time spent by the current thread while the tracker is alive to the cpu_time_us
+// metric of the tablet. Does nothing if metrics is null.
+class ScopedTabletCpuTracker {
+ public:
+  explicit ScopedTabletCpuTracker(TabletMetrics* metrics);
+  ~ScopedTabletCpuTracker();
+
+ private:
+  TabletMetrics* metrics_;
+  Stopwatch stopwatch_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTabletCpuTracker);
+};
+
 } // namespace tablet
 } // namespace yb
 #endif /* YB_TABLET_TABLET_METRICS_H */
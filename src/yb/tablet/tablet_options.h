@@ -20,12 +20,23 @@ class MemoryMonitor;
 }
 
 namespace yb {
+
+class MemTracker;
+class PriorityThreadPool;
+class ThreadPool;
+
 namespace tablet {
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Pool used to insert large write batches into memtables concurrently.
+  ThreadPool* memtable_insert_thread_pool = nullptr;
+  // Pool used to run compactions of all tablets, prioritized by read amplification.
+  PriorityThreadPool* priority_thread_pool_for_compactions = nullptr;
+  // Tracks memory of index and filter blocks pinned by RocksDB table readers of the tablet.
+  std::shared_ptr<MemTracker> block_based_table_mem_tracker;
 };
 
 } // namespace tablet
@@ -68,6 +68,7 @@
 
 #include "yb/tablet/operations/alter_schema_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -542,6 +543,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kTruncate:
       return consensus::TRUNCATE_OP;
 
+    case OperationType::kSplit:
+      return consensus::SPLIT_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -600,13 +604,16 @@ Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
     }
   }
 
-  // Next, interrogate the OperationTracker.
+  // Next, interrogate the OperationTracker. Operations before the pending ones have finished
+  // writing to RocksDB.
+  int64_t min_running_index = *min_index + 1;
   for (const auto& driver : operation_tracker_.GetPendingOperations()) {
     OpId tx_op_id = driver->GetOpId();
     // A operation which doesn't have an opid hasn't been submitted for replication yet and
     // thus has no need to anchor the log.
     if (tx_op_id.IsInitialized()) {
       *min_index = std::min(*min_index, tx_op_id.index());
+      min_running_index = std::min(min_running_index, tx_op_id.index());
     }
   }
 
@@ -615,6 +622,8 @@ Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
     *min_index = std::min(*min_index, transaction_coordinator->PrepareGC());
   }
 
+  // Bootstrap replays the log from the op id persistent in both DBs, so it is kept from there.
+  RETURN_NOT_OK(tablet_->AdvanceIdleIntentsFlushedFrontier(min_running_index));
   int64_t last_committed_write_index = tablet_->last_committed_write_index();
   Result<yb::OpId> max_persistent_op_id = tablet_->MaxPersistentOpId();
   RETURN_NOT_OK(max_persistent_op_id);
@@ -683,6 +692,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<TruncateOperation>(
           std::make_unique<TruncateOperationState>(tablet()), consensus::REPLICA);
 
+    case consensus::SPLIT_OP:
+      DCHECK(replicate_msg->has_split_request()) << "SPLIT_OP replica"
+          " operation must receive a SplitTabletRequestPB";
+      return std::make_unique<SplitOperation>(
+          std::make_unique<SplitOperationState>(tablet()), consensus::REPLICA);
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
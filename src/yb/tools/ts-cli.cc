@@ -66,6 +66,8 @@ using yb::server::ServerStatusPB;
 using yb::tablet::TabletStatusPB;
 using yb::tserver::DeleteTabletRequestPB;
 using yb::tserver::DeleteTabletResponsePB;
+using yb::tserver::ListHotKeysRequestPB;
+using yb::tserver::ListHotKeysResponsePB;
 using yb::tserver::ListTabletsRequestPB;
 using yb::tserver::ListTabletsResponsePB;
 using yb::tserver::TabletServerAdminServiceProxy;
@@ -82,6 +84,7 @@ const char* const kDumpTabletOp = "dump_tablet";
 const char* const kDeleteTabletOp = "delete_tablet";
 const char* const kCurrentHybridTime = "current_hybrid_time";
 const char* const kStatus = "status";
+const char* const kListHotKeysOp = "list_hot_keys";
 
 DEFINE_string(server_address, "localhost",
               "Address of server to run against");
@@ -136,6 +139,9 @@ class TsAdminClient {
   // given tablet server.
   Status ListTablets(std::vector<StatusAndSchemaPB>* tablets);
 
+  // Sets 'tablets' to the most frequently read and written keys of all tablets on a given
+  // tablet server.
+  Status ListHotKeys(std::vector<tserver::TabletHotKeysPB>* tablets);
 
   // Sets the gflag 'flag' to 'val' on the remote server via RPC.
   // If 'force' is true, allows setting flags even if they're not marked as
@@ -216,6 +222,24 @@ Status TsAdminClient::ListTablets(vector<StatusAndSchemaPB>* tablets) {
   return Status::OK();
 }
 
+Status TsAdminClient::ListHotKeys(vector<tserver::TabletHotKeysPB>* tablets) {
+  CHECK(initted_);
+
+  ListHotKeysRequestPB req;
+  ListHotKeysResponsePB resp;
+  RpcController rpc;
+
+  rpc.set_timeout(timeout_);
+  RETURN_NOT_OK(ts_proxy_->ListHotKeys(req, &resp, &rpc));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+
+  tablets->assign(resp.tablets().begin(), resp.tablets().end());
+
+  return Status::OK();
+}
+
 Status TsAdminClient::SetFlag(const string& flag, const string& val,
                               bool force) {
   server::SetFlagRequestPB req;
@@ -343,7 +367,8 @@ void SetUsage(const char* argv0) {
       << "  " << kDumpTabletOp << " <tablet_id>\n"
       << "  " << kDeleteTabletOp << " <tablet_id> <reason string>\n"
       << "  " << kCurrentHybridTime << "\n"
-      << "  " << kStatus;
+      << "  " << kStatus << "\n"
+      << "  " << kListHotKeysOp;
   google::SetUsageMessage(str.str());
 }
 
@@ -458,6 +483,23 @@ static int TsCliMain(int argc, char** argv) {
     RETURN_NOT_OK_PREPEND_FROM_MAIN(client.GetStatus(&status),
                                     "Unable to get status");
     std::cout << status.DebugString() << std::endl;
+  } else if (op == kListHotKeysOp) {
+    CHECK_ARGC_OR_RETURN_WITH_USAGE(op, 2);
+
+    vector<tserver::TabletHotKeysPB> tablets;
+    RETURN_NOT_OK_PREPEND_FROM_MAIN(client.ListHotKeys(&tablets),
+                                    "Unable to list hot keys on " + addr);
+    for (const auto& tablet : tablets) {
+      std::cout << "Tablet id: " << tablet.tablet_id() << std::endl;
+      for (const auto& key : tablet.read_keys()) {
+        std::cout << "Read: " << key.key() << " share: " << key.share()
+                  << " count: " << key.count() << " error: " << key.error() << std::endl;
+      }
+      for (const auto& key : tablet.write_keys()) {
+        std::cout << "Write: " << key.key() << " share: " << key.share()
+                  << " count: " << key.count() << " error: " << key.error() << std::endl;
+      }
+    }
   } else {
     std::cerr << "Invalid operation: " << op << std::endl;
     google::ShowUsageWithFlagsRestrict(argv[0], __FILE__);
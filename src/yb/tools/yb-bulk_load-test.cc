@@ -353,7 +353,7 @@ class YBBulkLoadTest : public YBMiniClusterTestBase<MiniCluster> {
     std::shared_ptr<std::vector<ColumnSchema>>
       columns = std::make_shared<std::vector<ColumnSchema>>(schema_.columns());
     yb::ql::RowsResult rowsResult(*table_name_, columns, rows_data.ToBuffer());
-    *rowblock = rowsResult.GetRowBlock();
+    *rowblock = ASSERT_RESULT(rowsResult.GetRowBlock());
   }
 
   std::shared_ptr<YBClient> client_;
@@ -32,7 +32,10 @@
 
 #include "yb/tserver/heartbeater.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
@@ -48,6 +51,7 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -71,6 +75,26 @@ DEFINE_int32(heartbeat_max_failures_before_backoff, 3,
              "rather than retrying.");
 TAG_FLAG(heartbeat_max_failures_before_backoff, advanced);
 
+DEFINE_double(tablet_hot_key_share_threshold, 0.2,
+              "A tablet is reported to the master as hot, if a single key gets at least this "
+              "fraction of its sampled reads or writes. Non-positive value disables reporting.");
+TAG_FLAG(tablet_hot_key_share_threshold, advanced);
+TAG_FLAG(tablet_hot_key_share_threshold, runtime);
+
+DEFINE_double(tablet_hot_key_min_ops_per_sec, 100,
+              "A tablet is only reported to the master as hot, if its hottest key also got at "
+              "least this many reads or writes per second since the previous metrics report. "
+              "So tablets that are skewed, but idle, are not reported.");
+TAG_FLAG(tablet_hot_key_min_ops_per_sec, advanced);
+TAG_FLAG(tablet_hot_key_min_ops_per_sec, runtime);
+
+DEFINE_int32(tablet_load_report_limit, 1000,
+             "Maximum number of tablet replica loads sent to the master in a single metrics "
+             "report. The busiest replicas are sent, and the other ones are considered idle by "
+             "the load balancer. 0 means no limit.");
+TAG_FLAG(tablet_load_report_limit, advanced);
+TAG_FLAG(tablet_load_report_limit, runtime);
+
 using google::protobuf::RepeatedPtrField;
 using yb::HostPortPB;
 using yb::consensus::RaftPeerPB;
@@ -175,6 +199,9 @@ class Heartbeater::Thread {
   // True once at least one heartbeat has been sent.
   bool has_heartbeated_;
 
+  // Number of changed tablets that did not fit into the last acknowledged tablet report.
+  int remaining_tablet_count_ = 0;
+
   // The number of heartbeats which have failed in a row.
   // This is tracked so as to back-off heartbeating.
   int consecutive_failed_heartbeats_;
@@ -197,6 +224,28 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Values of the load metrics of a tablet, at the time of the previous metrics report.
+  struct TabletLoadCounters {
+    int64_t read_ops;
+    int64_t read_bytes;
+    int64_t write_ops;
+    int64_t write_bytes;
+    int64_t cpu_time_us;
+  };
+
+  // Fills the load of the tablet replica, using the counters from the previous report.
+  void FillTabletLoad(const tablet::TabletPeer& tablet_peer, tablet::Tablet* tablet,
+                      double interval_sec,
+                      std::unordered_map<TabletId, TabletLoadCounters>* tablet_load_counters,
+                      master::TabletLoadPB* tablet_load);
+
+  // Adds the loads of the busiest tablet replicas to the metrics, up to
+  // FLAGS_tablet_load_report_limit of them.
+  void AddTabletLoads(std::vector<master::TabletLoadPB>* tablet_loads,
+                      master::TServerMetricsPB* metrics);
+
+  std::unordered_map<TabletId, TabletLoadCounters> prev_tablet_load_counters_;
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -361,6 +410,11 @@ int Heartbeater::Thread::GetMillisUntilNextHeartbeat() const {
     return GetMinimumHeartbeatMillis();
   }
 
+  // Send the rest of a tablet report that was split across heartbeats right away.
+  if (remaining_tablet_count_ > 0) {
+    return GetMinimumHeartbeatMillis();
+  }
+
   return FLAGS_heartbeat_interval_ms;
 }
 
@@ -405,14 +459,51 @@ Status Heartbeater::Thread::TryHeartbeat() {
     std::vector<scoped_refptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
+    const double hot_key_share_threshold = FLAGS_tablet_hot_key_share_threshold;
+    const double hot_key_min_ops_per_sec = FLAGS_tablet_hot_key_min_ops_per_sec;
+    const double interval_sec = (MonoTime::Now() - prev_tserver_metrics_submission_).ToSeconds();
+    std::unordered_map<TabletId, TabletLoadCounters> tablet_load_counters;
+    std::vector<master::TabletLoadPB> tablet_loads;
+    tablet_loads.reserve(tablet_peers.size());
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       scoped_refptr<yb::tablet::TabletPeer> tablet_peer = *it;
       if (tablet_peer) {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
-        total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        if (!tablet_class) {
+          continue;
+        }
+        tablet_loads.emplace_back();
+        auto& tablet_load = tablet_loads.back();
+        FillTabletLoad(*tablet_peer, tablet_class.get(), interval_sec, &tablet_load_counters,
+                       &tablet_load);
+        total_file_sizes += tablet_load.sst_file_size();
+
+        // Report the skewed tablets we lead, so the master could spread them across tservers.
+        // The share of the hottest key is only counted if the key is also busy, since the
+        // counts of the tracker decay with the number of accesses, not with time.
+        scoped_refptr<consensus::Consensus> consensus = tablet_peer->shared_consensus();
+        if (hot_key_share_threshold > 0 && consensus &&
+            consensus->role() == RaftPeerPB::LEADER) {
+          double max_key_share = 0;
+          const double read_key_share = tablet_class->read_hot_keys().MaxShare();
+          if (read_key_share * tablet_load.read_ops_per_sec() >= hot_key_min_ops_per_sec) {
+            max_key_share = read_key_share;
+          }
+          const double write_key_share = tablet_class->write_hot_keys().MaxShare();
+          if (write_key_share * tablet_load.write_ops_per_sec() >= hot_key_min_ops_per_sec) {
+            max_key_share = std::max(max_key_share, write_key_share);
+          }
+          if (max_key_share >= hot_key_share_threshold) {
+            auto* hot_tablet = req.mutable_metrics()->add_hot_tablets();
+            hot_tablet->set_tablet_id(tablet_peer->tablet_id());
+            hot_tablet->set_max_key_share(max_key_share);
+          }
+        }
       }
     }
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
+    prev_tablet_load_counters_.swap(tablet_load_counters);
+    AddTabletLoads(&tablet_loads, req.mutable_metrics());
 
     // Get the total number of read and write operations.
     scoped_refptr<Histogram> reads_hist = server_->GetMetricsHistogram
@@ -491,11 +582,74 @@ Status Heartbeater::Thread::TryHeartbeat() {
 
   // TODO: Handle TSHeartbeatResponsePB (e.g. deleted tablets and schema changes)
   server_->tablet_manager()->MarkTabletReportAcknowledged(req.tablet_report());
+  remaining_tablet_count_ = req.tablet_report().remaining_tablet_count();
+  if (remaining_tablet_count_ > 0) {
+    VLOG(1) << remaining_tablet_count_ << " tablets remain to be reported to master";
+  }
 
   // Update the live tserver list.
   return server_->PopulateLiveTServers(resp);
 }
 
+void Heartbeater::Thread::FillTabletLoad(
+    const tablet::TabletPeer& tablet_peer, tablet::Tablet* tablet, double interval_sec,
+    std::unordered_map<TabletId, TabletLoadCounters>* tablet_load_counters,
+    master::TabletLoadPB* tablet_load) {
+  tablet_load->set_tablet_id(tablet_peer.tablet_id());
+  tablet_load->set_sst_file_size(tablet->GetOwnSSTFileSizes());
+  const tablet::TabletMetrics* metrics = tablet->metrics();
+  if (!metrics) {
+    return;
+  }
+  const TabletLoadCounters counters = {
+    metrics->read_ops->value(),
+    metrics->read_bytes->value(),
+    metrics->write_ops->value(),
+    metrics->write_bytes->value(),
+    metrics->cpu_time_us->value()
+  };
+  (*tablet_load_counters)[tablet_peer.tablet_id()] = counters;
+
+  // The rates of a tablet that was not present at the previous report are not known yet.
+  auto it = prev_tablet_load_counters_.find(tablet_peer.tablet_id());
+  if (it == prev_tablet_load_counters_.end() || interval_sec <= 0) {
+    return;
+  }
+  const TabletLoadCounters& prev = it->second;
+  auto rate = [interval_sec](int64_t value, int64_t prev_value) {
+    return value > prev_value ? (value - prev_value) / interval_sec : 0.0;
+  };
+  tablet_load->set_read_ops_per_sec(rate(counters.read_ops, prev.read_ops));
+  tablet_load->set_read_bytes_per_sec(rate(counters.read_bytes, prev.read_bytes));
+  tablet_load->set_write_ops_per_sec(rate(counters.write_ops, prev.write_ops));
+  tablet_load->set_write_bytes_per_sec(rate(counters.write_bytes, prev.write_bytes));
+  tablet_load->set_cpu_usec_per_sec(rate(counters.cpu_time_us, prev.cpu_time_us));
+}
+
+void Heartbeater::Thread::AddTabletLoads(
+    std::vector<master::TabletLoadPB>* tablet_loads, master::TServerMetricsPB* metrics) {
+  const size_t limit = FLAGS_tablet_load_report_limit > 0 ? FLAGS_tablet_load_report_limit
+                                                          : std::numeric_limits<size_t>::max();
+  if (tablet_loads->size() > limit) {
+    auto busier = [](const master::TabletLoadPB& lhs, const master::TabletLoadPB& rhs) {
+      const double lhs_ops = lhs.read_ops_per_sec() + lhs.write_ops_per_sec();
+      const double rhs_ops = rhs.read_ops_per_sec() + rhs.write_ops_per_sec();
+      if (lhs_ops != rhs_ops) {
+        return lhs_ops > rhs_ops;
+      }
+      return lhs.sst_file_size() > rhs.sst_file_size();
+    };
+    std::nth_element(tablet_loads->begin(), tablet_loads->begin() + limit, tablet_loads->end(),
+                     busier);
+    VLOG(1) << "Reporting the load of " << limit << " out of " << tablet_loads->size()
+            << " tablets";
+    tablet_loads->resize(limit);
+  }
+  for (auto& tablet_load : *tablet_loads) {
+    metrics->add_tablet_loads()->Swap(&tablet_load);
+  }
+}
+
 Status Heartbeater::Thread::DoHeartbeat() {
   if (PREDICT_FALSE(server_->fail_heartbeats_for_tests())) {
     return STATUS(IOError, "failing all heartbeats for tests");
@@ -575,9 +575,20 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    rocksdb_dir));
 
+  // Files of the intents DB are listed relative to the tablet RocksDB directory.
+  const auto intents_dir = meta_->intents_rocksdb_dir();
+  bool intents_dir_created = false;
+
   DataIdPB data_id;
   data_id.set_type(DataIdPB::ROCKSDB_FILE);
   for (auto const& file_pb : new_sb->rocksdb_files()) {
+    if (!intents_dir_created &&
+        DirName(JoinPathSegments(rocksdb_dir, file_pb.name())) == intents_dir) {
+      RETURN_NOT_OK_PREPEND(meta_->fs_manager()->CreateDirIfMissing(intents_dir),
+                            Substitute("Failed to create intents RocksDB directory $0",
+                                       intents_dir));
+      intents_dir_created = true;
+    }
     RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
   }
   new_superblock_.swap(new_sb);
@@ -22,6 +22,7 @@
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/util/logging.h"
+#include "yb/util/sampling_profiler.h"
 
 namespace yb {
 namespace tserver {
@@ -111,6 +112,8 @@ bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
     return false;
   }
 
+  ScopedProfilerTag::SetTablet(tablet_id);
+
   // Check RUNNING state.
   tablet::TabletStatePB state = (*peer)->state();
   if (PREDICT_FALSE(state != tablet::RUNNING)) {
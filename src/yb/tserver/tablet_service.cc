@@ -62,6 +62,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -69,12 +70,14 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/util/atomic.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/sampling_profiler.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/status_callback.h"
@@ -119,6 +122,13 @@ DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_int32(max_wait_for_session_writes_on_follower_ms, 20,
+             "Maximum time in milliseconds a follower waits for its safe time to reach the writes "
+             "of the session of a consistent prefix read. The wait blocks a service thread, so "
+             "after it the follower rejects the read and the client retries it on the leader.");
+TAG_FLAG(max_wait_for_session_writes_on_follower_ms, advanced);
+TAG_FLAG(max_wait_for_session_writes_on_follower_ms, runtime);
+
 DEFINE_bool(tserver_noop_read_write, false, "Respond NOOP to read/write.");
 TAG_FLAG(tserver_noop_read_write, unsafe);
 TAG_FLAG(tserver_noop_read_write, hidden);
@@ -217,6 +227,13 @@ bool TabletServiceImpl::PrepareModify(
     return false;
   }
 
+  if (PREDICT_FALSE((*tablet)->split_started())) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS_FORMAT(IllegalState, "Tablet $0 is being split", req.tablet_id()),
+                         TabletServerErrorPB::TABLET_SPLIT, context);
+    return false;
+  }
+
   TRACE("Found Tablet");
   // Check for memory pressure; don't bother doing any additional work if we've
   // exceeded the limit.
@@ -260,6 +277,25 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
   context->RespondSuccess();
 }
 
+namespace {
+
+// Returns true if the trace of the current request should be sent back to the client. The client
+// could ask for the trace only if handling of the request took at least trace_threshold_us, so
+// that the traces are dumped only for the slow requests. The threshold is set per request, so a
+// call made of several requests passes a fraction of its own slow query threshold, see
+// rpc::SlowQueryLogRequestTraceThreshold().
+bool ShouldIncludeTrace(
+    bool include_trace, uint64_t trace_threshold_us, const rpc::RpcContext& context) {
+  if (!include_trace || Trace::CurrentTrace() == nullptr) {
+    return false;
+  }
+  return trace_threshold_us == 0 ||
+         MonoTime::Now().GetDeltaSince(context.ReceiveTime()) >=
+             MonoDelta::FromMicroseconds(trace_threshold_us);
+}
+
+} // namespace
+
 class WriteOperationCompletionCallback : public OperationCompletionCallback {
  public:
   WriteOperationCompletionCallback(
@@ -267,9 +303,10 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       WriteResponsePB* response,
       tablet::WriteOperationState* state,
       const server::ClockPtr& clock,
-      bool trace = false)
+      bool trace = false,
+      uint64_t trace_threshold_us = 0)
       : context_(std::move(context)), response_(response), state_(state), clock_(clock),
-        include_trace_(trace) {}
+        include_trace_(trace), trace_threshold_us_(trace_threshold_us) {}
 
   void OperationCompleted() override {
     if (!status_.ok()) {
@@ -293,10 +330,13 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
             context_.get());
         ql_write_resp->set_rows_data_sidecar(rows_data_sidecar_idx);
       }
-      if (include_trace_ && Trace::CurrentTrace() != nullptr) {
+      if (ShouldIncludeTrace(include_trace_, trace_threshold_us_, *context_)) {
         response_->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
       }
       response_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+      if (state_->hybrid_time_even_if_unset().is_valid()) {
+        response_->set_write_hybrid_time(state_->hybrid_time_even_if_unset().ToUint64());
+      }
       context_->RespondSuccess();
     }
   }
@@ -312,6 +352,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
   tablet::WriteOperationState* const state_;
   server::ClockPtr clock_;
   const bool include_trace_;
+  const uint64_t trace_threshold_us_;
 };
 
 // Checksums the scan result.
@@ -429,6 +470,80 @@ void TabletServiceAdminImpl::AlterSchema(const AlterSchemaRequestPB* req,
       std::move(operation_state), consensus::LEADER));
 }
 
+void TabletServiceAdminImpl::SplitTablet(const SplitTabletRequestPB* req,
+                                         SplitTabletResponsePB* resp,
+                                         rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "SplitTablet", req, resp, &context)) {
+    return;
+  }
+  LOG(INFO) << "Received SplitTablet RPC: " << req->ShortDebugString();
+
+  server::UpdateClock(*req, server_->Clock());
+
+  scoped_refptr<TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  auto meta = tablet_peer->tablet_metadata();
+  // If the split was already applied, make sure the new tablets get created and respond as
+  // succeeded.
+  const auto child_ids = meta->split_child_tablet_ids();
+  if (!child_ids.empty()) {
+    if (child_ids == std::vector<TabletId>{req->new_tablet1_id(), req->new_tablet2_id()}) {
+      server_->tablet_manager()->CreateSplitChildrenAsync(req->tablet_id());
+      context.RespondSuccess();
+    } else {
+      SetupErrorAndRespond(resp->mutable_error(),
+                           STATUS(IllegalState, "Tablet was split into different tablets"),
+                           TabletServerErrorPB::TABLET_SPLIT, &context);
+    }
+    return;
+  }
+
+  // The master aborts the split when it is rejected as not possible, so only the leader rejects
+  // it, once it knows the split was not replicated. Any other error makes the master retry.
+  if (tablet_peer->LeaderStatus() != consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+    SetupErrorAndRespond(resp->mutable_error(), STATUS(IllegalState, "Not the leader"),
+                         TabletServerErrorPB::NOT_THE_LEADER, &context);
+    return;
+  }
+  if (tablet_peer->tablet()->split_started()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS(ServiceUnavailable, "Split of the tablet is in progress"),
+                         TabletServerErrorPB::TABLET_SPLIT, &context);
+    return;
+  }
+
+  Status s;
+  if (meta->table_type() != TableType::YQL_TABLE_TYPE ||
+      meta->partition_schema().hash_schema() != YBHashSchema::kMultiColumnHash) {
+    s = STATUS(NotSupported, "Only tablets of hash partitioned YQL tables could be split");
+  } else if (meta->schema().table_properties().is_transactional()) {
+    s = STATUS(NotSupported, "Tablets of transactional tables could not be split");
+  } else if (req->split_partition_key() <= meta->partition().partition_key_start() ||
+             (!meta->partition().partition_key_end().empty() &&
+              req->split_partition_key() >= meta->partition().partition_key_end())) {
+    s = STATUS(InvalidArgument, "Split key is not inside of the tablet partition");
+  }
+  if (!s.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::OPERATION_NOT_SUPPORTED,
+                         &context);
+    return;
+  }
+
+  auto operation_state = std::make_unique<tablet::SplitOperationState>(
+      tablet_peer->tablet(), req);
+
+  operation_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the split op. The RPC will be responded to asynchronously.
+  tablet_peer->Submit(std::make_unique<tablet::SplitOperation>(
+      std::move(operation_state), consensus::LEADER));
+}
+
 void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
                                           UpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -692,7 +807,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
   auto context_ptr = std::make_shared<RpcContext>(std::move(context));
   operation_state->set_completion_callback(
       std::make_unique<WriteOperationCompletionCallback>(
-          context_ptr, resp, operation_state.get(), server_->Clock(), req->include_trace()));
+          context_ptr, resp, operation_state.get(), server_->Clock(), req->include_trace(),
+          req->trace_threshold_us()));
 
   auto status = tablet_peer->SubmitWrite(std::move(operation_state));
 
@@ -787,6 +903,15 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
     SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
     return false;
   }
+
+  // Once the split is applied, the data is served by the new tablets.
+  if (PREDICT_FALSE(ptr->split_started() &&
+                    !ptr->metadata()->split_child_tablet_ids().empty())) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS_FORMAT(IllegalState, "Tablet $0 was split", req->tablet_id()),
+                         TabletServerErrorPB::TABLET_SPLIT, context);
+    return false;
+  }
   *tablet = ptr;
   return true;
 }
@@ -816,7 +941,41 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   tablet::RequireLease require_lease(req->consistency_level() == YBConsistencyLevel::STRONG);
   bool transactional = tablet->SchemaRef().table_properties().is_transactional();
   if (!read_time) {
-    safe_ht_to_read = tablet->SafeTime(require_lease);
+    if (req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+        (req->has_max_staleness_ms() || req->has_session_write_hybrid_time())) {
+      // The read is served by this replica only if it has applied all the operations replicated
+      // before the staleness bound. Otherwise the client retries it on the leader, which is
+      // faster than waiting for this replica to catch up.
+      HybridTime min_safe_time = HybridTime::kMin;
+      MonoTime deadline = MonoTime::Now();
+      if (req->has_max_staleness_ms()) {
+        MicrosTime now = server_->Clock()->Now().GetPhysicalValueMicros();
+        MicrosTime max_staleness_us = req->max_staleness_ms() * 1000;
+        min_safe_time = HybridTime::FromMicros(
+            now > max_staleness_us ? now - max_staleness_us : 0);
+      }
+      // The writes of the session are usually replicated to this replica shortly, so it is worth
+      // waiting for them, to let the session read its own writes. The wait is kept short, since it
+      // blocks a service thread, and the leader can serve the read right away.
+      if (req->has_session_write_hybrid_time()) {
+        min_safe_time = std::max(min_safe_time, HybridTime(req->session_write_hybrid_time()));
+        deadline = std::min(
+            deadline + MonoDelta::FromMilliseconds(
+                GetAtomicFlag(&FLAGS_max_wait_for_session_writes_on_follower_ms)),
+            context.GetClientDeadline());
+      }
+      safe_ht_to_read = tablet->SafeTime(require_lease, min_safe_time, deadline);
+      if (!safe_ht_to_read.is_valid()) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(ServiceUnavailable, "Safe time of tablet $0 did not reach $1",
+                          req->tablet_id(), min_safe_time),
+            TabletServerErrorPB::STALE_FOLLOWER, &context);
+        return;
+      }
+    } else {
+      safe_ht_to_read = tablet->SafeTime(require_lease);
+    }
     // If the read time is not specified, then it is non transactional read.
     // So we should restart it in server in case of failure.
     read_time.read = safe_ht_to_read;
@@ -876,7 +1035,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       break;
     }
   }
-  if (req->include_trace() && Trace::CurrentTrace() != nullptr) {
+  if (ShouldIncludeTrace(req->include_trace(), req->trace_threshold_us(), context)) {
     resp->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
   }
   RpcOperationCompletionCallback<ReadResponsePB> callback(
@@ -892,6 +1051,8 @@ void HandleRedisReadRequestAsync(
     RedisResponsePB* response,
     const std::function<void(const Status& s)>& status_cb
 ) {
+  ScopedProfilerTag profiler_tag("tablet", "read");
+  ScopedProfilerTag::SetTablet(tablet->tablet_id());
   status_cb(tablet->HandleRedisReadRequest(read_time, redis_read_request, response));
 }
 
@@ -1379,6 +1540,52 @@ void TabletServiceImpl::GetTabletStatus(const GetTabletStatusRequestPB* req,
   context.RespondSuccess();
 }
 
+namespace {
+
+void HotKeysToPB(const std::vector<tablet::HotKey>& keys,
+                 google::protobuf::RepeatedPtrField<HotKeyPB>* out) {
+  for (const auto& key : keys) {
+    auto* key_pb = out->Add();
+    key_pb->set_key(key.key);
+    key_pb->set_count(key.count);
+    key_pb->set_error(key.error);
+    key_pb->set_share(key.share);
+  }
+}
+
+} // namespace
+
+void TabletServiceImpl::ListHotKeys(const ListHotKeysRequestPB* req,
+                                    ListHotKeysResponsePB* resp,
+                                    rpc::RpcContext context) {
+  std::vector<tablet::TabletPeerPtr> peers;
+  if (req->has_tablet_id()) {
+    tablet::TabletPeerPtr peer;
+    if (!server_->tablet_manager()->LookupTablet(req->tablet_id(), &peer)) {
+      TabletServerErrorPB::Code code = TabletServerErrorPB::TABLET_NOT_FOUND;
+      auto status = STATUS(NotFound, "Tablet not found", req->tablet_id());
+      SetupErrorAndRespond(resp->mutable_error(), status, code, &context);
+      return;
+    }
+    peers.push_back(std::move(peer));
+  } else {
+    server_->tablet_manager()->GetTabletPeers(&peers);
+  }
+
+  for (const auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    auto* tablet_pb = resp->add_tablets();
+    tablet_pb->set_tablet_id(peer->tablet_id());
+    HotKeysToPB(tablet->read_hot_keys().TopKeys(req->max_keys()), tablet_pb->mutable_read_keys());
+    HotKeysToPB(tablet->write_hot_keys().TopKeys(req->max_keys()),
+                tablet_pb->mutable_write_keys());
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::Shutdown() {
 }
 
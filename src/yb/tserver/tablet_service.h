@@ -108,6 +108,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                        GetTabletStatusResponsePB* resp,
                        rpc::RpcContext context) override;
 
+  void ListHotKeys(const ListHotKeysRequestPB* req,
+                   ListHotKeysResponsePB* resp,
+                   rpc::RpcContext context) override;
+
   void Shutdown() override;
 
  private:
@@ -170,6 +174,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                                 CopartitionTableResponsePB* resp,
                                 rpc::RpcContext context) override;
 
+  virtual void SplitTablet(const SplitTabletRequestPB* req,
+                           SplitTabletResponsePB* resp,
+                           rpc::RpcContext context) override;
+
  private:
   TabletServer* server_;
 };
@@ -32,6 +32,7 @@
 
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include <set>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -57,6 +58,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int32(tablet_report_limit);
 
 namespace yb {
 namespace tserver {
@@ -311,5 +313,41 @@ TEST_F(TsTabletManagerTest, TestTabletReports) {
   ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
 }
 
+TEST_F(TsTabletManagerTest, TestTabletReportLimit) {
+  const std::vector<std::string> kTabletIds = {"tablet-1", "tablet-2", "tablet-3"};
+  for (const auto& tablet_id : kTabletIds) {
+    ASSERT_OK(CreateNewTablet(tablet_id, schema_, nullptr));
+  }
+
+  FlagSaver flag_saver;
+  FLAGS_tablet_report_limit = 2;
+
+  TabletReportPB report;
+  int64_t seqno = -1;
+  tablet_manager_->GenerateFullTabletReport(&report);
+  ASSERT_FALSE(report.is_incremental());
+  ASSERT_EQ(2, report.updated_tablets().size());
+  ASSERT_EQ(1, report.remaining_tablet_count());
+  ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
+
+  // Tablets that did not fit into the full report should be sent in the following incremental
+  // reports, which are also limited in size.
+  std::set<std::string> reported_tablet_ids;
+  for (;;) {
+    for (const ReportedTabletPB& reported_tablet : report.updated_tablets()) {
+      reported_tablet_ids.insert(reported_tablet.tablet_id());
+    }
+    tablet_manager_->MarkTabletReportAcknowledged(report);
+    if (report.remaining_tablet_count() == 0) {
+      break;
+    }
+    tablet_manager_->GenerateIncrementalTabletReport(&report);
+    ASSERT_TRUE(report.is_incremental());
+    ASSERT_LE(report.updated_tablets().size(), 2);
+    ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
+  }
+  ASSERT_EQ(std::set<std::string>(kTabletIds.begin(), kTabletIds.end()), reported_tablet_ids);
+}
+
 } // namespace tserver
 } // namespace yb
@@ -33,6 +33,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -84,7 +85,9 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
@@ -168,6 +171,17 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_bool(use_work_stealing_thread_pools, false,
+            "Whether the read and prepare thread pools schedule tasks through per-worker "
+            "lock-free queues with work stealing, instead of a single queue protected by a lock.");
+TAG_FLAG(use_work_stealing_thread_pools, advanced);
+
+DEFINE_int32(tablet_report_limit, 1000,
+             "Maximum number of tablets reported to the master in a single heartbeat. Tablets "
+             "that did not fit are sent in the following heartbeats, so a full report from a "
+             "server with many tablets is handled by the master in several smaller pieces.");
+TAG_FLAG(tablet_report_limit, advanced);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -177,6 +191,23 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
              "Default timeout for the YBClient embedded into the tablet server that is used "
              "for distributed transactions.");
 
+DEFINE_int32(tablet_split_children_retry_interval_ms, 5000,
+             "Amount of time to wait before retrying to create the tablets a tablet was split into, "
+             "after a failed attempt.");
+TAG_FLAG(tablet_split_children_retry_interval_ms, advanced);
+
+DEFINE_bool(use_priority_thread_pool_for_compactions, true,
+            "Run RocksDB compactions of all tablets on a shared thread pool, that runs "
+            "compactions of tablets with the highest read amplification first.");
+TAG_FLAG(use_priority_thread_pool_for_compactions, advanced);
+
+DEFINE_int32(priority_thread_pool_size, -1,
+             "Max number of RocksDB compactions running at once on the shared priority thread "
+             "pool. -1 means rocksdb_max_background_compactions.");
+TAG_FLAG(priority_thread_pool_size, advanced);
+
+DECLARE_int32(rocksdb_max_background_compactions);
+
 namespace yb {
 namespace tserver {
 
@@ -222,6 +253,18 @@ METRIC_DEFINE_histogram(server, op_read_run_time, "Operation Read op Run Time",
                             "that operations consist of very large batches.",
                         10000000, 2);
 
+METRIC_DEFINE_gauge_uint64(server, compaction_queue_length, "Compaction Queue Length",
+                           MetricUnit::kTasks,
+                           "Number of RocksDB compactions of all tablets waiting for a thread "
+                           "in the shared priority thread pool.");
+
+METRIC_DEFINE_histogram(server, compaction_queue_time, "Compaction Queue Time",
+                        MetricUnit::kMicroseconds,
+                        "Time that RocksDB compactions spent waiting for a thread in the shared "
+                        "priority thread pool. High queue times indicate that compactions "
+                        "can't keep up with the write rate.",
+                        3600000000LU, 2);
+
 using consensus::ConsensusMetadata;
 using consensus::ConsensusStatePB;
 using consensus::OpId;
@@ -317,6 +360,7 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .Build(&raft_pool_));
   CHECK_OK(ThreadPoolBuilder("prepare")
                .set_max_threads(std::numeric_limits<int>::max())
+               .set_work_stealing(FLAGS_use_work_stealing_thread_pools)
                .Build(&tablet_prepare_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
@@ -327,8 +371,28 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_max_threads(FLAGS_read_pool_max_threads)
                .set_max_queue_size(FLAGS_read_pool_max_queue_size)
                .set_metrics(std::move(read_metrics))
+               .set_work_stealing(FLAGS_use_work_stealing_thread_pools)
                .Build(&read_pool_));
 
+  // Threads that help inserting large write batches into memtables of all tablets.
+  CHECK_OK(ThreadPoolBuilder("memtable-insert").Build(&memtable_insert_pool_));
+  tablet_options_.memtable_insert_thread_pool = memtable_insert_pool_.get();
+
+  // Compactions of all tablets are queued to a single pool, so that tablets with the highest
+  // read amplification don't wait behind large compactions of other tablets. Flushes keep using
+  // the separate HIGH priority pool of the RocksDB Env.
+  if (FLAGS_use_priority_thread_pool_for_compactions) {
+    PriorityThreadPoolMetrics compaction_metrics = {
+        METRIC_compaction_queue_length.Instantiate(server_->metric_entity(), 0),
+        METRIC_compaction_queue_time.Instantiate(server_->metric_entity())
+    };
+    int pool_size = FLAGS_priority_thread_pool_size > 0 ? FLAGS_priority_thread_pool_size
+                                                        : FLAGS_rocksdb_max_background_compactions;
+    compaction_pool_ = std::make_unique<PriorityThreadPool>(
+        "compaction", std::max(pool_size, 1), std::move(compaction_metrics));
+    tablet_options_.priority_thread_pool_for_compactions = compaction_pool_.get();
+  }
+
   int64_t block_cache_size_bytes = FLAGS_db_block_cache_size_bytes;
   int64_t total_ram_avail = MemTracker::GetRootTracker()->limit();
   // Auto-compute size of block cache if asked to.
@@ -736,6 +800,182 @@ scoped_refptr<TabletPeer> TSTabletManager::CreateAndRegisterTabletPeer(
   return tablet_peer;
 }
 
+void TSTabletManager::CreateSplitChildrenAsync(const TabletId& tablet_id) {
+  {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    if (!tablets_creating_split_children_.insert(tablet_id).second) {
+      return;
+    }
+  }
+  Status s = open_tablet_pool_->SubmitFunc(
+      std::bind(&TSTabletManager::CreateSplitChildren, this, tablet_id));
+  if (!s.ok()) {
+    LOG(WARNING) << LogPrefix(tablet_id, fs_manager_->uuid())
+                 << "Unable to schedule creation of split tablets: " << s;
+    std::lock_guard<rw_spinlock> lock(lock_);
+    tablets_creating_split_children_.erase(tablet_id);
+  }
+}
+
+void TSTabletManager::CreateSplitChildren(const TabletId& tablet_id) {
+  scoped_refptr<TabletPeer> tablet_peer;
+  shared_ptr<TabletClass> tablet;
+  Status s;
+  if (LookupTablet(tablet_id, &tablet_peer) && (tablet = tablet_peer->shared_tablet())) {
+    s = DoCreateSplitChildren(tablet.get());
+  }
+
+  bool retry = false;
+  {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    tablets_creating_split_children_.erase(tablet_id);
+    retry = !s.ok() && (state_ == MANAGER_INITIALIZING || state_ == MANAGER_RUNNING);
+  }
+  if (!retry) {
+    return;
+  }
+  // The split is already applied, so the new tablets have to be created eventually: the split
+  // tablet does not serve requests anymore.
+  LOG(WARNING) << LogPrefix(tablet_id, fs_manager_->uuid())
+               << "Unable to create split tablets, retrying in "
+               << FLAGS_tablet_split_children_retry_interval_ms << "ms: " << s;
+  server_->messenger()->ScheduleOnReactor(
+      [this, tablet_id](const Status& status) {
+        if (status.ok()) {
+          CreateSplitChildrenAsync(tablet_id);
+        }
+      },
+      MonoDelta::FromMilliseconds(FLAGS_tablet_split_children_retry_interval_ms));
+}
+
+Status TSTabletManager::DoCreateSplitChildren(tablet::Tablet* tablet) {
+  auto* parent_meta = tablet->metadata();
+  const auto child_ids = parent_meta->split_child_tablet_ids();
+  const auto split_partition_key = parent_meta->split_partition_key();
+  if (child_ids.size() != 2) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 is not split into two tablets: $1",
+                         tablet->tablet_id(), child_ids);
+  }
+  const string kLogPrefix = LogPrefix(tablet->tablet_id(), fs_manager_->uuid());
+  LOG(INFO) << kLogPrefix << "Creating split tablets " << child_ids[0] << " and "
+            << child_ids[1];
+
+  // The new tablets have the same peers as the split one.
+  std::unique_ptr<ConsensusMetadata> parent_cmeta;
+  RETURN_NOT_OK_PREPEND(
+      ConsensusMetadata::Load(fs_manager_, tablet->tablet_id(), fs_manager_->uuid(), &parent_cmeta),
+      "Unable to load consensus metadata of split tablet");
+  RaftConfigPB config = parent_cmeta->committed_config();
+  config.set_opid_index(consensus::kInvalidOpIdIndex);
+
+  for (size_t i = 0; i != child_ids.size(); ++i) {
+    PartitionPB partition_pb;
+    parent_meta->partition().ToPB(&partition_pb);
+    if (i == 0) {
+      partition_pb.set_partition_key_end(split_partition_key);
+    } else {
+      partition_pb.set_partition_key_start(split_partition_key);
+    }
+    Partition partition;
+    Partition::FromPB(partition_pb, &partition);
+    RETURN_NOT_OK_PREPEND(CreateSplitChildTablet(tablet, child_ids[i], partition, config),
+                          Substitute("Unable to create tablet $0", child_ids[i]));
+  }
+
+  MarkTabletDirty(tablet->tablet_id(),
+                  std::make_shared<consensus::StateChangeContext>(
+                      consensus::StateChangeReason::TABLET_SPLIT));
+  LOG(INFO) << kLogPrefix << "Tablet split into " << child_ids[0] << " and " << child_ids[1];
+  return Status::OK();
+}
+
+Status TSTabletManager::CreateSplitChildTablet(tablet::Tablet* parent,
+                                               const string& tablet_id,
+                                               const Partition& partition,
+                                               const RaftConfigPB& config) {
+  const string kLogPrefix = LogPrefix(tablet_id, fs_manager_->uuid());
+  auto* parent_meta = parent->metadata();
+  auto* env = fs_manager_->env();
+
+  scoped_refptr<TransitionInProgressDeleter> deleter;
+  {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    scoped_refptr<TabletPeer> junk;
+    if (LookupTabletUnlocked(tablet_id, &junk)) {
+      return Status::OK();
+    }
+    if (env->FileExists(fs_manager_->GetTabletMetadataPath(tablet_id))) {
+      // The tablet was created before a restart, and the tablet manager is still starting the
+      // tablets. It is registered by Init(), unless the tablet manager is already running.
+      if (state_ != MANAGER_RUNNING) {
+        return Status::OK();
+      }
+    }
+    RETURN_NOT_OK(StartTabletStateTransitionUnlocked(tablet_id, "splitting tablet", &deleter));
+  }
+
+  scoped_refptr<TabletMetadata> meta;
+  if (env->FileExists(fs_manager_->GetTabletMetadataPath(tablet_id))) {
+    RETURN_NOT_OK(OpenTabletMeta(tablet_id, &meta));
+    // The superblock could have been flushed before the split parent was set in it.
+    if (meta->split_parent_tablet_id().empty()) {
+      meta->set_split_parent_tablet_id(parent->tablet_id());
+      RETURN_NOT_OK(meta->Flush());
+    }
+    RegisterDataAndWalDir(fs_manager_, meta->table_id(), tablet_id, meta->table_type(),
+                          meta->data_root_dir(), meta->wal_root_dir());
+  } else {
+    const string data_root_dir = parent_meta->data_root_dir();
+    const string wal_root_dir = parent_meta->wal_root_dir();
+    // This is where TabletMetadata::CreateNew places the RocksDB of the tablet. The superblock is
+    // written last, so leftovers of an attempt that did not complete are removed first.
+    const string rocksdb_table_dir = JoinPathSegments(
+        JoinPathSegments(data_root_dir, FsManager::kRocksDBDirName),
+        Substitute("table-$0", parent_meta->table_id()));
+    const string rocksdb_dir = JoinPathSegments(
+        rocksdb_table_dir, Substitute("tablet-$0", tablet_id));
+    if (env->FileExists(rocksdb_dir)) {
+      RETURN_NOT_OK(env->DeleteRecursively(rocksdb_dir));
+    }
+    if (env->FileExists(fs_manager_->GetConsensusMetadataPath(tablet_id))) {
+      RETURN_NOT_OK(ConsensusMetadata::DeleteOnDiskData(fs_manager_, tablet_id));
+    }
+    RETURN_NOT_OK(env_util::CreateDirIfMissing(env, rocksdb_table_dir));
+    RETURN_NOT_OK(parent->CreateSplitCheckpoint(rocksdb_dir));
+
+    std::unique_ptr<ConsensusMetadata> cmeta;
+    RETURN_NOT_OK(ConsensusMetadata::Create(fs_manager_, tablet_id, fs_manager_->uuid(),
+                                            config, consensus::kMinimumTerm, &cmeta));
+
+    RegisterDataAndWalDir(fs_manager_, parent_meta->table_id(), tablet_id,
+                          parent_meta->table_type(), data_root_dir, wal_root_dir);
+    Status create_status = TabletMetadata::CreateNew(fs_manager_,
+                                                     parent_meta->table_id(),
+                                                     tablet_id,
+                                                     parent_meta->table_name(),
+                                                     parent_meta->table_type(),
+                                                     parent_meta->schema(),
+                                                     parent_meta->partition_schema(),
+                                                     partition,
+                                                     TABLET_DATA_READY,
+                                                     &meta,
+                                                     data_root_dir,
+                                                     wal_root_dir);
+    if (!create_status.ok()) {
+      UnregisterDataWalDir(parent_meta->table_id(), tablet_id, parent_meta->table_type(),
+                           data_root_dir, wal_root_dir);
+    }
+    RETURN_NOT_OK_PREPEND(create_status, "Couldn't create tablet metadata");
+    meta->set_split_parent_tablet_id(parent->tablet_id());
+    RETURN_NOT_OK(meta->Flush());
+    LOG(INFO) << kLogPrefix << "Created tablet metadata for split of " << parent->tablet_id();
+  }
+
+  CreateAndRegisterTabletPeer(meta, NEW_PEER);
+  return open_tablet_pool_->SubmitFunc(
+      std::bind(&TSTabletManager::OpenTablet, this, meta, deleter));
+}
+
 Status TSTabletManager::DeleteTablet(
     const string& tablet_id,
     TabletDataState delete_type,
@@ -910,7 +1150,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         tablet_peer->log_anchor_registry(),
         tablet_options_,
         tablet_peer.get(),
-        tablet_peer.get()};
+        tablet_peer.get(),
+        this};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to bootstrap: "
@@ -951,6 +1192,12 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
     tablet_peer->RegisterMaintenanceOps(server_->maintenance_manager());
   }
 
+  // The split of the tablet was applied before a restart, but the new tablets might not have been
+  // created yet.
+  if (!meta->split_child_tablet_ids().empty()) {
+    CreateSplitChildrenAsync(tablet_id);
+  }
+
   int elapsed_ms = MonoTime::Now().GetDeltaSince(start).ToMilliseconds();
   if (elapsed_ms > FLAGS_tablet_start_warn_threshold_ms) {
     LOG(WARNING) << kLogPrefix << "Tablet startup took " << elapsed_ms << "ms";
@@ -1013,6 +1260,12 @@ void TSTabletManager::Shutdown() {
   if (tablet_prepare_pool_) {
     tablet_prepare_pool_->Shutdown();
   }
+  if (memtable_insert_pool_) {
+    memtable_insert_pool_->Shutdown();
+  }
+  if (compaction_pool_) {
+    compaction_pool_->Shutdown();
+  }
 
   {
     std::lock_guard<rw_spinlock> l(lock_);
@@ -1173,7 +1426,33 @@ void TSTabletManager::GenerateIncrementalTabletReport(TabletReportPB* report) {
   report->Clear();
   report->set_sequence_number(next_report_seq_++);
   report->set_is_incremental(true);
+  GenerateTabletReportUnlocked(report);
+}
+
+void TSTabletManager::GenerateFullTabletReport(TabletReportPB* report) {
+  std::lock_guard<rw_spinlock> lock(lock_);
+  report->Clear();
+  report->set_is_incremental(false);
+  report->set_sequence_number(next_report_seq_++);
+  // Every tablet is reported, so the full report is expressed as all tablets being dirty. Tablets
+  // that do not fit into this report stay dirty and are sent in the following incremental reports.
+  dirty_tablets_.clear();
+  for (const TabletMap::value_type& entry : tablet_map_) {
+    InsertOrDie(&dirty_tablets_, entry.first, TabletReportState{
+        static_cast<uint32_t>(report->sequence_number())});
+  }
+  GenerateTabletReportUnlocked(report);
+}
+
+void TSTabletManager::GenerateTabletReportUnlocked(TabletReportPB* report) {
+  const int limit = FLAGS_tablet_report_limit > 0 ? FLAGS_tablet_report_limit
+                                                  : std::numeric_limits<int>::max();
+  int remaining = 0;
   for (const DirtyMap::value_type& dirty_entry : dirty_tablets_) {
+    if (report->updated_tablets_size() + report->removed_tablet_ids_size() >= limit) {
+      ++remaining;
+      continue;
+    }
     const string& tablet_id = dirty_entry.first;
     scoped_refptr<TabletPeer>* tablet_peer = FindOrNull(tablet_map_, tablet_id);
     if (tablet_peer) {
@@ -1184,17 +1463,9 @@ void TSTabletManager::GenerateIncrementalTabletReport(TabletReportPB* report) {
       report->add_removed_tablet_ids(tablet_id);
     }
   }
-}
-
-void TSTabletManager::GenerateFullTabletReport(TabletReportPB* report) {
-  boost::shared_lock<rw_spinlock> shared_lock(lock_);
-  report->Clear();
-  report->set_is_incremental(false);
-  report->set_sequence_number(next_report_seq_++);
-  for (const TabletMap::value_type& entry : tablet_map_) {
-    CreateReportedTabletPB(entry.first, entry.second, report->add_updated_tablets());
+  if (remaining > 0) {
+    report->set_remaining_tablet_count(remaining);
   }
-  dirty_tablets_.clear();
 }
 
 void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report) {
@@ -1203,19 +1474,20 @@ void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report)
   int32_t acked_seq = report.sequence_number();
   CHECK_LT(acked_seq, next_report_seq_);
 
-  // Clear the "dirty" state for any tablets which have not changed since
-  // this report.
-  auto it = dirty_tablets_.begin();
-  while (it != dirty_tablets_.end()) {
-    const TabletReportState& state = it->second;
-    if (state.change_seq <= acked_seq) {
-      // This entry has not changed since this tablet report, we no longer need
-      // to track it as dirty. If it becomes dirty again, it will be re-added
-      // with a higher sequence number.
-      it = dirty_tablets_.erase(it);
-    } else {
-      ++it;
+  // Clear the "dirty" state for the reported tablets which have not changed since this report.
+  // If such a tablet becomes dirty again, it will be re-added with a higher sequence number.
+  // Dirty tablets that did not fit into the report are kept for the next one.
+  auto acknowledge = [this, acked_seq](const std::string& tablet_id) {
+    auto it = dirty_tablets_.find(tablet_id);
+    if (it != dirty_tablets_.end() && it->second.change_seq <= acked_seq) {
+      dirty_tablets_.erase(it);
     }
+  };
+  for (const auto& reported_tablet : report.updated_tablets()) {
+    acknowledge(reported_tablet.tablet_id());
+  }
+  for (const auto& tablet_id : report.removed_tablet_ids()) {
+    acknowledge(tablet_id);
   }
 }
 
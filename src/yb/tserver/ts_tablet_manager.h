@@ -51,6 +51,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/tablet/tablet_fwd.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_admin.pb.h"
@@ -68,6 +69,7 @@ class HostPort;
 class Partition;
 class Schema;
 class BackgroundTask;
+class PriorityThreadPool;
 
 namespace consensus {
 class RaftConfigPB;
@@ -118,7 +120,7 @@ class TransitionInProgressDeleter;
 // TODO: will also be responsible for keeping the local metadata about
 // which tablets are hosted on this server persistent on disk, as well
 // as re-opening all the tablets at startup, etc.
-class TSTabletManager : public tserver::TabletPeerLookupIf {
+class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::TabletSplitter {
  public:
   typedef std::vector<scoped_refptr<tablet::TabletPeer>> TabletPeers;
 
@@ -179,6 +181,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                       const boost::optional<int64_t>& cas_config_opid_index_less_or_equal,
                       boost::optional<TabletServerErrorPB::Code>* error_code);
 
+  // Starts creating the tablets the given tablet was split into, in the background. Each replica
+  // of the split tablet creates a replica of the new tablets, so they form Raft groups with the same
+  // peers. Failed attempts are retried after FLAGS_tablet_split_children_retry_interval_ms.
+  void CreateSplitChildrenAsync(const TabletId& tablet_id) override;
+
   // Lookup the given tablet peer by its ID.
   // Returns true if the tablet is found successfully.
   bool LookupTablet(const std::string& tablet_id,
@@ -214,10 +221,14 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   void GenerateIncrementalTabletReport(master::TabletReportPB* report);
 
   // Generate a full tablet report and reset any incremental state tracking.
+  //
+  // At most FLAGS_tablet_report_limit tablets are included in a report, the number of tablets
+  // left out is set in remaining_tablet_count. Those tablets are included in the following
+  // incremental reports.
   void GenerateFullTabletReport(master::TabletReportPB* report);
 
   // Mark that the master successfully received and processed the given
-  // tablet report. This uses the report sequence number to "un-dirty" any
+  // tablet report. This uses the report sequence number to "un-dirty" the reported
   // tablets which have not changed since the acknowledged report.
   void MarkTabletReportAcknowledged(const master::TabletReportPB& report);
 
@@ -310,6 +321,19 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                                             const std::string& reason,
                                             scoped_refptr<TransitionInProgressDeleter>* deleter);
 
+  // Creates the tablets the given tablet was split into, and schedules a retry if that fails.
+  void CreateSplitChildren(const TabletId& tablet_id);
+
+  // Creates the replicas of the tablets that 'tablet' was split into, as recorded in its metadata.
+  CHECKED_STATUS DoCreateSplitChildren(tablet::Tablet* tablet);
+
+  // Creates a replica of the tablet that 'parent' is split into, covering 'partition', unless it
+  // was already created. Its RocksDB is a checkpoint of the parent's one.
+  CHECKED_STATUS CreateSplitChildTablet(tablet::Tablet* parent,
+                                        const std::string& tablet_id,
+                                        const Partition& partition,
+                                        const consensus::RaftConfigPB& config);
+
   // Open a tablet meta from the local file system by loading its superblock.
   CHECKED_STATUS OpenTabletMeta(const std::string& tablet_id,
                         scoped_refptr<tablet::TabletMetadata>* metadata);
@@ -351,6 +375,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
       const scoped_refptr<tablet::TabletMetadata>& meta,
       RegisterTabletPeerMode mode);
 
+  // Fill 'report' with the dirty tablets, up to FLAGS_tablet_report_limit of them.
+  //
+  // NOTE: requires that the caller holds the lock.
+  void GenerateTabletReportUnlocked(master::TabletReportPB* report);
+
   // Helper to generate the report for a single tablet.
   void CreateReportedTabletPB(const std::string& tablet_id,
                               const scoped_refptr<tablet::TabletPeer>& tablet_peer,
@@ -394,8 +423,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                              std::unordered_map<std::string, std::unordered_set<std::string>>>
     TableDiskAssignmentMap;
 
-  // Lock protecting tablet_map_, dirty_tablets_, state_, and
-  // transition_in_progress_.
+  // Lock protecting tablet_map_, dirty_tablets_, state_, transition_in_progress_ and
+  // tablets_creating_split_children_.
   mutable rw_spinlock lock_;
 
   // Map from tablet ID to tablet
@@ -410,6 +439,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // bootstrap, creation, or deletion is in-progress
   TransitionInProgressMap transition_in_progress_;
 
+  // Ids of the split tablets, whose new tablets are being created in the background.
+  std::unordered_set<TabletId> tablets_creating_split_children_;
+
   // Tablets to include in the next incremental tablet report.
   // When a tablet is added/removed/added locally and needs to be
   // reported to the master, an entry is added to this map.
@@ -437,6 +469,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Thread pool for inserting large write batches into memtables, shared between all tablets.
+  std::unique_ptr<ThreadPool> memtable_insert_pool_;
+
+  // Thread pool for RocksDB compactions, shared between all tablets.
+  std::unique_ptr<PriorityThreadPool> compaction_pool_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
@@ -42,6 +42,7 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
@@ -112,6 +113,9 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/hot-keys", "", std::bind(&TabletServerPathHandlers::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -405,6 +409,8 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("hot-keys", "Hot Keys", "Most frequently read and written keys "
+                                                      "of each tablet.");
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
@@ -474,5 +480,54 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "</table>\n";
 }
 
+namespace {
+
+void HotKeysToHtml(const std::string& title, const std::vector<tablet::HotKey>& keys,
+                   std::stringstream* output) {
+  if (keys.empty()) {
+    return;
+  }
+  *output << "<h3>" << title << "</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Key</th><th>Share</th><th>Count</th><th>Error</th></tr>\n";
+  for (const auto& key : keys) {
+    *output << Substitute("  <tr><td>$0</td><td>$1%</td><td>$2</td><td>$3</td></tr>\n",
+                          EscapeForHtmlToString(key.key),
+                          StringPrintf("%.2f", key.share * 100),
+                          key.count, key.error);
+  }
+  *output << "</table>\n";
+}
+
+}  // anonymous namespace
+
+void TabletServerPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  const size_t kMaxKeys = 10;
+
+  vector<scoped_refptr<TabletPeer> > peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+  std::sort(peers.begin(), peers.end(), &CompareByTabletId);
+
+  *output << "<h1>Hot Keys</h1>\n";
+  *output << "<p>The counts are estimated from a sample of the accesses, the actual count of a key "
+             "is between count - error and count.</p>\n";
+  for (const scoped_refptr<TabletPeer>& peer : peers) {
+    shared_ptr<Tablet> tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    auto read_keys = tablet->read_hot_keys().TopKeys(kMaxKeys);
+    auto write_keys = tablet->write_hot_keys().TopKeys(kMaxKeys);
+    if (read_keys.empty() && write_keys.empty()) {
+      continue;
+    }
+    *output << "<h2>Tablet " << TabletLink(peer->tablet_id()) << " ("
+            << EscapeForHtmlToString(peer->tablet_metadata()->table_name()) << ")</h2>\n";
+    HotKeysToHtml("Reads", read_keys, output);
+    HotKeysToHtml("Writes", write_keys, output);
+  }
+}
+
 }  // namespace tserver
 }  // namespace yb
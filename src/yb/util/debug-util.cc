@@ -592,6 +592,16 @@ string StackTrace::Symbolize(const StackTraceLineFormat stack_trace_line_format)
   return buf;
 }
 
+string SymbolizeFunctionName(void* pc) {
+  // See StackTrace::Symbolize() about why we subtract 1 from the address.
+  void* const adjusted_pc = reinterpret_cast<void*>(reinterpret_cast<size_t>(pc) - 1);
+  char tmp[1024];
+  if (google::Symbolize(adjusted_pc, tmp, sizeof(tmp))) {
+    return tmp;
+  }
+  return StringPrintf("%p", pc);
+}
+
 string StackTrace::ToLogFormatHexString() const {
   string buf;
   for (int i = 0; i < num_frames_; i++) {
@@ -95,6 +95,11 @@ std::string GetStackTraceHex();
 // is able to find the symbols).
 std::string GetLogFormatStackTraceHex();
 
+// Return the name of the function containing the given return address, demangled if possible,
+// or the address in hex if it could not be symbolized.
+// This is not async-safe.
+std::string SymbolizeFunctionName(void* pc);
+
 // Collect the current stack trace in hex form into the given buffer.
 //
 // The resulting trace just includes the hex addresses, space-separated. This is suitable
@@ -167,6 +172,9 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const { return num_frames_; }
+  void* frame(int i) const { return frames_[i]; }
+
  private:
   enum {
     // The maximum number of stack frames to collect.
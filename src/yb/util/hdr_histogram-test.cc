@@ -88,7 +88,8 @@ static const int kExpectedSum =
 static const int kExpectedMax = 1000000;
 static const int kExpectedCount = 100;
 static const int kExpectedMin = 10;
-static void load_percentiles(HdrHistogram* hist) {
+template <class Histogram>
+static void load_percentiles(Histogram* hist) {
   hist->IncrementBy(10, 80);
   hist->IncrementBy(100, 10);
   hist->IncrementBy(1000, 5);
@@ -125,4 +126,39 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MergeTest) {
+  HdrHistogram hist(100000LU, kSigDigits);
+  HdrHistogram other(100000LU, kSigDigits);
+  hist.IncrementBy(10, 2);
+  other.IncrementBy(5, 1);
+  other.IncrementBy(1000, 3);
+
+  hist.MergeFrom(other);
+  ASSERT_EQ(6, hist.TotalCount());
+  ASSERT_EQ(3025, hist.TotalSum());
+  ASSERT_EQ(5, hist.MinValue());
+  ASSERT_EQ(1000, hist.MaxValue());
+  ASSERT_EQ(2, hist.CountInBucketForValue(10));
+  ASSERT_EQ(3, hist.CountInBucketForValue(1000));
+
+  // Merging an empty histogram should not touch min and max.
+  HdrHistogram empty(100000LU, kSigDigits);
+  hist.MergeFrom(empty);
+  ASSERT_EQ(6, hist.TotalCount());
+  ASSERT_EQ(5, hist.MinValue());
+  ASSERT_EQ(1000, hist.MaxValue());
+}
+
+TEST_F(HdrHistogramTest, StripedPercentileTest) {
+  uint64_t specified_max = 10000;
+  StripedHdrHistogram striped(specified_max, kSigDigits);
+  ASSERT_EQ(0, striped.TotalCount());
+  load_percentiles(&striped);
+  ASSERT_EQ(kExpectedCount, striped.TotalCount());
+
+  HdrHistogram snapshot(specified_max, kSigDigits);
+  striped.MergeTo(&snapshot);
+  ASSERT_NO_FATALS(validate_percentiles(&snapshot, specified_max));
+}
+
 } // namespace yb
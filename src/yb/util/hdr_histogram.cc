@@ -31,13 +31,17 @@
 //
 #include "yb/util/hdr_histogram.h"
 
+#include <sched.h>
+
 #include <algorithm>
 #include <cmath>
 #include <limits>
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/bits.h"
+#include "yb/gutil/port.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/status.h"
 
 using base::subtle::Atomic64;
@@ -173,22 +177,23 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   NoBarrier_AtomicIncrement(&total_count_, count);
   NoBarrier_AtomicIncrement(&total_sum_, value * count);
 
-  // Update min, if needed.
-  {
-    Atomic64 min_val;
-    while (PREDICT_FALSE(value < (min_val = MinValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
-      if (PREDICT_TRUE(old_val == min_val)) break; // CAS success.
-    }
+  UpdateMinValue(value);
+  UpdateMaxValue(value);
+}
+
+void HdrHistogram::UpdateMinValue(int64_t value) {
+  Atomic64 min_val;
+  while (PREDICT_FALSE(value < (min_val = MinValue()))) {
+    Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
+    if (PREDICT_TRUE(old_val == min_val)) break; // CAS success.
   }
+}
 
-  // Update max, if needed.
-  {
-    Atomic64 max_val;
-    while (PREDICT_FALSE(value > (max_val = MaxValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
-      if (PREDICT_TRUE(old_val == max_val)) break; // CAS success.
-    }
+void HdrHistogram::UpdateMaxValue(int64_t value) {
+  Atomic64 max_val;
+  while (PREDICT_FALSE(value > (max_val = MaxValue()))) {
+    Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
+    if (PREDICT_TRUE(old_val == max_val)) break; // CAS success.
   }
 }
 
@@ -205,6 +210,32 @@ void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
   }
 }
 
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  DCHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  DCHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  uint64_t other_count = other.TotalCount();
+  if (other_count == 0) {
+    return;
+  }
+
+  // Same order as in the copy constructor: sum and min first, then the counts in order of
+  // ascending magnitude, and the max last.
+  NoBarrier_AtomicIncrement(&total_sum_, NoBarrier_Load(&other.total_sum_));
+  UpdateMinValue(NoBarrier_Load(&other.min_value_));
+  uint64_t total_merged_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count != 0) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      total_merged_count += count;
+    }
+  }
+  UpdateMaxValue(NoBarrier_Load(&other.max_value_));
+  // Keep the total consistent with the merged counts.
+  NoBarrier_AtomicIncrement(&total_count_, total_merged_count);
+}
+
 ////////////////////////////////////
 
 int HdrHistogram::BucketIndex(uint64_t value) const {
@@ -328,6 +359,100 @@ uint64_t HdrHistogram::ValueAtPercentile(double percentile) const {
   return 0;
 }
 
+///////////////////////////////////////////////////////////////////////
+// StripedHdrHistogram
+///////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Every stripe has its own counts array, e.g. ~139KB for a histogram of values up to 60s with 3
+// significant digits, so the number of stripes is capped. CPUs beyond the cap share stripes, which
+// still spreads the updates enough to avoid most of the contention.
+const int kMaxHistogramStripes = 8;
+
+size_t CurrentStripeIndex(size_t num_stripes) {
+#if defined(__linux__)
+  int cpu = sched_getcpu();
+  if (PREDICT_TRUE(cpu >= 0)) {
+    return cpu % num_stripes;
+  }
+#endif
+  // No CPU number, spread the threads among stripes instead.
+  static std::atomic<size_t> next_thread_index{0};
+  static thread_local size_t thread_index = next_thread_index.fetch_add(1);
+  return thread_index % num_stripes;
+}
+
+} // namespace
+
+// Padded, so that the hot fields of adjacent stripes don't share a cache line.
+struct StripedHdrHistogram::Stripe {
+  Stripe(uint64_t highest_trackable_value, int num_significant_digits)
+      : histogram(highest_trackable_value, num_significant_digits) {
+  }
+
+  char leading_pad[CACHELINE_SIZE];
+  HdrHistogram histogram;
+  char trailing_pad[CACHELINE_SIZE];
+};
+
+StripedHdrHistogram::StripedHdrHistogram(uint64_t highest_trackable_value,
+                                         int num_significant_digits)
+  : highest_trackable_value_(highest_trackable_value),
+    num_significant_digits_(num_significant_digits),
+    num_stripes_(std::min(std::max(base::NumCPUs(), 1), kMaxHistogramStripes)),
+    stripes_(new std::atomic<Stripe*>[num_stripes_]) {
+  CHECK(HdrHistogram::IsValidHighestTrackableValue(highest_trackable_value));
+  CHECK(HdrHistogram::IsValidNumSignificantDigits(num_significant_digits));
+  for (size_t i = 0; i != num_stripes_; ++i) {
+    stripes_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+StripedHdrHistogram::~StripedHdrHistogram() {
+  for (size_t i = 0; i != num_stripes_; ++i) {
+    delete stripes_[i].load(std::memory_order_relaxed);
+  }
+}
+
+StripedHdrHistogram::Stripe* StripedHdrHistogram::CurrentStripe() {
+  auto& slot = stripes_[CurrentStripeIndex(num_stripes_)];
+  Stripe* stripe = slot.load(std::memory_order_acquire);
+  if (PREDICT_FALSE(stripe == nullptr)) {
+    std::unique_ptr<Stripe> new_stripe(
+        new Stripe(highest_trackable_value_, num_significant_digits_));
+    if (slot.compare_exchange_strong(stripe, new_stripe.get(), std::memory_order_acq_rel)) {
+      stripe = new_stripe.release();
+    }
+    // Otherwise another thread has installed its stripe first, and stripe now points to it.
+  }
+  return stripe;
+}
+
+void StripedHdrHistogram::IncrementBy(int64_t value, int64_t count) {
+  CurrentStripe()->histogram.IncrementBy(value, count);
+}
+
+uint64_t StripedHdrHistogram::TotalCount() const {
+  uint64_t result = 0;
+  for (size_t i = 0; i != num_stripes_; ++i) {
+    const Stripe* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      result += stripe->histogram.TotalCount();
+    }
+  }
+  return result;
+}
+
+void StripedHdrHistogram::MergeTo(HdrHistogram* snapshot) const {
+  for (size_t i = 0; i != num_stripes_; ++i) {
+    const Stripe* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      snapshot->MergeFrom(stripe->histogram);
+    }
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////
 // AbstractHistogramIterator
 ///////////////////////////////////////////////////////////////////////
@@ -58,8 +58,12 @@
 
 #include <stdint.h>
 
+#include <atomic>
+#include <memory>
+
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/gutil/macros.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -104,6 +108,10 @@ class HdrHistogram {
   void IncrementWithExpectedInterval(int64_t value,
                                      int64_t expected_interval_between_samples);
 
+  // Add a (non-consistent) snapshot of other to this histogram.
+  // other must have the same highest trackable value and number of significant digits.
+  void MergeFrom(const HdrHistogram& other);
+
   // Fetch configuration params.
   uint64_t highest_trackable_value() const { return highest_trackable_value_; }
   int num_significant_digits() const { return num_significant_digits_; }
@@ -185,6 +193,8 @@ class HdrHistogram {
 
   void Init();
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
+  void UpdateMinValue(int64_t value);
+  void UpdateMaxValue(int64_t value);
 
   uint64_t highest_trackable_value_;
   int num_significant_digits_;
@@ -207,6 +217,52 @@ class HdrHistogram {
   HdrHistogram& operator=(const HdrHistogram& other); // Disable assignment operator.
 };
 
+// HdrHistogram split into per-CPU stripes, so that threads recording values on different CPUs
+// don't bounce the cache lines of the counts, sum, min and max between each other.
+//
+// The price is memory, because every stripe has its own counts array, and reads, which have to
+// merge the stripes. So it only pays off for hot histograms updated from many threads. There are at
+// most 8 stripes, shared by CPUs with the same index modulo the number of stripes. Stripes are
+// allocated on first use, i.e. only for the CPUs that actually recorded something.
+//
+// A thread could be moved to another CPU while recording, so two threads could still update the
+// same stripe at once. Stripes are updated atomically, so this only costs contention.
+//
+// This class is thread-safe.
+class StripedHdrHistogram {
+ public:
+  StripedHdrHistogram(uint64_t highest_trackable_value, int num_significant_digits);
+  ~StripedHdrHistogram();
+
+  // Record new data.
+  void Increment(int64_t value) { IncrementBy(value, 1); }
+  void IncrementBy(int64_t value, int64_t count);
+
+  // Fetch configuration params.
+  uint64_t highest_trackable_value() const { return highest_trackable_value_; }
+  int num_significant_digits() const { return num_significant_digits_; }
+  size_t num_stripes() const { return num_stripes_; }
+
+  // Count of all events recorded.
+  uint64_t TotalCount() const;
+
+  // Add a (non-consistent) snapshot of all stripes to snapshot, which must have the same
+  // configuration as this histogram.
+  void MergeTo(HdrHistogram* snapshot) const;
+
+ private:
+  struct Stripe;
+
+  Stripe* CurrentStripe();
+
+  const uint64_t highest_trackable_value_;
+  const int num_significant_digits_;
+  const size_t num_stripes_;
+  std::unique_ptr<std::atomic<Stripe*>[]> stripes_;
+
+  DISALLOW_COPY_AND_ASSIGN(StripedHdrHistogram);
+};
+
 // Value returned from iterators.
 struct HistogramIterationValue {
   HistogramIterationValue()
@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -41,9 +42,12 @@
 #include <gperftools/malloc_extension.h>
 #endif
 
+#include "yb/util/monotime.h"
 #include "yb/util/test_util.h"
 
 DECLARE_int32(memory_limit_soft_percentage);
+DECLARE_int64(mem_tracker_update_consumption_batch_bytes);
+DECLARE_int64(mem_tracker_max_consumption_lag_bytes);
 
 namespace yb {
 
@@ -127,6 +131,120 @@ TEST(MemTrackerTest, TrackerHierarchy) {
   c2->Release(60);
 }
 
+TEST(MemTrackerTest, BatchedAncestorUpdates) {
+  google::FlagSaver saver;
+  FLAGS_mem_tracker_update_consumption_batch_bytes = 1000;
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker(-1, "p");
+  shared_ptr<MemTracker> c = MemTracker::CreateTracker(-1, "c", p);
+
+  // Small changes are applied to the parent once a batch is accumulated.
+  c->Consume(600);
+  EXPECT_EQ(c->consumption(), 600);
+  EXPECT_EQ(p->consumption(), 0);
+  c->Consume(600);
+  EXPECT_EQ(c->consumption(), 1200);
+  EXPECT_EQ(p->consumption(), 1200);
+
+  // Large changes are applied right away.
+  c->Release(1200);
+  EXPECT_EQ(c->consumption(), 0);
+  EXPECT_EQ(p->consumption(), 0);
+
+  // Pending changes are applied when the tracker is destroyed.
+  c->Consume(1);
+  c->Consume(1000);
+  c->Release(1001);
+  EXPECT_NE(p->consumption(), 0);
+  c.reset();
+  EXPECT_EQ(p->consumption(), 0);
+
+  // Batches are capped by the limits of the ancestors.
+  shared_ptr<MemTracker> limited = MemTracker::CreateTracker(100000, "limited");
+  shared_ptr<MemTracker> c2 = MemTracker::CreateTracker(-1, "c2", limited);
+  c2->Consume(100);
+  EXPECT_EQ(limited->consumption(), 100);
+  c2->Release(100);
+
+  // Pending changes are applied when the consumption of the subtree is requested.
+  c = MemTracker::CreateTracker(-1, "c", p);
+  c->Consume(600);
+  EXPECT_EQ(p->consumption(), 0);
+  p->FlushPendingConsumption();
+  EXPECT_EQ(p->consumption(), 600);
+  c->Release(600);
+  p->FlushPendingConsumption();
+  EXPECT_EQ(p->consumption(), 0);
+}
+
+TEST(MemTrackerTest, AncestorLagBoundedForManyDescendants) {
+  constexpr int kNumChildren = 10;
+  google::FlagSaver saver;
+  FLAGS_mem_tracker_update_consumption_batch_bytes = 1000;
+  FLAGS_mem_tracker_max_consumption_lag_bytes = 1000 * MemTracker::kNumPendingStripes;
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker(-1, "p");
+
+  // With many descendants, each of them accumulates smaller batches, so that the total lag of the
+  // parent stays within the bound. This thread uses a single stripe of every child, so the lag
+  // is within a single batch per child.
+  std::vector<shared_ptr<MemTracker>> children;
+  for (int i = 0; i != kNumChildren; ++i) {
+    children.push_back(MemTracker::CreateTracker(-1, "c" + std::to_string(i), p));
+  }
+  int64_t total = 0;
+  for (int j = 0; j != 100; ++j) {
+    for (auto& child : children) {
+      child->Consume(j % 10 + 1);
+      total += j % 10 + 1;
+      ASSERT_LT(total - p->consumption(),
+                FLAGS_mem_tracker_max_consumption_lag_bytes / MemTracker::kNumPendingStripes);
+    }
+  }
+
+  p->FlushPendingConsumption();
+  ASSERT_EQ(total, p->consumption());
+  for (auto& child : children) {
+    child->Release(child->consumption());
+  }
+  children.clear();
+  ASSERT_EQ(0, p->consumption());
+}
+
+// Measures the throughput of small consumption changes made by many threads to the same tracker,
+// with and without batching the updates of its ancestors.
+TEST(MemTrackerTest, ContendedUpdates) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIterations = 200000;
+  google::FlagSaver saver;
+  for (int64_t batch_bytes : {0L, 64L * 1024}) {
+    FLAGS_mem_tracker_update_consumption_batch_bytes = batch_bytes;
+    shared_ptr<MemTracker> p = MemTracker::CreateTracker(-1, "p");
+    shared_ptr<MemTracker> c = MemTracker::CreateTracker(-1, "c", p);
+
+    auto start = MonoTime::Now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i != kNumThreads; ++i) {
+      threads.emplace_back([&c] {
+        for (int j = 0; j != kNumIterations; ++j) {
+          c->Consume(j % 128 + 1);
+          c->Release(j % 128 + 1);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    auto elapsed = MonoTime::Now().GetDeltaSince(start);
+
+    LOG(INFO) << "Batch " << batch_bytes << ": "
+              << kNumThreads * kNumIterations * 2 / elapsed.ToSeconds() << " updates/s";
+    ASSERT_EQ(c->consumption(), 0);
+    ASSERT_LE(std::abs(p->consumption()),
+              static_cast<int64_t>(MemTracker::kNumPendingStripes) * batch_bytes);
+    c.reset();
+    ASSERT_EQ(p->consumption(), 0);
+  }
+}
+
 class GcFunctionHelper {
  public:
   static const int NUM_RELEASE_BYTES = 1;
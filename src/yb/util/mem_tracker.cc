@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -95,6 +96,18 @@ DEFINE_bool(mem_tracker_log_stack_trace, false,
             "Enable logging of stack traces on memory tracker consume/release operations. "
             "Only takes effect if mem_tracker_logging is also enabled.");
 
+DEFINE_int64(mem_tracker_update_consumption_batch_bytes, 64 * 1024,
+             "Memory tracker consumption changes smaller than this are accumulated per thread and "
+             "applied to the ancestor trackers in batches of this size, to avoid contention on "
+             "the trackers shared by many threads. 0 disables batching.");
+TAG_FLAG(mem_tracker_update_consumption_batch_bytes, advanced);
+
+DEFINE_int64(mem_tracker_max_consumption_lag_bytes, 16 * 1024 * 1024,
+             "Maximum amount by which the consumption of a memory tracker may lag behind the "
+             "consumption of its descendants because of batched updates. For trackers with a "
+             "limit, the lag is also kept within 1% of the limit.");
+TAG_FLAG(mem_tracker_max_consumption_lag_bytes, advanced);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -109,6 +122,8 @@ using std::vector;
 
 using strings::Substitute;
 
+constexpr size_t MemTracker::kNumPendingStripes;
+
 // The ancestor for all trackers. Every tracker is visible from the root down.
 static shared_ptr<MemTracker> root_tracker;
 static GoogleOnceType root_tracker_once = GOOGLE_ONCE_INIT;
@@ -205,8 +220,12 @@ MemTracker::~MemTracker() {
   if (parent_) {
     DCHECK(consumption() == 0) << "Memory tracker " << ToString()
         << " has unreleased consumption " << consumption();
+    FlushPending();
     parent_->Release(consumption());
     UnregisterFromParent();
+    for (size_t i = 1; i < all_trackers_.size(); ++i) {
+      all_trackers_[i]->num_descendants_.fetch_sub(1, std::memory_order_relaxed);
+    }
   }
 }
 
@@ -281,6 +300,8 @@ void MemTracker::ListTrackers(vector<shared_ptr<MemTracker>>* trackers) {
     shared_ptr<MemTracker> t = to_process.back();
     to_process.pop_back();
 
+    // Apply pending changes, so that the listed ancestors report up to date consumption.
+    t->FlushPending();
     trackers->push_back(t);
     {
       MutexLock l(t->child_trackers_lock_);
@@ -313,12 +334,8 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
-  for (auto& tracker : all_trackers_) {
-    tracker->consumption_.IncrementBy(bytes);
-    if (tracker->consumption_func_) {
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
-    }
-  }
+  consumption_.IncrementBy(bytes);
+  UpdateAncestors(bytes);
 }
 
 bool MemTracker::TryConsume(int64_t bytes) {
@@ -381,12 +398,8 @@ void MemTracker::Release(int64_t bytes) {
     return;
   }
 
-  if (PREDICT_FALSE(base::subtle::Barrier_AtomicIncrement(&released_memory_since_gc, bytes) >
-                    GC_RELEASE_SIZE)) {
-    GcTcmalloc();
-  }
-
   if (consumption_func_) {
+    CountReleased(bytes);
     UpdateConsumption();
     return;
   }
@@ -398,20 +411,93 @@ void MemTracker::Release(int64_t bytes) {
     LogUpdate(false, bytes);
   }
 
-  for (auto& tracker : all_trackers_) {
-    tracker->consumption_.IncrementBy(-bytes);
-    // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
-    // reported amount, the subsequent call to FunctionContext::Free() may cause the
-    // process mem tracker to go negative until it is synced back to the tcmalloc
-    // metric. Don't blow up in this case. (Note that this doesn't affect non-process
-    // trackers since we can enforce that the reported memory usage is internally
-    // consistent.)
+  consumption_.IncrementBy(-bytes);
+  UpdateAncestors(-bytes);
+}
+
+void MemTracker::UpdateAncestors(int64_t bytes) {
+  int64_t batch_size = FLAGS_mem_tracker_update_consumption_batch_bytes;
+  for (size_t i = 1; batch_size > 0 && i < all_trackers_.size(); ++i) {
+    batch_size = std::min(batch_size, all_trackers_[i]->MaxDescendantBatch());
+  }
+  if (batch_size > 0 && std::abs(bytes) < batch_size) {
+    auto& pending = pending_[CurrentThreadStripe()].value;
+    if (std::abs(pending.fetch_add(bytes, std::memory_order_relaxed) + bytes) < batch_size) {
+      return;
+    }
+    bytes = pending.exchange(0, std::memory_order_relaxed);
+  }
+  ApplyToAncestors(bytes);
+}
+
+void MemTracker::ApplyToAncestors(int64_t bytes) {
+  if (bytes < 0) {
+    CountReleased(-bytes);
+  }
+  for (size_t i = 1; i < all_trackers_.size(); ++i) {
+    MemTracker* tracker = all_trackers_[i];
+    tracker->consumption_.IncrementBy(bytes);
+    // The process tracker could go negative until it is synced back to the tcmalloc metric, if
+    // less memory was allocated than reported. Don't blow up in this case.
     if (tracker->consumption_func_) {
       DCHECK_GE(tracker->consumption_.current_value(), 0);
     }
   }
 }
 
+int64_t MemTracker::MaxDescendantBatch() const {
+  // The consumption of a tracker with a consumption function does not depend on the changes
+  // reported by its descendants.
+  if (consumption_func_) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  int64_t max_lag = FLAGS_mem_tracker_max_consumption_lag_bytes;
+  if (limit_ >= 0) {
+    max_lag = std::min(max_lag, limit_ / 100);
+  }
+  // Every descendant could have a batch pending in each of its stripes.
+  const int64_t num_descendants =
+      std::max<int64_t>(num_descendants_.load(std::memory_order_relaxed), 1);
+  return max_lag / (num_descendants * kNumPendingStripes);
+}
+
+void MemTracker::FlushPendingConsumption() {
+  std::vector<std::shared_ptr<MemTracker>> to_process = { shared_from_this() };
+  while (!to_process.empty()) {
+    auto tracker = std::move(to_process.back());
+    to_process.pop_back();
+    tracker->FlushPending();
+    MutexLock l(tracker->child_trackers_lock_);
+    for (MemTracker* child : tracker->child_trackers_) {
+      to_process.push_back(child->shared_from_this());
+    }
+  }
+}
+
+void MemTracker::FlushPending() {
+  int64_t bytes = 0;
+  for (auto& stripe : pending_) {
+    bytes += stripe.value.exchange(0, std::memory_order_relaxed);
+  }
+  if (bytes != 0) {
+    ApplyToAncestors(bytes);
+  }
+}
+
+void MemTracker::CountReleased(int64_t bytes) {
+  if (PREDICT_FALSE(base::subtle::Barrier_AtomicIncrement(&released_memory_since_gc, bytes) >
+                    GC_RELEASE_SIZE)) {
+    GcTcmalloc();
+  }
+}
+
+size_t MemTracker::CurrentThreadStripe() {
+  static std::atomic<size_t> next_stripe{0};
+  static thread_local size_t stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed) % kNumPendingStripes;
+  return stripe;
+}
+
 bool MemTracker::AnyLimitExceeded() {
   for (const auto& tracker : limit_trackers_) {
     if (tracker->LimitExceeded()) {
@@ -568,6 +654,12 @@ void MemTracker::Init() {
   }
   DCHECK_GT(all_trackers_.size(), 0);
   DCHECK_EQ(all_trackers_[0], this);
+
+  // Batches of ancestor updates are sized based on the number of descendants of each ancestor,
+  // see MaxDescendantBatch().
+  for (size_t i = 1; i < all_trackers_.size(); ++i) {
+    all_trackers_[i]->num_descendants_.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 void MemTracker::AddChildTrackerUnlocked(MemTracker* tracker) {
@@ -34,6 +34,8 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <list>
 #include <memory>
@@ -44,6 +46,7 @@
 #include <gperftools/malloc_extension.h>
 #endif
 
+#include "yb/gutil/port.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/high_water_mark.h"
 #include "yb/util/locks.h"
@@ -89,6 +92,15 @@ class MemTracker;
 // this will be called before the process limit is reported as exceeded. GcFunctions are
 // called in the order they are added, so expensive functions should be added last.
 //
+// To avoid contention on the trackers shared by many threads, such as the root tracker, small
+// consumption changes are applied to the ancestors in batches. A tracker accumulates them in
+// per-thread stripes and applies a stripe to its ancestors once it reaches
+// FLAGS_mem_tracker_update_consumption_batch_bytes. The consumption of the tracker itself is always
+// exact, while the consumption of an ancestor may lag behind by up to kNumPendingStripes batches
+// per descendant. The batch is capped based on the number of descendants of every ancestor, so that
+// the total lag of an ancestor stays within FLAGS_mem_tracker_max_consumption_lag_bytes and 1% of
+// its limit. ListTrackers() and FlushPendingConsumption() apply the pending changes.
+//
 // This class is thread-safe.
 //
 // NOTE: this class has been partially ported over from Impala with
@@ -113,6 +125,9 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Signature for function that can be called to free some memory after limit is reached.
   typedef std::function<void()> GcFunction;
 
+  // Number of stripes that consumption changes not yet applied to the ancestors are spread over.
+  static constexpr size_t kNumPendingStripes = 16;
+
   ~MemTracker();
 
   #ifdef TCMALLOC_ENABLED
@@ -246,6 +261,10 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   bool has_limit() const { return limit_ >= 0; }
   const std::string& id() const { return id_; }
 
+  // Applies the pending changes of this tracker and its descendants to their ancestors, so that
+  // the consumption of this tracker accounts for all changes made so far.
+  void FlushPendingConsumption();
+
   // Returns the memory consumed in bytes.
   int64_t consumption() const {
     return consumption_.current_value();
@@ -316,6 +335,26 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // child_trackers_lock_ must be held.
   void AddChildTrackerUnlocked(MemTracker* tracker);
 
+  // Applies the consumption change of this tracker to its ancestors, small changes are
+  // accumulated in the stripe of the current thread and applied in batches.
+  void UpdateAncestors(int64_t bytes);
+
+  // Applies the consumption change to the ancestors right away.
+  void ApplyToAncestors(int64_t bytes);
+
+  // Applies the changes accumulated in all stripes to the ancestors.
+  void FlushPending();
+
+  // Maximum size of a batch of changes that a descendant of this tracker may accumulate in one
+  // stripe, so that the consumption of this tracker does not lag behind too much.
+  int64_t MaxDescendantBatch() const;
+
+  // Counts released memory, releasing unused tcmalloc memory when enough was released.
+  void CountReleased(int64_t bytes);
+
+  // Index of the pending stripe used by the current thread.
+  static size_t CurrentThreadStripe();
+
   // Logs the stack of the current consume/release. Used for debugging only.
   void LogUpdate(bool is_consume, int64_t bytes) const;
 
@@ -360,6 +399,17 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   ConsumptionFunction consumption_func_;
 
+  // Consumption change of this tracker that was not applied to its ancestors yet. Padded, so
+  // that stripes used by different threads do not share a cache line.
+  struct PendingStripe {
+    std::atomic<int64_t> value{0};
+    char pad[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+  };
+  std::array<PendingStripe, kNumPendingStripes> pending_;
+
+  // Number of trackers in the subtree of this tracker, excluding the tracker itself.
+  std::atomic<int64_t> num_descendants_{0};
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
@@ -707,15 +707,38 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_((proto->flags() & STRIPED_HISTOGRAM)
+        ? nullptr
+        : new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
+    striped_histogram_((proto->flags() & STRIPED_HISTOGRAM)
+        ? new StripedHdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())
+        : nullptr) {
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  if (striped_histogram_) {
+    striped_histogram_->Increment(value);
+  } else {
+    histogram_->Increment(value);
+  }
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  if (striped_histogram_) {
+    striped_histogram_->IncrementBy(value, amount);
+  } else {
+    histogram_->IncrementBy(value, amount);
+  }
+}
+
+std::unique_ptr<HdrHistogram> Histogram::Snapshot() const {
+  if (!striped_histogram_) {
+    return std::make_unique<HdrHistogram>(*histogram_);
+  }
+  auto result = std::make_unique<HdrHistogram>(
+      striped_histogram_->highest_trackable_value(), striped_histogram_->num_significant_digits());
+  striped_histogram_->MergeTo(result.get());
+  return result;
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -729,7 +752,8 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
+  auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -762,7 +786,8 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -796,22 +821,22 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return Snapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  return striped_histogram_ ? striped_histogram_->TotalCount() : histogram_->TotalCount();
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return Snapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return Snapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return Snapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(Histogram* latency_hist)
@@ -119,6 +119,18 @@
 //                            "Total number of threads started on this server",
 //                            yb::EXPOSE_AS_COUNTER);
 //
+// Similarly, a histogram that is updated from many threads at a high rate could be defined
+// with the 'STRIPED_HISTOGRAM' flag. Such a histogram records values into per-CPU stripes, which
+// are merged when the histogram is read. It avoids contention on the shared buckets at the cost
+// of memory, so use it only for hot histograms with few instances. For example:
+//
+// METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
+//                         "RPC Queue Time",
+//                         yb::MetricUnit::kMicroseconds,
+//                         "Number of microseconds incoming RPC requests spend in the worker queue",
+//                         60000000LU, 2,
+//                         yb::STRIPED_HISTOGRAM);
+//
 //
 // Metrics ownership
 // ------------------------------------------------------------
@@ -239,6 +251,7 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -303,13 +316,14 @@
 #define METRIC_DEFINE_gauge_double(entity, name, label, unit, desc, ...) \
     METRIC_DEFINE_gauge(double, entity, name, label, unit, desc, ## __VA_ARGS__)
 
-#define METRIC_DEFINE_histogram(entity, name, label, unit, desc, max_val, num_sig_digits) \
+#define METRIC_DEFINE_histogram(entity, name, label, unit, desc, max_val, num_sig_digits, ...) \
   ::yb::HistogramPrototype BOOST_PP_CAT(METRIC_, name)(                                   \
       ::yb::MetricPrototype::CtorArgs(BOOST_PP_STRINGIZE(entity), \
                                       BOOST_PP_STRINGIZE(name), \
                                       label, \
                                       unit, \
-                                      desc), \
+                                      desc, \
+                                      ## __VA_ARGS__), \
       max_val, \
       num_sig_digits)
 
@@ -365,6 +379,7 @@ class MetricPrototype;
 class MetricRegistry;
 
 class HdrHistogram;
+class StripedHdrHistogram;
 class Histogram;
 class HistogramPrototype;
 class HistogramSnapshotPB;
@@ -767,7 +782,10 @@ class MetricPrototypeRegistry {
 enum PrototypeFlags {
   // Flag which causes a Gauge prototype to expose itself as if it
   // were a counter.
-  EXPOSE_AS_COUNTER = 1 << 0
+  EXPOSE_AS_COUNTER = 1 << 0,
+
+  // Flag which causes a Histogram to record values into per-CPU stripes.
+  STRIPED_HISTOGRAM = 1 << 1
 };
 
 class MetricPrototype {
@@ -802,6 +820,7 @@ class MetricPrototype {
   const char* label() const { return args_.label_; }
   MetricUnit::Type unit() const { return args_.unit_; }
   const char* description() const { return args_.description_; }
+  uint32_t flags() const { return args_.flags_; }
   virtual MetricType::Type type() const = 0;
 
   // Writes the fields of this prototype to the given JSON writer.
@@ -1142,10 +1161,16 @@ class Histogram : public Metric {
 
  private:
   FRIEND_TEST(MetricsTest, SimpleHistogramTest);
+  FRIEND_TEST(MetricsTest, StripedHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
 
+  // Returns a (non-consistent) snapshot of the recorded values.
+  std::unique_ptr<HdrHistogram> Snapshot() const;
+
+  // Exactly one of these is set, depending on the STRIPED_HISTOGRAM flag of the prototype.
   const gscoped_ptr<HdrHistogram> histogram_;
+  const std::unique_ptr<StripedHdrHistogram> striped_histogram_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -31,6 +31,7 @@
 //
 #include <gtest/gtest.h>
 #include <gflags/gflags.h>
+#include <algorithm>
 #include <vector>
 
 #include "yb/gutil/ref_counted.h"
@@ -63,12 +64,30 @@ class MtHdrHistogramTest : public YBTest {
 };
 
 // Increment a counter a bunch of times in the same bucket
-static void IncrementSameHistValue(HdrHistogram* hist, uint64_t value, uint64_t times) {
+template <class Histogram>
+static void IncrementSameHistValue(Histogram* hist, uint64_t value, uint64_t times) {
   for (uint64_t i = 0; i < times; i++) {
     hist->Increment(value);
   }
 }
 
+// Runs num_threads threads, each incrementing the histogram num_times times.
+// Returns the number of increments per second.
+template <class Histogram>
+static double MeasureIncrementRate(Histogram* hist, int num_threads, uint64_t num_times) {
+  vector<scoped_refptr<yb::Thread>> threads(num_threads);
+  MonoTime start = MonoTime::Now();
+  for (int i = 0; i < num_threads; i++) {
+    CHECK_OK(yb::Thread::Create("test", strings::Substitute("thread-$0", i),
+        IncrementSameHistValue<Histogram>, hist, 1000LU, num_times, &threads[i]));
+  }
+  for (int i = 0; i < num_threads; i++) {
+    CHECK_OK(ThreadJoiner(threads[i].get()).Join());
+  }
+  MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+  return num_threads * num_times / std::max(elapsed.ToSeconds(), 1e-9);
+}
+
 TEST_F(MtHdrHistogramTest, ConcurrentWriteTest) {
   const uint64_t kValue = 1LU;
 
@@ -77,7 +96,7 @@ TEST_F(MtHdrHistogramTest, ConcurrentWriteTest) {
   auto threads = new scoped_refptr<yb::Thread>[num_threads_];
   for (int i = 0; i < num_threads_; i++) {
     CHECK_OK(yb::Thread::Create("test", strings::Substitute("thread-$0", i),
-        IncrementSameHistValue, &hist, kValue, num_times_, &threads[i]));
+        IncrementSameHistValue<HdrHistogram>, &hist, kValue, num_times_, &threads[i]));
   }
   for (int i = 0; i < num_threads_; i++) {
     CHECK_OK(ThreadJoiner(threads[i].get()).Join());
@@ -99,7 +118,7 @@ TEST_F(MtHdrHistogramTest, ConcurrentCopyWhileWritingTest) {
   auto threads = new scoped_refptr<yb::Thread>[num_threads_];
   for (int i = 0; i < num_threads_; i++) {
     CHECK_OK(yb::Thread::Create("test", strings::Substitute("thread-$0", i),
-        IncrementSameHistValue, &hist, kValue, num_times_, &threads[i]));
+        IncrementSameHistValue<HdrHistogram>, &hist, kValue, num_times_, &threads[i]));
   }
 
   // This is somewhat racy but the goal is to catch this issue at least
@@ -123,4 +142,51 @@ TEST_F(MtHdrHistogramTest, ConcurrentCopyWhileWritingTest) {
   delete[] threads;
 }
 
+TEST_F(MtHdrHistogramTest, ConcurrentStripedWriteTest) {
+  const uint64_t kValue = 1LU;
+
+  StripedHdrHistogram hist(100000LU, 3);
+
+  vector<scoped_refptr<yb::Thread>> threads(num_threads_);
+  for (int i = 0; i < num_threads_; i++) {
+    CHECK_OK(yb::Thread::Create("test", strings::Substitute("thread-$0", i),
+        IncrementSameHistValue<StripedHdrHistogram>, &hist, kValue, num_times_, &threads[i]));
+  }
+
+  // Merge while writing, snapshots should stay consistent.
+  for (int i = 0; i < 10; i++) {
+    HdrHistogram snapshot(100000LU, 3);
+    hist.MergeTo(&snapshot);
+    ASSERT_EQ(snapshot.TotalCount(), snapshot.CountInBucketForValue(kValue));
+    SleepFor(MonoDelta::FromMicroseconds(100));
+  }
+
+  for (int i = 0; i < num_threads_; i++) {
+    CHECK_OK(ThreadJoiner(threads[i].get()).Join());
+  }
+
+  ASSERT_EQ(num_threads_ * num_times_, hist.TotalCount());
+  HdrHistogram snapshot(100000LU, 3);
+  hist.MergeTo(&snapshot);
+  ASSERT_EQ(num_threads_ * num_times_, snapshot.CountInBucketForValue(kValue));
+  ASSERT_EQ(kValue, snapshot.MinValue());
+  ASSERT_EQ(kValue, snapshot.MaxValue());
+}
+
+// Compares the increment rate of plain and striped histograms for a growing number of threads.
+TEST_F(MtHdrHistogramTest, ScalabilityBenchmark) {
+  for (int num_threads = 1; num_threads <= num_threads_; num_threads *= 2) {
+    HdrHistogram plain(60000000LU, 3);
+    StripedHdrHistogram striped(60000000LU, 3);
+    double plain_rate = MeasureIncrementRate(&plain, num_threads, num_times_);
+    double striped_rate = MeasureIncrementRate(&striped, num_threads, num_times_);
+    LOG(INFO) << strings::Substitute(
+        "$0 threads: plain $1 increments/s, striped $2 increments/s ($3 stripes)",
+        num_threads, static_cast<int64_t>(plain_rate), static_cast<int64_t>(striped_rate),
+        striped.num_stripes());
+    ASSERT_EQ(num_threads * num_times_, plain.TotalCount());
+    ASSERT_EQ(num_threads * num_times_, striped.TotalCount());
+  }
+}
+
 } // namespace yb
@@ -0,0 +1,140 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class PriorityThreadPoolTest : public YBTest {
+ protected:
+  // Submits a task that blocks the only thread of the pool until the returned latch is released.
+  void BlockPool(PriorityThreadPool* pool, CountDownLatch* started, CountDownLatch* release) {
+    ASSERT_OK(pool->Submit(0, nullptr, [started, release](const Status& status) {
+      started->CountDown();
+      release->Wait();
+    }));
+    started->Wait();
+  }
+
+  PriorityThreadPool::Task RecordingTask(int id) {
+    return [this, id](const Status& status) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (status.ok()) {
+        run_.push_back(id);
+      } else {
+        aborted_.push_back(id);
+      }
+    };
+  }
+
+  void WaitRun(size_t num_tasks) {
+    ASSERT_OK(WaitFor([this, num_tasks] {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return run_.size() == num_tasks;
+    }, MonoDelta::FromSeconds(5), "Tasks run"));
+  }
+
+  std::mutex mutex_;
+  std::vector<int> run_;
+  std::vector<int> aborted_;
+};
+
+TEST_F(PriorityThreadPoolTest, RunsHighestPriorityFirst) {
+  PriorityThreadPool pool("test", 1);
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  BlockPool(&pool, &started, &release);
+
+  ASSERT_OK(pool.Submit(1, nullptr, RecordingTask(1)));
+  ASSERT_OK(pool.Submit(3, nullptr, RecordingTask(2)));
+  ASSERT_OK(pool.Submit(2, nullptr, RecordingTask(3)));
+  ASSERT_OK(pool.Submit(3, nullptr, RecordingTask(4)));
+  ASSERT_EQ(4U, pool.queue_length());
+
+  release.CountDown();
+  WaitRun(4);
+  pool.Shutdown();
+
+  ASSERT_EQ((std::vector<int>{2, 4, 3, 1}), run_);
+  ASSERT_TRUE(aborted_.empty());
+}
+
+TEST_F(PriorityThreadPoolTest, RemoveByTag) {
+  PriorityThreadPool pool("test", 1);
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  BlockPool(&pool, &started, &release);
+
+  int tag1 = 0, tag2 = 0;
+  ASSERT_OK(pool.Submit(1, &tag1, RecordingTask(1)));
+  ASSERT_OK(pool.Submit(2, &tag2, RecordingTask(2)));
+  ASSERT_OK(pool.Submit(3, &tag1, RecordingTask(3)));
+
+  ASSERT_EQ(2U, pool.Remove(&tag1));
+  ASSERT_EQ(0U, pool.Remove(&tag1));
+  ASSERT_EQ((std::vector<int>{3, 1}), aborted_);
+
+  release.CountDown();
+  WaitRun(1);
+  pool.Shutdown();
+  ASSERT_EQ((std::vector<int>{2}), run_);
+}
+
+TEST_F(PriorityThreadPoolTest, ShutdownAbortsQueuedTasks) {
+  PriorityThreadPool pool("test", 1);
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  BlockPool(&pool, &started, &release);
+
+  ASSERT_OK(pool.Submit(1, nullptr, RecordingTask(1)));
+  ASSERT_OK(pool.Submit(2, nullptr, RecordingTask(2)));
+
+  std::thread shutdown_thread([&pool] { pool.Shutdown(); });
+  // Queued tasks are aborted right away, while the running task is waited for.
+  ASSERT_OK(WaitFor([this] {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return aborted_.size() == 2;
+  }, MonoDelta::FromSeconds(5), "Queued tasks aborted"));
+  release.CountDown();
+  shutdown_thread.join();
+
+  ASSERT_TRUE(run_.empty());
+  ASSERT_NOK(pool.Submit(1, nullptr, RecordingTask(3)));
+}
+
+TEST_F(PriorityThreadPoolTest, RunsTasksConcurrently) {
+  constexpr size_t kMaxRunningTasks = 4;
+  PriorityThreadPool pool("test", kMaxRunningTasks);
+  CountDownLatch started(kMaxRunningTasks);
+  CountDownLatch release(1);
+  for (size_t i = 0; i != kMaxRunningTasks; ++i) {
+    ASSERT_OK(pool.Submit(0, nullptr, [&started, &release](const Status& status) {
+      started.CountDown();
+      release.Wait();
+    }));
+  }
+  // All tasks should be started, despite none of them is completed yet.
+  ASSERT_TRUE(started.WaitFor(MonoDelta::FromSeconds(5)));
+  release.CountDown();
+  pool.Shutdown();
+}
+
+} // namespace yb
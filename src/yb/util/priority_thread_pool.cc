@@ -0,0 +1,151 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/priority_thread_pool.h"
+
+#include <glog/logging.h>
+
+#include "yb/util/thread.h"
+
+namespace yb {
+
+PriorityThreadPool::PriorityThreadPool(std::string name, size_t max_running_tasks,
+                                       PriorityThreadPoolMetrics metrics)
+    : name_(std::move(name)),
+      max_running_tasks_(std::max<size_t>(max_running_tasks, 1)),
+      metrics_(std::move(metrics)) {
+}
+
+PriorityThreadPool::~PriorityThreadPool() {
+  Shutdown();
+}
+
+Status PriorityThreadPool::Submit(int64_t priority, void* tag, Task task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (shutting_down_) {
+    return STATUS(ServiceUnavailable, "The pool has been shut down.");
+  }
+
+  queue_.insert(QueuedTask{priority, next_serial_no_++, tag, MonoTime::Now(), std::move(task)});
+  UpdateQueueLength();
+
+  if (queue_.size() > idle_threads_ && threads_.size() < max_running_tasks_) {
+    scoped_refptr<Thread> thread;
+    Status status = Thread::Create(
+        "priority_thread_pool", name_, &PriorityThreadPool::Worker, this, &thread);
+    if (status.ok()) {
+      threads_.push_back(std::move(thread));
+    } else if (threads_.empty()) {
+      // Nobody would run the task, so don't keep it in the queue.
+      for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        if (it->serial_no == next_serial_no_ - 1) {
+          queue_.erase(it);
+          break;
+        }
+      }
+      UpdateQueueLength();
+      return status;
+    } else {
+      LOG(WARNING) << name_ << ": failed to start a thread: " << status;
+    }
+  }
+  cond_.notify_one();
+  return Status::OK();
+}
+
+size_t PriorityThreadPool::Remove(void* tag) {
+  std::vector<Task> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (it->tag == tag) {
+        removed.push_back(std::move(it->task));
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    UpdateQueueLength();
+  }
+  for (auto& task : removed) {
+    task(STATUS(Aborted, "Task removed from the queue"));
+  }
+  return removed.size();
+}
+
+void PriorityThreadPool::Shutdown() {
+  std::vector<Task> aborted;
+  std::vector<scoped_refptr<Thread>> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutting_down_ = true;
+    for (const auto& queued_task : queue_) {
+      aborted.push_back(std::move(queued_task.task));
+    }
+    queue_.clear();
+    UpdateQueueLength();
+    threads.swap(threads_);
+  }
+  cond_.notify_all();
+
+  for (auto& task : aborted) {
+    task(STATUS(Aborted, "Thread pool is shutting down"));
+  }
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+size_t PriorityThreadPool::queue_length() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+void PriorityThreadPool::Worker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    if (queue_.empty() && !shutting_down_) {
+      ++idle_threads_;
+      cond_.wait(lock, [this] { return shutting_down_ || !queue_.empty(); });
+      --idle_threads_;
+    }
+    if (shutting_down_) {
+      return;
+    }
+
+    auto it = queue_.begin();
+    Task task = std::move(it->task);
+    MonoTime submit_time = it->submit_time;
+    queue_.erase(it);
+    UpdateQueueLength();
+    lock.unlock();
+
+    if (metrics_.queue_time_us) {
+      metrics_.queue_time_us->Increment(
+          MonoTime::Now().GetDeltaSince(submit_time).ToMicroseconds());
+    }
+    task(Status::OK());
+    // Release whatever the task has captured before taking the lock.
+    task = nullptr;
+
+    lock.lock();
+  }
+}
+
+void PriorityThreadPool::UpdateQueueLength() {
+  if (metrics_.queue_length) {
+    metrics_.queue_length->set_value(queue_.size());
+  }
+}
+
+} // namespace yb
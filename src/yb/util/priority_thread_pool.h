@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_PRIORITY_THREAD_POOL_H
+#define YB_UTIL_PRIORITY_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+
+struct PriorityThreadPoolMetrics {
+  // Number of tasks waiting in the queue.
+  scoped_refptr<AtomicGauge<uint64_t>> queue_length;
+
+  // Measures the amount of time that tasks spend waiting in the queue.
+  scoped_refptr<Histogram> queue_time_us;
+};
+
+// Thread pool that runs at most max_running_tasks tasks at once. When a thread becomes free, it
+// picks the queued task with the highest priority, tasks with equal priority are run in the order
+// they were submitted.
+//
+// Tasks are submitted with a tag, usually the object that submits them, so that an object that is
+// being destroyed could remove all its queued tasks.
+//
+// This class is thread-safe.
+class PriorityThreadPool {
+ public:
+  // The task is invoked with OK status when it is run, and with Aborted status when it is removed
+  // from the queue without being run.
+  typedef std::function<void(const Status&)> Task;
+
+  PriorityThreadPool(std::string name, size_t max_running_tasks,
+                     PriorityThreadPoolMetrics metrics = PriorityThreadPoolMetrics());
+  ~PriorityThreadPool();
+
+  CHECKED_STATUS Submit(int64_t priority, void* tag, Task task);
+
+  // Removes queued tasks with the specified tag, invoking them with Aborted status.
+  // Returns the number of removed tasks. Running tasks are not affected.
+  size_t Remove(void* tag);
+
+  // Aborts the queued tasks and waits for the running ones to complete.
+  void Shutdown();
+
+  size_t queue_length() const;
+
+  const std::string& name() const { return name_; }
+
+ private:
+  struct QueuedTask {
+    int64_t priority;
+    uint64_t serial_no;
+    void* tag;
+    MonoTime submit_time;
+    // The task is mutable, so that it could be moved out of the set before erasing.
+    mutable Task task;
+
+    bool operator<(const QueuedTask& rhs) const {
+      return priority != rhs.priority ? priority > rhs.priority : serial_no < rhs.serial_no;
+    }
+  };
+
+  void Worker();
+
+  void UpdateQueueLength();
+
+  const std::string name_;
+  const size_t max_running_tasks_;
+  const PriorityThreadPoolMetrics metrics_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::set<QueuedTask> queue_;
+  std::vector<scoped_refptr<Thread>> threads_;
+  size_t idle_threads_ = 0;
+  uint64_t next_serial_no_ = 0;
+  bool shutting_down_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityThreadPool);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_PRIORITY_THREAD_POOL_H
@@ -89,6 +89,21 @@ TEST_F(RefCntBufferTest, TestVector) {
   }
 }
 
+TEST_F(RefCntBufferTest, TestSlice) {
+  RefCntSlice slice;
+  {
+    RefCntBuffer buffer("0123456789"s);
+    slice = RefCntSlice(buffer, Slice(buffer.udata() + 2, 5));
+    RefCntSlice whole = buffer;
+    ASSERT_EQ(buffer.size(), whole.size());
+    ASSERT_EQ(buffer.udata(), whole.data());
+  }
+  // The slice keeps the buffer alive.
+  ASSERT_EQ("23456", slice.AsSlice().ToBuffer());
+  ASSERT_EQ("56", slice.Suffix(3).AsSlice().ToBuffer());
+  ASSERT_EQ(slice.holder().udata(), slice.Suffix(3).holder().udata());
+}
+
 namespace {
 
 const size_t kInitialBuffers = 1000;
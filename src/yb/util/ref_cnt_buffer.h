@@ -22,6 +22,8 @@
 #include <atomic>
 #include <string>
 
+#include "yb/util/slice.h"
+
 namespace yb {
 
 class faststring;
@@ -115,6 +117,54 @@ class RefCntBuffer {
   char *data_;
 };
 
+// Part of the RefCntBuffer data, that keeps the whole buffer alive. Used to pass data that was
+// received from the network, for instance a sidecar of an RPC response, further without copying.
+class RefCntSlice {
+ public:
+  RefCntSlice() {}
+
+  // Implicit, so that a whole buffer could be passed where a slice is expected.
+  RefCntSlice(RefCntBuffer holder) // NOLINT
+      : holder_(std::move(holder)), slice_(holder_.udata(), holder_.size()) {}
+
+  // The slice should point into the data of holder.
+  RefCntSlice(RefCntBuffer holder, const Slice& slice)
+      : holder_(std::move(holder)), slice_(slice) {}
+
+  const RefCntBuffer& holder() const {
+    return holder_;
+  }
+
+  const Slice& AsSlice() const {
+    return slice_;
+  }
+
+  const uint8_t* data() const {
+    return slice_.data();
+  }
+
+  const char* cdata() const {
+    return slice_.cdata();
+  }
+
+  size_t size() const {
+    return slice_.size();
+  }
+
+  bool empty() const {
+    return slice_.empty();
+  }
+
+  // Returns the part of this slice that starts at the given offset.
+  RefCntSlice Suffix(size_t offset) const {
+    return RefCntSlice(holder_, Slice(slice_.data() + offset, slice_.size() - offset));
+  }
+
+ private:
+  RefCntBuffer holder_;
+  Slice slice_;
+};
+
 } // namespace yb
 
 #endif // YB_UTIL_REF_CNT_BUFFER_H
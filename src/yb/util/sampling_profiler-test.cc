@@ -0,0 +1,162 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/util/monotime.h"
+#include "yb/util/sampling_profiler.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_util.h"
+#include "yb/util/tsan_util.h"
+
+DECLARE_bool(sampling_profiler_enabled);
+DECLARE_int32(sampling_profiler_frequency_hz);
+
+namespace yb {
+
+class SamplingProfilerTest : public YBTest {
+ protected:
+  // Burns CPU for the given time, so that the profiler takes samples of this thread.
+  static uint64_t BurnCpu(MonoDelta duration) {
+    volatile uint64_t value = 0;
+    auto deadline = MonoTime::Now() + duration;
+    while (MonoTime::Now() < deadline) {
+      for (int i = 0; i != 10000; ++i) {
+        value = value * 31 + i;
+      }
+    }
+    return value;
+  }
+
+  // Runs a fixed amount of work, and returns the CPU time it took, in seconds.
+  static double CpuSecondsForWork() {
+    Stopwatch stopwatch(Stopwatch::THIS_THREAD);
+    stopwatch.start();
+    volatile uint64_t value = 0;
+    for (int i = 0; i != 200000000; ++i) {
+      value = value * 31 + i;
+    }
+    stopwatch.stop();
+    return stopwatch.elapsed().user_cpu_seconds() + stopwatch.elapsed().system_cpu_seconds();
+  }
+
+  // Returns the CPU time of the tags of a single call, in nanoseconds.
+  static double CpuNanosPerTag() {
+    constexpr int kNumTags = 10000000;
+    const std::string service = "TestService";
+    const std::string method = "TestMethod";
+    Stopwatch stopwatch(Stopwatch::THIS_THREAD);
+    stopwatch.start();
+    for (int i = 0; i != kNumTags; ++i) {
+      ScopedProfilerTag tag(service, method);
+      ScopedProfilerTag::SetTablet(service);
+    }
+    stopwatch.stop();
+    return (stopwatch.elapsed().user_cpu_seconds() + stopwatch.elapsed().system_cpu_seconds()) *
+           1e9 / kNumTags;
+  }
+};
+
+TEST_F(SamplingProfilerTest, TaggedSamples) {
+  if (IsTsan()) {
+    LOG(INFO) << "Sampling profiler is disabled in TSAN builds";
+    return;
+  }
+
+  FLAGS_sampling_profiler_enabled = true;
+  FLAGS_sampling_profiler_frequency_hz = 1000;
+  ASSERT_OK(StartSamplingProfiler());
+  {
+    ScopedProfilerTag outer_tag("TestService", "Outer");
+    BurnCpu(MonoDelta::FromMilliseconds(300));
+    {
+      ScopedProfilerTag inner_tag("TestService", "Inner");
+      ScopedProfilerTag::SetTablet("test-tablet");
+      BurnCpu(MonoDelta::FromMilliseconds(300));
+    }
+    // The outer tags are restored, without the tablet of the inner scope.
+    BurnCpu(MonoDelta::FromMilliseconds(300));
+  }
+  StopSamplingProfiler();
+
+  std::stringstream out;
+  DumpSamplingProfile(&out, /* reset */ true);
+  const std::string profile = out.str();
+  LOG(INFO) << "Profile size: " << profile.size();
+  // Prepend a new line, so that every line could be searched for by its beginning.
+  const std::string lines_text = "\n" + profile;
+  ASSERT_NE(std::string::npos, lines_text.find("\nTestService;Outer;")) << profile;
+  ASSERT_NE(std::string::npos, lines_text.find("\nTestService;Inner;test-tablet;")) << profile;
+  ASSERT_EQ(std::string::npos, profile.find("TestService;Outer;test-tablet")) << profile;
+
+  // Every line should end with the number of samples.
+  std::istringstream lines(profile);
+  std::string line;
+  while (std::getline(lines, line)) {
+    auto space = line.rfind(' ');
+    ASSERT_NE(std::string::npos, space) << line;
+    ASSERT_GT(std::stoi(line.substr(space + 1)), 0) << line;
+  }
+
+  std::stringstream after_reset;
+  DumpSamplingProfile(&after_reset, /* reset */ false);
+  ASSERT_EQ(std::string::npos, after_reset.str().find("TestService")) << after_reset.str();
+}
+
+// Measures the CPU overhead of the profiler on a CPU bound thread, and the cost of the tags.
+TEST_F(SamplingProfilerTest, Overhead) {
+  if (IsTsan()) {
+    LOG(INFO) << "Sampling profiler is disabled in TSAN builds";
+    return;
+  }
+  constexpr int kRuns = 3;
+
+  double best_disabled = std::numeric_limits<double>::max();
+  for (int i = 0; i != kRuns; ++i) {
+    best_disabled = std::min(best_disabled, CpuSecondsForWork());
+  }
+  const double tag_disabled_ns = CpuNanosPerTag();
+
+  FLAGS_sampling_profiler_enabled = true;
+  double overhead_at_default_frequency = 0;
+  for (int frequency_hz : {50, 1000}) {
+    FLAGS_sampling_profiler_frequency_hz = frequency_hz;
+    ASSERT_OK(StartSamplingProfiler());
+    double best_enabled = std::numeric_limits<double>::max();
+    for (int i = 0; i != kRuns; ++i) {
+      best_enabled = std::min(best_enabled, CpuSecondsForWork());
+    }
+    const double tag_enabled_ns = CpuNanosPerTag();
+    StopSamplingProfiler();
+
+    const double overhead = (best_enabled - best_disabled) / best_disabled;
+    LOG(INFO) << "Sampling at " << frequency_hz << " Hz: " << best_enabled << " s CPU vs "
+              << best_disabled << " s CPU without the profiler, overhead " << overhead * 100
+              << "%, tags cost " << tag_enabled_ns << " ns vs " << tag_disabled_ns << " ns";
+    if (frequency_hz == 50) {
+      overhead_at_default_frequency = overhead;
+    }
+  }
+  std::stringstream out;
+  DumpSamplingProfile(&out, /* reset */ true);
+
+  ASSERT_LT(overhead_at_default_frequency, 0.05);
+}
+
+} // namespace yb
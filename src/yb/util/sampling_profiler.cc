@@ -0,0 +1,521 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/sampling_profiler.h"
+
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__)
+#define UNW_LOCAL_ONLY
+#include <libunwind.h>
+#endif
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/port.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/thread.h"
+#include "yb/util/tsan_util.h"
+
+DEFINE_bool(sampling_profiler_enabled, false,
+            "Whether to run the continuous sampling profiler, that attributes the CPU time to "
+            "RPC services, methods and tablets. The profile is available at /profilez. Disabled "
+            "by default, because unwinding the stack in the signal handler could deadlock a "
+            "thread that is interrupted while holding the dynamic loader lock.");
+TAG_FLAG(sampling_profiler_enabled, advanced);
+
+DEFINE_int32(sampling_profiler_frequency_hz, 50,
+             "Number of stack samples the sampling profiler takes per second of CPU time "
+             "consumed by the process.");
+TAG_FLAG(sampling_profiler_frequency_hz, advanced);
+
+DEFINE_int32(sampling_profiler_buffer_size, 8192,
+             "Number of samples the sampling profiler could buffer between aggregations. "
+             "Rounded up to a power of two.");
+TAG_FLAG(sampling_profiler_buffer_size, advanced);
+
+DEFINE_int32(sampling_profiler_aggregate_interval_ms, 500,
+             "How often the sampling profiler aggregates the buffered samples.");
+TAG_FLAG(sampling_profiler_aggregate_interval_ms, advanced);
+
+DEFINE_int32(sampling_profiler_max_stacks, 20000,
+             "Max number of distinct tagged stacks the sampling profiler keeps. Samples of new "
+             "stacks above this limit are counted as dropped.");
+TAG_FLAG(sampling_profiler_max_stacks, advanced);
+
+namespace yb {
+
+namespace internal {
+
+std::atomic<bool> sampling_profiler_running{false};
+
+} // namespace internal
+
+namespace {
+
+// Tags of the current thread. Accessed from the signal handler, so use the initial-exec model,
+// which does not allocate on first access.
+__thread internal::ProfilerTags tls_tags ATTRIBUTE_INITIAL_EXEC;
+
+// Whether tls_tags holds valid tags. Cleared while the tags are being changed, so that the signal
+// handler, which runs on the same thread, never sees torn tags.
+__thread bool tls_tagged ATTRIBUTE_INITIAL_EXEC;
+
+template <size_t N>
+void CopyTag(const Slice& value, char (&dest)[N]) {
+  size_t length = std::min(value.size(), N - 1);
+  memcpy(dest, value.data(), length);
+  dest[length] = 0;
+}
+
+// Maximum number of frames kept for a sample.
+constexpr int kMaxFrames = 16;
+
+// Maximum number of frames of the signal handler itself, that are skipped.
+constexpr int kMaxHandlerFrames = 16;
+
+// Collects the return addresses of the code the current thread was running when the signal was
+// delivered, the innermost frame first. The frames up to the signal trampoline belong to the
+// handler and are skipped.
+int CollectInterruptedStack(void** frames) {
+#if defined(__linux__)
+  unw_context_t context;
+  unw_cursor_t cursor;
+  if (unw_getcontext(&context) != 0 || unw_init_local(&cursor, &context) != 0) {
+    return 0;
+  }
+  int handler_frames = 0;
+  for (;;) {
+    if (unw_step(&cursor) <= 0 || ++handler_frames > kMaxHandlerFrames) {
+      return 0;
+    }
+    if (unw_is_signal_frame(&cursor) > 0) {
+      break;
+    }
+  }
+  int num_frames = 0;
+  while (num_frames != kMaxFrames && unw_step(&cursor) > 0) {
+    unw_word_t ip;
+    if (unw_get_reg(&cursor, UNW_REG_IP, &ip) != 0 || ip == 0) {
+      break;
+    }
+    frames[num_frames++] = reinterpret_cast<void*>(ip);
+  }
+  return num_frames;
+#else
+  return 0;
+#endif
+}
+
+// The timer signal. A real-time one, so that it does not interfere with SIGPROF, that is used by
+// the gperftools CPU profiler behind /pprof/profile.
+int ProfilerSignal() {
+#if defined(__linux__)
+  return SIGRTMIN + 4;
+#else
+  return SIGPROF;
+#endif
+}
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+class SamplingProfiler {
+ public:
+  explicit SamplingProfiler(size_t buffer_size)
+      : mask_(RoundUpToPowerOfTwo(std::max<size_t>(buffer_size, 2)) - 1),
+        samples_(new Sample[mask_ + 1]) {
+  }
+
+  CHECKED_STATUS Start(int frequency_hz);
+  void Stop();
+
+  // Records a sample of the current thread. Called from the signal handler.
+  void RecordSample();
+
+  void Dump(std::ostream* out, bool reset);
+
+ private:
+  // Slot of the ring buffer. sequence is 2 * ticket + 1 while the sample with that ticket is
+  // being written, and 2 * ticket + 2 once it is complete, so the reader could detect slots that
+  // are incomplete or were overwritten while being copied.
+  struct Sample {
+    std::atomic<uint64_t> sequence{0};
+    bool tagged = false;
+    internal::ProfilerTags tags;
+    int num_frames = 0;
+    void* frames[kMaxFrames];
+  };
+
+  void AggregateThread();
+
+  // Moves the samples from the ring buffer to stacks_.
+  void Aggregate();
+
+  void AddSample(bool tagged, const internal::ProfilerTags& tags, void* const* frames,
+                 int num_frames);
+
+  const size_t mask_;
+  std::unique_ptr<Sample[]> samples_;
+  std::atomic<uint64_t> next_ticket_{0};
+
+  // Protects all fields below.
+  std::mutex mutex_;
+  bool running_ = false;
+#if defined(__linux__)
+  timer_t timer_;
+#endif
+  std::unique_ptr<CountDownLatch> stop_latch_;
+  scoped_refptr<Thread> aggregate_thread_;
+
+  uint64_t read_ticket_ = 0;
+  uint64_t dropped_ = 0;
+
+  // Aggregated samples. The key is the tags string followed by '\0' and the raw frame addresses,
+  // the innermost frame first.
+  std::unordered_map<std::string, uint64_t> stacks_;
+};
+
+// Never deleted, since the signal handler could still be running after the profiler is stopped.
+std::atomic<SamplingProfiler*> g_profiler{nullptr};
+std::mutex g_profiler_mutex;
+
+void HandleProfilerSignal(int signum) {
+  int old_errno = errno;
+  SamplingProfiler* profiler = g_profiler.load(std::memory_order_acquire);
+  if (profiler != nullptr) {
+    profiler->RecordSample();
+  }
+  errno = old_errno;
+}
+
+Status InstallSignalHandler() {
+  int signum = ProfilerSignal();
+  struct sigaction old_act;
+  if (sigaction(signum, nullptr, &old_act) != 0) {
+    return STATUS(RuntimeError, "Failed to query the profiler signal handler",
+                  ErrnoToString(errno), errno);
+  }
+  if (old_act.sa_handler == &HandleProfilerSignal) {
+    return Status::OK();
+  }
+  if (old_act.sa_handler != SIG_DFL && old_act.sa_handler != SIG_IGN) {
+    return STATUS_FORMAT(IllegalState, "Handler for profiler signal $0 is already in use", signum);
+  }
+  struct sigaction act;
+  memset(&act, 0, sizeof(act));
+  act.sa_handler = &HandleProfilerSignal;
+  act.sa_flags = SA_RESTART;
+  sigemptyset(&act.sa_mask);
+  if (sigaction(signum, &act, nullptr) != 0) {
+    return STATUS(RuntimeError, "Failed to install the profiler signal handler",
+                  ErrnoToString(errno), errno);
+  }
+  return Status::OK();
+}
+
+Status SamplingProfiler::Start(int frequency_hz) {
+#if defined(__linux__)
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) {
+    return Status::OK();
+  }
+  if (frequency_hz <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid sampling frequency: $0", frequency_hz);
+  }
+  RETURN_NOT_OK(InstallSignalHandler());
+
+  // The timer counts the CPU time of the whole process, and the kernel delivers the signal to the
+  // thread that was running when it expired.
+  struct sigevent event;
+  memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_SIGNAL;
+  event.sigev_signo = ProfilerSignal();
+  if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &event, &timer_) != 0) {
+    return STATUS(RuntimeError, "Failed to create the profiler timer",
+                  ErrnoToString(errno), errno);
+  }
+  struct itimerspec spec;
+  spec.it_interval.tv_sec = 0;
+  spec.it_interval.tv_nsec = 1000000000L / std::min(frequency_hz, 1000000);
+  spec.it_value = spec.it_interval;
+  if (timer_settime(timer_, 0, &spec, nullptr) != 0) {
+    Status status = STATUS(RuntimeError, "Failed to arm the profiler timer",
+                           ErrnoToString(errno), errno);
+    timer_delete(timer_);
+    return status;
+  }
+
+  stop_latch_.reset(new CountDownLatch(1));
+  Status status = Thread::Create(
+      "sampling_profiler", "aggregate", &SamplingProfiler::AggregateThread, this,
+      &aggregate_thread_);
+  if (!status.ok()) {
+    timer_delete(timer_);
+    return status;
+  }
+  running_ = true;
+  internal::sampling_profiler_running.store(true, std::memory_order_relaxed);
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Sampling profiler is only supported on Linux");
+#endif
+}
+
+void SamplingProfiler::Stop() {
+  scoped_refptr<Thread> aggregate_thread;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+      return;
+    }
+#if defined(__linux__)
+    timer_delete(timer_);
+#endif
+    running_ = false;
+    internal::sampling_profiler_running.store(false, std::memory_order_relaxed);
+    stop_latch_->CountDown();
+    aggregate_thread.swap(aggregate_thread_);
+  }
+  CHECK_OK(ThreadJoiner(aggregate_thread.get()).Join());
+}
+
+void SamplingProfiler::RecordSample() {
+  uint64_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+  Sample& sample = samples_[ticket & mask_];
+  // Claim the slot. It could still be written by a thread that took a ticket one lap ago, in which
+  // case this sample is dropped.
+  uint64_t sequence = sample.sequence.load(std::memory_order_relaxed);
+  if ((sequence & 1) ||
+      !sample.sequence.compare_exchange_strong(
+          sequence, ticket * 2 + 1, std::memory_order_relaxed)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  sample.tagged = tls_tagged;
+  if (sample.tagged) {
+    memcpy(&sample.tags, &tls_tags, sizeof(sample.tags));
+  }
+  sample.num_frames = CollectInterruptedStack(sample.frames);
+
+  sample.sequence.store(ticket * 2 + 2, std::memory_order_release);
+}
+
+void SamplingProfiler::AggregateThread() {
+  auto interval = MonoDelta::FromMilliseconds(FLAGS_sampling_profiler_aggregate_interval_ms);
+  CountDownLatch* stop_latch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_latch = stop_latch_.get();
+  }
+  while (!stop_latch->WaitFor(interval)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Aggregate();
+  }
+}
+
+void SamplingProfiler::Aggregate() {
+  const size_t capacity = mask_ + 1;
+  uint64_t end = next_ticket_.load(std::memory_order_acquire);
+  if (end - read_ticket_ > capacity) {
+    // The ring buffer wrapped around since the last aggregation.
+    dropped_ += end - read_ticket_ - capacity;
+    read_ticket_ = end - capacity;
+  }
+
+  bool tagged;
+  internal::ProfilerTags tags;
+  int num_frames;
+  void* frames[kMaxFrames];
+  for (; read_ticket_ != end; ++read_ticket_) {
+    Sample& sample = samples_[read_ticket_ & mask_];
+    const uint64_t complete = read_ticket_ * 2 + 2;
+    uint64_t sequence = sample.sequence.load(std::memory_order_acquire);
+    if (sequence != complete) {
+      if (sequence & 1) {
+        // Still being written, pick it up next time.
+        break;
+      }
+      // Dropped by the writer, or already overwritten.
+      ++dropped_;
+      continue;
+    }
+    tagged = sample.tagged;
+    if (tagged) {
+      memcpy(&tags, &sample.tags, sizeof(tags));
+    }
+    num_frames = std::min(sample.num_frames, kMaxFrames);
+    memcpy(frames, sample.frames, num_frames * sizeof(frames[0]));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sample.sequence.load(std::memory_order_relaxed) != complete) {
+      ++dropped_;
+      continue;
+    }
+    AddSample(tagged, tags, frames, num_frames);
+  }
+}
+
+void SamplingProfiler::AddSample(
+    bool tagged, const internal::ProfilerTags& tags, void* const* frames, int num_frames) {
+  std::string key;
+  if (tagged) {
+    key += tags.service;
+    key += ';';
+    key += tags.method;
+    if (tags.tablet[0]) {
+      key += ';';
+      key += tags.tablet;
+    }
+  } else {
+    key += "(untagged)";
+  }
+  key.push_back(0);
+  key.append(reinterpret_cast<const char*>(frames), num_frames * sizeof(frames[0]));
+
+  auto it = stacks_.find(key);
+  if (it != stacks_.end()) {
+    ++it->second;
+  } else if (stacks_.size() < static_cast<size_t>(FLAGS_sampling_profiler_max_stacks)) {
+    stacks_.emplace(std::move(key), 1);
+  } else {
+    ++dropped_;
+  }
+}
+
+void SamplingProfiler::Dump(std::ostream* out, bool reset) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Aggregate();
+
+  std::unordered_map<void*, std::string> symbols;
+  for (const auto& entry : stacks_) {
+    const std::string& key = entry.first;
+    size_t tags_end = key.find('\0');
+    out->write(key.data(), tags_end);
+    // Flame graphs expect the outermost frame first.
+    const char* frames = key.data() + tags_end + 1;
+    for (size_t i = (key.size() - tags_end - 1) / sizeof(void*); i-- > 0;) {
+      void* frame;
+      memcpy(&frame, frames + i * sizeof(frame), sizeof(frame));
+      auto it = symbols.find(frame);
+      if (it == symbols.end()) {
+        it = symbols.emplace(frame, SymbolizeFunctionName(frame)).first;
+      }
+      *out << ';' << it->second;
+    }
+    if (key.size() == tags_end + 1) {
+      *out << ";(no stack)";
+    }
+    *out << ' ' << entry.second << '\n';
+  }
+  if (dropped_ != 0) {
+    *out << "(dropped) " << dropped_ << '\n';
+  }
+
+  if (reset) {
+    stacks_.clear();
+    dropped_ = 0;
+  }
+}
+
+} // namespace
+
+Status StartSamplingProfiler() {
+  if (!FLAGS_sampling_profiler_enabled) {
+    return Status::OK();
+  }
+  if (IsTsan()) {
+    // The aggregation copies samples that could be concurrently overwritten by the signal handler,
+    // and detects that afterwards, which TSAN reports as races.
+    LOG(INFO) << "Sampling profiler is disabled in TSAN builds";
+    return Status::OK();
+  }
+  SamplingProfiler* profiler;
+  {
+    std::lock_guard<std::mutex> lock(g_profiler_mutex);
+    profiler = g_profiler.load(std::memory_order_acquire);
+    if (profiler == nullptr) {
+      profiler = new SamplingProfiler(FLAGS_sampling_profiler_buffer_size);
+      g_profiler.store(profiler, std::memory_order_release);
+    }
+  }
+  return profiler->Start(FLAGS_sampling_profiler_frequency_hz);
+}
+
+void StopSamplingProfiler() {
+  SamplingProfiler* profiler = g_profiler.load(std::memory_order_acquire);
+  if (profiler != nullptr) {
+    profiler->Stop();
+  }
+}
+
+void DumpSamplingProfile(std::ostream* out, bool reset) {
+  SamplingProfiler* profiler = g_profiler.load(std::memory_order_acquire);
+  if (profiler != nullptr) {
+    profiler->Dump(out, reset);
+  }
+}
+
+void ScopedProfilerTag::Enter(const Slice& service, const Slice& method) {
+  had_tags_ = tls_tagged;
+  if (had_tags_) {
+    memcpy(&saved_tags_, &tls_tags, sizeof(saved_tags_));
+  }
+  tls_tagged = false;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  CopyTag(service, tls_tags.service);
+  CopyTag(method, tls_tags.method);
+  tls_tags.tablet[0] = 0;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  tls_tagged = true;
+}
+
+void ScopedProfilerTag::Exit() {
+  tls_tagged = false;
+  if (had_tags_) {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    memcpy(&tls_tags, &saved_tags_, sizeof(tls_tags));
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    tls_tagged = true;
+  }
+}
+
+void ScopedProfilerTag::DoSetTablet(const Slice& tablet_id) {
+  if (!tls_tagged) {
+    return;
+  }
+  tls_tagged = false;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  CopyTag(tablet_id, tls_tags.tablet);
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  tls_tagged = true;
+}
+
+} // namespace yb
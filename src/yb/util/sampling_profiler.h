@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SAMPLING_PROFILER_H
+#define YB_UTIL_SAMPLING_PROFILER_H
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+// Continuous sampling profiler, that attributes CPU time to the work a thread is doing. Disabled by
+// default, see the sampling_profiler_enabled flag and the note on stack unwinding below.
+//
+// Threads tag themselves with the (service, method, tablet) they are working on, using
+// ScopedProfilerTag. The profiler arms a timer that fires every 1/frequency seconds of CPU time
+// consumed by the process. The signal is delivered to the thread that consumed the time, which
+// records its current tags and stack into a lock-free ring buffer. A background thread drains
+// the ring and aggregates identical samples, the aggregate could be dumped in the "folded stacks"
+// format used by flame graph tools:
+//
+//   <service>;<method>;<tablet>;<outermost frame>;...;<innermost frame> <number of samples>
+//
+// The stacks are symbolized only when they are dumped, so a sample costs only the stack unwinding.
+//
+// The signal handler unwinds the stack with libunwind directly, rather than with glog's
+// GetStackTrace(), whose process-wide reentrancy guard would leave the samples taken while another
+// thread is unwinding its stack without frames. Samples that still get no frames keep their tags
+// and are reported with "(no stack)" in place of the frames.
+//
+// Local unwinding does not allocate, but looks up the unwind info of the loaded objects under the
+// dynamic loader lock. So a sample that interrupts a thread holding that lock, e.g. in dlopen() or
+// while throwing an exception, deadlocks that thread. This is why the profiler is not enabled by
+// default. Its CPU overhead is measured by SamplingProfilerTest.Overhead.
+
+// Starts the profiler with the parameters from the sampling_profiler_* flags. Does nothing if the
+// profiler is disabled by the flags, or is already running.
+CHECKED_STATUS StartSamplingProfiler();
+
+// Stops the profiler. Samples aggregated so far are kept.
+void StopSamplingProfiler();
+
+// Writes the aggregated samples to 'out', in the folded stacks format described above.
+// If reset is true, the aggregated samples are dropped after being written.
+void DumpSamplingProfile(std::ostream* out, bool reset);
+
+namespace internal {
+
+// Tags of the work a thread is doing. It has a fixed size, so that the signal handler could copy
+// it without allocations.
+struct ProfilerTags {
+  char service[48];
+  char method[48];
+  char tablet[40];
+};
+
+// Whether the profiler is running. Threads tag their work only while it is.
+extern std::atomic<bool> sampling_profiler_running;
+
+} // namespace internal
+
+// Tags the samples taken on the current thread while this object is alive. Tags are copied, and
+// truncated if they are too long. Nested tags replace the outer ones, which are restored when the
+// nested tag goes out of scope. Costs only a check of a flag while the profiler is not running.
+class ScopedProfilerTag {
+ public:
+  ScopedProfilerTag(const Slice& service, const Slice& method)
+      : active_(internal::sampling_profiler_running.load(std::memory_order_relaxed)) {
+    if (active_) {
+      Enter(service, method);
+    }
+  }
+
+  ~ScopedProfilerTag() {
+    if (active_) {
+      Exit();
+    }
+  }
+
+  // Sets the tablet in the tags of the current thread, until the innermost ScopedProfilerTag goes
+  // out of scope. Does nothing if the thread is not tagged.
+  static void SetTablet(const Slice& tablet_id) {
+    if (internal::sampling_profiler_running.load(std::memory_order_relaxed)) {
+      DoSetTablet(tablet_id);
+    }
+  }
+
+ private:
+  void Enter(const Slice& service, const Slice& method);
+  void Exit();
+  static void DoSetTablet(const Slice& tablet_id);
+
+  const bool active_;
+  bool had_tags_;
+  internal::ProfilerTags saved_tags_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedProfilerTag);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SAMPLING_PROFILER_H
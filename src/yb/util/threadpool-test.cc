@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <limits>
@@ -669,7 +670,9 @@ TEST_P(TestThreadPoolTokenTypes, TestTokenSubmissionsAdhereToMaxQueueSize) {
   ASSERT_TRUE(s.IsServiceUnavailable());
 }
 
-TEST_F(TestThreadPool, TestTokenConcurrency) {
+namespace {
+
+void TestTokenConcurrency(bool work_stealing) {
   const int kNumTokens = 20;
   const int kTestRuntimeSecs = 1;
   const int kCycleThreads = 2;
@@ -679,6 +682,7 @@ TEST_F(TestThreadPool, TestTokenConcurrency) {
 
   gscoped_ptr<ThreadPool> thread_pool;
   ASSERT_OK(ThreadPoolBuilder("test")
+                .set_work_stealing(work_stealing)
                 .Build(&thread_pool));
   vector<shared_ptr<ThreadPoolToken>> tokens;
   Random rng(SeedRandom());
@@ -798,4 +802,332 @@ TEST_F(TestThreadPool, TestTokenConcurrency) {
                           kSubmitThreads, total_num_tokens_submitted.load());
 }
 
+} // namespace
+
+TEST_F(TestThreadPool, TestTokenConcurrency) {
+  TestTokenConcurrency(false /* work_stealing */);
+}
+
+TEST_F(TestThreadPool, TestWorkStealingTokenConcurrency) {
+  TestTokenConcurrency(true /* work_stealing */);
+}
+
+TEST_F(TestThreadPool, TestWorkStealingSimpleTasks) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_min_threads(4)
+                .set_max_threads(4)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  Atomic32 counter(0);
+  std::shared_ptr<Runnable> task(new SimpleTask(15, &counter));
+
+  ASSERT_OK(thread_pool->SubmitFunc(std::bind(&SimpleTaskMethod, 10, &counter)));
+  ASSERT_OK(thread_pool->Submit(task));
+  ASSERT_OK(thread_pool->SubmitFunc(std::bind(&SimpleTaskMethod, 20, &counter)));
+  ASSERT_OK(thread_pool->Submit(task));
+  ASSERT_OK(thread_pool->SubmitClosure(Bind(&SimpleTaskMethod, 123, &counter)));
+  thread_pool->Wait();
+  ASSERT_EQ(10 + 15 + 20 + 15 + 123, base::subtle::NoBarrier_Load(&counter));
+  thread_pool->Shutdown();
+  ASSERT_TRUE(thread_pool->SubmitFunc([](){}).IsServiceUnavailable());
+}
+
+TEST_F(TestThreadPool, TestWorkStealingMaxQueueSize) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_min_threads(1)
+                .set_max_threads(1)
+                .set_max_queue_size(1)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  // Running tasks are counted together with the queued ones, so the result does not depend on
+  // whether the worker has picked the first task yet.
+  CountDownLatch latch(1);
+  ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+  ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+  Status s = thread_pool->Submit(SlowTask::NewSlowTask(&latch));
+  ASSERT_TRUE(s.IsServiceUnavailable()) << s;
+  latch.CountDown();
+  thread_pool->Wait();
+  ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+  thread_pool->Shutdown();
+}
+
+// Several threads submit to the same SERIAL tokens, while tokenless tasks keep the workers busy.
+// The tasks of a token should never overlap and should run in the order they were submitted.
+TEST_F(TestThreadPool, TestWorkStealingSerialTokens) {
+  const int kNumTokens = 4;
+  const int kNumSubmitters = 4;
+  const int kTasksPerSubmitter = 2000;
+
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(8)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  struct TokenState {
+    unique_ptr<ThreadPoolToken> token;
+    atomic<bool> running{false};
+    atomic<int> overlaps{0};
+    // Last sequence number seen from each submitter. Only accessed by the token's tasks.
+    vector<int> last_seq = vector<int>(kNumSubmitters, -1);
+    atomic<int> out_of_order{0};
+  };
+  vector<unique_ptr<TokenState>> tokens;
+  for (int i = 0; i < kNumTokens; i++) {
+    tokens.emplace_back(new TokenState);
+    tokens.back()->token = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  }
+
+  atomic<int> tokenless_tasks(0);
+  vector<thread> threads;
+  for (int submitter = 0; submitter < kNumSubmitters; submitter++) {
+    threads.emplace_back([&, submitter]() {
+      for (int seq = 0; seq < kTasksPerSubmitter; seq++) {
+        auto* state = tokens[seq % kNumTokens].get();
+        ASSERT_OK(state->token->SubmitFunc([state, submitter, seq]() {
+          if (state->running.exchange(true)) {
+            state->overlaps++;
+          }
+          if (state->last_seq[submitter] >= seq) {
+            state->out_of_order++;
+          }
+          state->last_seq[submitter] = seq;
+          state->running = false;
+        }));
+        ASSERT_OK(thread_pool->SubmitFunc([&tokenless_tasks]() { tokenless_tasks++; }));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  thread_pool->Wait();
+
+  ASSERT_EQ(kNumSubmitters * kTasksPerSubmitter, tokenless_tasks.load());
+  for (int i = 0; i < kNumTokens; i++) {
+    const auto& state = *tokens[i];
+    ASSERT_EQ(0, state.overlaps.load());
+    ASSERT_EQ(0, state.out_of_order.load());
+    for (int submitter = 0; submitter < kNumSubmitters; submitter++) {
+      ASSERT_EQ(kTasksPerSubmitter - kNumTokens + i, state.last_seq[submitter]);
+    }
+  }
+}
+
+// Tasks submitted by the workers go to their own queues, from which idle workers steal them.
+TEST_F(TestThreadPool, TestWorkStealingSubmitFromWorkers) {
+  const int kDepth = 12;
+
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(4)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  atomic<int> num_tasks(0);
+  std::function<void(int)> spawn = [&](int depth) {
+    num_tasks++;
+    if (depth == 0) {
+      return;
+    }
+    for (int i = 0; i < 2; i++) {
+      ASSERT_OK(thread_pool->SubmitFunc(std::bind(spawn, depth - 1)));
+    }
+  };
+  ASSERT_OK(thread_pool->SubmitFunc(std::bind(spawn, kDepth)));
+  thread_pool->Wait();
+  ASSERT_EQ((1 << (kDepth + 1)) - 1, num_tasks.load());
+}
+
+TEST_F(TestThreadPool, TestWorkStealingIdleWorkersRetire) {
+  constexpr size_t kMaxThreads = 4;
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_min_threads(1)
+                .set_max_threads(kMaxThreads)
+                .set_idle_timeout(MonoDelta::FromMilliseconds(1))
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+  ASSERT_EQ(1U, thread_pool->num_work_stealing_workers());
+
+  for (int round = 0; round != 2; ++round) {
+    // Every slow task takes a worker of its own.
+    CountDownLatch latch(1);
+    BOOST_SCOPE_EXIT(&latch) {
+        latch.CountDown();
+    } BOOST_SCOPE_EXIT_END;
+    for (size_t i = 0; i != kMaxThreads; ++i) {
+      ASSERT_OK(thread_pool->Submit(SlowTask::NewSlowTask(&latch)));
+    }
+    ASSERT_EQ(kMaxThreads, thread_pool->num_work_stealing_workers());
+    latch.CountDown();
+    thread_pool->Wait();
+
+    // The workers above min_threads retire once idle.
+    ASSERT_OK(WaitFor([&thread_pool] { return thread_pool->num_work_stealing_workers() == 1; },
+                      MonoDelta::FromSeconds(10), "Idle workers retired"));
+  }
+
+  // The remaining worker still runs tasks.
+  atomic<int> num_tasks(0);
+  ASSERT_OK(thread_pool->SubmitFunc([&num_tasks] { ++num_tasks; }));
+  thread_pool->Wait();
+  ASSERT_EQ(1, num_tasks.load());
+}
+
+// A task that keeps submitting tasks to the queue of its worker should not starve the tasks
+// submitted by other threads.
+TEST_F(TestThreadPool, TestWorkStealingInboxNotStarved) {
+  const int kMaxChainLength = 1000000;
+
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(1)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  atomic<int> chain_length(0);
+  atomic<bool> external_ran(false);
+  std::function<void()> chain = [&] {
+    if (++chain_length < kMaxChainLength && !external_ran.load()) {
+      ASSERT_OK(thread_pool->SubmitFunc(chain));
+    }
+  };
+  ASSERT_OK(thread_pool->SubmitFunc(chain));
+  while (chain_length.load() == 0) {
+    std::this_thread::yield();
+  }
+  ASSERT_OK(thread_pool->SubmitFunc([&external_ran] { external_ran = true; }));
+  thread_pool->Wait();
+  ASSERT_TRUE(external_ran.load());
+  ASSERT_LT(chain_length.load(), kMaxChainLength);
+}
+
+TEST_P(TestThreadPoolTokenTypes, TestWorkStealingTokenShutdown) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(4)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  unique_ptr<ThreadPoolToken> t1(thread_pool->NewToken(GetParam()));
+  unique_ptr<ThreadPoolToken> t2(thread_pool->NewToken(GetParam()));
+  CountDownLatch l1(1);
+  CountDownLatch l2(1);
+
+  // A violation to the tested invariant would yield a deadlock, so let's set
+  // up an alarm to bail us out.
+  alarm(60);
+  BOOST_SCOPE_EXIT(void) {
+                     alarm(0); // Disable alarm on test exit.
+  } BOOST_SCOPE_EXIT_END;
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_OK(t1->SubmitFunc([&]() {
+      l1.Wait();
+    }));
+  }
+  for (int i = 0; i < 3; i++) {
+    ASSERT_OK(t2->SubmitFunc([&]() {
+      l2.Wait();
+    }));
+  }
+
+  // Unblock all of t1's tasks, but not t2's tasks.
+  l1.CountDown();
+
+  // If this also waited for t2's tasks, it would deadlock.
+  t1->Shutdown();
+
+  // We can no longer submit to t1 but we can still submit to t2.
+  ASSERT_TRUE(t1->SubmitFunc([](){}).IsServiceUnavailable());
+  ASSERT_OK(t2->SubmitFunc([](){}));
+
+  // Unblock t2's tasks.
+  l2.CountDown();
+  t2->Shutdown();
+  thread_pool->Wait();
+}
+
+namespace {
+
+struct BenchmarkResult {
+  double tasks_per_sec;
+  int64_t p50_us;
+  int64_t p99_us;
+  int64_t p999_us;
+  int64_t max_us;
+};
+
+// Several threads submit short tasks, half of them without a token and half via SERIAL tokens, the
+// way the read and prepare pools are used. Measures the throughput and the time from submission
+// to the start of each task.
+void RunThroughputBenchmark(bool work_stealing, BenchmarkResult* result) {
+  const int kNumSubmitters = 4;
+  const int kTasksPerSubmitter = 50000;
+  const int kNumTasks = kNumSubmitters * kTasksPerSubmitter;
+
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("bench")
+                .set_max_threads(std::max(base::NumCPUs(), 2))
+                .set_work_stealing(work_stealing)
+                .Build(&thread_pool));
+
+  vector<int64_t> latencies(kNumTasks);
+  vector<unique_ptr<ThreadPoolToken>> tokens;
+  for (int i = 0; i < kNumSubmitters; i++) {
+    tokens.push_back(thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL));
+  }
+
+  MonoTime start = MonoTime::Now();
+  vector<thread> threads;
+  for (int submitter = 0; submitter < kNumSubmitters; submitter++) {
+    threads.emplace_back([&, submitter]() {
+      for (int i = 0; i < kTasksPerSubmitter; i++) {
+        int64_t* latency = &latencies[submitter * kTasksPerSubmitter + i];
+        auto task = [latency, submit_time = MonoTime::Now()]() {
+          *latency = (MonoTime::Now() - submit_time).ToMicroseconds();
+        };
+        if (i % 2 == 0) {
+          ASSERT_OK(thread_pool->SubmitFunc(task));
+        } else {
+          ASSERT_OK(tokens[submitter]->SubmitFunc(task));
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  thread_pool->Wait();
+  MonoDelta elapsed = MonoTime::Now() - start;
+  tokens.clear();
+  thread_pool->Shutdown();
+
+  std::sort(latencies.begin(), latencies.end());
+  result->tasks_per_sec = kNumTasks / elapsed.ToSeconds();
+  result->p50_us = latencies[kNumTasks / 2];
+  result->p99_us = latencies[kNumTasks * 99 / 100];
+  result->p999_us = latencies[kNumTasks * 999 / 1000];
+  result->max_us = latencies.back();
+}
+
+} // namespace
+
+TEST_F(TestThreadPool, TestThroughputAndLatency) {
+  for (bool work_stealing : {false, true}) {
+    BenchmarkResult result;
+    ASSERT_NO_FATALS(RunThroughputBenchmark(work_stealing, &result));
+    LOG(INFO) << Substitute(
+        "$0: $1 tasks/s, queue time p50: $2us, p99: $3us, p99.9: $4us, max: $5us",
+        work_stealing ? "Work stealing" : "Shared queue", static_cast<int64_t>(result.tasks_per_sec),
+        result.p50_us, result.p99_us, result.p999_us, result.max_us);
+  }
+}
+
 } // namespace yb
@@ -31,10 +31,19 @@
 //
 
 #include <algorithm>
+#include <condition_variable>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -45,17 +54,94 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
+#include "yb/util/work_stealing_queue.h"
+
+DEFINE_bool(thread_pool_numa_aware_workers, false,
+            "Whether the workers of thread pools that use work stealing are bound to the CPUs of "
+            "a single NUMA node, with the workers of each pool spread evenly over the nodes. "
+            "Such workers steal tasks from the workers on their own node first.");
+TAG_FLAG(thread_pool_numa_aware_workers, advanced);
 
 namespace yb {
 
 using strings::Substitute;
 using std::unique_ptr;
 
+namespace {
+
+// Parses a list of CPUs in the format of /sys/devices/system/node/node*/cpulist, e.g. "0-3,8-11".
+std::vector<int> ParseCpuList(const std::string& str) {
+  std::vector<int> result;
+  size_t pos = 0;
+  while (pos < str.size()) {
+    size_t end = str.find(',', pos);
+    if (end == std::string::npos) {
+      end = str.size();
+    }
+    std::string range = str.substr(pos, end - pos);
+    pos = end + 1;
+    if (range.empty() || !isdigit(range[0])) {
+      continue;
+    }
+    size_t dash = range.find('-');
+    int first = atoi(range.c_str());
+    int last = dash == std::string::npos ? first : atoi(range.c_str() + dash + 1);
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+// Returns the CPUs of each NUMA node, or nothing when the machine has a single node or its
+// topology is unknown.
+const std::vector<std::vector<int>>& NumaNodes() {
+  static const std::vector<std::vector<int>> nodes = [] {
+    std::vector<std::vector<int>> result;
+#if defined(__linux__)
+    for (int node = 0;; ++node) {
+      std::ifstream in(Substitute("/sys/devices/system/node/node$0/cpulist", node));
+      if (!in) {
+        break;
+      }
+      std::string line;
+      std::getline(in, line);
+      auto cpus = ParseCpuList(line);
+      if (!cpus.empty()) {
+        result.push_back(std::move(cpus));
+      }
+    }
+#endif
+    if (result.size() < 2) {
+      result.clear();
+    }
+    return result;
+  }();
+  return nodes;
+}
+
+void BindCurrentThreadToCpus(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    LOG(WARNING) << "Failed to bind thread to NUMA node CPUs: " << ErrnoToString(errno);
+  }
+#endif
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////
 // FunctionRunnable
 ////////////////////////////////////////////////////////
@@ -111,6 +197,11 @@ ThreadPoolBuilder& ThreadPoolBuilder::set_idle_timeout(const MonoDelta& idle_tim
   return *this;
 }
 
+ThreadPoolBuilder& ThreadPoolBuilder::set_work_stealing(bool work_stealing) {
+  work_stealing_ = work_stealing;
+  return *this;
+}
+
 Status ThreadPoolBuilder::Build(gscoped_ptr<ThreadPool>* pool) const {
   pool->reset(new ThreadPool(*this));
   RETURN_NOT_OK((*pool)->Init());
@@ -123,6 +214,696 @@ Status ThreadPoolBuilder::Build(unique_ptr<ThreadPool>* pool) const {
   return Status::OK();
 }
 
+////////////////////////////////////////////////////////
+// WorkStealingScheduler
+////////////////////////////////////////////////////////
+
+// Schedules the tasks of a pool built with work stealing.
+//
+// Every worker owns a WorkStealingQueue, and an inbox, that is a lock-free stack other threads push
+// to. Tasks submitted by a worker go to its own queue, other submitters spread tasks over the
+// inboxes. A worker runs the tasks from its queue first, then takes its whole inbox, then tries to
+// steal from the queues and inboxes of the other workers, and goes to sleep when there is nothing
+// to run. The worker also takes its inbox after every kMaxLocalPops items popped from its queue, so
+// that tasks which keep submitting new tasks to the worker queue do not starve other submitters.
+//
+// Counters of not yet completed tasks are kept for the pool and for each token. Such a counter
+// only drops to zero under the pool lock, so that whoever waits for it, and may destroy the token
+// right after that, could not miss the notification or see the counter before it is sent.
+//
+// Workers above min_threads retire after sleeping for idle_timeout, the most recently created one
+// first, and only while the pool has no pending tasks. So a retired worker never has items in its
+// queue or inbox, and submitters that could still pick it see that it is gone. The Worker object
+// stays, because thieves may still look at it, and is reused when a worker is created again.
+class ThreadPool::WorkStealingScheduler {
+ public:
+  // An entry of the worker queues. It is either a task submitted via a CONCURRENT token, or the
+  // turn of a SERIAL token, which runs the next task of the token.
+  struct Item {
+    // Link to the next item in an inbox.
+    Item* next = nullptr;
+    ThreadPoolToken* token = nullptr;
+    // Not used by the turns of SERIAL tokens.
+    Task task;
+  };
+
+  explicit WorkStealingScheduler(ThreadPool* pool);
+
+  // Starts the specified number of workers.
+  CHECKED_STATUS Init(int num_workers);
+
+  CHECKED_STATUS Submit(std::shared_ptr<Runnable> runnable, ThreadPoolToken* token);
+
+  // Rejects new tasks, waits for the running tasks to complete and drops the queued ones.
+  void Shutdown();
+
+  // Rejects new tasks submitted via the token and waits for its submitted tasks to complete or be
+  // dropped. Tasks of a CONCURRENT token that are already in the worker queues are dropped when a
+  // worker gets to them.
+  void ShutdownToken(ThreadPoolToken* token);
+
+  // Number of tasks that were submitted but not completed yet.
+  int64_t pending_tasks() const {
+    return pending_tasks_.load(std::memory_order_acquire);
+  }
+
+  bool IsWorkerThread() const;
+
+  size_t num_workers() const {
+    return num_workers_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Worker {
+    Worker(size_t worker_index, int worker_node)
+        : index(worker_index), node(worker_node), queue(kQueueCapacity) {}
+
+    const size_t index;
+    // NUMA node the worker is bound to, or -1.
+    const int node;
+    WorkStealingQueue<Item> queue;
+    std::atomic<Item*> inbox{nullptr};
+    // Where the next attempt to steal starts, so that thieves do not all go after the same worker.
+    size_t steal_start = 0;
+    // Number of items popped from the queue since the inbox was taken last time.
+    size_t local_pops = 0;
+  };
+
+  static constexpr size_t kQueueCapacity = 1024;
+
+  // Maximum number of items popped from the worker queue in a row, before the inbox is checked.
+  static constexpr size_t kMaxLocalPops = 32;
+
+  // Workers are created on demand, so this only limits the size of the table of workers for pools
+  // with practically no limit on the number of threads.
+  static constexpr size_t kMaxWorkers = 1024;
+
+  CHECKED_STATUS DoSubmit(std::shared_ptr<Runnable> runnable, ThreadPoolToken* token);
+
+  // Starts a new worker if there are more pending tasks than workers. Fails only if the pool has
+  // no workers at all.
+  CHECKED_STATUS MaybeCreateWorker(int64_t pending_tasks);
+  CHECKED_STATUS CreateWorkerUnlocked();
+
+  void WorkerMain(Worker* worker);
+
+  // Adds the item to the queue of the current worker, or to some inbox when called from a thread
+  // that is not a worker of this pool. Items that should wait for the other work of the current
+  // worker are always added to its inbox.
+  void Enqueue(Item* item, bool to_inbox);
+  static void PushInbox(Worker* worker, Item* item);
+
+  // Wakes up a sleeping worker, if any. Should be called after an item was added to a queue.
+  void WakeWorker();
+
+  Item* NextItem(Worker* worker);
+  Item* Steal(Worker* worker);
+
+  // Takes all items from the inbox of 'from'. Returns the oldest one, and adds the others to the
+  // queue of 'to', so that they are popped in the order they were submitted.
+  Item* TakeInbox(Worker* from, Worker* to);
+
+  bool HasWork() const;
+
+  // Sleeps until there is work to do. Returns false if the worker slept for the idle timeout of the
+  // pool and should try to retire.
+  bool Park(Worker* worker);
+
+  // Removes the worker from the pool, if it is the most recently created one above min_threads,
+  // and the pool has no pending tasks.
+  bool MaybeRetire(Worker* worker);
+
+  // Runs the item or, if 'run' is false, drops its tasks.
+  void Process(Item* item, bool run);
+  void ProcessTurn(ThreadPoolToken* token, bool run);
+  static void DropTask(Task* task);
+
+  // Subtracts delta from the counter, and broadcasts the condition if it drops to zero.
+  void DecrementPending(std::atomic<int64_t>* counter, int64_t delta, ConditionVariable* cond);
+
+  ThreadPool* const pool_;
+
+  // CPUs of each NUMA node, empty unless the workers are NUMA-aware.
+  const std::vector<std::vector<int>> numa_nodes_;
+
+  // Preallocated, so that it never changes while the workers scan it. The first num_workers_
+  // entries are set.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> num_workers_{0};
+
+  std::mutex create_mutex_;
+  // Protected by create_mutex_.
+  std::vector<scoped_refptr<Thread>> threads_;
+
+  std::atomic<int64_t> pending_tasks_{0};
+
+  // Number of Submit() calls in progress, so that Shutdown() could wait for them to complete.
+  std::atomic<int> submitting_{0};
+  std::atomic<bool> closing_{false};
+
+  std::mutex park_mutex_;
+  std::condition_variable park_cond_;
+  std::atomic<int> sleeping_{0};
+
+  static thread_local Worker* current_worker_;
+  static thread_local WorkStealingScheduler* current_scheduler_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingScheduler);
+};
+
+struct ThreadPoolToken::WorkStealingState {
+  explicit WorkStealingState(ThreadPoolToken* token) {
+    turn.token = token;
+  }
+
+  // Number of tasks submitted via the token that were not completed or dropped yet, plus one
+  // while the turn of a SERIAL token is scheduled.
+  std::atomic<int64_t> pending{0};
+
+  std::atomic<bool> shut_down{false};
+
+  // The fields below are only used by SERIAL tokens.
+  std::mutex mutex;
+
+  // Protected by mutex.
+  std::deque<ThreadPool::Task> entries;
+
+  // Whether the turn is in a worker queue or running. Protected by mutex.
+  bool scheduled = false;
+
+  ThreadPool::WorkStealingScheduler::Item turn;
+};
+
+constexpr size_t ThreadPool::WorkStealingScheduler::kQueueCapacity;
+constexpr size_t ThreadPool::WorkStealingScheduler::kMaxWorkers;
+constexpr size_t ThreadPool::WorkStealingScheduler::kMaxLocalPops;
+
+thread_local ThreadPool::WorkStealingScheduler::Worker*
+    ThreadPool::WorkStealingScheduler::current_worker_ = nullptr;
+thread_local ThreadPool::WorkStealingScheduler*
+    ThreadPool::WorkStealingScheduler::current_scheduler_ = nullptr;
+
+ThreadPool::WorkStealingScheduler::WorkStealingScheduler(ThreadPool* pool)
+    : pool_(pool),
+      numa_nodes_(FLAGS_thread_pool_numa_aware_workers ? NumaNodes()
+                                                       : std::vector<std::vector<int>>()),
+      workers_(std::min<size_t>(pool->max_threads_, kMaxWorkers)) {
+}
+
+Status ThreadPool::WorkStealingScheduler::Init(int num_workers) {
+  std::lock_guard<std::mutex> lock(create_mutex_);
+  for (int i = 0; i < num_workers && num_workers_.load() < workers_.size(); ++i) {
+    RETURN_NOT_OK(CreateWorkerUnlocked());
+  }
+  return Status::OK();
+}
+
+bool ThreadPool::WorkStealingScheduler::IsWorkerThread() const {
+  return current_scheduler_ == this;
+}
+
+Status ThreadPool::WorkStealingScheduler::Submit(
+    std::shared_ptr<Runnable> runnable, ThreadPoolToken* token) {
+  submitting_.fetch_add(1, std::memory_order_seq_cst);
+  Status status = DoSubmit(std::move(runnable), token);
+  submitting_.fetch_sub(1, std::memory_order_release);
+  return status;
+}
+
+Status ThreadPool::WorkStealingScheduler::DoSubmit(
+    std::shared_ptr<Runnable> runnable, ThreadPoolToken* token) {
+  MonoTime submit_time = MonoTime::Now();
+  if (PREDICT_FALSE(closing_.load(std::memory_order_seq_cst))) {
+    return STATUS(ServiceUnavailable, "The pool has been shut down.");
+  }
+
+  auto* state = token->work_stealing_state_.get();
+  // The counter is incremented before checking the flag, so that ShutdownToken() either waits for
+  // this task or we see that the token was shut down.
+  state->pending.fetch_add(1, std::memory_order_seq_cst);
+  if (PREDICT_FALSE(state->shut_down.load(std::memory_order_seq_cst))) {
+    DecrementPending(&state->pending, 1, &token->not_running_cond_);
+    return STATUS(ServiceUnavailable, "Thread pool token was shut down.", "", ESHUTDOWN);
+  }
+
+  // Size limit check.
+  const int64_t capacity = static_cast<int64_t>(pool_->max_threads_) + pool_->max_queue_size_;
+  // Sequentially consistent, so that either a retiring worker sees this task, or we see that the
+  // worker is gone. See MaybeRetire().
+  int64_t length_at_submit = pending_tasks_.fetch_add(1, std::memory_order_seq_cst);
+  Status status;
+  if (length_at_submit >= capacity) {
+    status = STATUS(ServiceUnavailable,
+                    Substitute("Thread pool is at capacity ($0/$1 tasks pending)",
+                               length_at_submit, capacity),
+                    "", ESHUTDOWN);
+  } else {
+    status = MaybeCreateWorker(length_at_submit + 1);
+  }
+  if (!status.ok()) {
+    DecrementPending(&pending_tasks_, 1, &pool_->idle_cond_);
+    DecrementPending(&state->pending, 1, &token->not_running_cond_);
+    return status;
+  }
+
+  Task task;
+  task.runnable = std::move(runnable);
+  task.trace = Trace::CurrentTrace();
+  // Need to AddRef, since the thread which submitted the task may go away,
+  // and we don't want the trace to be destructed while waiting in the queue.
+  if (task.trace) {
+    task.trace->AddRef();
+  }
+  task.submit_time = submit_time;
+
+  if (token->mode() == ExecutionMode::SERIAL) {
+    bool schedule = false;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->entries.push_back(std::move(task));
+      if (!state->scheduled) {
+        state->scheduled = true;
+        state->pending.fetch_add(1, std::memory_order_relaxed);
+        schedule = true;
+      }
+    }
+    if (schedule) {
+      Enqueue(&state->turn, /* to_inbox= */ false);
+    }
+  } else {
+    auto* item = new Item;
+    item->token = token;
+    item->task = std::move(task);
+    Enqueue(item, /* to_inbox= */ false);
+  }
+
+  if (pool_->metrics_.queue_length_histogram) {
+    pool_->metrics_.queue_length_histogram->Increment(length_at_submit);
+  }
+  if (token->metrics_.queue_length_histogram) {
+    token->metrics_.queue_length_histogram->Increment(length_at_submit);
+  }
+
+  return Status::OK();
+}
+
+Status ThreadPool::WorkStealingScheduler::MaybeCreateWorker(int64_t pending_tasks) {
+  // Same as with the shared queue, we assume that each worker will take one pending task.
+  size_t num_workers = num_workers_.load(std::memory_order_seq_cst);
+  if (num_workers != 0 &&
+      (pending_tasks <= static_cast<int64_t>(num_workers) || num_workers == workers_.size())) {
+    return Status::OK();
+  }
+
+  std::lock_guard<std::mutex> lock(create_mutex_);
+  num_workers = num_workers_.load(std::memory_order_relaxed);
+  if (num_workers == workers_.size() ||
+      (num_workers != 0 && pending_tasks <= static_cast<int64_t>(num_workers))) {
+    return Status::OK();
+  }
+  Status status = CreateWorkerUnlocked();
+  if (!status.ok()) {
+    if (num_workers == 0) {
+      // If we have no threads, we can't do any work.
+      return status;
+    }
+    // If we failed to create a thread, but there are still some other
+    // worker threads, log a warning message and continue.
+    LOG(WARNING) << "Thread pool failed to create thread: " << status.ToString();
+  }
+  return Status::OK();
+}
+
+Status ThreadPool::WorkStealingScheduler::CreateWorkerUnlocked() {
+  size_t index = num_workers_.load(std::memory_order_relaxed);
+  DCHECK_LT(index, workers_.size());
+  // The worker of a retired thread is reused, since other workers could still be stealing from it.
+  if (!workers_[index]) {
+    int node = numa_nodes_.empty() ? -1 : static_cast<int>(index % numa_nodes_.size());
+    workers_[index].reset(new Worker(index, node));
+  }
+  scoped_refptr<Thread> thread;
+  RETURN_NOT_OK(yb::Thread::Create(
+      "thread pool", Substitute("$0 [worker]", pool_->name_),
+      &WorkStealingScheduler::WorkerMain, this, workers_[index].get(), &thread));
+  threads_.push_back(std::move(thread));
+  num_workers_.store(index + 1, std::memory_order_release);
+  return Status::OK();
+}
+
+void ThreadPool::WorkStealingScheduler::WorkerMain(Worker* worker) {
+  current_worker_ = worker;
+  current_scheduler_ = this;
+  if (worker->node >= 0) {
+    BindCurrentThreadToCpus(numa_nodes_[worker->node]);
+  }
+
+  while (!closing_.load(std::memory_order_acquire)) {
+    Item* item = NextItem(worker);
+    if (!item) {
+      // Give the submitters a chance before going to sleep.
+      std::this_thread::yield();
+      item = NextItem(worker);
+    }
+    if (!item) {
+      if (!Park(worker) && MaybeRetire(worker)) {
+        break;
+      }
+      continue;
+    }
+    Process(item, /* run= */ true);
+  }
+
+  current_worker_ = nullptr;
+  current_scheduler_ = nullptr;
+}
+
+void ThreadPool::WorkStealingScheduler::Enqueue(Item* item, bool to_inbox) {
+  if (current_scheduler_ == this) {
+    if (to_inbox || !current_worker_->queue.Push(item)) {
+      PushInbox(current_worker_, item);
+    }
+  } else {
+    // Spread the items over the inboxes, without a shared counter that all submitters would
+    // contend on.
+    static thread_local size_t next_inbox = std::hash<std::thread::id>()(
+        std::this_thread::get_id());
+    size_t num_workers = num_workers_.load(std::memory_order_seq_cst);
+    DCHECK_GT(num_workers, 0);
+    PushInbox(workers_[next_inbox++ % num_workers].get(), item);
+  }
+  WakeWorker();
+}
+
+void ThreadPool::WorkStealingScheduler::PushInbox(Worker* worker, Item* item) {
+  Item* head = worker->inbox.load(std::memory_order_relaxed);
+  do {
+    item->next = head;
+  } while (!worker->inbox.compare_exchange_weak(
+               head, item, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ThreadPool::WorkStealingScheduler::WakeWorker() {
+  // Pairs with the fence in Park(): either the worker sees the new item, or we see that it sleeps.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed) > 0) {
+    {
+      std::lock_guard<std::mutex> lock(park_mutex_);
+    }
+    park_cond_.notify_one();
+  }
+}
+
+ThreadPool::WorkStealingScheduler::Item* ThreadPool::WorkStealingScheduler::NextItem(
+    Worker* worker) {
+  Item* item;
+  if (worker->local_pops >= kMaxLocalPops) {
+    worker->local_pops = 0;
+    item = TakeInbox(worker, worker);
+    if (item) {
+      return item;
+    }
+  }
+  item = worker->queue.Pop();
+  if (item) {
+    ++worker->local_pops;
+    return item;
+  }
+  worker->local_pops = 0;
+  item = TakeInbox(worker, worker);
+  if (item) {
+    return item;
+  }
+  return Steal(worker);
+}
+
+ThreadPool::WorkStealingScheduler::Item* ThreadPool::WorkStealingScheduler::Steal(
+    Worker* worker) {
+  size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  if (num_workers < 2) {
+    return nullptr;
+  }
+  size_t start = worker->steal_start++;
+  // NUMA-aware workers try the workers on their own node during the first pass.
+  for (int pass = numa_nodes_.empty() ? 1 : 0; pass != 2; ++pass) {
+    for (size_t i = 0; i != num_workers; ++i) {
+      Worker* victim = workers_[(start + i) % num_workers].get();
+      if (victim == worker || (pass == 0 && victim->node != worker->node)) {
+        continue;
+      }
+      Item* item = victim->queue.Steal();
+      if (!item) {
+        item = TakeInbox(victim, worker);
+      }
+      if (item) {
+        return item;
+      }
+    }
+  }
+  return nullptr;
+}
+
+ThreadPool::WorkStealingScheduler::Item* ThreadPool::WorkStealingScheduler::TakeInbox(
+    Worker* from, Worker* to) {
+  if (from->inbox.load(std::memory_order_relaxed) == nullptr) {
+    return nullptr;
+  }
+  Item* item = from->inbox.exchange(nullptr, std::memory_order_acquire);
+  if (!item) {
+    return nullptr;
+  }
+  // The inbox is a stack, so the list starts with the most recent item. Pushing them in this
+  // order makes Pop() return the oldest one first.
+  bool moved = item->next != nullptr;
+  while (item->next) {
+    Item* next = item->next;
+    item->next = nullptr;
+    if (!to->queue.Push(item)) {
+      PushInbox(to, item);
+    }
+    item = next;
+  }
+  if (moved) {
+    // Let idle workers steal the rest of the batch.
+    WakeWorker();
+  }
+  return item;
+}
+
+bool ThreadPool::WorkStealingScheduler::HasWork() const {
+  size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i != num_workers; ++i) {
+    const Worker& worker = *workers_[i];
+    if (!worker.queue.Empty() || worker.inbox.load(std::memory_order_acquire) != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::WorkStealingScheduler::Park(Worker* worker) {
+  const bool may_retire = worker->index >= static_cast<size_t>(pool_->min_threads_) &&
+                          pool_->idle_timeout_.Initialized();
+  bool woken_up = true;
+  std::unique_lock<std::mutex> lock(park_mutex_);
+  sleeping_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!closing_.load(std::memory_order_acquire) && !HasWork()) {
+    if (may_retire) {
+      woken_up = park_cond_.wait_for(
+          lock, std::chrono::microseconds(pool_->idle_timeout_.ToMicroseconds())) ==
+          std::cv_status::no_timeout;
+    } else {
+      park_cond_.wait(lock);
+    }
+  }
+  sleeping_.fetch_sub(1, std::memory_order_relaxed);
+  return woken_up;
+}
+
+bool ThreadPool::WorkStealingScheduler::MaybeRetire(Worker* worker) {
+  std::lock_guard<std::mutex> lock(create_mutex_);
+  const size_t num_workers = num_workers_.load(std::memory_order_relaxed);
+  if (worker->index + 1 != num_workers ||
+      num_workers <= static_cast<size_t>(pool_->min_threads_) ||
+      closing_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  // Pairs with the increment of pending_tasks_ in DoSubmit(), and with the loads of num_workers_
+  // that follow it.
+  num_workers_.store(num_workers - 1, std::memory_order_seq_cst);
+  if (pending_tasks_.load(std::memory_order_seq_cst) != 0) {
+    num_workers_.store(num_workers, std::memory_order_release);
+    return false;
+  }
+
+  auto it = std::find_if(
+      threads_.begin(), threads_.end(),
+      [](const scoped_refptr<Thread>& thread) { return thread.get() == Thread::current_thread(); });
+  if (it != threads_.end()) {
+    threads_.erase(it);
+  }
+  VLOG(3) << "Releasing worker thread from pool " << pool_->name_ << " after "
+          << pool_->idle_timeout_.ToMilliseconds() << "ms of idle time.";
+  return true;
+}
+
+void ThreadPool::WorkStealingScheduler::Process(Item* item, bool run) {
+  ThreadPoolToken* token = item->token;
+  if (token->mode() == ExecutionMode::SERIAL) {
+    ProcessTurn(token, run);
+    return;
+  }
+
+  std::unique_ptr<Item> holder(item);
+  auto* state = token->work_stealing_state_.get();
+  if (run && !state->shut_down.load(std::memory_order_acquire)) {
+    pool_->RunTask(&item->task, token);
+  } else {
+    DropTask(&item->task);
+  }
+  DecrementPending(&state->pending, 1, &token->not_running_cond_);
+  DecrementPending(&pending_tasks_, 1, &pool_->idle_cond_);
+}
+
+void ThreadPool::WorkStealingScheduler::ProcessTurn(ThreadPoolToken* token, bool run) {
+  auto* state = token->work_stealing_state_.get();
+  Task task;
+  bool has_task = false;
+  std::deque<Task> dropped;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (run && !state->shut_down.load(std::memory_order_acquire) && !state->entries.empty()) {
+      task = std::move(state->entries.front());
+      state->entries.pop_front();
+      has_task = true;
+    } else {
+      dropped.swap(state->entries);
+      state->scheduled = false;
+    }
+  }
+
+  if (has_task) {
+    pool_->RunTask(&task, token);
+    bool requeue;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      requeue = !state->entries.empty();
+      if (!requeue) {
+        state->scheduled = false;
+      }
+    }
+    if (requeue) {
+      // Let the other work of this worker run before the next task of the token.
+      Enqueue(&state->turn, /* to_inbox= */ true);
+    }
+    // This is the last time we touch the token, unless the turn was requeued it could be
+    // destroyed right after that.
+    DecrementPending(&state->pending, requeue ? 1 : 2, &token->not_running_cond_);
+    DecrementPending(&pending_tasks_, 1, &pool_->idle_cond_);
+    return;
+  }
+
+  for (auto& dropped_task : dropped) {
+    DropTask(&dropped_task);
+  }
+  int64_t num_dropped = dropped.size();
+  DecrementPending(&state->pending, num_dropped + 1, &token->not_running_cond_);
+  if (num_dropped) {
+    DecrementPending(&pending_tasks_, num_dropped, &pool_->idle_cond_);
+  }
+}
+
+void ThreadPool::WorkStealingScheduler::DropTask(Task* task) {
+  if (task->trace) {
+    task->trace->Release();
+  }
+  task->runnable.reset();
+}
+
+void ThreadPool::WorkStealingScheduler::DecrementPending(
+    std::atomic<int64_t>* counter, int64_t delta, ConditionVariable* cond) {
+  int64_t value = counter->load(std::memory_order_acquire);
+  for (;;) {
+    DCHECK_GE(value, delta);
+    if (value == delta) {
+      MutexLock lock(pool_->lock_);
+      if (counter->fetch_sub(delta, std::memory_order_acq_rel) == delta) {
+        cond->Broadcast();
+      }
+      return;
+    }
+    if (counter->compare_exchange_weak(value, value - delta, std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::WorkStealingScheduler::ShutdownToken(ThreadPoolToken* token) {
+  auto* state = token->work_stealing_state_.get();
+  state->shut_down.store(true, std::memory_order_seq_cst);
+
+  // Release the queued tasks of a SERIAL token right away. A scheduled turn finds the token shut
+  // down and completes.
+  std::deque<Task> dropped;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    dropped.swap(state->entries);
+  }
+  for (auto& task : dropped) {
+    DropTask(&task);
+  }
+  int64_t num_dropped = dropped.size();
+  if (num_dropped) {
+    DecrementPending(&state->pending, num_dropped, &token->not_running_cond_);
+    DecrementPending(&pending_tasks_, num_dropped, &pool_->idle_cond_);
+  }
+
+  MutexLock lock(pool_->lock_);
+  while (state->pending.load(std::memory_order_acquire) > 0) {
+    token->not_running_cond_.Wait();
+  }
+}
+
+void ThreadPool::WorkStealingScheduler::Shutdown() {
+  closing_.store(true, std::memory_order_seq_cst);
+  {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+  }
+  park_cond_.notify_all();
+
+  // Let the submissions in progress complete, so that nothing is added to the queues after they
+  // are drained below.
+  while (submitting_.load(std::memory_order_acquire) > 0) {
+    std::this_thread::yield();
+  }
+
+  std::vector<scoped_refptr<Thread>> threads;
+  {
+    std::lock_guard<std::mutex> lock(create_mutex_);
+    threads.swap(threads_);
+  }
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+
+  // The workers are gone, drop the items left in their queues.
+  size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i != num_workers; ++i) {
+    Worker* worker = workers_[i].get();
+    while (Item* item = worker->queue.Pop()) {
+      Process(item, /* run= */ false);
+    }
+    Item* item = worker->inbox.exchange(nullptr, std::memory_order_acquire);
+    while (item) {
+      Item* next = item->next;
+      item->next = nullptr;
+      Process(item, /* run= */ false);
+      item = next;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////
 // ThreadPoolToken
 ////////////////////////////////////////////////////////
@@ -135,7 +916,8 @@ ThreadPoolToken::ThreadPoolToken(ThreadPool* pool,
       metrics_(std::move(metrics)),
       state_(ThreadPoolTokenState::kIdle),
       not_running_cond_(&pool->lock_),
-      active_threads_(0) {
+      active_threads_(0),
+      work_stealing_state_(pool->work_stealing_ ? new WorkStealingState(this) : nullptr) {
 }
 
 ThreadPoolToken::~ThreadPoolToken() {
@@ -156,6 +938,15 @@ Status ThreadPoolToken::Submit(std::shared_ptr<Runnable> r) {
 }
 
 void ThreadPoolToken::Shutdown() {
+  if (work_stealing_state_) {
+    {
+      MutexLock lock(pool_->lock_);
+      pool_->CheckNotPoolThreadUnlocked();
+    }
+    pool_->work_stealing_->ShutdownToken(this);
+    return;
+  }
+
   MutexLock unique_lock(pool_->lock_);
   pool_->CheckNotPoolThreadUnlocked();
 
@@ -218,7 +1009,7 @@ void ThreadPoolToken::Shutdown() {
 void ThreadPoolToken::Wait() {
   MutexLock unique_lock(pool_->lock_);
   pool_->CheckNotPoolThreadUnlocked();
-  while (IsActive()) {
+  while (HasPendingTasks()) {
     not_running_cond_.Wait();
   }
 }
@@ -230,7 +1021,7 @@ bool ThreadPoolToken::WaitUntil(const MonoTime& until) {
 bool ThreadPoolToken::WaitFor(const MonoDelta& delta) {
   MutexLock unique_lock(pool_->lock_);
   pool_->CheckNotPoolThreadUnlocked();
-  while (IsActive()) {
+  while (HasPendingTasks()) {
     if (!not_running_cond_.TimedWait(delta)) {
       return false;
     }
@@ -238,6 +1029,13 @@ bool ThreadPoolToken::WaitFor(const MonoDelta& delta) {
   return true;
 }
 
+bool ThreadPoolToken::HasPendingTasks() const {
+  if (work_stealing_state_) {
+    return work_stealing_state_->pending.load(std::memory_order_acquire) > 0;
+  }
+  return IsActive();
+}
+
 void ThreadPoolToken::Transition(ThreadPoolTokenState new_state) {
 #ifndef NDEBUG
   CHECK_NE(state_, new_state);
@@ -314,8 +1112,11 @@ ThreadPool::ThreadPool(const ThreadPoolBuilder& builder)
     num_threads_(0),
     active_threads_(0),
     total_queued_tasks_(0),
-    tokenless_(NewToken(ExecutionMode::CONCURRENT)),
     metrics_(builder.metrics_) {
+  if (builder.work_stealing_) {
+    work_stealing_.reset(new WorkStealingScheduler(this));
+  }
+  tokenless_ = NewToken(ExecutionMode::CONCURRENT);
 }
 
 ThreadPool::~ThreadPool() {
@@ -324,6 +1125,8 @@ ThreadPool::~ThreadPool() {
       "Threadpool $0 destroyed with $1 allocated tokens",
       name_, tokens_.size());
   Shutdown();
+  // The token refers to the scheduler, so it should go first.
+  tokenless_.reset();
 }
 
 Status ThreadPool::Init() {
@@ -332,6 +1135,14 @@ Status ThreadPool::Init() {
     return STATUS(NotSupported, "The thread pool is already initialized");
   }
   pool_status_ = Status::OK();
+  if (work_stealing_) {
+    unique_lock.Unlock();
+    Status status = work_stealing_->Init(min_threads_);
+    if (!status.ok()) {
+      Shutdown();
+    }
+    return status;
+  }
   for (int i = 0; i < min_threads_; i++) {
     Status status = CreateThreadUnlocked();
     if (!status.ok()) {
@@ -346,6 +1157,13 @@ void ThreadPool::Shutdown() {
   MutexLock unique_lock(lock_);
   CheckNotPoolThreadUnlocked();
 
+  if (work_stealing_) {
+    pool_status_ = STATUS(ServiceUnavailable, "The pool has been shut down.");
+    unique_lock.Unlock();
+    work_stealing_->Shutdown();
+    return;
+  }
+
   // Note: this is the same error seen at submission if the pool is at
   // capacity, so clients can't tell them apart. This isn't really a practical
   // concern though because shutting down a pool typically requires clients to
@@ -443,6 +1261,10 @@ Status ThreadPool::Submit(const std::shared_ptr<Runnable>& r) {
 
 Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToken* token) {
   DCHECK(token);
+  if (work_stealing_) {
+    return work_stealing_->Submit(task, token);
+  }
+
   MonoTime submit_time = MonoTime::Now();
 
   MutexLock guard(lock_);
@@ -530,7 +1352,7 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
 
 void ThreadPool::Wait() {
   MutexLock unique_lock(lock_);
-  while ((!queue_.empty()) || (active_threads_ > 0)) {
+  while (!IsIdleUnlocked()) {
     idle_cond_.Wait();
   }
 }
@@ -542,7 +1364,7 @@ bool ThreadPool::WaitUntil(const MonoTime& until) {
 
 bool ThreadPool::WaitFor(const MonoDelta& delta) {
   MutexLock unique_lock(lock_);
-  while ((!queue_.empty()) || (active_threads_ > 0)) {
+  while (!IsIdleUnlocked()) {
     if (!idle_cond_.TimedWait(delta)) {
       return false;
     }
@@ -550,6 +1372,13 @@ bool ThreadPool::WaitFor(const MonoDelta& delta) {
   return true;
 }
 
+bool ThreadPool::IsIdleUnlocked() const {
+  if (work_stealing_) {
+    return work_stealing_->pending_tasks() == 0;
+  }
+  return queue_.empty() && active_threads_ == 0;
+}
+
 void ThreadPool::DispatchThread(bool permanent) {
   MutexLock unique_lock(lock_);
   while (true) {
@@ -592,43 +1421,7 @@ void ThreadPool::DispatchThread(bool permanent) {
     ++active_threads_;
 
     unique_lock.Unlock();
-
-    // Release the reference which was held by the queued item.
-    ADOPT_TRACE(task.trace);
-    if (task.trace) {
-      task.trace->Release();
-    }
-
-    // Update metrics
-    MonoTime now(MonoTime::Now());
-    int64_t queue_time_us = (now - task.submit_time).ToMicroseconds();
-    if (metrics_.queue_time_us_histogram) {
-      metrics_.queue_time_us_histogram->Increment(queue_time_us);
-    }
-    if (token->metrics_.queue_time_us_histogram) {
-      token->metrics_.queue_time_us_histogram->Increment(queue_time_us);
-    }
-
-    // Execute the task
-    {
-      MicrosecondsInt64 start_wall_us = GetMonoTimeMicros();
-      task.runnable->Run();
-      int64_t wall_us = GetMonoTimeMicros() - start_wall_us;
-
-      if (metrics_.run_time_us_histogram) {
-        metrics_.run_time_us_histogram->Increment(wall_us);
-      }
-      if (token->metrics_.run_time_us_histogram) {
-        token->metrics_.run_time_us_histogram->Increment(wall_us);
-      }
-    }
-    // Destruct the task while we do not hold the lock.
-    //
-    // The task's destructor may be expensive if it has a lot of bound
-    // objects, and we don't want to block submission of the threadpool.
-    // In the worst case, the destructor might even try to do something
-    // with this threadpool, and produce a deadlock.
-    task.runnable.reset();
+    RunTask(&task, token);
     unique_lock.Lock();
 
     // Possible states:
@@ -669,6 +1462,45 @@ void ThreadPool::DispatchThread(bool permanent) {
   }
 }
 
+void ThreadPool::RunTask(Task* task, ThreadPoolToken* token) {
+  // Release the reference which was held by the queued item.
+  ADOPT_TRACE(task->trace);
+  if (task->trace) {
+    task->trace->Release();
+  }
+
+  // Update metrics
+  MonoTime now(MonoTime::Now());
+  int64_t queue_time_us = (now - task->submit_time).ToMicroseconds();
+  if (metrics_.queue_time_us_histogram) {
+    metrics_.queue_time_us_histogram->Increment(queue_time_us);
+  }
+  if (token->metrics_.queue_time_us_histogram) {
+    token->metrics_.queue_time_us_histogram->Increment(queue_time_us);
+  }
+
+  // Execute the task
+  {
+    MicrosecondsInt64 start_wall_us = GetMonoTimeMicros();
+    task->runnable->Run();
+    int64_t wall_us = GetMonoTimeMicros() - start_wall_us;
+
+    if (metrics_.run_time_us_histogram) {
+      metrics_.run_time_us_histogram->Increment(wall_us);
+    }
+    if (token->metrics_.run_time_us_histogram) {
+      token->metrics_.run_time_us_histogram->Increment(wall_us);
+    }
+  }
+  // Destruct the task while we do not hold the lock.
+  //
+  // The task's destructor may be expensive if it has a lot of bound
+  // objects, and we don't want to block submission of the threadpool.
+  // In the worst case, the destructor might even try to do something
+  // with this threadpool, and produce a deadlock.
+  task->runnable.reset();
+}
+
 Status ThreadPool::CreateThreadUnlocked() {
   // The first few threads are permanent, and do not time out.
   bool permanent = (num_threads_ < min_threads_);
@@ -684,11 +1516,15 @@ Status ThreadPool::CreateThreadUnlocked() {
 
 void ThreadPool::CheckNotPoolThreadUnlocked() {
   Thread* current = Thread::current_thread();
-  if (ContainsKey(threads_, current)) {
+  if (ContainsKey(threads_, current) || (work_stealing_ && work_stealing_->IsWorkerThread())) {
     LOG(FATAL) << Substitute("Thread belonging to thread pool '$0' with "
         "name '$1' called pool function that would result in deadlock",
         name_, current->name());
   }
 }
 
+size_t ThreadPool::num_work_stealing_workers() const {
+  return work_stealing_ ? work_stealing_->num_workers() : 0;
+}
+
 } // namespace yb
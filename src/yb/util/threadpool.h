@@ -103,6 +103,11 @@ struct ThreadPoolMetrics {
 // metrics: Histograms, counters, etc. to update on various threadpool events.
 //    Default: not set.
 //
+// work_stealing: Whether tasks are scheduled through per-worker lock-free queues with work
+//    stealing instead of the single queue protected by the pool lock. Worker threads are still
+//    started on demand up to max_threads, but they do not time out.
+//    Default: false.
+//
 class ThreadPoolBuilder {
  public:
   explicit ThreadPoolBuilder(std::string name);
@@ -114,12 +119,14 @@ class ThreadPoolBuilder {
   ThreadPoolBuilder& set_max_queue_size(int max_queue_size);
   ThreadPoolBuilder& set_idle_timeout(const MonoDelta& idle_timeout);
   ThreadPoolBuilder& set_metrics(ThreadPoolMetrics metrics);
+  ThreadPoolBuilder& set_work_stealing(bool work_stealing);
 
   const std::string& name() const { return name_; }
   int min_threads() const { return min_threads_; }
   int max_threads() const { return max_threads_; }
   int max_queue_size() const { return max_queue_size_; }
   const MonoDelta& idle_timeout() const { return idle_timeout_; }
+  bool work_stealing() const { return work_stealing_; }
 
   // Instantiate a new ThreadPool with the existing builder arguments.
   CHECKED_STATUS Build(gscoped_ptr<ThreadPool>* pool) const;
@@ -133,6 +140,7 @@ class ThreadPoolBuilder {
   int max_queue_size_;
   MonoDelta idle_timeout_;
   ThreadPoolMetrics metrics_;
+  bool work_stealing_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolBuilder);
 };
@@ -159,6 +167,13 @@ class ThreadPoolBuilder {
 // from starving one another. However, tokenless (and CONCURRENT token-based)
 // tasks can starve SERIAL token-based tasks.
 //
+// A pool built with work stealing keeps the same semantics, but there is no shared queue. Each
+// worker has a lock-free deque and an inbox that other threads push to, idle workers steal from
+// the busy ones, and the pool lock is only taken when a worker goes to sleep or a pool or token
+// becomes idle. Tasks submitted by a worker go to its own deque. A SERIAL token is scheduled as a
+// single item that runs the token's tasks one at a time and puts itself at the back of the
+// worker's inbox after each of them, so busy tokens still take turns.
+//
 // Usage Example:
 //    static void Func(int n) { ... }
 //    class Task : public Runnable { ... }
@@ -242,13 +257,22 @@ class ThreadPool {
   // Create new thread. Required that lock_ is held.
   CHECKED_STATUS CreateThreadUnlocked();
 
+  // Whether there are no queued or running tasks. Required that lock_ is held.
+  bool IsIdleUnlocked() const;
+
+  class WorkStealingScheduler;
+
  private:
   FRIEND_TEST(TestThreadPool, TestThreadPoolWithNoMinimum);
   FRIEND_TEST(TestThreadPool, TestThreadPoolWithNoMaxThreads);
   FRIEND_TEST(TestThreadPool, TestVariableSizeThreadPool);
+  FRIEND_TEST(TestThreadPool, TestWorkStealingIdleWorkersRetire);
   // Aborts if the current thread is a member of this thread pool.
   void CheckNotPoolThreadUnlocked();
 
+  // Number of running workers of a pool built with work stealing.
+  size_t num_work_stealing_workers() const;
+
   struct Task {
     std::shared_ptr<Runnable> runnable;
     Trace* trace;
@@ -256,6 +280,10 @@ class ThreadPool {
     // Time at which the entry was submitted to the pool.
     MonoTime submit_time;
   };
+
+  // Runs the task and updates the pool and token metrics. Called without lock_ held.
+  void RunTask(Task* task, ThreadPoolToken* token);
+
   // Submits a task to be run via token.
   Status DoSubmit(std::shared_ptr<Runnable> r, ThreadPoolToken* token);
 
@@ -305,6 +333,10 @@ class ThreadPool {
   // Metrics for the entire thread pool.
   const ThreadPoolMetrics metrics_;
 
+  // Set when the pool is built with work stealing, in which case the fields above that describe
+  // the shared queue and its threads are not used.
+  std::unique_ptr<WorkStealingScheduler> work_stealing_;
+
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
@@ -396,6 +428,9 @@ class ThreadPoolToken {
            state_ == ThreadPoolTokenState::kQuiescing;
   }
 
+  // Returns true if a task submitted via this token is queued or running.
+  bool HasPendingTasks() const;
+
   // Returns true if new tasks may be submitted to this token.
   bool MaySubmitNewTasks() const {
     return state_ != ThreadPoolTokenState::kQuiescing &&
@@ -428,6 +463,10 @@ class ThreadPoolToken {
   // token.
   int active_threads_;
 
+  // Used instead of the fields above when the pool uses work stealing.
+  struct WorkStealingState;
+  std::unique_ptr<WorkStealingState> work_stealing_state_;
+
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolToken);
 };
 
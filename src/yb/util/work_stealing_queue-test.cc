@@ -0,0 +1,119 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+#include "yb/util/work_stealing_queue.h"
+
+namespace yb {
+
+class WorkStealingQueueTest : public YBTest {
+};
+
+TEST_F(WorkStealingQueueTest, PushPopSteal) {
+  WorkStealingQueue<int> queue(3);
+  ASSERT_EQ(4U, queue.capacity());
+  ASSERT_TRUE(queue.Empty());
+  ASSERT_EQ(nullptr, queue.Pop());
+  ASSERT_EQ(nullptr, queue.Steal());
+
+  int items[5];
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_TRUE(queue.Push(&items[i]));
+  }
+  ASSERT_FALSE(queue.Push(&items[4]));
+  ASSERT_FALSE(queue.Empty());
+
+  // The owner takes the newest item, thieves take the oldest one.
+  ASSERT_EQ(&items[3], queue.Pop());
+  ASSERT_EQ(&items[0], queue.Steal());
+  ASSERT_TRUE(queue.Push(&items[4]));
+  ASSERT_EQ(&items[1], queue.Steal());
+  ASSERT_EQ(&items[4], queue.Pop());
+  ASSERT_EQ(&items[2], queue.Pop());
+  ASSERT_TRUE(queue.Empty());
+  ASSERT_EQ(nullptr, queue.Pop());
+  ASSERT_EQ(nullptr, queue.Steal());
+}
+
+// The owner pushes and pops while several thieves steal, every item should be taken exactly once.
+TEST_F(WorkStealingQueueTest, ConcurrentSteal) {
+  constexpr int kNumItems = 200000;
+  constexpr int kNumThieves = 4;
+
+  WorkStealingQueue<int> queue(64);
+  std::vector<int> items(kNumItems);
+  std::vector<std::atomic<int>> taken(kNumItems);
+  for (auto& counter : taken) {
+    counter.store(0);
+  }
+  std::atomic<bool> done(false);
+  std::atomic<int> num_stolen(0);
+
+  auto take = [&items, &taken](int* item) {
+    taken[item - items.data()].fetch_add(1);
+  };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i != kNumThieves; ++i) {
+    thieves.emplace_back([&queue, &done, &num_stolen, &take] {
+      while (!done.load(std::memory_order_acquire) || !queue.Empty()) {
+        int* item = queue.Steal();
+        if (item) {
+          take(item);
+          num_stolen.fetch_add(1);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  int next = 0;
+  int num_popped = 0;
+  while (next != kNumItems) {
+    bool full = !queue.Push(&items[next]);
+    if (!full) {
+      ++next;
+    }
+    // Pop only some of the items, leaving the rest to the thieves.
+    if (full || next % 3 == 0) {
+      int* item = queue.Pop();
+      if (item) {
+        take(item);
+        ++num_popped;
+      }
+    }
+  }
+  while (int* item = queue.Pop()) {
+    take(item);
+    ++num_popped;
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& thread : thieves) {
+    thread.join();
+  }
+
+  ASSERT_EQ(kNumItems, num_popped + num_stolen.load());
+  for (int i = 0; i != kNumItems; ++i) {
+    ASSERT_EQ(1, taken[i].load()) << "Item " << i;
+  }
+  LOG(INFO) << "Popped: " << num_popped << ", stolen: " << num_stolen.load();
+}
+
+} // namespace yb
@@ -0,0 +1,138 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WORK_STEALING_QUEUE_H
+#define YB_UTIL_WORK_STEALING_QUEUE_H
+
+#include <atomic>
+#include <memory>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/port.h"
+
+namespace yb {
+
+// Bounded lock-free work-stealing deque of pointers (Chase-Lev, with the memory orderings from
+// "Correct and Efficient Work-Stealing for Weak Memory Models" by Le et al.).
+//
+// Only the owner thread may call Push() and Pop(), which work at the bottom of the deque. Any
+// thread may call Steal(), which takes the item at the top, i.e. the oldest one.
+template <class T>
+class WorkStealingQueue {
+ public:
+  // The capacity is rounded up to a power of two.
+  explicit WorkStealingQueue(size_t capacity)
+      : mask_(RoundUpToPowerOfTwo(capacity) - 1),
+        buffer_(new std::atomic<T*>[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      buffer_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  // Adds the item at the bottom of the deque. Returns false if the deque is full.
+  // Owner only.
+  bool Push(T* item) {
+    DCHECK(item != nullptr);
+    int64_t bottom = bottom_.value.load(std::memory_order_relaxed);
+    int64_t top = top_.value.load(std::memory_order_acquire);
+    if (bottom - top > static_cast<int64_t>(mask_)) {
+      return false;
+    }
+    buffer_[bottom & mask_].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.value.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Takes the item at the bottom of the deque, i.e. the most recently pushed one. Returns nullptr
+  // if the deque is empty.
+  // Owner only.
+  T* Pop() {
+    int64_t bottom = bottom_.value.load(std::memory_order_relaxed) - 1;
+    bottom_.value.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.value.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      // Empty.
+      bottom_.value.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* item = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // The last item, race with the thieves for it.
+      if (!top_.value.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.value.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // Takes the item at the top of the deque. Returns nullptr if the deque is empty or another
+  // thread took the item first.
+  T* Steal() {
+    int64_t top = top_.value.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.value.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    // The slot could only be reused by the owner after top moves past it, in which case the CAS
+    // below fails and the loaded value is discarded.
+    T* item = buffer_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.value.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  // Could be called from any thread, so the result is approximate.
+  bool Empty() const {
+    return top_.value.load(std::memory_order_acquire) >=
+           bottom_.value.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const {
+    return mask_ + 1;
+  }
+
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  // top_ is written by thieves and bottom_ by the owner, so keep them on separate cache lines.
+  struct PaddedIndex {
+    std::atomic<int64_t> value{0};
+    char pad[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+  };
+
+  const size_t mask_;
+  std::unique_ptr<std::atomic<T*>[]> buffer_;
+  PaddedIndex top_;
+  PaddedIndex bottom_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingQueue);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_WORK_STEALING_QUEUE_H
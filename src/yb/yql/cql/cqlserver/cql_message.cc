@@ -23,6 +23,23 @@
 
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
+
+DEFINE_int32(cql_compression_min_body_size, 512,
+             "Bodies of CQL responses smaller than this are sent uncompressed, even if the client "
+             "has negotiated compression.");
+TAG_FLAG(cql_compression_min_body_size, advanced);
+
+DEFINE_int32(cql_max_reusable_buffer_size, 256 * 1024,
+             "Per-thread buffers used to parse and serialize CQL messages are released after the "
+             "message, if they grew larger than this. The retained buffers are tracked by the "
+             "\"CQL Message Buffers\" memory tracker.");
+TAG_FLAG(cql_max_reusable_buffer_size, advanced);
+TAG_FLAG(cql_max_reusable_buffer_size, runtime);
+
+DECLARE_int32(max_message_length);
 
 namespace yb {
 namespace cqlserver {
@@ -174,6 +191,77 @@ Type LoadInt(const Slice& slice, size_t offset) {
   return static_cast<Type>(NetworkByteOrder::Load32(slice.data() + offset));
 }
 
+// Never destroyed, since threads that still hold buffers could exit after static destructors ran.
+const std::shared_ptr<MemTracker>& BuffersMemTracker() {
+  static const auto* tracker = new std::shared_ptr<MemTracker>(
+      MemTracker::FindOrCreateTracker(-1, "CQL Message Buffers"));
+  return *tracker;
+}
+
+// Buffer kept by a thread between messages, together with the capacity charged for it to the
+// memory tracker.
+class ThreadBuffer {
+ public:
+  ThreadBuffer() = default;
+
+  ~ThreadBuffer() {
+    Track(0);
+  }
+
+  std::unique_ptr<faststring>& buffer() { return buffer_; }
+
+  void Track(size_t capacity) {
+    if (capacity > tracked_capacity_) {
+      BuffersMemTracker()->Consume(capacity - tracked_capacity_);
+    } else if (capacity < tracked_capacity_) {
+      BuffersMemTracker()->Release(tracked_capacity_ - capacity);
+    }
+    tracked_capacity_ = capacity;
+  }
+
+ private:
+  std::unique_ptr<faststring> buffer_;
+  size_t tracked_capacity_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+// Per-thread buffers for uncompressed message bodies and for whole messages.
+thread_local ThreadBuffer body_buffer;
+thread_local ThreadBuffer message_buffer;
+
+// Buffer that is reused between the messages parsed or serialized by the same thread, so that
+// large messages do not allocate and grow a new buffer each time. Buffers that grew larger than
+// cql_max_reusable_buffer_size are released after the message.
+class ReusableBuffer {
+ public:
+  explicit ReusableBuffer(ThreadBuffer* holder) : holder_(holder) {
+    auto& buffer = holder_->buffer();
+    if (buffer == nullptr) {
+      buffer.reset(new faststring());
+    }
+    buffer->clear();
+  }
+
+  ~ReusableBuffer() {
+    auto& buffer = holder_->buffer();
+    if (buffer->capacity() >
+        static_cast<size_t>(GetAtomicFlag(&FLAGS_cql_max_reusable_buffer_size))) {
+      buffer.reset();
+    }
+    holder_->Track(buffer ? buffer->capacity() : 0);
+  }
+
+  faststring* get() const { return holder_->buffer().get(); }
+  faststring* operator->() const { return get(); }
+  faststring& operator*() const { return *get(); }
+
+ private:
+  ThreadBuffer* holder_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReusableBuffer);
+};
+
 } // namespace
 
 // ------------------------------------ CQL request -----------------------------------
@@ -224,7 +312,7 @@ bool CQLRequest::ParseRequest(
 
   size_t body_size = mesg.size() - kMessageHeaderLength;
   const uint8_t* body_data = (body_size > 0) ? &mesg[kMessageHeaderLength] : to_uchar_ptr("");
-  unique_ptr<uint8_t[]> buffer;
+  ReusableBuffer buffer(&body_buffer);
 
   // If the message body is compressed, uncompress it.
   if (body_size > 0 && (header.flags & kCompressionFlag)) {
@@ -246,10 +334,17 @@ bool CQLRequest::ParseRequest(
         }
 
         const uint32_t uncomp_size = static_cast<uint32_t>(NetworkByteOrder::Load32(body_data));
-        buffer = std::make_unique<uint8_t[]>(uncomp_size);
+        if (uncomp_size > static_cast<uint32_t>(FLAGS_max_message_length)) {
+          error_response->reset(
+              new ErrorResponse(
+                  header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
+                  "Uncompressed CQL message is too long"));
+          return false;
+        }
+        buffer->resize(uncomp_size);
         body_data += sizeof(uncomp_size);
         body_size -= sizeof(uncomp_size);
-        const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer.get()),
+        const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer->data()),
                                              body_size, uncomp_size);
         if (size < 0 || size != uncomp_size) {
           error_response->reset(
@@ -258,16 +353,17 @@ bool CQLRequest::ParseRequest(
                   "Error occurred when uncompressing CQL message"));
           return false;
         }
-        body_data = buffer.get();
+        body_data = buffer->data();
         body_size = uncomp_size;
         break;
       }
       case CompressionScheme::SNAPPY: {
         size_t uncomp_size = 0;
-        if (GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size)) {
-          buffer = std::make_unique<uint8_t[]>(uncomp_size);
-          if (RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer.get()))) {
-            body_data = buffer.get();
+        if (GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size) &&
+            uncomp_size <= static_cast<size_t>(FLAGS_max_message_length)) {
+          buffer->resize(uncomp_size);
+          if (RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer->data()))) {
+            body_data = buffer->data();
             body_size = uncomp_size;
             break;
           }
@@ -909,22 +1005,31 @@ CQLResponse::~CQLResponse() {
 #define SERIALIZE_LONG(buf, pos, value) \
   NetworkByteOrder::Store64(&(buf)[pos], static_cast<int64_t>(value))
 
-void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststring* mesg) const {
+void CQLResponse::Serialize(CompressionScheme compression_scheme, faststring* mesg) const {
   const size_t start_pos = mesg->size(); // save the start position
-  const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
-  SerializeHeader(compress, mesg);
-  if (compress) {
-    faststring body;
-    SerializeBody(&body);
+  if (compression_scheme == CQLMessage::CompressionScheme::NONE) {
+    SerializeHeader(false /* compress */, mesg);
+    SerializeBody(mesg);
+  } else {
+    ReusableBuffer body(&body_buffer);
+    SerializeBody(body.get());
+    // Compressing a tiny body costs more than sending it as is.
+    const bool compress =
+        body->size() >= static_cast<size_t>(FLAGS_cql_compression_min_body_size);
+    SerializeHeader(compress, mesg);
+    if (!compress) {
+      mesg->append(body->data(), body->size());
+      compression_scheme = CQLMessage::CompressionScheme::NONE;
+    }
     switch (compression_scheme) {
       case CQLMessage::CompressionScheme::LZ4: {
-        SerializeInt(static_cast<int32_t>(body.size()), mesg);
+        SerializeInt(static_cast<int32_t>(body->size()), mesg);
         const size_t curr_size = mesg->size();
-        const int max_comp_size = LZ4_compressBound(body.size());
+        const int max_comp_size = LZ4_compressBound(body->size());
         mesg->resize(curr_size + max_comp_size);
-        const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
+        const int comp_size = LZ4_compress_default(to_char_ptr(body->data()),
                                                    to_char_ptr(mesg->data() + curr_size),
-                                                   body.size(),
+                                                   body->size(),
                                                    max_comp_size);
         CHECK_NE(comp_size, 0) << "LZ4 compression failed";
         mesg->resize(curr_size + comp_size);
@@ -932,25 +1037,29 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
       }
       case CQLMessage::CompressionScheme::SNAPPY: {
         const size_t curr_size = mesg->size();
-        const size_t max_comp_size = MaxCompressedLength(body.size());
+        const size_t max_comp_size = MaxCompressedLength(body->size());
         size_t comp_size = 0;
         mesg->resize(curr_size + max_comp_size);
-        RawCompress(to_char_ptr(body.data()), body.size(),
+        RawCompress(to_char_ptr(body->data()), body->size(),
                     to_char_ptr(mesg->data() + curr_size), &comp_size);
         mesg->resize(curr_size + comp_size);
         break;
       }
       case CQLMessage::CompressionScheme::NONE:
-        LOG(FATAL) << "No compression scheme";
         break;
     }
-  } else {
-    SerializeBody(mesg);
   }
   SERIALIZE_INT(
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+void CQLResponse::SerializeToSlices(
+    const CompressionScheme compression_scheme, std::vector<RefCntSlice>* output) const {
+  ReusableBuffer mesg(&message_buffer);
+  Serialize(compression_scheme, mesg.get());
+  output->push_back(RefCntBuffer(*mesg));
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1482,11 +1591,37 @@ RowsResultResponse::RowsResultResponse(
 RowsResultResponse::~RowsResultResponse() {
 }
 
+void RowsResultResponse::SerializeToSlices(
+    const CompressionScheme compression_scheme, std::vector<RefCntSlice>* output) const {
+  faststring mesg;
+  SerializeHeader(false /* compress */, &mesg);
+  SerializeInt(static_cast<int32_t>(kind()), &mesg);
+  SerializeRowsHeader(&mesg);
+  const size_t body_size = mesg.size() - kMessageHeaderLength + result_->rows_data_size();
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE &&
+      body_size >= static_cast<size_t>(FLAGS_cql_compression_min_body_size)) {
+    // The compressed body has to be built in a single buffer.
+    CQLResponse::SerializeToSlices(compression_scheme, output);
+    return;
+  }
+
+  NetworkByteOrder::Store32(mesg.data() + kHeaderPosLength, static_cast<int32_t>(body_size));
+  output->push_back(RefCntBuffer(mesg));
+  output->insert(output->end(), result_->rows_data().begin(), result_->rows_data().end());
+}
+
 void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
+  SerializeRowsHeader(mesg);
+  for (const auto& rows : result_->rows_data()) {
+    mesg->append(rows.data(), rows.size());
+  }
+}
+
+void RowsResultResponse::SerializeRowsHeader(faststring* mesg) const {
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
-  mesg->append(result_->rows_data());
+  SerializeInt(static_cast<int32_t>(result_->row_count()), mesg);
 }
 
 //----------------------------------------------------------------------------------------
@@ -1721,7 +1856,7 @@ CQLServerEvent::CQLServerEvent(std::unique_ptr<EventResponse> event_response)
   serialized_response_ = RefCntBuffer(temp);
 }
 
-void CQLServerEvent::Serialize(std::deque<RefCntBuffer>* output) const {
+void CQLServerEvent::Serialize(std::deque<RefCntSlice>* output) const {
   output->push_back(serialized_response_);
 }
 
@@ -1738,7 +1873,7 @@ void CQLServerEventList::Transferred(const Status& status, rpc::Connection*) {
   }
 }
 
-void CQLServerEventList::Serialize(std::deque<RefCntBuffer>* output) const {
+void CQLServerEventList::Serialize(std::deque<RefCntSlice>* output) const {
   for (const auto& cql_server_event : cql_server_events_) {
     cql_server_event->Serialize(output);
   }
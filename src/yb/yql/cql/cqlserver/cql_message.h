@@ -465,6 +465,11 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Serialize the response into buffers that are sent one after another. Responses that carry
+  // rows data reference it from the output instead of copying it into the message.
+  virtual void SerializeToSlices(
+      CompressionScheme compression_scheme, std::vector<RefCntSlice>* output) const;
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
@@ -698,6 +703,8 @@ class ResultResponse : public CQLResponse {
   // Function to serialize a result body that all ResultResponse subclasses need to implement
   virtual void SerializeResultBody(faststring* mesg) const = 0;
 
+  Kind kind() const { return kind_; }
+
   // Helper serialize functions
   void SerializeType(const RowsMetadata::Type* type, faststring* mesg) const;
   void SerializeColSpecs(
@@ -726,10 +733,16 @@ class RowsResultResponse : public ResultResponse {
   RowsResultResponse(const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result);
   virtual ~RowsResultResponse() override;
 
+  virtual void SerializeToSlices(
+      CompressionScheme compression_scheme, std::vector<RefCntSlice>* output) const override;
+
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
 
  private:
+  // Serialize the rows metadata and the row count, i.e. the result body except for the rows.
+  void SerializeRowsHeader(faststring* mesg) const;
+
   const ql::RowsResult::SharedPtr result_;
   const bool skip_metadata_;
 };
@@ -900,7 +913,7 @@ class AuthSuccessResponse : public CQLResponse {
 class CQLServerEvent : public rpc::ServerEvent {
  public:
   explicit CQLServerEvent(std::unique_ptr<EventResponse> event_response);
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(std::deque<RefCntSlice>* output) const override;
   std::string ToString() const override;
  private:
 
@@ -915,7 +928,7 @@ class CQLServerEventList : public rpc::ServerEventList {
  public:
   CQLServerEventList();
   void AddEvent(std::unique_ptr<CQLServerEvent> event);
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(std::deque<RefCntSlice>* output) const override;
   std::string ToString() const override;
  private:
   void Transferred(const Status& status, rpc::Connection*) override;
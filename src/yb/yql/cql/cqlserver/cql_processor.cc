@@ -170,9 +170,9 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   MonoTime response_begin = MonoTime::Now();
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  std::vector<RefCntSlice> msg;
+  response.SerializeToSlices(compression_scheme, &msg);
+  call_->RespondSuccess(std::move(msg), cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -451,7 +451,7 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
     case ExecutedResult::Type::ROWS: {
       const RowsResult::SharedPtr& rows_result = std::static_pointer_cast<RowsResult>(result);
       if (request_->opcode() != CQLMessage::Opcode::AUTH_RESPONSE) {
-        cql_metrics_->ql_response_size_bytes_->Increment(rows_result->rows_data().size());
+        cql_metrics_->ql_response_size_bytes_->Increment(rows_result->rows_data_size());
       }
       switch (request_->opcode()) {
         case CQLMessage::Opcode::EXECUTE:
@@ -462,7 +462,12 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
           {
             const auto& req = down_cast<const AuthResponseRequest&>(*request_);
             const auto& params = req.params();
-            const auto row_block = rows_result->GetRowBlock();
+            const auto row_block_result = rows_result->GetRowBlock();
+            if (!row_block_result.ok()) {
+              return new ErrorResponse(*request_, ErrorResponse::Code::SERVER_ERROR,
+                  row_block_result.status().ToString());
+            }
+            const auto& row_block = *row_block_result;
             if (row_block->row_count() != 1) {
               return new ErrorResponse(*request_, ErrorResponse::Code::SERVER_ERROR,
                   "Could not get data for " + params.username);
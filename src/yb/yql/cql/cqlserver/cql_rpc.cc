@@ -22,6 +22,7 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/slow_query_log.h"
 
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/size_literals.h"
@@ -162,11 +163,11 @@ const std::string& CQLInboundCall::method_name() const {
   return result;
 }
 
-void CQLInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void CQLInboundCall::Serialize(std::deque<RefCntSlice>* output) const {
   TRACE_EVENT0("rpc", "CQLInboundCall::Serialize");
-  CHECK_GT(response_msg_buf_.size(), 0);
+  CHECK(!response_msg_bufs_.empty());
 
-  output->push_back(response_msg_buf_);
+  output->insert(output->end(), response_msg_bufs_.begin(), response_msg_bufs_.end());
 }
 
 void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code,
@@ -197,20 +198,20 @@ void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_cod
       break;
     }
   }
-  response_msg_buf_ = RefCntBuffer(msg);
+  response_msg_bufs_.assign(1, RefCntBuffer(msg));
 
   QueueResponse(/* is_success */ false);
 }
 
-void CQLInboundCall::RespondSuccess(const RefCntBuffer& buffer,
+void CQLInboundCall::RespondSuccess(std::vector<RefCntSlice> buffers,
                                     const yb::rpc::RpcMethodMetrics& metrics) {
   RecordHandlingCompleted(metrics.handler_latency);
-  response_msg_buf_ = buffer;
+  response_msg_bufs_ = std::move(buffers);
 
   QueueResponse(/* is_success */ true);
 }
 
-void CQLInboundCall::GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) {
+void CQLInboundCall::GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) const {
   std::shared_ptr<const CQLRequest> request =
 #ifdef THREAD_SANITIZER
       request_;
@@ -284,12 +285,21 @@ void CQLInboundCall::GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_p
 
 void CQLInboundCall::LogTrace() const {
   MonoTime now = MonoTime::Now();
-  int total_time = now.GetDeltaSince(timing_.time_received).ToMilliseconds();
+  MonoDelta elapsed = now.GetDeltaSince(timing_.time_received);
+  int total_time = elapsed.ToMilliseconds();
 
   if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces || total_time > FLAGS_rpc_slow_query_threshold_ms)) {
     LOG(INFO) << ToString() << " took " << total_time << "ms. Trace:";
     trace_->Dump(&LOG(INFO), true);
   }
+
+  if (PREDICT_FALSE(rpc::IsSlowQueryLogEnabled() && elapsed >= rpc::SlowQueryLogThreshold())) {
+    rpc::RpcCallInProgressPB call;
+    call.set_trace_buffer(trace_->DumpToString(true));
+    call.set_micros_elapsed(elapsed.ToMicroseconds());
+    GetCallDetails(&call);
+    rpc::AddSlowQuery(connection()->remote(), std::move(call));
+  }
 }
 
 std::string CQLInboundCall::ToString() const {
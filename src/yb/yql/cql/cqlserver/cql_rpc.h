@@ -76,7 +76,7 @@ class CQLInboundCall : public rpc::InboundCall {
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(std::deque<RefCntSlice>* output) const override;
 
   void LogTrace() const override;
   std::string ToString() const override;
@@ -84,9 +84,9 @@ class CQLInboundCall : public rpc::InboundCall {
 
   MonoTime GetClientDeadline() const override;
 
-  // Return the response message buffer.
-  RefCntBuffer& response_msg_buf() {
-    return response_msg_buf_;
+  // Return the buffers of the response message.
+  const std::vector<RefCntSlice>& response_msg_bufs() const {
+    return response_msg_bufs_;
   }
 
   // Return the SQL session of this CQL call.
@@ -105,8 +105,8 @@ class CQLInboundCall : public rpc::InboundCall {
   const std::string& service_name() const override;
   const std::string& method_name() const override;
   void RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) override;
-  void RespondSuccess(const RefCntBuffer& buffer, const yb::rpc::RpcMethodMetrics& metrics);
-  void GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb);
+  void RespondSuccess(std::vector<RefCntSlice> buffers, const yb::rpc::RpcMethodMetrics& metrics);
+  void GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) const;
   void SetRequest(std::shared_ptr<const CQLRequest> request, CQLServiceImpl* service_impl) {
     service_impl_ = service_impl;
 #ifdef THREAD_SANITIZER
@@ -120,7 +120,7 @@ class CQLInboundCall : public rpc::InboundCall {
   void RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_time) override;
 
   Callback<void(void)>* resume_from_ = nullptr;
-  RefCntBuffer response_msg_buf_;
+  std::vector<RefCntSlice> response_msg_bufs_;
   ql::QLSession::SharedPtr ql_session_;
   uint16_t stream_id_;
   std::shared_ptr<const CQLRequest> request_;
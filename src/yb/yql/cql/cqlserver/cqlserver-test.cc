@@ -21,11 +21,18 @@
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
 
+#include "yb/common/ql_rowblock.h"
+#include "yb/gutil/endian.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/util/cast.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
+DECLARE_int32(cql_max_reusable_buffer_size);
+
 namespace yb {
 namespace cqlserver {
 
@@ -250,5 +257,153 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+TEST(TestCQLMessage, CompressionCpuPerResponse) {
+  constexpr int kNumResponses = 1000;
+  string message;
+  for (int i = 0; message.size() < 64_KB; ++i) {
+    message += Substitute("row $0: value $1; ", i, i % 7);
+  }
+  const ErrorResponse response(
+      static_cast<CQLMessage::StreamId>(1), ErrorResponse::Code::SERVER_ERROR, message);
+
+  for (auto scheme : {CQLMessage::CompressionScheme::NONE,
+                      CQLMessage::CompressionScheme::LZ4,
+                      CQLMessage::CompressionScheme::SNAPPY}) {
+    size_t size = 0;
+    Stopwatch stopwatch(Stopwatch::THIS_THREAD);
+    stopwatch.start();
+    for (int i = 0; i != kNumResponses; ++i) {
+      std::vector<RefCntSlice> output;
+      response.SerializeToSlices(scheme, &output);
+      ASSERT_EQ(1U, output.size());
+      size = output[0].size();
+      const bool compressed = (output[0].data()[CQLMessage::kHeaderPosFlags] &
+                               CQLMessage::kCompressionFlag) != 0;
+      ASSERT_EQ(scheme != CQLMessage::CompressionScheme::NONE, compressed);
+    }
+    stopwatch.stop();
+    const auto cpu_us = (stopwatch.elapsed().user_cpu_seconds() +
+                         stopwatch.elapsed().system_cpu_seconds()) * 1e6;
+    LOG(INFO) << "Compression scheme " << static_cast<int>(scheme) << ": " << size
+              << " bytes, " << cpu_us / kNumResponses << " us CPU per response";
+  }
+
+  // Tiny responses are not compressed.
+  std::vector<RefCntSlice> output;
+  ErrorResponse(static_cast<CQLMessage::StreamId>(1), ErrorResponse::Code::SERVER_ERROR, "Error")
+      .SerializeToSlices(CQLMessage::CompressionScheme::LZ4, &output);
+  ASSERT_EQ(1U, output.size());
+  ASSERT_EQ(0, output[0].data()[CQLMessage::kHeaderPosFlags] & CQLMessage::kCompressionFlag);
+}
+
+// The per-thread buffers used to serialize responses are charged to a memory tracker, and buffers
+// that grew for a large response are not retained.
+TEST(TestCQLMessage, ReusableBuffersAreTracked) {
+  const auto tracker = MemTracker::FindOrCreateTracker(-1, "CQL Message Buffers");
+  const auto max_buffer_size = static_cast<int64_t>(FLAGS_cql_max_reusable_buffer_size);
+
+  std::vector<RefCntSlice> output;
+  ErrorResponse(static_cast<CQLMessage::StreamId>(1), ErrorResponse::Code::SERVER_ERROR, "Error")
+      .SerializeToSlices(CQLMessage::CompressionScheme::LZ4, &output);
+  ASSERT_GT(tracker->consumption(), 0);
+  ASSERT_LE(tracker->consumption(), 2 * max_buffer_size);
+
+  output.clear();
+  ErrorResponse(
+      static_cast<CQLMessage::StreamId>(1), ErrorResponse::Code::SERVER_ERROR,
+      string(4 * max_buffer_size, 'x'))
+      .SerializeToSlices(CQLMessage::CompressionScheme::LZ4, &output);
+  ASSERT_NE(0, output[0].data()[CQLMessage::kHeaderPosFlags] & CQLMessage::kCompressionFlag);
+  ASSERT_LE(tracker->consumption(), 2 * max_buffer_size);
+}
+
+// The rows of a response are sent as the chunks returned by the tablet servers, which should give
+// the same bytes as the response serialized into a single buffer.
+TEST(TestCQLMessage, RowsResultSlicesMatchSerialize) {
+  // QUERY request with the default query parameters.
+  const string query = "SELECT * FROM t";
+  faststring request_data;
+  request_data.resize(CQLMessage::kMessageHeaderLength);
+  request_data[CQLMessage::kHeaderPosVersion] = CQLMessage::kCurrentVersion;
+  request_data[CQLMessage::kHeaderPosFlags] = 0;
+  NetworkByteOrder::Store16(request_data.data() + CQLMessage::kHeaderPosStreamId, 1);
+  request_data[CQLMessage::kHeaderPosOpcode] = static_cast<uint8_t>(CQLMessage::Opcode::QUERY);
+  uint8_t buffer[4];
+  NetworkByteOrder::Store32(buffer, static_cast<uint32_t>(query.size()));
+  request_data.append(buffer, 4);
+  request_data.append(query);
+  NetworkByteOrder::Store16(buffer, 0x0001); // Consistency ONE.
+  request_data.append(buffer, 2);
+  request_data.push_back(0); // Query flags.
+  NetworkByteOrder::Store32(
+      request_data.data() + CQLMessage::kHeaderPosLength,
+      static_cast<uint32_t>(request_data.size() - CQLMessage::kMessageHeaderLength));
+
+  unique_ptr<CQLRequest> request;
+  unique_ptr<CQLResponse> error_response;
+  ASSERT_TRUE(CQLRequest::ParseRequest(
+      Slice(request_data.data(), request_data.size()), CQLMessage::CompressionScheme::NONE,
+      &request, &error_response));
+  ASSERT_EQ(CQLMessage::Opcode::QUERY, request->opcode());
+
+  // Rows result that consists of several chunks of rows data.
+  const client::YBTableName table_name("test_keyspace", "t");
+  auto columns = std::make_shared<vector<ColumnSchema>>();
+  columns->emplace_back("k", INT32);
+  columns->emplace_back("v", STRING);
+  constexpr int kNumChunks = 3;
+  constexpr int kRowsPerChunk = 10;
+  std::shared_ptr<ql::RowsResult> rows_result;
+  for (int chunk = 0; chunk != kNumChunks; ++chunk) {
+    QLRowBlock row_block(Schema(*columns, 0));
+    for (int i = 0; i != kRowsPerChunk; ++i) {
+      auto& row = row_block.Extend();
+      row.mutable_column(0)->set_int32_value(chunk * kRowsPerChunk + i);
+      row.mutable_column(1)->set_string_value(Substitute("value $0", i));
+    }
+    faststring rows_data;
+    row_block.Serialize(YQL_CLIENT_CQL, &rows_data);
+    auto chunk_result = std::make_shared<ql::RowsResult>(table_name, columns, rows_data.ToString());
+    ASSERT_OK(chunk_result->rows_data_status());
+    if (rows_result) {
+      ASSERT_OK(rows_result->Append(*chunk_result));
+    } else {
+      rows_result = chunk_result;
+    }
+  }
+  ASSERT_EQ(kNumChunks * kRowsPerChunk, rows_result->row_count());
+  ASSERT_EQ(kNumChunks, rows_result->rows_data().size());
+  ASSERT_EQ(kNumChunks * kRowsPerChunk, ASSERT_RESULT(rows_result->GetRowBlock())->row_count());
+
+  const RowsResultResponse response(static_cast<const QueryRequest&>(*request), rows_result);
+  faststring serialized;
+  response.Serialize(CQLMessage::CompressionScheme::NONE, &serialized);
+  std::vector<RefCntSlice> slices;
+  response.SerializeToSlices(CQLMessage::CompressionScheme::NONE, &slices);
+  ASSERT_EQ(1 + kNumChunks, slices.size());
+  string joined;
+  for (const auto& slice : slices) {
+    joined.append(slice.cdata(), slice.size());
+  }
+  ASSERT_EQ(serialized.ToString(), joined);
+}
+
+// Malformed rows data is reported as an error instead of crashing the server.
+TEST(TestCQLMessage, MalformedRowsData) {
+  auto columns = std::make_shared<vector<ColumnSchema>>();
+  columns->emplace_back("k", INT32);
+  const client::YBTableName table_name("test_keyspace", "t");
+
+  // Too short for the row count.
+  ql::RowsResult no_count(table_name, columns, string("\x00\x01", 2));
+  ASSERT_NOK(no_count.rows_data_status());
+  ASSERT_NOK(no_count.GetRowBlock());
+
+  // One row is announced, but its value is truncated.
+  ql::RowsResult truncated(table_name, columns, string("\x00\x00\x00\x01\x00\x00\x00\x04\x00", 9));
+  ASSERT_OK(truncated.rows_data_status());
+  ASSERT_NOK(truncated.GetRowBlock());
+}
+
 }  // namespace cqlserver
 }  // namespace yb
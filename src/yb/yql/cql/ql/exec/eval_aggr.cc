@@ -32,7 +32,7 @@ CHECKED_STATUS Executor::AggregateResultSets() {
 
   shared_ptr<RowsResult> rows = std::static_pointer_cast<RowsResult>(result_);
   DCHECK(rows->client() == QLClient::YQL_CLIENT_CQL);
-  shared_ptr<QLRowBlock> row_block = rows->GetRowBlock();
+  shared_ptr<QLRowBlock> row_block = VERIFY_RESULT(rows->GetRowBlock());
   int column_index = 0;
   faststring buffer;
 
@@ -68,8 +68,8 @@ CHECKED_STATUS Executor::AggregateResultSets() {
   }
 
   // Change the result set to the aggregate result.
-  std::static_pointer_cast<RowsResult>(result_)->set_rows_data(buffer.c_str(), buffer.size());
-  return Status::OK();
+  return std::static_pointer_cast<RowsResult>(result_)->set_rows_data(
+      buffer.c_str(), buffer.size());
 }
 
 CHECKED_STATUS Executor::EvalCount(const shared_ptr<QLRowBlock>& row_block,
@@ -20,6 +20,10 @@
 #ifndef YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 #define YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 
+#include <deque>
+#include <vector>
+
+#include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ptree/process_context.h"
 #include "yb/yql/cql/ql/util/ql_env.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -195,6 +199,55 @@ class ExecContext : public ProcessContextBase {
     partitions_count_ = count;
   }
 
+  // Used for full-table and token-range selects that scan several hash code ranges of the table
+  // in parallel. Each range keeps the position up to which its rows were returned and the read
+  // operation issued for it in the current round, if any. The ranges are ordered by partition and
+  // removed once finished. Every range reads ahead of its position independently. The operations
+  // read ahead are buffered until all ranges before it are finished, so that rows are returned in
+  // token order, and the position advances only when their rows are appended to the result.
+  struct ScanRange {
+    QLScanCursorPB cursor;
+    std::shared_ptr<client::YBqlReadOp> op;
+    std::deque<std::shared_ptr<client::YBqlReadOp>> read_ahead_ops;
+    size_t num_read_ahead_rows = 0;
+    // Whether the last operation read ahead reached the end of the range.
+    bool read_ahead_to_end = false;
+
+    // Drops the operations read ahead, their rows are read again from the position.
+    void DropReadAhead() {
+      read_ahead_ops.clear();
+      num_read_ahead_rows = 0;
+      read_ahead_to_end = false;
+    }
+  };
+
+  bool is_parallel_scan() const {
+    return scan_template_ != nullptr;
+  }
+
+  // The read operation that the per-range operations are copied from.
+  const std::shared_ptr<client::YBqlReadOp>& scan_template() const {
+    return scan_template_;
+  }
+
+  void set_scan_template(std::shared_ptr<client::YBqlReadOp> op) {
+    scan_template_ = std::move(op);
+  }
+
+  std::vector<ScanRange>* mutable_scan_ranges() {
+    return &scan_ranges_;
+  }
+
+  const std::vector<ScanRange>& scan_ranges() const {
+    return scan_ranges_;
+  }
+
+  // Apply the read operation of the given scan range.
+  CHECKED_STATUS ApplyScanRange(ScanRange* range, std::shared_ptr<client::YBqlReadOp> op) {
+    range->op = op;
+    return ql_env_->Apply(std::move(op));
+  }
+
   // Access function for start_time.
   const MonoTime& start_time() const {
     return start_time_;
@@ -243,6 +296,10 @@ class ExecContext : public ProcessContextBase {
   std::unique_ptr<std::vector<std::vector<QLExpressionPB>>> hash_values_options_;
   uint64_t partitions_count_ = 0;
   uint64_t current_partition_index_ = 0;
+
+  // For selects that scan several hash code ranges in parallel.
+  std::shared_ptr<client::YBqlReadOp> scan_template_;
+  std::vector<ScanRange> scan_ranges_;
 };
 
 }  // namespace ql
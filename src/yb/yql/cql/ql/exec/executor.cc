@@ -22,6 +22,21 @@
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/util/decimal.h"
 #include "yb/common/common.pb.h"
+#include "yb/common/partition.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(cql_scan_parallelism, 1,
+             "Number of hash code ranges that a full-table or token-range SELECT is split into and "
+             "scanned in parallel. 1 scans the table one tablet after another.");
+TAG_FLAG(cql_scan_parallelism, advanced);
+
+DEFINE_int64(cql_scan_memory_budget_bytes, 64_MB,
+             "Maximum size of the rows a parallel scan collects for a page. Once it is reached "
+             "the page is returned and the remaining rows are read in the next fetch.");
+TAG_FLAG(cql_scan_memory_budget_bytes, advanced);
 
 namespace yb {
 namespace ql {
@@ -45,6 +60,42 @@ using strings::Substitute;
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Splits the hash code range of a full-table or token-range scan into up to 'count' ranges of
+// about the same size, in partition order.
+void SplitHashCodeRange(const QLReadRequestPB& req, int count,
+                        std::vector<ExecContext::ScanRange>* ranges) {
+  const int64_t start = req.has_hash_code() ? req.hash_code() : 0;
+  const int64_t end = req.has_max_hash_code() ? req.max_hash_code()
+                                              : PartitionSchema::kMaxPartitionKey;
+  if (end < start) {
+    return;
+  }
+  const int64_t size = end - start + 1;
+  count = static_cast<int>(std::min<int64_t>(count, size));
+  for (int i = 0; i < count; i++) {
+    ExecContext::ScanRange range;
+    range.cursor.set_next_partition_key(
+        PartitionSchema::EncodeMultiColumnHashValue(start + size * i / count));
+    range.cursor.set_max_hash_code(start + size * (i + 1) / count - 1);
+    ranges->push_back(std::move(range));
+  }
+}
+
+// Gets the number of rows returned by a read op of a parallel scan.
+Status GetScanRowCount(const YBqlReadOp& op, size_t* num_rows) {
+  if (op.rows_data().empty()) {
+    *num_rows = 0;
+    return Status::OK();
+  }
+  return QLRowBlock::GetRowCount(op.request().client(), op.rows_data().AsSlice(), num_rows);
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
 Executor::Executor(QLEnv *ql_env, const QLMetrics* ql_metrics)
     : ql_env_(ql_env),
       ql_metrics_(ql_metrics),
@@ -583,8 +634,10 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     QLRowBlock empty_row_block(tnode->table()->InternalSchema(), {});
     faststring buffer;
     empty_row_block.Serialize(select_op->request().client(), &buffer);
-    *select_op->mutable_rows_data() = buffer.ToString();
-    result_ = std::make_shared<RowsResult>(select_op.get());
+    select_op->set_rows_data(RefCntBuffer(buffer));
+    auto rows_result = std::make_shared<RowsResult>(select_op.get());
+    RETURN_NOT_OK(rows_result->rows_data_status());
+    result_ = std::move(rows_result);
     return Status::OK();
   }
 
@@ -674,6 +727,28 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     select_op->set_yb_consistency_level(params.yb_consistency_level());
   }
 
+  // Full-table and token-range scans may be split into several hash code ranges that are scanned
+  // in parallel. A continued select keeps scanning in parallel if it did so for the prior page.
+  const bool parallel_scan = continue_select
+      ? !params.scan_cursors().empty()
+      : FLAGS_cql_scan_parallelism > 1 && req->hashed_column_values().empty() &&
+        exec_context_->UnreadPartitionsRemaining() == 0 && tnode->is_forward_scan() &&
+        !tnode->is_aggregate() && !tnode->is_system();
+  if (parallel_scan) {
+    std::vector<ExecContext::ScanRange>* ranges = exec_context_->mutable_scan_ranges();
+    if (continue_select) {
+      for (const auto& cursor : params.scan_cursors()) {
+        ranges->push_back(ExecContext::ScanRange{cursor, nullptr});
+      }
+    } else {
+      SplitHashCodeRange(*req, FLAGS_cql_scan_parallelism, ranges);
+    }
+    if (!ranges->empty()) {
+      exec_context_->set_scan_template(select_op);
+      return ApplyScanRanges(req->limit());
+    }
+  }
+
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
   // start partition here, and then iteratively scan the rest in FetchMoreRowsIfNeeded.
   // Otherwise, the request will already have the right hashed column values set.
@@ -690,7 +765,130 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
   return exec_context_->Apply(select_op);
 }
 
+Status Executor::ApplyScanRanges(uint64_t fetch_limit) {
+  const PTSelectStmt *tnode = static_cast<const PTSelectStmt *>(exec_context_->tnode());
+  const std::shared_ptr<YBqlReadOp>& scan_template = exec_context_->scan_template();
+  std::vector<ExecContext::ScanRange>* ranges = exec_context_->mutable_scan_ranges();
+
+  // Size of the rows collected for the page so far, including those read ahead.
+  size_t buffered_size = result_ == nullptr
+      ? 0 : std::static_pointer_cast<RowsResult>(result_)->rows_data_size();
+  for (const auto& range : *ranges) {
+    for (const auto& op : range.read_ahead_ops) {
+      buffered_size += op->rows_data().size();
+    }
+  }
+
+  // Every range reads ahead from where its buffered rows end, up to the rows missing from the
+  // page. The first range is always read so that the scan progresses, the following ones only
+  // while the buffered rows are within the memory budget.
+  for (auto& range : *ranges) {
+    if (&range != &ranges->front() &&
+        buffered_size >= static_cast<size_t>(FLAGS_cql_scan_memory_budget_bytes)) {
+      break;
+    }
+    if (range.read_ahead_to_end || range.num_read_ahead_rows >= fetch_limit) {
+      continue;
+    }
+    shared_ptr<YBqlReadOp> op(tnode->table()->NewQLSelect());
+    QLReadRequestPB *req = op->mutable_request();
+    req->CopyFrom(scan_template->request());
+    req->set_request_id(reinterpret_cast<uint64_t>(op.get()));
+    req->set_limit(fetch_limit - range.num_read_ahead_rows);
+    req->set_return_paging_state(true);
+    QLPagingStatePB *paging_state = req->mutable_paging_state();
+    paging_state->Clear();
+    if (range.read_ahead_ops.empty()) {
+      paging_state->set_next_partition_key(range.cursor.next_partition_key());
+      paging_state->set_next_row_key(range.cursor.next_row_key());
+    } else {
+      const QLPagingStatePB& last = range.read_ahead_ops.back()->response().paging_state();
+      paging_state->set_next_partition_key(last.next_partition_key());
+      paging_state->set_next_row_key(last.next_row_key());
+    }
+    req->set_hash_code(
+        PartitionSchema::DecodeMultiColumnHashValue(paging_state->next_partition_key()));
+    req->set_max_hash_code(range.cursor.max_hash_code());
+    op->set_yb_consistency_level(scan_template->yb_consistency_level());
+    RETURN_NOT_OK(exec_context_->ApplyScanRange(&range, std::move(op)));
+  }
+  return Status::OK();
+}
+
+Status Executor::FetchMoreScanRangesIfNeeded() {
+  // The current select statement.
+  const PTSelectStmt *tnode = static_cast<const PTSelectStmt *>(exec_context_->tnode());
+
+  // Rows read so far: in this fetch, previous fetches and in total.
+  RowsResult::SharedPtr current_result = std::static_pointer_cast<RowsResult>(result_);
+  size_t current_fetch_row_count = 0;
+  if (current_result != nullptr) {
+    current_fetch_row_count = current_result->row_count();
+  }
+  const size_t total_row_count =
+      exec_context_->params()->total_num_rows_read() + current_fetch_row_count;
+
+  // If all ranges are finished, we are done.
+  std::vector<ExecContext::ScanRange>* ranges = exec_context_->mutable_scan_ranges();
+  if (ranges->empty()) {
+    if (current_result != nullptr) {
+      current_result->clear_paging_state();
+    }
+    return Status::OK();
+  }
+
+  // The limit for this select: min of page size and result limit (if set).
+  uint64_t fetch_limit = exec_context_->params()->page_size();
+  bool limit_clause_reached = false;
+  if (tnode->has_limit()) {
+    QLExpressionPB limit_pb;
+    RETURN_NOT_OK(PTExprToPB(tnode->limit(), &limit_pb));
+    const int64_t limit =
+        limit_pb.value().int32_value() - exec_context_->params()->total_num_rows_read();
+    if (limit <= static_cast<int64_t>(fetch_limit)) {
+      fetch_limit = limit;
+      limit_clause_reached = current_fetch_row_count >= fetch_limit;
+    }
+  }
+
+  // Fetch more rows unless the page is full. The first page of a scan always has a result because
+  // the first range that is read returns rows data, even when it is empty.
+  const bool over_budget =
+      current_result != nullptr &&
+      current_result->rows_data_size() >= static_cast<size_t>(FLAGS_cql_scan_memory_budget_bytes);
+  if (current_fetch_row_count < fetch_limit && !over_budget) {
+    return ApplyScanRanges(fetch_limit - current_fetch_row_count);
+  }
+
+  // Otherwise, the rows read ahead are dropped. The positions of their ranges were not advanced,
+  // so they are read again in the next fetch.
+  for (auto& range : *ranges) {
+    range.DropReadAhead();
+  }
+
+  // Return the positions of the unfinished ranges so that the next fetch can resume them, unless
+  // the LIMIT clause has been reached.
+  if (current_result != nullptr) {
+    if (limit_clause_reached) {
+      current_result->clear_paging_state();
+    } else {
+      QLPagingStatePB paging_state;
+      paging_state.set_table_id(tnode->table()->id());
+      paging_state.set_total_num_rows_read(total_row_count);
+      for (const auto& range : *ranges) {
+        *paging_state.add_scan_cursors() = range.cursor;
+      }
+      current_result->set_paging_state(paging_state);
+    }
+  }
+  return Status::OK();
+}
+
 Status Executor::FetchMoreRowsIfNeeded() {
+  if (exec_context_->is_parallel_scan()) {
+    return FetchMoreScanRangesIfNeeded();
+  }
+
   if (result_ == nullptr) {
     return Status::OK();
   }
@@ -700,10 +898,7 @@ Status Executor::FetchMoreRowsIfNeeded() {
 
   // Rows read so far: in this fetch, previous fetches (for paging selects), and in total.
   RowsResult::SharedPtr current_result = std::static_pointer_cast<RowsResult>(result_);
-  size_t current_fetch_row_count = 0;
-  RETURN_NOT_OK(QLRowBlock::GetRowCount(current_result->client(),
-                                        current_result->rows_data(),
-                                        &current_fetch_row_count));
+  size_t current_fetch_row_count = current_result->row_count();
 
   size_t previous_fetches_row_count = exec_context_->params()->total_num_rows_read();
   size_t total_row_count = previous_fetches_row_count + current_fetch_row_count;
@@ -1088,25 +1283,99 @@ Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context
   if (resp.status() != QLResponsePB::YQL_STATUS_OK) {
     return exec_context->Error(resp.error_message().c_str(), QLStatusToErrorCode(resp.status()));
   }
-  return op->rows_data().empty() ? Status::OK() : AppendResult(std::make_shared<RowsResult>(op));
+  if (op->rows_data().empty()) {
+    return Status::OK();
+  }
+  auto rows_result = std::make_shared<RowsResult>(op);
+  RETURN_NOT_OK(rows_result->rows_data_status());
+  return AppendResult(rows_result);
+}
+
+Status Executor::ProcessOpError(client::YBqlOp* op, ExecContext* exec_context) {
+  Status s = ql_env_->GetOpError(op);
+  if (PREDICT_FALSE(!s.ok())) {
+    // YBOperation returns not-found error when the tablet is not found.
+    const auto error_code =
+        s.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
+    return exec_context->Error(s, error_code);
+  }
+  return Status::OK();
+}
+
+Status Executor::ProcessOpResult(client::YBqlOp* op, ExecContext* exec_context) {
+  RETURN_NOT_OK(ProcessOpError(op, exec_context));
+  return ProcessOpResponse(op, exec_context);
+}
+
+Status Executor::ProcessScanRangeResults(ExecContext* exec_context) {
+  // Buffer the operation read for each range in this round, then append the buffered rows of the
+  // ranges in partition order, so that rows are returned in token order across pages too. The rows
+  // of a range are appended only when all ranges before it are finished, and its position advances
+  // with them. A range is dropped once all its rows are appended. When the page cannot take the
+  // rows of an operation read ahead, because of its size limit or its memory budget, that operation
+  // and those after it are dropped and read again from the position of their range.
+  const uint64_t fetch_limit = exec_context->scan_template()->request().limit();
+  size_t row_count = result_ == nullptr
+      ? 0 : std::static_pointer_cast<RowsResult>(result_)->row_count();
+  std::vector<ExecContext::ScanRange>* ranges = exec_context->mutable_scan_ranges();
+  std::vector<ExecContext::ScanRange> unfinished_ranges;
+  unfinished_ranges.reserve(ranges->size());
+  bool in_order = true;
+  bool over_budget = false;
+  for (auto& range : *ranges) {
+    if (range.op != nullptr) {
+      shared_ptr<YBqlReadOp> op = std::move(range.op);
+      range.op = nullptr;
+      RETURN_NOT_OK(ProcessOpError(op.get(), exec_context));
+      size_t num_rows = 0;
+      RETURN_NOT_OK(GetScanRowCount(*op, &num_rows));
+      range.num_read_ahead_rows += num_rows;
+      range.read_ahead_to_end = !op->response().has_paging_state();
+      range.read_ahead_ops.push_back(std::move(op));
+    }
+
+    while (in_order && !range.read_ahead_ops.empty()) {
+      shared_ptr<YBqlReadOp> op = range.read_ahead_ops.front();
+      size_t num_rows = 0;
+      RETURN_NOT_OK(GetScanRowCount(*op, &num_rows));
+      if (row_count + num_rows > fetch_limit || over_budget) {
+        range.DropReadAhead();
+        break;
+      }
+      range.read_ahead_ops.pop_front();
+      range.num_read_ahead_rows -= num_rows;
+      RETURN_NOT_OK(ProcessOpResponse(op.get(), exec_context));
+      row_count += num_rows;
+      over_budget = result_ != nullptr &&
+          std::static_pointer_cast<RowsResult>(result_)->rows_data_size() >=
+              static_cast<size_t>(FLAGS_cql_scan_memory_budget_bytes);
+      if (op->response().has_paging_state()) {
+        const QLPagingStatePB& paging_state = op->response().paging_state();
+        range.cursor.set_next_partition_key(paging_state.next_partition_key());
+        range.cursor.set_next_row_key(paging_state.next_row_key());
+      }
+    }
+    if (in_order && range.read_ahead_ops.empty() && range.read_ahead_to_end) {
+      continue;
+    }
+    in_order = false;
+    unfinished_ranges.push_back(std::move(range));
+  }
+  ranges->swap(unfinished_ranges);
+  return Status::OK();
 }
 
 Status Executor::ProcessAsyncResults() {
   Status s, ss;
   for (auto& exec_context : exec_contexts_) {
-    client::YBqlOp* op = exec_context.op().get();
-    if (op == nullptr) {
-      continue; // Skip empty op.
-    }
-    ss = ql_env_->GetOpError(op);
-    if (PREDICT_FALSE(!ss.ok())) {
-      // YBOperation returns not-found error when the tablet is not found.
-      const auto error_code =
-          ss.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
-      ss = exec_context.Error(ss, error_code);
-    }
-    if (ss.ok()) {
-      ss = ProcessOpResponse(op, &exec_context);
+    if (exec_context.is_parallel_scan()) {
+      ss = ProcessScanRangeResults(&exec_context);
+    } else {
+      client::YBqlOp* op = exec_context.op().get();
+      if (op == nullptr) {
+        continue; // Skip empty op.
+      }
+      ss = ProcessOpResult(op, &exec_context);
     }
     ss = ProcessStatementStatus(*exec_context.parse_tree(), ss);
     if (PREDICT_FALSE(!ss.ok())) {
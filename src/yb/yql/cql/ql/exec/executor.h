@@ -155,6 +155,16 @@ class Executor : public QLExprExecutor {
   // Process the read/write op response.
   CHECKED_STATUS ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context);
 
+  // Process the error of a read/write op, if any.
+  CHECKED_STATUS ProcessOpError(client::YBqlOp* op, ExecContext* exec_context);
+
+  // Process the error or response of a read/write op.
+  CHECKED_STATUS ProcessOpResult(client::YBqlOp* op, ExecContext* exec_context);
+
+  // Process the responses of the ranges of a parallel scan in partition order and advance the
+  // ranges whose rows are appended.
+  CHECKED_STATUS ProcessScanRangeResults(ExecContext* exec_context);
+
   // Process result of FlushAsyncDone.
   CHECKED_STATUS ProcessAsyncResults();
 
@@ -164,6 +174,14 @@ class Executor : public QLExprExecutor {
   // Continue a multi-partition select (e.g. table scan or query with 'IN' condition on hash cols).
   CHECKED_STATUS FetchMoreRowsIfNeeded();
 
+  // Read the next rows of the unfinished ranges of a parallel scan (full-table or token-range
+  // select split into several hash code ranges), up to 'fetch_limit' rows in total.
+  CHECKED_STATUS ApplyScanRanges(uint64_t fetch_limit);
+
+  // Continue a parallel scan, or fill in the paging state with the positions of its ranges when
+  // the page is full.
+  CHECKED_STATUS FetchMoreScanRangesIfNeeded();
+
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets();
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
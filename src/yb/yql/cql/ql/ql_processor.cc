@@ -19,6 +19,8 @@
 
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/trace.h"
+
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_SQLProcessor_ParseRequest,
     "Time spent parsing the SQL query", yb::MetricUnit::kMicroseconds,
@@ -136,6 +138,7 @@ Status QLProcessor::Parse(const string& ql_stmt, ParseTree::UniPtr* parse_tree,
   }
   *parse_tree = parser_.Done();
   DCHECK(parse_tree->get() != nullptr) << "Parse tree is null";
+  TRACE("Parsed statement");
   return Status::OK();
 }
 
@@ -151,6 +154,7 @@ Status QLProcessor::Analyze(const string& ql_stmt, ParseTree::UniPtr* parse_tree
   }
   *parse_tree = analyzer_.Done();
   CHECK(parse_tree->get() != nullptr) << "Parse tree is null";
+  TRACE("Analyzed statement");
   return s;
 }
 
@@ -168,6 +172,7 @@ Status QLProcessor::Prepare(const string& ql_stmt, ParseTree::UniPtr* parse_tree
 
 void QLProcessor::ExecuteAsync(const string& ql_stmt, const ParseTree& parse_tree,
                                 const StatementParameters& params, StatementExecutedCallback cb) {
+  TRACE("Executing statement");
   executor_.ExecuteAsync(ql_stmt, parse_tree, &params, std::move(cb));
 }
 
@@ -15,6 +15,7 @@
 
 #include <thread>
 #include <cmath>
+#include <set>
 
 #include "yb/util/yb_partition.h"
 #include "yb/yql/cql/ql/test/ql-test-base.h"
@@ -23,6 +24,10 @@
 #include "yb/master/ts_manager.h"
 #include "yb/util/crypt.h"
 
+DECLARE_int32(cql_scan_parallelism);
+DECLARE_int64(cql_scan_memory_budget_bytes);
+DECLARE_int32(yb_num_shards_per_tserver);
+
 using std::string;
 using std::unique_ptr;
 using std::shared_ptr;
@@ -1244,6 +1249,134 @@ TEST_F(TestQLQuery, TestPagination) {
   EXPECT_EQ(55, sum);
 }
 
+namespace {
+
+// Reads all rows of the select page by page and returns the sum of the first column. Verifies that
+// no row is returned twice. Optionally returns the first column of the rows in the order read.
+int64_t ReadAllPages(TestQLProcessor* processor, const string& select_stmt, int page_size,
+                     int* row_count, std::vector<int32_t>* ordered_keys = nullptr) {
+  StatementParameters params;
+  params.set_page_size(page_size);
+  std::set<int32_t> keys;
+  int64_t sum = 0;
+  *row_count = 0;
+  do {
+    CHECK_OK(processor->Run(select_stmt, params));
+    std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+    CHECK_LE(row_block->row_count(), page_size);
+    for (int j = 0; j < row_block->row_count(); j++) {
+      const int32_t key = row_block->row(j).column(0).int32_value();
+      CHECK(keys.insert(key).second) << "Duplicate row " << key;
+      if (ordered_keys) {
+        ordered_keys->push_back(key);
+      }
+      sum += key;
+      (*row_count)++;
+    }
+    if (processor->rows_result()->paging_state().empty()) {
+      break;
+    }
+    CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+  } while (true);
+  return sum;
+}
+
+} // namespace
+
+TEST_F(TestQLQuery, TestParallelScan) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE scan_test (h int PRIMARY KEY, v int);");
+  static constexpr int kNumRows = 1000;
+  for (int i = 1; i <= kNumRows; i++) {
+    CHECK_VALID_STMT(Substitute("INSERT INTO scan_test (h, v) VALUES ($0, $1);", i, i));
+  }
+  static constexpr int64_t kSum = static_cast<int64_t>(kNumRows) * (kNumRows + 1) / 2;
+
+  // Rows in token order, as returned by the sequential scan.
+  std::vector<int32_t> sequential_keys;
+
+  for (int parallelism : {1, 4, 16}) {
+    FLAGS_cql_scan_parallelism = parallelism;
+    int row_count = 0;
+
+    // Full-table scan. Rows are returned in token order across pages.
+    MonoTime start = MonoTime::Now();
+    std::vector<int32_t> keys;
+    EXPECT_EQ(kSum, ReadAllPages(processor, "SELECT h, v FROM scan_test;", 97, &row_count, &keys));
+    EXPECT_EQ(kNumRows, row_count);
+    if (parallelism == 1) {
+      sequential_keys = keys;
+    } else {
+      EXPECT_EQ(sequential_keys, keys);
+    }
+    LOG(INFO) << "Full-table scan with parallelism " << parallelism << " took "
+              << MonoTime::Now().GetDeltaSince(start).ToMilliseconds() << " ms";
+
+    // Scan with a LIMIT clause.
+    ReadAllPages(processor, "SELECT h, v FROM scan_test LIMIT 150;", 97, &row_count);
+    EXPECT_EQ(150, row_count);
+
+    // Token-range scans covering the whole table.
+    int lower_count = 0;
+    int64_t sum = ReadAllPages(
+        processor, "SELECT h, v FROM scan_test WHERE token(h) < 0;", 97, &lower_count);
+    sum += ReadAllPages(
+        processor, "SELECT h, v FROM scan_test WHERE token(h) >= 0;", 97, &row_count);
+    EXPECT_EQ(kSum, sum);
+    EXPECT_EQ(kNumRows, lower_count + row_count);
+  }
+
+  // With a tiny memory budget every page holds the rows of a single range, but all rows are still
+  // returned.
+  FLAGS_cql_scan_parallelism = 8;
+  FLAGS_cql_scan_memory_budget_bytes = 1;
+  int row_count = 0;
+  std::vector<int32_t> keys;
+  EXPECT_EQ(kSum, ReadAllPages(processor, "SELECT h, v FROM scan_test;", 500, &row_count, &keys));
+  EXPECT_EQ(kNumRows, row_count);
+  EXPECT_EQ(sequential_keys, keys);
+}
+
+TEST_F(TestQLQuery, TestParallelScanSpeedup) {
+  // A sparse table whose rows fit into a single page, so that a sequential scan reads its tablets
+  // one after another, while a parallel scan reads the tablets of its ranges concurrently.
+  FLAGS_yb_num_shards_per_tserver = 32;
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE scan_bench (h int PRIMARY KEY, v int);");
+  static constexpr int kNumRows = 64;
+  for (int i = 1; i <= kNumRows; i++) {
+    CHECK_VALID_STMT(Substitute("INSERT INTO scan_bench (h, v) VALUES ($0, $1);", i, i));
+  }
+  static constexpr int64_t kSum = static_cast<int64_t>(kNumRows) * (kNumRows + 1) / 2;
+
+  static constexpr int kNumScans = 20;
+  auto time_scans = [processor](int parallelism) {
+    FLAGS_cql_scan_parallelism = parallelism;
+    MonoTime start = MonoTime::Now();
+    for (int i = 0; i < kNumScans; i++) {
+      int row_count = 0;
+      EXPECT_EQ(kSum, ReadAllPages(processor, "SELECT h, v FROM scan_bench;", 1000, &row_count));
+      EXPECT_EQ(kNumRows, row_count);
+    }
+    return MonoTime::Now().GetDeltaSince(start);
+  };
+
+  const MonoDelta sequential_time = time_scans(1);
+  const MonoDelta parallel_time = time_scans(16);
+  const double speedup = sequential_time.ToSeconds() / parallel_time.ToSeconds();
+  LOG(INFO) << kNumScans << " full-table scans took " << sequential_time.ToMilliseconds()
+            << " ms sequentially and " << parallel_time.ToMilliseconds()
+            << " ms with parallelism 16, speedup " << speedup;
+  EXPECT_GT(speedup, 1.0);
+}
+
 TEST_F(TestQLQuery, TestTokenBcall) {
   //------------------------------------------------------------------------------------------------
   // Setting up cluster
@@ -115,7 +115,8 @@ class TestQLProcessor : public QLProcessor {
     LOG(INFO) << (result_ == NULL ? "Result is NULL." : "Got result.")
               << " Return type = " << static_cast<int>(ExecutedResult::Type::ROWS);
     if (result_ != nullptr && result_->type() == ExecutedResult::Type::ROWS) {
-      return std::shared_ptr<QLRowBlock>(static_cast<RowsResult*>(result_.get())->GetRowBlock());
+      return std::shared_ptr<QLRowBlock>(
+          CHECK_RESULT(static_cast<RowsResult*>(result_.get())->GetRowBlock()));
     }
     return nullptr;
   }
@@ -64,6 +64,10 @@ class StatementParameters {
 
   int64_t next_partition_index() const { return paging_state().next_partition_index(); }
 
+  const google::protobuf::RepeatedPtrField<QLScanCursorPB>& scan_cursors() const {
+    return paging_state().scan_cursors();
+  }
+
   // Retrieve a bind variable for the execution of the statement. To be overridden by subclasses
   // to return actual bind variables.
   virtual CHECKED_STATUS GetBindVariable(const std::string& name,
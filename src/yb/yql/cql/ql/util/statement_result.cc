@@ -150,8 +150,10 @@ PreparedResult::~PreparedResult() {
 RowsResult::RowsResult(YBqlOp *op, const PTDmlStmt *tnode)
     : table_name_(op->table()->name()),
       column_schemas_(GetColumnSchemasFromOp(*op, tnode)),
-      client_(GetClientFromOp(*op)),
-      rows_data_(op->rows_data()) {
+      client_(GetClientFromOp(*op)) {
+  if (!op->rows_data().empty()) {
+    rows_data_status_ = AppendRowsData(op->rows_data());
+  }
 
   if (column_schemas_ == nullptr) {
     column_schemas_ = make_shared<vector<ColumnSchema>>();
@@ -173,25 +175,52 @@ RowsResult::RowsResult(const client::YBTableName& table_name,
                        const std::string& rows_data)
     : table_name_(table_name),
       column_schemas_(column_schemas),
-      client_(QLClient::YQL_CLIENT_CQL),
-      rows_data_(rows_data) {
+      client_(QLClient::YQL_CLIENT_CQL) {
+  rows_data_status_ = set_rows_data(rows_data.data(), rows_data.size());
 }
 
 RowsResult::~RowsResult() {
 }
 
-Status RowsResult::Append(const RowsResult& other) {
-  if (rows_data_.empty()) {
-    rows_data_ = other.rows_data_;
-  } else {
-    RETURN_NOT_OK(QLRowBlock::AppendRowsData(other.client_, other.rows_data_, &rows_data_));
+Status RowsResult::set_rows_data(const char *str, size_t size) {
+  rows_data_.clear();
+  rows_data_size_ = 0;
+  row_count_ = 0;
+  rows_data_status_ = Status::OK();
+  return AppendRowsData(RefCntBuffer(str, size));
+}
+
+Status RowsResult::AppendRowsData(const RefCntSlice& rows_data) {
+  size_t count = 0;
+  Slice rows;
+  RETURN_NOT_OK_PREPEND(QLRowBlock::GetRowCount(client_, rows_data.AsSlice(), &count, &rows),
+                        Substitute("Bad rows data for $0", table_name_.ToString()));
+  if (count == 0) {
+    return Status::OK();
   }
+  rows_data_.emplace_back(rows_data.holder(), rows);
+  rows_data_size_ += rows.size();
+  row_count_ += count;
+  return Status::OK();
+}
+
+Status RowsResult::Append(const RowsResult& other) {
+  RETURN_NOT_OK(other.rows_data_status_);
+  rows_data_.insert(rows_data_.end(), other.rows_data_.begin(), other.rows_data_.end());
+  rows_data_size_ += other.rows_data_size_;
+  row_count_ += other.row_count_;
   paging_state_ = other.paging_state_;
   return Status::OK();
 }
 
-std::unique_ptr<QLRowBlock> RowsResult::GetRowBlock() const {
-  return CreateRowBlock(client_, Schema(*column_schemas_, 0), rows_data_);
+Result<std::unique_ptr<QLRowBlock>> RowsResult::GetRowBlock() const {
+  RETURN_NOT_OK(rows_data_status_);
+  auto row_block = std::make_unique<QLRowBlock>(Schema(*column_schemas_, 0));
+  for (const auto& chunk : rows_data_) {
+    RETURN_NOT_OK_PREPEND(row_block->DeserializeRows(client_, chunk.AsSlice()),
+                          Substitute("Bad rows data for $0", table_name_.ToString()));
+  }
+  return std::move(row_block);
 }
 
 //------------------------------------------------------------------------------------------------
@@ -24,6 +24,8 @@
 #include "yb/common/schema.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
+#include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/result.h"
 
 namespace yb {
 namespace ql {
@@ -133,8 +135,17 @@ class RowsResult : public ExecutedResult {
   // Accessor functions.
   const client::YBTableName& table_name() const { return table_name_; }
   const std::vector<ColumnSchema>& column_schemas() const { return *column_schemas_; }
-  const std::string& rows_data() const { return rows_data_; }
-  void set_rows_data(const char *str, size_t size) { rows_data_.assign(str, size); }
+
+  // Rows data is kept as the chunks of serialized rows returned by the tablet servers, without
+  // their row count headers, so that the rows could be sent to the client without copying.
+  const std::vector<RefCntSlice>& rows_data() const { return rows_data_; }
+  size_t rows_data_size() const { return rows_data_size_; }
+  size_t row_count() const { return row_count_; }
+  CHECKED_STATUS set_rows_data(const char *str, size_t size);
+
+  // Status of the rows data passed to the constructor. The rows are not sent to the client, if
+  // their data is malformed.
+  const Status& rows_data_status() const { return rows_data_status_; }
   const std::string& paging_state() const { return paging_state_; }
   QLClient client() const { return client_; }
 
@@ -144,15 +155,21 @@ class RowsResult : public ExecutedResult {
     paging_state.SerializeToString(&paging_state_);
   }
 
-  // Parse the rows data and return it as a row block. It is the caller's responsibility to free
-  // the row block after use.
-  std::unique_ptr<QLRowBlock> GetRowBlock() const;
+  // Parse the rows data and return it as a row block. Returns an error if the rows data is
+  // malformed.
+  Result<std::unique_ptr<QLRowBlock>> GetRowBlock() const;
 
  private:
+  // Adds serialized rows data that starts with the row count.
+  CHECKED_STATUS AppendRowsData(const RefCntSlice& rows_data);
+
   const client::YBTableName table_name_;
   std::shared_ptr<std::vector<ColumnSchema>> column_schemas_;
   const QLClient client_;
-  std::string rows_data_;
+  std::vector<RefCntSlice> rows_data_;
+  size_t rows_data_size_ = 0;
+  size_t row_count_ = 0;
+  Status rows_data_status_;
   std::string paging_state_;
 };
 
@@ -26,6 +26,7 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/slow_query_log.h"
 
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
@@ -195,12 +196,23 @@ MonoTime RedisInboundCall::GetClientDeadline() const {
 
 void RedisInboundCall::LogTrace() const {
   MonoTime now = MonoTime::Now();
-  auto total_time = now.GetDeltaSince(timing_.time_received).ToMilliseconds();
+  auto elapsed = now.GetDeltaSince(timing_.time_received);
+  auto total_time = elapsed.ToMilliseconds();
 
   if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces || total_time > FLAGS_rpc_slow_query_threshold_ms)) {
     LOG(INFO) << ToString() << " took " << total_time << "ms. Trace:";
     trace_->Dump(&LOG(INFO), /* include_time_deltas */ true);
   }
+
+  if (PREDICT_FALSE(rpc::IsSlowQueryLogEnabled() && elapsed >= rpc::SlowQueryLogThreshold())) {
+    rpc::RpcCallInProgressPB call;
+    call.set_trace_buffer(trace_->DumpToString(/* include_time_deltas */ true));
+    call.set_micros_elapsed(elapsed.ToMicroseconds());
+    // The slow query log is kept for a while and could be read by anyone with access to the web
+    // UI, so it does not get the values.
+    GetCallDetails(&call, /* redact_values= */ true);
+    rpc::AddSlowQuery(connection()->remote(), std::move(call));
+  }
 }
 
 string RedisInboundCall::ToString() const {
@@ -214,22 +226,31 @@ bool RedisInboundCall::DumpPB(const rpc::DumpRunningRpcsRequestPB& req,
   }
   resp->set_micros_elapsed(MonoTime::Now().GetDeltaSince(timing_.time_received)
       .ToMicroseconds());
+  GetCallDetails(resp);
+  return true;
+}
 
+void RedisInboundCall::GetCallDetails(rpc::RpcCallInProgressPB* call_in_progress_pb,
+                                      bool redact_values) const {
   if (!parsed_.load(std::memory_order_acquire)) {
-    return true;
+    return;
   }
 
   // RedisClientBatch client_batch_
-  rpc::RedisCallDetailsPB* redis_details = resp->mutable_redis_details();
+  rpc::RedisCallDetailsPB* redis_details = call_in_progress_pb->mutable_redis_details();
   for (RedisClientCommand command : client_batch_) {
     string query = "";
+    size_t arg_idx = 0;
     for (Slice arg : command) {
-      query += " " + arg.ToDebugString(FLAGS_rpcz_max_redis_query_dump_size);
+      // The first argument is the command name, and the second one is the key.
+      if (redact_values && arg_idx++ >= 2) {
+        query += Format(" <$0 bytes>", arg.size());
+      } else {
+        query += " " + arg.ToDebugString(FLAGS_rpcz_max_redis_query_dump_size);
+      }
     }
     redis_details->add_call_details()->set_redis_string(query);
   }
-
-  return true;
 }
 
 template <class Collection, class Out>
@@ -284,7 +305,7 @@ RefCntBuffer SerializeResponses(const Collection& responses) {
   return result;
 }
 
-void RedisInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void RedisInboundCall::Serialize(std::deque<RefCntSlice>* output) const {
   output->push_back(SerializeResponses(responses_));
 }
 
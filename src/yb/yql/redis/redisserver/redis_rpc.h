@@ -62,7 +62,7 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(std::deque<RefCntSlice>* output) const override;
 
   void LogTrace() const override;
   std::string ToString() const override;
@@ -84,6 +84,10 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
 
  private:
   void Respond(size_t idx, bool is_success, RedisResponsePB* resp);
+  // If redact_values is true, only the command names and the keys are filled, while the other
+  // arguments are replaced with their sizes.
+  void GetCallDetails(rpc::RpcCallInProgressPB* call_in_progress_pb,
+                      bool redact_values = false) const;
 
   // The connection on which this inbound call arrived.
   static constexpr size_t batch_capacity = RedisClientBatch::static_capacity;
@@ -51,6 +51,7 @@
 #include "yb/util/memory/mc_types.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/stol_utils.h"
+#include "yb/util/trace.h"
 
 using yb::operator"" _MB;
 using namespace std::literals;
@@ -1021,6 +1022,7 @@ void RedisServiceImpl::Impl::Handle(rpc::InboundCallPtr call_ptr) {
   auto context = make_scoped_refptr<BatchContext>(
       client_, table_.get(), &session_pool_, call, metrics_internal_.data());
   const auto& batch = call->client_batch();
+  TRACE("Handling $0 commands", batch.size());
   for (size_t idx = 0; idx != batch.size(); ++idx) {
     const RedisClientCommand& c = batch[idx];
 
@@ -1054,6 +1056,7 @@ void RedisServiceImpl::Impl::Handle(rpc::InboundCallPtr call_ptr) {
       cmd_info->functor(*cmd_info, idx, context.get());
     }
   }
+  TRACE("Committing commands");
   context->Commit();
 }
 
@@ -25,6 +25,8 @@
 
 #include "yb/client/meta_cache.h"
 
+#include "yb/rpc/slow_query_log.h"
+
 #include "yb/integration-tests/redis_table_test_base.h"
 
 #include "yb/yql/redis/redisserver/redis_constants.h"
@@ -45,6 +47,8 @@ DECLARE_int32(redis_max_command_size);
 DECLARE_int32(rpc_max_message_size);
 DECLARE_int32(consensus_max_batch_size_bytes);
 DECLARE_int32(consensus_rpc_timeout_ms);
+DECLARE_int32(slow_query_log_threshold_ms);
+DECLARE_int32(tablet_inject_latency_on_apply_write_txn_ms);
 
 DEFINE_uint64(test_redis_max_concurrent_commands, 20,
     "Value of redis_max_concurrent_commands for pipeline test");
@@ -637,6 +641,40 @@ TEST_F(TestRedisService, SimpleCommandMulti) {
       __LINE__, "*3\r\n$3\r\nset\r\n$3\r\nfoo\r\n$4\r\nTEST\r\n", "+OK\r\n");
 }
 
+// A slow call is added to the slow query log, with the stages it went through on the proxy and on
+// the tablet server.
+TEST_F(TestRedisService, SlowQueryLog) {
+  google::FlagSaver flag_saver;
+  FLAGS_slow_query_log_threshold_ms = 500;
+  rpc::DumpSlowQueriesResponsePB resp;
+  rpc::DumpSlowQueries(/* reset */ true, &resp);
+
+  FLAGS_tablet_inject_latency_on_apply_write_txn_ms = 1000;
+  SendCommandAndExpectResponse(__LINE__, "set slow_key slow_value\r\n", "+OK\r\n");
+  FLAGS_tablet_inject_latency_on_apply_write_txn_ms = 0;
+
+  resp.Clear();
+  rpc::DumpSlowQueries(/* reset */ true, &resp);
+  const rpc::SlowQueryPB* slow_query = nullptr;
+  for (const auto& query : resp.queries()) {
+    for (const auto& details : query.call().redis_details().call_details()) {
+      if (details.redis_string().find("slow_key") != std::string::npos) {
+        slow_query = &query;
+      }
+    }
+  }
+  ASSERT_TRUE(slow_query != nullptr) << resp.ShortDebugString();
+  ASSERT_GE(slow_query->call().micros_elapsed(), 1000000U);
+
+  // The trace has the stages of the call on the proxy, the RPC it sent to the tablet server, and
+  // the trace returned by the tablet server.
+  const std::string& trace = slow_query->call().trace_buffer();
+  for (const auto* stage : {"Handling 1 commands", "Committing commands", "WriteRpc initiated to",
+                            "Received from server"}) {
+    ASSERT_NE(std::string::npos, trace.find(stage)) << "No " << stage << " in trace: " << trace;
+  }
+}
+
 TEST_F(TestRedisService, BatchedCommandsInline) {
   SendCommandAndExpectResponse(
       __LINE__,